@@ -33,3 +33,12 @@ function filter(gn)
   end
   return true
 end
+
+-- filters many candidates with a single call from LTRsift
+function filter_batch(nodes)
+  local results = {}
+  for i, gn in ipairs(nodes) do
+    results[i] = filter(gn)
+  end
+  return results
+end
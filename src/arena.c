@@ -0,0 +1,104 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "arena.h"
+#include "genometools.h"
+
+#define ARENA_ALIGNMENT (2 * sizeof (gpointer))
+#define ARENA_ALIGN(N)  (((N) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+typedef struct ArenaBlock ArenaBlock;
+
+/* the usable memory of a block directly follows its header */
+struct ArenaBlock {
+  ArenaBlock *next;
+  gsize size,
+        used;
+};
+
+struct Arena {
+  ArenaBlock *blocks;
+  gsize block_size,
+        total;
+};
+
+Arena* arena_new(gsize block_size)
+{
+  Arena *arena = g_slice_new(Arena);
+
+  arena->blocks = NULL;
+  arena->block_size = MAX(block_size, ARENA_ALIGNMENT);
+  arena->total = 0;
+  return arena;
+}
+
+static ArenaBlock* arena_add_block(Arena *arena, gsize size)
+{
+  ArenaBlock *block;
+  gsize header = ARENA_ALIGN(sizeof (ArenaBlock));
+
+  block = g_malloc(header + MAX(size, arena->block_size));
+  block->size = MAX(size, arena->block_size);
+  block->used = 0;
+  /* allocations larger than a block get a block of their own, which is put
+     behind the current block so the latter can still be filled up */
+  if (size > arena->block_size && arena->blocks) {
+    block->next = arena->blocks->next;
+    arena->blocks->next = block;
+  } else {
+    block->next = arena->blocks;
+    arena->blocks = block;
+  }
+  arena->total += header + block->size;
+  return block;
+}
+
+gpointer arena_alloc(Arena *arena, gsize size)
+{
+  ArenaBlock *block;
+  gchar *mem;
+
+  gt_assert(arena);
+  size = ARENA_ALIGN(MAX(size, 1));
+  block = arena->blocks;
+  if (!block || block->size - block->used < size)
+    block = arena_add_block(arena, size);
+  mem = (gchar*) block + ARENA_ALIGN(sizeof (ArenaBlock)) + block->used;
+  block->used += size;
+  memset(mem, 0, size);
+  return mem;
+}
+
+gsize arena_get_size(Arena *arena)
+{
+  gt_assert(arena);
+  return arena->total;
+}
+
+void arena_delete(Arena *arena)
+{
+  ArenaBlock *block;
+
+  if (!arena)
+    return;
+  while ((block = arena->blocks)) {
+    arena->blocks = block->next;
+    g_free(block);
+  }
+  g_slice_free(Arena, arena);
+}
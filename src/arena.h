@@ -0,0 +1,43 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <glib.h>
+
+/* <Arena> hands out memory from large blocks. Single allocations are never
+   freed, all memory of an arena is released at once by arena_delete(). It is
+   meant for data living exactly as long as a project, which then does not
+   have to be freed piece by piece on close. An arena must only be used by
+   one thread at a time. */
+typedef struct Arena Arena;
+
+/* Returns a new arena allocating blocks of (at least) <block_size> bytes. */
+Arena*   arena_new(gsize block_size);
+
+/* Returns <size> bytes of zeroed memory, aligned for any basic type. */
+gpointer arena_alloc(Arena *arena, gsize size);
+
+#define  arena_new0(A, T) ((T*) arena_alloc(A, sizeof (T)))
+
+/* Returns the number of bytes allocated from the system by <arena>. */
+gsize    arena_get_size(Arena *arena);
+
+void     arena_delete(Arena *arena);
+
+#endif
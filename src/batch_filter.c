@@ -0,0 +1,195 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batch_filter.h"
+
+/* the Makefile defines LTRSIFT_BATCH_FILTER if the Lua bindings of the
+   GenomeTools sources are available */
+#ifdef LTRSIFT_BATCH_FILTER
+
+#include "lauxlib.h"
+#include "lualib.h"
+#include "gtlua.h"
+#include "gtlua/genome_node_lua.h"
+
+#define BATCH_FILTER_FUNC "filter_batch"
+#define BATCH_FILTER_NODE_FUNC "filter"
+
+struct BatchFilter {
+  lua_State *L;
+  bool has_batch;
+};
+
+BatchFilter* batch_filter_new(const gchar *filename, GtError *err)
+{
+  BatchFilter *bf;
+  lua_State *L;
+
+  gt_error_check(err);
+  gt_assert(filename);
+  if (!(L = luaL_newstate())) {
+    gt_error_set(err, "out of memory (cannot create new Lua state)");
+    return NULL;
+  }
+  luaL_openlibs(L);
+  luaopen_gt(L);
+  lua_pop(L, 1);
+  if (luaL_loadfile(L, filename) || lua_pcall(L, 0, 0, 0)) {
+    gt_error_set(err, "cannot run filter file: %s", lua_tostring(L, -1));
+    lua_close(L);
+    return NULL;
+  }
+  bf = g_slice_new(BatchFilter);
+  bf->L = L;
+  lua_getglobal(L, BATCH_FILTER_FUNC);
+  bf->has_batch = lua_isfunction(L, -1);
+  lua_pop(L, 1);
+  return bf;
+}
+
+bool batch_filter_has_batch(const BatchFilter *bf)
+{
+  gt_assert(bf);
+  return bf->has_batch;
+}
+
+int batch_filter_run_node(BatchFilter *bf, GtFeatureNode *fn, bool *result,
+                          GtError *err)
+{
+  int had_err = 0;
+
+  gt_error_check(err);
+  gt_assert(bf && fn && result);
+  lua_getglobal(bf->L, BATCH_FILTER_NODE_FUNC);
+  if (!lua_isfunction(bf->L, -1)) {
+    gt_error_set(err, "function '%s' is not defined", BATCH_FILTER_NODE_FUNC);
+    had_err = -1;
+  }
+  if (!had_err) {
+    /* Lua takes over the reference */
+    gt_lua_genome_node_push(bf->L, gt_genome_node_ref((GtGenomeNode*) fn));
+    if (lua_pcall(bf->L, 1, 1, 0)) {
+      gt_error_set(err, "error running %s(): %s", BATCH_FILTER_NODE_FUNC,
+                   lua_tostring(bf->L, -1));
+      had_err = -1;
+    }
+  }
+  if (!had_err && !lua_isboolean(bf->L, -1)) {
+    gt_error_set(err, "%s() must return a boolean", BATCH_FILTER_NODE_FUNC);
+    had_err = -1;
+  }
+  if (!had_err)
+    *result = lua_toboolean(bf->L, -1);
+  lua_settop(bf->L, 0);
+  return had_err;
+}
+
+int batch_filter_run(BatchFilter *bf, GtFeatureNode **nodes,
+                     unsigned long num_nodes, bool *results, GtError *err)
+{
+  unsigned long i;
+  int had_err = 0;
+
+  gt_error_check(err);
+  gt_assert(bf && bf->has_batch && nodes && results);
+  lua_getglobal(bf->L, BATCH_FILTER_FUNC);
+  lua_createtable(bf->L, (int) num_nodes, 0);
+  for (i = 0; i < num_nodes; i++) {
+    /* Lua takes over the reference */
+    gt_lua_genome_node_push(bf->L,
+                            gt_genome_node_ref((GtGenomeNode*) nodes[i]));
+    lua_rawseti(bf->L, -2, (int) i + 1);
+  }
+  if (lua_pcall(bf->L, 1, 1, 0)) {
+    gt_error_set(err, "error running %s(): %s", BATCH_FILTER_FUNC,
+                 lua_tostring(bf->L, -1));
+    had_err = -1;
+  }
+  if (!had_err && !lua_istable(bf->L, -1)) {
+    gt_error_set(err, "%s() must return a table of booleans",
+                 BATCH_FILTER_FUNC);
+    had_err = -1;
+  }
+  for (i = 0; !had_err && i < num_nodes; i++) {
+    lua_rawgeti(bf->L, -1, (int) i + 1);
+    if (!lua_isboolean(bf->L, -1)) {
+      gt_error_set(err, "%s() returned no boolean for candidate %lu of %lu",
+                   BATCH_FILTER_FUNC, i + 1, num_nodes);
+      had_err = -1;
+    } else
+      results[i] = lua_toboolean(bf->L, -1);
+    lua_pop(bf->L, 1);
+  }
+  lua_settop(bf->L, 0);
+  return had_err;
+}
+
+void batch_filter_collect(BatchFilter *bf)
+{
+  gt_assert(bf);
+  lua_gc(bf->L, LUA_GCCOLLECT, 0);
+}
+
+void batch_filter_delete(BatchFilter *bf)
+{
+  if (!bf)
+    return;
+  lua_close(bf->L);
+  g_slice_free(BatchFilter, bf);
+}
+
+#else
+
+BatchFilter* batch_filter_new(GT_UNUSED const gchar *filename,
+                              GT_UNUSED GtError *err)
+{
+  return NULL;
+}
+
+bool batch_filter_has_batch(GT_UNUSED const BatchFilter *bf)
+{
+  gt_assert(false);
+  return false;
+}
+
+int batch_filter_run_node(GT_UNUSED BatchFilter *bf,
+                          GT_UNUSED GtFeatureNode *fn,
+                          GT_UNUSED bool *result, GT_UNUSED GtError *err)
+{
+  gt_assert(false);
+  return -1;
+}
+
+int batch_filter_run(GT_UNUSED BatchFilter *bf,
+                     GT_UNUSED GtFeatureNode **nodes,
+                     GT_UNUSED unsigned long num_nodes,
+                     GT_UNUSED bool *results, GT_UNUSED GtError *err)
+{
+  gt_assert(false);
+  return -1;
+}
+
+void batch_filter_collect(GT_UNUSED BatchFilter *bf)
+{
+  gt_assert(false);
+}
+
+void batch_filter_delete(GT_UNUSED BatchFilter *bf)
+{
+}
+
+#endif
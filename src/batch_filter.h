@@ -0,0 +1,57 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BATCH_FILTER_H
+#define BATCH_FILTER_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* Besides the function ``filter(gn)'' called for every candidate, a filter
+   script may define ``filter_batch(nodes)'', which is given a table of many
+   candidates (nodes[1] to nodes[n]) and returns a table of n booleans, the
+   results of ``filter'' for each of them. Calling Lua once for many
+   candidates saves most of the time of cheap filters. */
+typedef struct BatchFilter BatchFilter;
+
+/* Loads the filter script <filename>, whose ``filter'' function can then be
+   called as well, so that the script need not be loaded a second time.
+   Returns NULL if LTRsift was built without batch support, or NULL and sets
+   <err> on errors. */
+BatchFilter* batch_filter_new(const gchar *filename, GtError *err);
+
+/* Returns true if the script of <bf> defines ``filter_batch''. */
+bool         batch_filter_has_batch(const BatchFilter *bf);
+
+/* Calls ``filter'' for the candidate <fn> and sets <result> to its result. */
+int          batch_filter_run_node(BatchFilter *bf, GtFeatureNode *fn,
+                                   bool *result, GtError *err);
+
+/* Calls ``filter_batch'', which must be defined, for the <num_nodes>
+   candidates in <nodes> and sets <results> (of <num_nodes> entries) to its
+   results. */
+int          batch_filter_run(BatchFilter *bf, GtFeatureNode **nodes,
+                              unsigned long num_nodes, bool *results,
+                              GtError *err);
+
+/* Frees the candidates passed to the script which it does not refer to
+   anymore, to be called once after the last block of a run. */
+void         batch_filter_collect(BatchFilter *bf);
+
+void         batch_filter_delete(BatchFilter *bf);
+
+#endif
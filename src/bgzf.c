@@ -0,0 +1,412 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "bgzf.h"
+
+/* same block layout as used by samtools/tabix, so that the files can also be
+   handled by bgzip */
+#define BGZF_BLOCK_SIZE        0xff00
+#define BGZF_MAX_BLOCK_SIZE    0x10000
+#define BGZF_HEADER_SIZE       18
+#define BGZF_FOOTER_SIZE       8
+#define BGZF_BLOCKS_PER_THREAD 8
+
+static const guchar bgzf_header[BGZF_HEADER_SIZE - 2] = {
+  0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0xff, 0x06, 0x00, 0x42, 0x43, 0x02, 0x00
+};
+
+static const guchar bgzf_eof_block[28] = {
+  0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0xff, 0x06, 0x00, 0x42, 0x43, 0x02, 0x00,
+  0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00
+};
+
+typedef struct {
+  guchar in[BGZF_MAX_BLOCK_SIZE],
+         out[BGZF_MAX_BLOCK_SIZE];
+  gsize inlen,
+        outlen;
+  gint had_err;
+} BGZFBlock;
+
+typedef struct {
+  GThreadPool *pool;
+  GMutex *mutex;
+  GCond *cond;
+  guint pending;
+  gboolean compress;
+} BGZFJobs;
+
+static void bgzf_put_le32(guchar *buf, guint32 val)
+{
+  buf[0] = (guchar) (val & 0xff);
+  buf[1] = (guchar) ((val >> 8) & 0xff);
+  buf[2] = (guchar) ((val >> 16) & 0xff);
+  buf[3] = (guchar) ((val >> 24) & 0xff);
+}
+
+static guint32 bgzf_get_le32(const guchar *buf)
+{
+  return (guint32) buf[0] | ((guint32) buf[1] << 8) |
+         ((guint32) buf[2] << 16) | ((guint32) buf[3] << 24);
+}
+
+static gint bgzf_deflate_block(BGZFBlock *block)
+{
+  z_stream zs;
+  gsize clen;
+  guint32 crc;
+  gint rval;
+
+  memset(&zs, 0, sizeof (zs));
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    return -1;
+  zs.next_in = block->in;
+  zs.avail_in = (uInt) block->inlen;
+  zs.next_out = block->out + BGZF_HEADER_SIZE;
+  zs.avail_out = BGZF_MAX_BLOCK_SIZE - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE;
+  rval = deflate(&zs, Z_FINISH);
+  clen = zs.total_out;
+  deflateEnd(&zs);
+  /* a block of BGZF_BLOCK_SIZE bytes always fits, even if incompressible */
+  if (rval != Z_STREAM_END)
+    return -1;
+
+  block->outlen = BGZF_HEADER_SIZE + clen + BGZF_FOOTER_SIZE;
+  memcpy(block->out, bgzf_header, sizeof (bgzf_header));
+  block->out[16] = (guchar) ((block->outlen - 1) & 0xff);
+  block->out[17] = (guchar) (((block->outlen - 1) >> 8) & 0xff);
+  crc = (guint32) crc32(crc32(0L, Z_NULL, 0), block->in, (uInt) block->inlen);
+  bgzf_put_le32(block->out + BGZF_HEADER_SIZE + clen, crc);
+  bgzf_put_le32(block->out + BGZF_HEADER_SIZE + clen + 4,
+                (guint32) block->inlen);
+  return 0;
+}
+
+static gint bgzf_inflate_block(BGZFBlock *block)
+{
+  z_stream zs;
+  const guchar *footer;
+  guint32 crc;
+  gint rval;
+
+  memset(&zs, 0, sizeof (zs));
+  if (inflateInit2(&zs, -15) != Z_OK)
+    return -1;
+  zs.next_in = block->in + BGZF_HEADER_SIZE;
+  zs.avail_in = (uInt) (block->inlen - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE);
+  zs.next_out = block->out;
+  zs.avail_out = BGZF_MAX_BLOCK_SIZE;
+  rval = inflate(&zs, Z_FINISH);
+  block->outlen = zs.total_out;
+  inflateEnd(&zs);
+  if (rval != Z_STREAM_END)
+    return -1;
+
+  footer = block->in + block->inlen - BGZF_FOOTER_SIZE;
+  crc = (guint32) crc32(crc32(0L, Z_NULL, 0), block->out,
+                        (uInt) block->outlen);
+  if (crc != bgzf_get_le32(footer) ||
+      (guint32) block->outlen != bgzf_get_le32(footer + 4))
+    return -1;
+  return 0;
+}
+
+static void bgzf_worker(gpointer data, gpointer user_data)
+{
+  BGZFBlock *block = (BGZFBlock*) data;
+  BGZFJobs *jobs = (BGZFJobs*) user_data;
+
+  if (jobs->compress)
+    block->had_err = bgzf_deflate_block(block);
+  else
+    block->had_err = bgzf_inflate_block(block);
+
+  g_mutex_lock(jobs->mutex);
+  jobs->pending--;
+  if (jobs->pending == 0)
+    g_cond_signal(jobs->cond);
+  g_mutex_unlock(jobs->mutex);
+}
+
+static gint bgzf_jobs_init(BGZFJobs *jobs, gboolean compress,
+                           guint num_threads, GtError *err)
+{
+  GError *gerr = NULL;
+
+  jobs->compress = compress;
+  jobs->pending = 0;
+  jobs->mutex = g_mutex_new();
+  jobs->cond = g_cond_new();
+  jobs->pool = g_thread_pool_new(bgzf_worker, jobs, (gint) num_threads, TRUE,
+                                 &gerr);
+  if (!jobs->pool) {
+    gt_error_set(err, "Could not create compression threads: %s",
+                 gerr->message);
+    g_error_free(gerr);
+    g_mutex_free(jobs->mutex);
+    g_cond_free(jobs->cond);
+    return -1;
+  }
+  return 0;
+}
+
+static void bgzf_jobs_clear(BGZFJobs *jobs)
+{
+  g_thread_pool_free(jobs->pool, FALSE, TRUE);
+  g_mutex_free(jobs->mutex);
+  g_cond_free(jobs->cond);
+}
+
+/* hands the first <n> blocks to the thread pool and waits until all of them
+   are done, the blocks are written by the caller in their original order */
+static gint bgzf_jobs_run(BGZFJobs *jobs, BGZFBlock *blocks, guint n)
+{
+  guint i;
+
+  g_mutex_lock(jobs->mutex);
+  jobs->pending = n;
+  g_mutex_unlock(jobs->mutex);
+  for (i = 0; i < n; i++)
+    g_thread_pool_push(jobs->pool, &blocks[i], NULL);
+  g_mutex_lock(jobs->mutex);
+  while (jobs->pending > 0)
+    g_cond_wait(jobs->cond, jobs->mutex);
+  g_mutex_unlock(jobs->mutex);
+
+  for (i = 0; i < n; i++) {
+    if (blocks[i].had_err)
+      return -1;
+  }
+  return 0;
+}
+
+static gboolean bgzf_is_block_header(const guchar *buf)
+{
+  return (buf[0] == 0x1f && buf[1] == 0x8b && buf[2] == 0x08 &&
+          (buf[3] & 0x04) && buf[10] == 0x06 && buf[11] == 0x00 &&
+          buf[12] == 'B' && buf[13] == 'C' && buf[14] == 0x02 &&
+          buf[15] == 0x00);
+}
+
+/* returns 1 if a block was read, 0 at the end of <fp> and -1 on error */
+static gint bgzf_read_block(FILE *fp, BGZFBlock *block, GtError *err)
+{
+  gsize len;
+
+  len = fread(block->in, 1, BGZF_HEADER_SIZE, fp);
+  if (len == 0 && feof(fp))
+    return 0;
+  if (len != BGZF_HEADER_SIZE || !bgzf_is_block_header(block->in)) {
+    gt_error_set(err, "Corrupt or truncated BGZF block");
+    return -1;
+  }
+  block->inlen = (gsize) (block->in[16] | (block->in[17] << 8)) + 1;
+  if (block->inlen < BGZF_HEADER_SIZE + BGZF_FOOTER_SIZE) {
+    gt_error_set(err, "Corrupt BGZF block");
+    return -1;
+  }
+  len = fread(block->in + BGZF_HEADER_SIZE, 1,
+              block->inlen - BGZF_HEADER_SIZE, fp);
+  if (len != block->inlen - BGZF_HEADER_SIZE) {
+    gt_error_set(err, "Truncated BGZF block");
+    return -1;
+  }
+  return 1;
+}
+
+static gint bgzf_write(FILE *fp, const guchar *buf, gsize len,
+                       const gchar *filename, GtError *err)
+{
+  if (fwrite(buf, 1, len, fp) != len) {
+    gt_error_set(err, "Could not write to %s: %s", filename, strerror(errno));
+    return -1;
+  }
+  return 0;
+}
+
+gint bgzf_compress_file(const gchar *infile, const gchar *outfile,
+                        guint num_threads, GtError *err)
+{
+  BGZFJobs jobs;
+  BGZFBlock *blocks = NULL;
+  FILE *in = NULL,
+       *out = NULL;
+  guint i, n,
+        batch;
+  gint had_err = 0;
+
+  if (num_threads == 0)
+    num_threads = 1;
+  if (!(in = fopen(infile, "rb"))) {
+    gt_error_set(err, "Could not open %s: %s", infile, strerror(errno));
+    return -1;
+  }
+  if (!(out = fopen(outfile, "wb"))) {
+    gt_error_set(err, "Could not open %s: %s", outfile, strerror(errno));
+    fclose(in);
+    return -1;
+  }
+  had_err = bgzf_jobs_init(&jobs, TRUE, num_threads, err);
+
+  if (!had_err) {
+    batch = num_threads * BGZF_BLOCKS_PER_THREAD;
+    blocks = g_malloc(batch * sizeof (BGZFBlock));
+    do {
+      for (n = 0; n < batch; n++) {
+        blocks[n].inlen = fread(blocks[n].in, 1, BGZF_BLOCK_SIZE, in);
+        if (blocks[n].inlen == 0)
+          break;
+      }
+      if (ferror(in)) {
+        gt_error_set(err, "Could not read %s: %s", infile, strerror(errno));
+        had_err = -1;
+      }
+      if (!had_err && n > 0) {
+        had_err = bgzf_jobs_run(&jobs, blocks, n);
+        if (had_err)
+          gt_error_set(err, "Could not compress %s", infile);
+      }
+      for (i = 0; !had_err && i < n; i++)
+        had_err = bgzf_write(out, blocks[i].out, blocks[i].outlen, outfile,
+                             err);
+    } while (!had_err && n == batch);
+    bgzf_jobs_clear(&jobs);
+  }
+
+  if (!had_err)
+    had_err = bgzf_write(out, bgzf_eof_block, sizeof (bgzf_eof_block),
+                         outfile, err);
+  if (fclose(out) != 0 && !had_err) {
+    gt_error_set(err, "Could not write to %s: %s", outfile, strerror(errno));
+    had_err = -1;
+  }
+  fclose(in);
+  g_free(blocks);
+
+  return had_err;
+}
+
+/* fallback for gzip files which were not written in blocks, e.g. by
+   recompressing a project file with gzip */
+static gint bgzf_decompress_plain_gzip(const gchar *infile, FILE *out,
+                                       const gchar *outfile, GtError *err)
+{
+  gzFile gz;
+  guchar buf[BUFSIZ];
+  gint len = 0,
+       had_err = 0;
+
+  if (!(gz = gzopen(infile, "rb"))) {
+    gt_error_set(err, "Could not open %s", infile);
+    return -1;
+  }
+  while (!had_err && (len = gzread(gz, buf, sizeof (buf))) > 0)
+    had_err = bgzf_write(out, buf, (gsize) len, outfile, err);
+  if (!had_err && len < 0) {
+    gt_error_set(err, "Could not decompress %s", infile);
+    had_err = -1;
+  }
+  gzclose(gz);
+
+  return had_err;
+}
+
+gint bgzf_decompress_file(const gchar *infile, const gchar *outfile,
+                          guint num_threads, GtError *err)
+{
+  BGZFJobs jobs;
+  BGZFBlock *blocks = NULL;
+  FILE *in = NULL,
+       *out = NULL;
+  guchar magic[BGZF_HEADER_SIZE];
+  guint i, n,
+        batch;
+  gint rval = 1,
+       had_err = 0;
+
+  if (num_threads == 0)
+    num_threads = 1;
+  if (!(in = fopen(infile, "rb"))) {
+    gt_error_set(err, "Could not open %s: %s", infile, strerror(errno));
+    return -1;
+  }
+  if (!(out = fopen(outfile, "wb"))) {
+    gt_error_set(err, "Could not open %s: %s", outfile, strerror(errno));
+    fclose(in);
+    return -1;
+  }
+
+  if (fread(magic, 1, BGZF_HEADER_SIZE, in) != BGZF_HEADER_SIZE ||
+      !bgzf_is_block_header(magic)) {
+    fclose(in);
+    had_err = bgzf_decompress_plain_gzip(infile, out, outfile, err);
+    if (fclose(out) != 0 && !had_err) {
+      gt_error_set(err, "Could not write to %s: %s", outfile, strerror(errno));
+      had_err = -1;
+    }
+    return had_err;
+  }
+  rewind(in);
+  had_err = bgzf_jobs_init(&jobs, FALSE, num_threads, err);
+
+  if (!had_err) {
+    batch = num_threads * BGZF_BLOCKS_PER_THREAD;
+    blocks = g_malloc(batch * sizeof (BGZFBlock));
+    do {
+      for (n = 0; n < batch; n++) {
+        if ((rval = bgzf_read_block(in, &blocks[n], err)) <= 0)
+          break;
+      }
+      if (rval < 0)
+        had_err = -1;
+      if (!had_err && n > 0) {
+        had_err = bgzf_jobs_run(&jobs, blocks, n);
+        if (had_err)
+          gt_error_set(err, "Could not decompress %s", infile);
+      }
+      for (i = 0; !had_err && i < n; i++)
+        had_err = bgzf_write(out, blocks[i].out, blocks[i].outlen, outfile,
+                             err);
+    } while (!had_err && rval > 0);
+    bgzf_jobs_clear(&jobs);
+  }
+
+  if (fclose(out) != 0 && !had_err) {
+    gt_error_set(err, "Could not write to %s: %s", outfile, strerror(errno));
+    had_err = -1;
+  }
+  fclose(in);
+  g_free(blocks);
+
+  return had_err;
+}
+
+guint bgzf_default_threads(void)
+{
+  long num = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return (num > 0 ? (guint) num : 1);
+}
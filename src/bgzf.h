@@ -0,0 +1,41 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BGZF_H
+#define BGZF_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* Compresses <infile> into <outfile> in the BGZF format, i.e. as a series of
+   independent gzip members holding at most 64 KB of data each, followed by
+   the empty BGZF end-of-file block. The blocks are compressed by
+   <num_threads> threads, the result can be read by any gzip reader. */
+gint  bgzf_compress_file(const gchar *infile, const gchar *outfile,
+                         guint num_threads, GtError *err);
+
+/* Decompresses <infile> into <outfile>. The blocks of a BGZF file are
+   decompressed by <num_threads> threads, other gzip files are decompressed
+   sequentially. */
+gint  bgzf_decompress_file(const gchar *infile, const gchar *outfile,
+                           guint num_threads, GtError *err);
+
+/* Returns the number of processors, which is used as the number of threads
+   if no other value is given. */
+guint bgzf_default_threads(void);
+
+#endif
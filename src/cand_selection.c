@@ -0,0 +1,197 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "cand_selection.h"
+#include "genometools.h"
+
+#define CAND_SELECTION_BITS       64
+#define CAND_SELECTION_WORD(row)  ((row) / CAND_SELECTION_BITS)
+#define CAND_SELECTION_BIT(row)\
+        ((guint64) 1 << ((row) % CAND_SELECTION_BITS))
+
+struct CandSelection {
+  guint64 *words;
+  unsigned long size,
+                num_words;
+};
+
+static guint cand_selection_popcount(guint64 word)
+{
+#ifdef __GNUC__
+  return (guint) __builtin_popcountll(word);
+#else
+  word = word - ((word >> 1) & G_GUINT64_CONSTANT(0x5555555555555555));
+  word = (word & G_GUINT64_CONSTANT(0x3333333333333333)) +
+         ((word >> 2) & G_GUINT64_CONSTANT(0x3333333333333333));
+  word = (word + (word >> 4)) & G_GUINT64_CONSTANT(0x0f0f0f0f0f0f0f0f);
+  return (guint) ((word * G_GUINT64_CONSTANT(0x0101010101010101)) >> 56);
+#endif
+}
+
+/* <word> must not be 0 */
+static guint cand_selection_lowest_bit(guint64 word)
+{
+#ifdef __GNUC__
+  return (guint) __builtin_ctzll(word);
+#else
+  guint bit = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+/* the bits after the last row are kept 0 */
+static void cand_selection_clear_tail(CandSelection *cs)
+{
+  if (cs->size % CAND_SELECTION_BITS)
+    cs->words[cs->num_words - 1] &= CAND_SELECTION_BIT(cs->size) - 1;
+}
+
+CandSelection* cand_selection_new(unsigned long size)
+{
+  CandSelection *cs = g_slice_new(CandSelection);
+  cs->size = size;
+  cs->num_words = (size + CAND_SELECTION_BITS - 1) / CAND_SELECTION_BITS;
+  cs->words = g_new0(guint64, cs->num_words);
+  return cs;
+}
+
+unsigned long cand_selection_size(const CandSelection *cs)
+{
+  gt_assert(cs);
+  return cs->size;
+}
+
+void cand_selection_add(CandSelection *cs, unsigned long row)
+{
+  gt_assert(cs && row < cs->size);
+  cs->words[CAND_SELECTION_WORD(row)] |= CAND_SELECTION_BIT(row);
+}
+
+void cand_selection_remove(CandSelection *cs, unsigned long row)
+{
+  gt_assert(cs && row < cs->size);
+  cs->words[CAND_SELECTION_WORD(row)] &= ~CAND_SELECTION_BIT(row);
+}
+
+gboolean cand_selection_contains(const CandSelection *cs, unsigned long row)
+{
+  gt_assert(cs);
+  if (row >= cs->size)
+    return FALSE;
+  return (cs->words[CAND_SELECTION_WORD(row)] & CAND_SELECTION_BIT(row)) != 0;
+}
+
+void cand_selection_add_range(CandSelection *cs, unsigned long first,
+                              unsigned long last)
+{
+  unsigned long i, first_word, last_word;
+  guint64 first_mask, last_mask;
+
+  gt_assert(cs && first <= last && last < cs->size);
+  first_word = CAND_SELECTION_WORD(first);
+  last_word = CAND_SELECTION_WORD(last);
+  first_mask = ~(CAND_SELECTION_BIT(first) - 1);
+  last_mask = CAND_SELECTION_BIT(last) | (CAND_SELECTION_BIT(last) - 1);
+  if (first_word == last_word) {
+    cs->words[first_word] |= first_mask & last_mask;
+    return;
+  }
+  cs->words[first_word] |= first_mask;
+  for (i = first_word + 1; i < last_word; i++)
+    cs->words[i] = ~(guint64) 0;
+  cs->words[last_word] |= last_mask;
+}
+
+void cand_selection_invert(CandSelection *cs)
+{
+  unsigned long i;
+  gt_assert(cs);
+  for (i = 0; i < cs->num_words; i++)
+    cs->words[i] = ~cs->words[i];
+  cand_selection_clear_tail(cs);
+}
+
+void cand_selection_clear(CandSelection *cs)
+{
+  gt_assert(cs);
+  memset(cs->words, 0, cs->num_words * sizeof (guint64));
+}
+
+unsigned long cand_selection_count(const CandSelection *cs)
+{
+  unsigned long i, count = 0;
+  gt_assert(cs);
+  for (i = 0; i < cs->num_words; i++)
+    count += cand_selection_popcount(cs->words[i]);
+  return count;
+}
+
+unsigned long cand_selection_next(const CandSelection *cs, unsigned long row)
+{
+  unsigned long i;
+  guint64 word;
+
+  gt_assert(cs);
+  if (row >= cs->size)
+    return cs->size;
+  i = CAND_SELECTION_WORD(row);
+  word = cs->words[i] & ~(CAND_SELECTION_BIT(row) - 1);
+  while (!word) {
+    if (++i == cs->num_words)
+      return cs->size;
+    word = cs->words[i];
+  }
+  return i * CAND_SELECTION_BITS + cand_selection_lowest_bit(word);
+}
+
+unsigned long cand_selection_run_end(const CandSelection *cs,
+                                     unsigned long row)
+{
+  unsigned long i;
+  guint64 word;
+
+  gt_assert(cs && cand_selection_contains(cs, row));
+  /* the first unselected row is the lowest bit of the inverted words */
+  i = CAND_SELECTION_WORD(row);
+  word = ~cs->words[i] & ~(CAND_SELECTION_BIT(row) - 1);
+  while (!word) {
+    if (++i == cs->num_words)
+      return cs->size - 1;
+    word = ~cs->words[i];
+  }
+  return MIN(i * CAND_SELECTION_BITS + cand_selection_lowest_bit(word),
+             cs->size) - 1;
+}
+
+gsize cand_selection_memory(const CandSelection *cs)
+{
+  gt_assert(cs);
+  return sizeof (CandSelection) + cs->num_words * sizeof (guint64);
+}
+
+void cand_selection_delete(CandSelection *cs)
+{
+  if (!cs)
+    return;
+  g_free(cs->words);
+  g_slice_free(CandSelection, cs);
+}
@@ -0,0 +1,66 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CAND_SELECTION_H
+#define CAND_SELECTION_H
+
+#include <glib.h>
+
+/* <CandSelection> is a set of the candidates of a list (given by their row
+   numbers from 0 to <size> - 1) kept as a bitset, so that huge selections
+   take one bit per row and can be changed, counted and walked through a
+   machine word at a time. */
+typedef struct CandSelection CandSelection;
+
+CandSelection* cand_selection_new(unsigned long size);
+
+unsigned long  cand_selection_size(const CandSelection *cs);
+
+void           cand_selection_add(CandSelection *cs, unsigned long row);
+
+void           cand_selection_remove(CandSelection *cs, unsigned long row);
+
+gboolean       cand_selection_contains(const CandSelection *cs,
+                                       unsigned long row);
+
+/* Adds the rows from <first> to <last> (both included). */
+void           cand_selection_add_range(CandSelection *cs, unsigned long first,
+                                        unsigned long last);
+
+/* Selects the rows which are not selected and vice versa. */
+void           cand_selection_invert(CandSelection *cs);
+
+void           cand_selection_clear(CandSelection *cs);
+
+/* Returns the number of selected rows. */
+unsigned long  cand_selection_count(const CandSelection *cs);
+
+/* Returns the first selected row not before <row>, or the size of <cs> if
+   there is none. */
+unsigned long  cand_selection_next(const CandSelection *cs, unsigned long row);
+
+/* Returns the last row of the run of selected rows starting at the selected
+   <row>. */
+unsigned long  cand_selection_run_end(const CandSelection *cs,
+                                      unsigned long row);
+
+/* Returns the number of bytes used by <cs>. */
+gsize          cand_selection_memory(const CandSelection *cs);
+
+void           cand_selection_delete(CandSelection *cs);
+
+#endif
@@ -0,0 +1,756 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <string.h>
+#include "chrom_overview.h"
+#include "symbols.h"
+
+#define CHROM_OVERVIEW_MAX_LANES     16
+#define CHROM_OVERVIEW_LANE_HEIGHT   14.0
+#define CHROM_OVERVIEW_DEPTH_HEIGHT  10
+
+/* a bin knows how many positions are covered by candidates (nested
+   candidates count again) and the family covering most of them, which is
+   found by a weighted majority vote, so that bins can be merged into the
+   bins of the next level without looking at the candidates again */
+typedef struct {
+  unsigned long coverage,
+                votes;
+  const gchar *family;
+  guint depth;
+} ChromOverviewBin;
+
+typedef struct {
+  const gchar *seqid;
+  unsigned long length,
+                max_cand_length;
+  GtArray *cands;
+  guint num_lanes,
+        num_levels;
+  ChromOverviewBin *bins[CHROM_OVERVIEW_MAX_LEVEL - CHROM_OVERVIEW_BIN_LEVEL
+                         + 1];
+  unsigned long num_bins[CHROM_OVERVIEW_MAX_LEVEL - CHROM_OVERVIEW_BIN_LEVEL
+                         + 1],
+                max_coverage[CHROM_OVERVIEW_MAX_LEVEL - CHROM_OVERVIEW_BIN_LEVEL
+                             + 1];
+} ChromOverviewSeq;
+
+struct ChromOverview {
+  GtHashmap *seqs;
+  GtArray *seqids;
+  gsize memory;
+  gboolean finished;
+  volatile gint reference_count;
+};
+
+typedef struct {
+  cairo_surface_t *surface;
+  unsigned long stamp;
+} ChromTile;
+
+typedef struct ChromTileJob ChromTileJob;
+
+struct ChromTiles {
+  GThreadPool *pool;
+  ChromOverview *co;
+  GtHashmap *tiles,
+            *pending;
+  ChromTilesReadyFunc ready;
+  gpointer data;
+  unsigned long stamp,
+                num_tiles;
+  guint max_tiles,
+        reference_count;
+  gsize memory;
+  volatile gint view,
+                closed;
+};
+
+struct ChromTileJob {
+  ChromTiles *ct;
+  ChromOverview *co;
+  gchar *key;
+  const gchar *seqid;
+  guint level;
+  gint view,
+       height;
+  unsigned long tileno;
+  cairo_surface_t *surface;
+};
+
+static void chrom_overview_free_seq(void *elem)
+{
+  ChromOverviewSeq *seq = (ChromOverviewSeq*) elem;
+  guint i;
+
+  gt_array_delete(seq->cands);
+  for (i = 0; i < seq->num_levels; i++)
+    g_free(seq->bins[i]);
+  g_slice_free(ChromOverviewSeq, seq);
+}
+
+ChromOverview* chrom_overview_new(void)
+{
+  ChromOverview *co = g_slice_new(ChromOverview);
+
+  /* seqids are interned, so they are compared as pointers */
+  co->seqs = gt_hashmap_new(GT_HASH_DIRECT, NULL, chrom_overview_free_seq);
+  co->seqids = gt_array_new(sizeof (const gchar*));
+  co->memory = sizeof (ChromOverview);
+  co->finished = FALSE;
+  co->reference_count = 1;
+  return co;
+}
+
+static ChromOverviewSeq* chrom_overview_get_seq(ChromOverview *co,
+                                                const gchar *seqid,
+                                                gboolean create)
+{
+  ChromOverviewSeq *seq;
+
+  seqid = symbols_intern(seqid);
+  if ((seq = (ChromOverviewSeq*) gt_hashmap_get(co->seqs, seqid)) || !create)
+    return seq;
+  seq = g_slice_new0(ChromOverviewSeq);
+  seq->seqid = seqid;
+  seq->cands = gt_array_new(sizeof (ChromOverviewCand));
+  gt_hashmap_add(co->seqs, (gpointer) seqid, seq);
+  gt_array_add(co->seqids, seqid);
+  return seq;
+}
+
+void chrom_overview_set_length(ChromOverview *co, const gchar *seqid,
+                               unsigned long length)
+{
+  gt_assert(co && seqid && !co->finished);
+  chrom_overview_get_seq(co, seqid, TRUE)->length = length;
+}
+
+void chrom_overview_add(ChromOverview *co, const gchar *seqid,
+                        unsigned long start, unsigned long end,
+                        const gchar *family, gboolean loaded)
+{
+  ChromOverviewSeq *seq;
+  ChromOverviewCand cand;
+
+  gt_assert(co && seqid && start <= end && !co->finished);
+  seq = chrom_overview_get_seq(co, seqid, TRUE);
+  cand.start = start;
+  cand.end = end;
+  cand.family = symbols_intern(family ? family : "");
+  cand.loaded = loaded;
+  cand.lane = 0;
+  gt_array_add(seq->cands, cand);
+  if (end - start + 1 > seq->max_cand_length)
+    seq->max_cand_length = end - start + 1;
+}
+
+/* candidates containing others come first, so these are put into the lanes
+   below them */
+static int chrom_overview_cand_cmp(const void *a, const void *b)
+{
+  const ChromOverviewCand *c1 = (const ChromOverviewCand*) a,
+                          *c2 = (const ChromOverviewCand*) b;
+
+  if (c1->start != c2->start)
+    return c1->start < c2->start ? -1 : 1;
+  if (c1->end != c2->end)
+    return c1->end > c2->end ? -1 : 1;
+  return 0;
+}
+
+static int chrom_overview_seqid_cmp(const void *a, const void *b)
+{
+  return strcmp(*(const gchar* const*) a, *(const gchar* const*) b);
+}
+
+static void chrom_overview_vote(ChromOverviewBin *bin, const gchar *family,
+                                unsigned long votes)
+{
+  if (bin->family == family)
+    bin->votes += votes;
+  else if (votes > bin->votes) {
+    bin->family = family;
+    bin->votes = votes - bin->votes;
+  } else
+    bin->votes -= votes;
+}
+
+static void chrom_overview_assign_lanes(ChromOverviewSeq *seq)
+{
+  ChromOverviewCand *cand;
+  unsigned long i,
+                lane_ends[CHROM_OVERVIEW_MAX_LANES] = {0};
+  guint lane;
+
+  /* every candidate goes into the first lane which is free at its start,
+     candidates nested deeper than the last lane share it */
+  seq->num_lanes = 1;
+  for (i = 0; i < gt_array_size(seq->cands); i++) {
+    cand = (ChromOverviewCand*) gt_array_get(seq->cands, i);
+    for (lane = 0; lane < seq->num_lanes; lane++) {
+      if (lane_ends[lane] < cand->start)
+        break;
+    }
+    if (lane == seq->num_lanes) {
+      if (seq->num_lanes < CHROM_OVERVIEW_MAX_LANES)
+        seq->num_lanes++;
+      else
+        lane = seq->num_lanes - 1;
+    }
+    lane_ends[lane] = MAX(lane_ends[lane], cand->end);
+    cand->lane = lane;
+  }
+}
+
+static void chrom_overview_compute_bins(ChromOverviewSeq *seq)
+{
+  ChromOverviewCand *cand;
+  ChromOverviewBin *bins,
+                   *bin,
+                   *child;
+  unsigned long i, j, first, last, overlap, binsize;
+  guint level;
+
+  binsize = 1UL << CHROM_OVERVIEW_BIN_LEVEL;
+  seq->num_bins[0] = (seq->length + binsize - 1) / binsize;
+  bins = seq->bins[0] = g_malloc0(MAX(seq->num_bins[0], 1) *
+                                  sizeof (ChromOverviewBin));
+  for (i = 0; i < gt_array_size(seq->cands); i++) {
+    cand = (ChromOverviewCand*) gt_array_get(seq->cands, i);
+    first = (cand->start - 1) / binsize;
+    last = (cand->end - 1) / binsize;
+    for (j = first; j <= last && j < seq->num_bins[0]; j++) {
+      overlap = MIN(cand->end, (j + 1) * binsize) -
+                MAX(cand->start - 1, j * binsize);
+      bins[j].coverage += overlap;
+      bins[j].depth = MAX(bins[j].depth, cand->lane + 1);
+      chrom_overview_vote(&bins[j], cand->family, overlap);
+    }
+  }
+
+  /* each bin of the next level is made of two bins of the level below */
+  seq->num_levels = 1;
+  for (level = 1;
+       level <= CHROM_OVERVIEW_MAX_LEVEL - CHROM_OVERVIEW_BIN_LEVEL &&
+       seq->num_bins[level - 1] > 1;
+       level++) {
+    seq->num_bins[level] = (seq->num_bins[level - 1] + 1) / 2;
+    seq->bins[level] = g_malloc0(seq->num_bins[level] *
+                                 sizeof (ChromOverviewBin));
+    for (i = 0; i < seq->num_bins[level - 1]; i++) {
+      bin = &seq->bins[level][i / 2];
+      child = &seq->bins[level - 1][i];
+      bin->coverage += child->coverage;
+      bin->depth = MAX(bin->depth, child->depth);
+      if (child->votes > 0)
+        chrom_overview_vote(bin, child->family, child->votes);
+    }
+    seq->num_levels++;
+  }
+
+  for (level = 0; level < seq->num_levels; level++) {
+    seq->max_coverage[level] = 0;
+    for (i = 0; i < seq->num_bins[level]; i++) {
+      seq->max_coverage[level] = MAX(seq->max_coverage[level],
+                                     seq->bins[level][i].coverage);
+    }
+  }
+}
+
+void chrom_overview_finish(ChromOverview *co)
+{
+  ChromOverviewSeq *seq;
+  ChromOverviewCand *last;
+  unsigned long i;
+  guint level;
+
+  gt_assert(co && !co->finished);
+  gt_array_sort_stable(co->seqids, chrom_overview_seqid_cmp);
+  for (i = 0; i < gt_array_size(co->seqids); i++) {
+    seq = chrom_overview_get_seq(co, *(const gchar**) gt_array_get(co->seqids,
+                                                                   i),
+                                 FALSE);
+    gt_array_sort_stable(seq->cands, chrom_overview_cand_cmp);
+    if (gt_array_size(seq->cands) > 0) {
+      last = (ChromOverviewCand*) gt_array_get_last(seq->cands);
+      seq->length = MAX(seq->length, last->end);
+    }
+    seq->length = MAX(seq->length, 1);
+    chrom_overview_assign_lanes(seq);
+    chrom_overview_compute_bins(seq);
+    co->memory += sizeof (ChromOverviewSeq) +
+                  gt_array_size(seq->cands) * sizeof (ChromOverviewCand);
+    for (level = 0; level < seq->num_levels; level++)
+      co->memory += seq->num_bins[level] * sizeof (ChromOverviewBin);
+  }
+  co->finished = TRUE;
+}
+
+ChromOverview* chrom_overview_ref(ChromOverview *co)
+{
+  gt_assert(co);
+  g_atomic_int_inc(&co->reference_count);
+  return co;
+}
+
+unsigned long chrom_overview_num_seqids(ChromOverview *co)
+{
+  gt_assert(co);
+  return gt_array_size(co->seqids);
+}
+
+const gchar* chrom_overview_get_seqid(ChromOverview *co, unsigned long i)
+{
+  gt_assert(co && i < gt_array_size(co->seqids));
+  return *(const gchar**) gt_array_get(co->seqids, i);
+}
+
+unsigned long chrom_overview_get_length(ChromOverview *co,
+                                        const gchar *seqid)
+{
+  ChromOverviewSeq *seq;
+
+  gt_assert(co && co->finished);
+  seq = chrom_overview_get_seq(co, seqid, FALSE);
+  return seq ? seq->length : 0;
+}
+
+unsigned long chrom_overview_num_candidates(ChromOverview *co,
+                                            const gchar *seqid)
+{
+  ChromOverviewSeq *seq;
+
+  gt_assert(co);
+  seq = chrom_overview_get_seq(co, seqid, FALSE);
+  return seq ? gt_array_size(seq->cands) : 0;
+}
+
+static gdouble chrom_overview_seq_lane_height(ChromOverviewSeq *seq,
+                                              gint height)
+{
+  return MIN(CHROM_OVERVIEW_LANE_HEIGHT,
+             (gdouble) height / (seq ? seq->num_lanes : 1));
+}
+
+gdouble chrom_overview_lane_height(ChromOverview *co, const gchar *seqid,
+                                   gint height)
+{
+  gt_assert(co && co->finished);
+  return chrom_overview_seq_lane_height(chrom_overview_get_seq(co, seqid,
+                                                               FALSE),
+                                        height);
+}
+
+/* returns the number of the first candidate which may overlap positions
+   from <start> on */
+static unsigned long chrom_overview_first_cand(ChromOverviewSeq *seq,
+                                               unsigned long start)
+{
+  ChromOverviewCand *cand;
+  unsigned long left = 0,
+                right = gt_array_size(seq->cands),
+                mid;
+
+  /* no candidate is longer than <max_cand_length> */
+  start = start > seq->max_cand_length ? start - seq->max_cand_length : 0;
+  while (left < right) {
+    mid = left + (right - left) / 2;
+    cand = (ChromOverviewCand*) gt_array_get(seq->cands, mid);
+    if (cand->start < start)
+      left = mid + 1;
+    else
+      right = mid;
+  }
+  return left;
+}
+
+const ChromOverviewCand* chrom_overview_find(ChromOverview *co,
+                                             const gchar *seqid,
+                                             unsigned long start,
+                                             unsigned long end, guint lane)
+{
+  ChromOverviewSeq *seq;
+  ChromOverviewCand *cand;
+  unsigned long i;
+
+  gt_assert(co && co->finished);
+  if (!(seq = chrom_overview_get_seq(co, seqid, FALSE)))
+    return NULL;
+  for (i = chrom_overview_first_cand(seq, start);
+       i < gt_array_size(seq->cands); i++) {
+    cand = (ChromOverviewCand*) gt_array_get(seq->cands, i);
+    if (cand->start > end)
+      break;
+    if (cand->end >= start && cand->lane == lane)
+      return cand;
+  }
+  return NULL;
+}
+
+/* unclassified candidates are grey, the colours of the families are taken
+   from the hues of a circle */
+static void chrom_overview_set_family_color(cairo_t *cr, const gchar *family)
+{
+  gdouble h, f, r, g, b,
+          s = 0.6,
+          v = 0.85;
+
+  if (*family == '\0') {
+    cairo_set_source_rgb(cr, 0.6, 0.6, 0.6);
+    return;
+  }
+  h = (g_str_hash(family) % 360) / 60.0;
+  f = h - floor(h);
+  switch ((gint) h) {
+    case 0:  r = v; g = v * (1 - s * (1 - f)); b = v * (1 - s); break;
+    case 1:  r = v * (1 - s * f); g = v; b = v * (1 - s); break;
+    case 2:  r = v * (1 - s); g = v; b = v * (1 - s * (1 - f)); break;
+    case 3:  r = v * (1 - s); g = v * (1 - s * f); b = v; break;
+    case 4:  r = v * (1 - s * (1 - f)); g = v * (1 - s); b = v; break;
+    default: r = v; g = v * (1 - s); b = v * (1 - s * f); break;
+  }
+  cairo_set_source_rgb(cr, r, g, b);
+}
+
+static void chrom_overview_draw_bins(ChromOverviewSeq *seq, cairo_t *cr,
+                                     guint level, unsigned long tilestart,
+                                     gint height)
+{
+  ChromOverviewBin *bin;
+  unsigned long idx, bpp = 1UL << level;
+  guint binlevel;
+  gdouble barheight,
+          densheight = height - CHROM_OVERVIEW_DEPTH_HEIGHT - 1;
+  gint x;
+
+  binlevel = MIN(level - CHROM_OVERVIEW_BIN_LEVEL, seq->num_levels - 1);
+  if (seq->max_coverage[binlevel] == 0)
+    return;
+  for (x = 0; x < CHROM_OVERVIEW_TILE_WIDTH; x++) {
+    idx = (tilestart + x * bpp) >> (CHROM_OVERVIEW_BIN_LEVEL + binlevel);
+    if (idx >= seq->num_bins[binlevel])
+      break;
+    bin = &seq->bins[binlevel][idx];
+    if (bin->coverage == 0)
+      continue;
+    /* the square root keeps sparse regions visible next to dense ones */
+    barheight = densheight * sqrt((gdouble) bin->coverage /
+                                  seq->max_coverage[binlevel]);
+    chrom_overview_set_family_color(cr, bin->family ? bin->family : "");
+    cairo_rectangle(cr, x, densheight - barheight, 1, MAX(barheight, 1));
+    cairo_fill(cr);
+    if (bin->depth > 1) {
+      cairo_set_source_rgb(cr, 0.3, 0.3, 0.3);
+      cairo_rectangle(cr, x, height - CHROM_OVERVIEW_DEPTH_HEIGHT, 1,
+                      MIN(bin->depth - 1, 5) * 2);
+      cairo_fill(cr);
+    }
+  }
+}
+
+static void chrom_overview_draw_cands(ChromOverviewSeq *seq, cairo_t *cr,
+                                      guint level, unsigned long tilestart,
+                                      gint height)
+{
+  ChromOverviewCand *cand;
+  unsigned long i,
+                bpp = 1UL << level,
+                tileend = tilestart + CHROM_OVERVIEW_TILE_WIDTH * bpp;
+  gdouble x1, x2,
+          laneheight = chrom_overview_seq_lane_height(seq, height);
+
+  for (i = chrom_overview_first_cand(seq, tilestart + 1);
+       i < gt_array_size(seq->cands); i++) {
+    cand = (ChromOverviewCand*) gt_array_get(seq->cands, i);
+    if (cand->start > tileend)
+      break;
+    if (cand->end <= tilestart)
+      continue;
+    x1 = (gdouble) ((long) cand->start - 1 - (long) tilestart) / bpp;
+    x2 = (gdouble) ((long) cand->end - (long) tilestart) / bpp;
+    chrom_overview_set_family_color(cr, cand->family);
+    cairo_rectangle(cr, x1, cand->lane * laneheight + 1, MAX(x2 - x1, 1),
+                    MAX(laneheight - 2, 1));
+    cairo_fill_preserve(cr);
+    /* candidates which are not loaded yet are drawn without a frame */
+    if (cand->loaded && laneheight >= 4 && x2 - x1 >= 4) {
+      cairo_set_source_rgb(cr, 0.2, 0.2, 0.2);
+      cairo_set_line_width(cr, 1);
+      cairo_stroke(cr);
+    } else
+      cairo_new_path(cr);
+  }
+}
+
+cairo_surface_t* chrom_overview_render_tile(ChromOverview *co,
+                                            const gchar *seqid, guint level,
+                                            unsigned long tileno, gint height)
+{
+  ChromOverviewSeq *seq;
+  cairo_surface_t *surface;
+  cairo_t *cr;
+  unsigned long tilestart;
+
+  gt_assert(co && co->finished && level <= CHROM_OVERVIEW_MAX_LEVEL);
+  surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+                                       CHROM_OVERVIEW_TILE_WIDTH, height);
+  cr = cairo_create(surface);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_paint(cr);
+  tilestart = (tileno * CHROM_OVERVIEW_TILE_WIDTH) << level;
+  seq = chrom_overview_get_seq(co, seqid, FALSE);
+  if (seq && tilestart < seq->length) {
+    if (level >= CHROM_OVERVIEW_BIN_LEVEL)
+      chrom_overview_draw_bins(seq, cr, level, tilestart, height);
+    else
+      chrom_overview_draw_cands(seq, cr, level, tilestart, height);
+  }
+  cairo_destroy(cr);
+  return surface;
+}
+
+gsize chrom_overview_memory(ChromOverview *co)
+{
+  gt_assert(co);
+  return co->memory;
+}
+
+void chrom_overview_delete(ChromOverview *co)
+{
+  if (!co || !g_atomic_int_dec_and_test(&co->reference_count))
+    return;
+  gt_hashmap_delete(co->seqs);
+  gt_array_delete(co->seqids);
+  g_slice_free(ChromOverview, co);
+}
+
+static gsize chrom_tile_memory(cairo_surface_t *surface)
+{
+  return (gsize) cairo_image_surface_get_stride(surface) *
+         cairo_image_surface_get_height(surface);
+}
+
+static void chrom_tiles_free_tile(void *elem)
+{
+  ChromTile *tile = (ChromTile*) elem;
+
+  cairo_surface_destroy(tile->surface);
+  g_slice_free(ChromTile, tile);
+}
+
+typedef struct {
+  ChromTile *tile;
+  void *key;
+} ChromTilesOldest;
+
+static int chrom_tiles_find_oldest(void *key, void *value, void *data,
+                                   GT_UNUSED GtError *err)
+{
+  ChromTile *tile = (ChromTile*) value;
+  ChromTilesOldest *oldest = (ChromTilesOldest*) data;
+
+  if (!oldest->tile || tile->stamp < oldest->tile->stamp) {
+    oldest->tile = tile;
+    oldest->key = key;
+  }
+  return 0;
+}
+
+/* takes ownership of <key> and <surface> */
+static void chrom_tiles_insert(ChromTiles *ct, gchar *key,
+                               cairo_surface_t *surface)
+{
+  ChromTilesOldest oldest;
+  ChromTile *tile;
+
+  /* the least recently used tiles make room */
+  while (ct->num_tiles > 0 && ct->num_tiles >= ct->max_tiles) {
+    oldest.tile = NULL;
+    oldest.key = NULL;
+    (void) gt_hashmap_foreach(ct->tiles, chrom_tiles_find_oldest, &oldest,
+                              NULL);
+    ct->memory -= chrom_tile_memory(oldest.tile->surface);
+    gt_hashmap_remove(ct->tiles, oldest.key);
+    ct->num_tiles--;
+  }
+  tile = g_slice_new(ChromTile);
+  tile->surface = surface;
+  tile->stamp = ++ct->stamp;
+  gt_hashmap_add(ct->tiles, key, tile);
+  ct->num_tiles++;
+  ct->memory += chrom_tile_memory(surface);
+}
+
+static void chrom_tiles_unref(ChromTiles *ct)
+{
+  if (--ct->reference_count > 0)
+    return;
+  chrom_overview_delete(ct->co);
+  gt_hashmap_delete(ct->pending);
+  gt_hashmap_delete(ct->tiles);
+  g_slice_free(ChromTiles, ct);
+}
+
+static gboolean chrom_tiles_job_done(gpointer data)
+{
+  ChromTileJob *job = (ChromTileJob*) data;
+  ChromTiles *ct = job->ct;
+  gboolean ready = FALSE;
+
+  if (!ct->closed) {
+    gt_hashmap_remove(ct->pending, job->key);
+    /* tiles of a replaced overview are dropped, skipped tiles are requested
+       again by the redraw if they are still needed */
+    if (job->surface && job->co == ct->co) {
+      chrom_tiles_insert(ct, job->key, job->surface);
+      job->key = NULL;
+      job->surface = NULL;
+    }
+    ready = TRUE;
+  }
+  if (job->surface)
+    cairo_surface_destroy(job->surface);
+  g_free(job->key);
+  chrom_overview_delete(job->co);
+  g_slice_free(ChromTileJob, job);
+  if (ready)
+    ct->ready(ct->data);
+  chrom_tiles_unref(ct);
+  return FALSE;
+}
+
+static void chrom_tiles_worker(gpointer data, gpointer user_data)
+{
+  ChromTileJob *job = (ChromTileJob*) data;
+  ChromTiles *ct = (ChromTiles*) user_data;
+
+  /* tiles of a view which has been left are not rendered anymore */
+  if (!g_atomic_int_get(&ct->closed) &&
+      g_atomic_int_get(&ct->view) == job->view) {
+    job->surface = chrom_overview_render_tile(job->co, job->seqid, job->level,
+                                              job->tileno, job->height);
+  }
+  g_idle_add(chrom_tiles_job_done, job);
+}
+
+ChromTiles* chrom_tiles_new(guint num_threads, guint max_tiles,
+                            ChromTilesReadyFunc ready, gpointer data)
+{
+  ChromTiles *ct = g_slice_new(ChromTiles);
+  GError *gerr = NULL;
+
+  gt_assert(ready);
+  ct->pool = NULL;
+  if (num_threads > 0) {
+    ct->pool = g_thread_pool_new(chrom_tiles_worker, ct, (gint) num_threads,
+                                 FALSE, &gerr);
+    /* without threads the tiles are rendered right away */
+    if (!ct->pool)
+      g_error_free(gerr);
+  }
+  ct->co = NULL;
+  ct->tiles = gt_hashmap_new(GT_HASH_STRING, g_free, chrom_tiles_free_tile);
+  ct->pending = gt_hashmap_new(GT_HASH_STRING, g_free, NULL);
+  ct->ready = ready;
+  ct->data = data;
+  ct->stamp = ct->num_tiles = 0;
+  ct->max_tiles = MAX(max_tiles, 1);
+  ct->reference_count = 1;
+  ct->memory = 0;
+  ct->view = 0;
+  ct->closed = 0;
+  return ct;
+}
+
+void chrom_tiles_set_overview(ChromTiles *ct, ChromOverview *co)
+{
+  gt_assert(ct);
+  chrom_overview_delete(ct->co);
+  ct->co = co ? chrom_overview_ref(co) : NULL;
+  gt_hashmap_delete(ct->tiles);
+  ct->tiles = gt_hashmap_new(GT_HASH_STRING, g_free, chrom_tiles_free_tile);
+  ct->num_tiles = 0;
+  ct->memory = 0;
+  chrom_tiles_new_view(ct);
+}
+
+void chrom_tiles_new_view(ChromTiles *ct)
+{
+  gt_assert(ct);
+  g_atomic_int_inc(&ct->view);
+}
+
+cairo_surface_t* chrom_tiles_get(ChromTiles *ct, const gchar *seqid,
+                                 guint level, unsigned long tileno,
+                                 gint height, gboolean request)
+{
+  ChromTileJob *job;
+  ChromTile *tile;
+  cairo_surface_t *surface;
+  gchar *key;
+
+  gt_assert(ct && seqid);
+  key = g_strdup_printf("%s\t%u\t%lu\t%d", seqid, level, tileno, height);
+  if ((tile = (ChromTile*) gt_hashmap_get(ct->tiles, key))) {
+    tile->stamp = ++ct->stamp;
+    g_free(key);
+    return tile->surface;
+  }
+  if (!request || !ct->co || gt_hashmap_get(ct->pending, key)) {
+    g_free(key);
+    return NULL;
+  }
+  if (!ct->pool) {
+    surface = chrom_overview_render_tile(ct->co, seqid, level, tileno, height);
+    chrom_tiles_insert(ct, key, surface);
+    return surface;
+  }
+  job = g_slice_new(ChromTileJob);
+  job->ct = ct;
+  job->co = chrom_overview_ref(ct->co);
+  job->key = g_strdup(key);
+  job->seqid = symbols_intern(seqid);
+  job->level = level;
+  job->view = g_atomic_int_get(&ct->view);
+  job->height = height;
+  job->tileno = tileno;
+  job->surface = NULL;
+  gt_hashmap_add(ct->pending, key, job);
+  ct->reference_count++;
+  g_thread_pool_push(ct->pool, job, NULL);
+  return NULL;
+}
+
+gsize chrom_tiles_memory(ChromTiles *ct)
+{
+  gt_assert(ct);
+  return ct->memory;
+}
+
+void chrom_tiles_delete(ChromTiles *ct)
+{
+  if (!ct)
+    return;
+  /* queued tiles are skipped, the jobs are released in the main loop */
+  g_atomic_int_set(&ct->closed, 1);
+  if (ct->pool)
+    g_thread_pool_free(ct->pool, FALSE, TRUE);
+  ct->pool = NULL;
+  chrom_tiles_unref(ct);
+}
@@ -0,0 +1,145 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHROM_OVERVIEW_H
+#define CHROM_OVERVIEW_H
+
+#include <cairo.h>
+#include <glib.h>
+#include "genometools.h"
+
+/* The overview is drawn in tiles of this width (in pixels). At zoom level
+   <level> a pixel shows 2^<level> positions of the sequence. */
+#define CHROM_OVERVIEW_TILE_WIDTH  256
+#define CHROM_OVERVIEW_MAX_LEVEL   28
+/* From this level on, the density of the candidates is drawn instead of the
+   candidates themselves. */
+#define CHROM_OVERVIEW_BIN_LEVEL   10
+
+/* <ChromOverview> is a snapshot of the positions and families of all
+   candidates of a project, arranged for drawing whole sequences: the
+   candidates of each sequence are sorted and put into lanes so that nested
+   candidates lie below the candidates containing them, and the coverage of
+   each sequence is precomputed in bins of 2^<CHROM_OVERVIEW_BIN_LEVEL>
+   positions and in coarser bins for each zoom level above. Once finished, an
+   overview is not changed anymore and can be read by any thread. */
+typedef struct ChromOverview ChromOverview;
+
+typedef struct {
+  unsigned long start,
+                end;
+  const gchar *family;  /* interned, "" for unclassified candidates */
+  gboolean loaded;
+  guint lane;
+} ChromOverviewCand;
+
+ChromOverview*           chrom_overview_new(void);
+
+/* Sets the length of <seqid>, otherwise the end of its last candidate is
+   used. */
+void                     chrom_overview_set_length(ChromOverview *co,
+                                                   const gchar *seqid,
+                                                   unsigned long length);
+
+void                     chrom_overview_add(ChromOverview *co,
+                                            const gchar *seqid,
+                                            unsigned long start,
+                                            unsigned long end,
+                                            const gchar *family,
+                                            gboolean loaded);
+
+/* Sorts the candidates, assigns their lanes and computes the bins. No
+   candidates can be added afterwards. */
+void                     chrom_overview_finish(ChromOverview *co);
+
+ChromOverview*           chrom_overview_ref(ChromOverview *co);
+
+/* Returns the number of sequences with candidates or a length. */
+unsigned long            chrom_overview_num_seqids(ChromOverview *co);
+
+/* Returns the interned name of the <i>-th sequence (in the order of
+   their names). */
+const gchar*             chrom_overview_get_seqid(ChromOverview *co,
+                                                  unsigned long i);
+
+unsigned long            chrom_overview_get_length(ChromOverview *co,
+                                                   const gchar *seqid);
+
+unsigned long            chrom_overview_num_candidates(ChromOverview *co,
+                                                       const gchar *seqid);
+
+/* Returns the height of a lane for a drawing <height> pixels high. */
+gdouble                  chrom_overview_lane_height(ChromOverview *co,
+                                                    const gchar *seqid,
+                                                    gint height);
+
+/* Returns the candidate in <lane> of <seqid> overlapping the range from
+   <start> to <end>, NULL if there is none. */
+const ChromOverviewCand* chrom_overview_find(ChromOverview *co,
+                                             const gchar *seqid,
+                                             unsigned long start,
+                                             unsigned long end, guint lane);
+
+/* Draws tile <tileno> of <seqid> at zoom level <level> into a new image
+   <height> pixels high. */
+cairo_surface_t*         chrom_overview_render_tile(ChromOverview *co,
+                                                    const gchar *seqid,
+                                                    guint level,
+                                                    unsigned long tileno,
+                                                    gint height);
+
+/* Returns the number of bytes used by <co>. */
+gsize                    chrom_overview_memory(ChromOverview *co);
+
+/* Drops a reference, <co> is deleted with the last one. Can be called from
+   any thread. */
+void                     chrom_overview_delete(ChromOverview *co);
+
+/* <ChromTiles> renders the tiles of a <ChromOverview> on background threads
+   and keeps the most recently used ones. It must only be used from the main
+   thread. */
+typedef struct ChromTiles ChromTiles;
+
+/* Called in the main thread whenever a requested tile has been rendered or
+   skipped. */
+typedef void (*ChromTilesReadyFunc)(gpointer data);
+
+ChromTiles*      chrom_tiles_new(guint num_threads, guint max_tiles,
+                                 ChromTilesReadyFunc ready, gpointer data);
+
+/* Replaces the overview the tiles are rendered from, all tiles are
+   dropped. */
+void             chrom_tiles_set_overview(ChromTiles *ct, ChromOverview *co);
+
+/* Tiles which have been requested but not rendered yet are skipped, for
+   use when the sequence or zoom level shown is changed. */
+void             chrom_tiles_new_view(ChromTiles *ct);
+
+/* Returns the tile if it has been rendered, otherwise NULL is returned and,
+   if <request> is TRUE, the tile is rendered in the background. The
+   returned image belongs to <ct> and stays valid until the next call or
+   until the main loop is run again. */
+cairo_surface_t* chrom_tiles_get(ChromTiles *ct, const gchar *seqid,
+                                 guint level, unsigned long tileno,
+                                 gint height, gboolean request);
+
+/* Returns the number of bytes used by the rendered tiles. */
+gsize            chrom_tiles_memory(ChromTiles *ct);
+
+void             chrom_tiles_delete(ChromTiles *ct);
+
+#endif
@@ -0,0 +1,345 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include "dedup_stream.h"
+#include "location_index.h"
+#include "message_strings.h"
+#include "symbols.h"
+
+#define DEDUP_NO_CAND G_MAXULONG
+
+typedef struct DedupCand DedupCand;
+
+struct DedupCand {
+  GtFeatureNode *element;
+  const gchar *seqid;
+  unsigned long start,
+                end,
+                num_features,
+                order;
+  double score,
+         similarity;
+  DedupCand *kept;
+};
+
+typedef struct {
+  GtGenomeNode *gn;
+  unsigned long cand;
+} DedupNode;
+
+struct LTRGuiDedupStream {
+  const GtNodeStream parent_instance;
+  GtNodeStream *in_stream;
+  JobProgress *jp;
+  GtArray *nodes,
+          *cands;
+  double min_overlap;
+  guint stage;
+  unsigned long next,
+                duplicates;
+  bool flag,
+       done;
+};
+
+#define ltrgui_dedup_stream_cast(GS)\
+        gt_node_stream_cast(ltrgui_dedup_stream_class(), GS);
+
+/* the element of a candidate is its LTR_retrotransposon feature, or the
+   whole candidate if there is none */
+static void ltrgui_dedup_stream_add_cand(LTRGuiDedupStream *ds,
+                                         GtFeatureNode *fn)
+{
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *curnode;
+  DedupCand cand;
+  GtRange range;
+  const char *similarity;
+
+  cand.element = fn;
+  cand.num_features = 0;
+  fni = gt_feature_node_iterator_new(fn);
+  while ((curnode = gt_feature_node_iterator_next(fni))) {
+    if (cand.element == fn && symbols_feature_type(curnode) == SYMBOL_LTRRETRO)
+      cand.element = curnode;
+    cand.num_features++;
+  }
+  gt_feature_node_iterator_delete(fni);
+  range = gt_genome_node_get_range((GtGenomeNode*) cand.element);
+  cand.seqid = symbols_intern(gt_str_get(
+                          gt_genome_node_get_seqid((GtGenomeNode*) fn)));
+  cand.start = range.start;
+  cand.end = range.end;
+  cand.order = gt_array_size(ds->cands);
+  cand.score = gt_feature_node_score_is_defined(cand.element)
+               ? gt_feature_node_get_score(cand.element) : -G_MAXDOUBLE;
+  similarity = gt_feature_node_get_attribute(cand.element, ATTR_LTRSIM);
+  cand.similarity = similarity ? atof(similarity) : -1.0;
+  cand.kept = NULL;
+  gt_array_add(ds->cands, cand);
+}
+
+static int ltrgui_dedup_stream_read(LTRGuiDedupStream *ds, GtError *err)
+{
+  GtGenomeNode *gn;
+  GtFeatureNode *fn;
+  DedupNode node;
+  int had_err;
+
+  while (!(had_err = gt_node_stream_next(ds->in_stream, &gn, err)) && gn) {
+    node.gn = gn;
+    node.cand = DEDUP_NO_CAND;
+    if ((fn = gt_feature_node_try_cast(gn))) {
+      node.cand = gt_array_size(ds->cands);
+      ltrgui_dedup_stream_add_cand(ds, fn);
+    }
+    gt_array_add(ds->nodes, node);
+  }
+  return had_err;
+}
+
+/* better candidates come first */
+static int ltrgui_dedup_cand_cmp(const void *a, const void *b)
+{
+  const DedupCand *ca = *(DedupCand* const*) a,
+                  *cb = *(DedupCand* const*) b;
+
+  if (ca->score != cb->score)
+    return ca->score > cb->score ? -1 : 1;
+  if (ca->similarity != cb->similarity)
+    return ca->similarity > cb->similarity ? -1 : 1;
+  if (ca->num_features != cb->num_features)
+    return ca->num_features > cb->num_features ? -1 : 1;
+  if (ca->order != cb->order)
+    return ca->order < cb->order ? -1 : 1;
+  return 0;
+}
+
+static bool ltrgui_dedup_stream_overlap(LTRGuiDedupStream *ds, DedupCand *a,
+                                        DedupCand *b)
+{
+  unsigned long overlap;
+
+  if (a->end < b->start || b->end < a->start)
+    return false;
+  overlap = MIN(a->end, b->end) - MAX(a->start, b->start) + 1;
+  return overlap >= ds->min_overlap * (a->end - a->start + 1) &&
+         overlap >= ds->min_overlap * (b->end - b->start + 1);
+}
+
+/* The candidates are visited from the best to the worst one, every candidate
+   overlapping a kept one enough is a duplicate of it, otherwise it is kept.
+   As a duplicate shares at least half of its positions with the kept
+   candidate, the kept candidate contains one of its middle positions (two if
+   its length is even), so only the kept candidates at those positions have
+   to be compared. */
+static void ltrgui_dedup_stream_run(LTRGuiDedupStream *ds)
+{
+  LocationIndex *kept;
+  GtArray *ranks,
+          *found;
+  DedupCand *cand,
+            *other;
+  unsigned long i, j, length;
+
+  if (ds->jp)
+    job_progress_start_stage(ds->jp, ds->stage);
+  ranks = gt_array_new(sizeof (DedupCand*));
+  for (i = 0; i < gt_array_size(ds->cands); i++) {
+    cand = (DedupCand*) gt_array_get(ds->cands, i);
+    gt_array_add(ranks, cand);
+  }
+  if (gt_array_size(ranks) > 0)
+    qsort(gt_array_get_space(ranks), gt_array_size(ranks),
+          sizeof (DedupCand*), ltrgui_dedup_cand_cmp);
+
+  kept = location_index_new();
+  found = gt_array_new(sizeof (gpointer));
+  for (i = 0; i < gt_array_size(ranks); i++) {
+    cand = *(DedupCand**) gt_array_get(ranks, i);
+    length = cand->end - cand->start + 1;
+    gt_array_reset(found);
+    location_index_find_range(kept, cand->seqid,
+                              cand->start + (length - 1) / 2,
+                              cand->start + length / 2, found);
+    for (j = 0; j < gt_array_size(found); j++) {
+      other = *(DedupCand**) gt_array_get(found, j);
+      if (ltrgui_dedup_stream_overlap(ds, cand, other)) {
+        cand->kept = other;
+        break;
+      }
+    }
+    if (cand->kept)
+      ds->duplicates++;
+    else
+      location_index_add(kept, cand->seqid, cand->start, cand->end, NULL,
+                         cand);
+    if (ds->jp)
+      job_progress_add(ds->jp, ds->stage, 1);
+  }
+  gt_array_delete(found);
+  location_index_delete(kept);
+  gt_array_delete(ranks);
+  if (ds->jp) {
+    job_progress_set_items(ds->jp, gt_array_size(ds->cands) - ds->duplicates);
+    job_progress_next_stage(ds->jp);
+  }
+}
+
+static int ltrgui_dedup_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
+                                    GtError *err)
+{
+  LTRGuiDedupStream *ds;
+  DedupNode *node;
+  DedupCand *cand;
+  gchar location[BUFSIZ];
+  int had_err = 0;
+
+  gt_error_check(err);
+  ds = ltrgui_dedup_stream_cast(gs);
+
+  if (!ds->done) {
+    ds->done = true;
+    had_err = ltrgui_dedup_stream_read(ds, err);
+    if (!had_err)
+      ltrgui_dedup_stream_run(ds);
+  }
+
+  *gn = NULL;
+  while (!had_err && ds->next < gt_array_size(ds->nodes)) {
+    node = (DedupNode*) gt_array_get(ds->nodes, ds->next++);
+    if (node->cand != DEDUP_NO_CAND) {
+      cand = (DedupCand*) gt_array_get(ds->cands, node->cand);
+      if (cand->kept && !ds->flag) {
+        gt_genome_node_delete(node->gn);
+        continue;
+      }
+      /* the location of the kept candidate can be entered to jump to it */
+      if (cand->kept) {
+        g_snprintf(location, BUFSIZ, "%s:%lu-%lu", cand->kept->seqid,
+                   cand->kept->start, cand->kept->end);
+        gt_feature_node_set_attribute(cand->element, ATTR_DUPLICATE,
+                                      location);
+      }
+    }
+    *gn = node->gn;
+    break;
+  }
+  return had_err;
+}
+
+static void ltrgui_dedup_stream_free(GtNodeStream *gs)
+{
+  LTRGuiDedupStream *ds = ltrgui_dedup_stream_cast(gs);
+  unsigned long i;
+
+  /* nodes which have not been passed on are still owned by the stream */
+  for (i = ds->next; i < gt_array_size(ds->nodes); i++)
+    gt_genome_node_delete(((DedupNode*) gt_array_get(ds->nodes, i))->gn);
+  gt_array_delete(ds->nodes);
+  gt_array_delete(ds->cands);
+  gt_node_stream_delete(ds->in_stream);
+}
+
+const GtNodeStreamClass* ltrgui_dedup_stream_class(void)
+{
+  static const GtNodeStreamClass *gsc = NULL;
+  if (!gsc)
+    gsc = gt_node_stream_class_new(sizeof (LTRGuiDedupStream),
+                                   ltrgui_dedup_stream_free,
+                                   ltrgui_dedup_stream_next);
+  return gsc;
+}
+
+GtNodeStream* ltrgui_dedup_stream_new(GtNodeStream *in_stream,
+                                      double min_overlap, bool flag,
+                                      JobProgress *jp, guint stage)
+{
+  GtNodeStream *gs;
+  LTRGuiDedupStream *ds;
+  gt_assert(in_stream && min_overlap >= 0.5 && min_overlap <= 1.0);
+  gs = gt_node_stream_create(ltrgui_dedup_stream_class(), false);
+  ds = ltrgui_dedup_stream_cast(gs);
+  ds->in_stream = gt_node_stream_ref(in_stream);
+  ds->jp = jp;
+  ds->nodes = gt_array_new(sizeof (DedupNode));
+  ds->cands = gt_array_new(sizeof (DedupCand));
+  ds->min_overlap = min_overlap;
+  ds->stage = stage;
+  ds->next = ds->duplicates = 0;
+  ds->flag = flag;
+  ds->done = false;
+  return gs;
+}
+
+unsigned long ltrgui_dedup_stream_get_duplicates(LTRGuiDedupStream *ds)
+{
+  gt_assert(ds);
+  return ds->duplicates;
+}
+
+/* runs pairs of candidates overlapping by exactly <min_overlap> or by one
+   position less through a stream and checks that only the former are
+   merged */
+int ltrgui_dedup_stream_unit_test(GtError *err)
+{
+  static const unsigned long pairs[][5] = {
+    /* start1, end1, start2, end2, duplicate */
+    { 1, 10,  6, 15, 1 }, /* even length, overlap exactly half */
+    { 1, 10,  7, 16, 0 },
+    { 6, 15,  1, 10, 1 },
+    { 1,  9,  5, 13, 1 }, /* odd length, overlap just above half */
+    { 1,  9,  6, 14, 0 },
+    { 1,  2,  2,  3, 1 },
+    { 1,  1,  1,  1, 1 }
+  };
+  GtNodeStream *array_in_stream,
+               *dedup_stream;
+  GtGenomeNode *gn;
+  GtArray *nodes;
+  GtStr *seqid;
+  unsigned long i, j;
+  int had_err = 0;
+
+  gt_error_check(err);
+  seqid = gt_str_new_cstr("seq0");
+  for (i = 0; !had_err && i < sizeof (pairs) / sizeof (pairs[0]); i++) {
+    nodes = gt_array_new(sizeof (GtGenomeNode*));
+    for (j = 0; j < 2; j++) {
+      gn = gt_feature_node_new(seqid, FNT_REPEATR, pairs[i][2 * j],
+                               pairs[i][2 * j + 1], GT_STRAND_BOTH);
+      gt_array_add(nodes, gn);
+    }
+    array_in_stream = gt_array_in_stream_new(nodes, NULL, err);
+    dedup_stream = ltrgui_dedup_stream_new(array_in_stream, 0.5, true, NULL,
+                                           0);
+    while (!(had_err = gt_node_stream_next(dedup_stream, &gn, err)) && gn)
+      gt_genome_node_delete(gn);
+    if (!had_err &&
+        ltrgui_dedup_stream_get_duplicates((LTRGuiDedupStream*) dedup_stream)
+          != pairs[i][4]) {
+      gt_error_set(err, "dedup unit test failed for %lu-%lu and %lu-%lu",
+                   pairs[i][0], pairs[i][1], pairs[i][2], pairs[i][3]);
+      had_err = -1;
+    }
+    gt_node_stream_delete(dedup_stream);
+    gt_node_stream_delete(array_in_stream);
+    gt_array_delete(nodes);
+  }
+  gt_str_delete(seqid);
+  return had_err;
+}
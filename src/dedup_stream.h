@@ -0,0 +1,49 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEDUP_STREAM_H
+#define DEDUP_STREAM_H
+
+#include "genometools.h"
+#include "job_progress.h"
+
+typedef struct LTRGuiDedupStream LTRGuiDedupStream;
+
+const GtNodeStreamClass* ltrgui_dedup_stream_class(void);
+
+/* Implements the <GtNodeStream> interface. <LTRGuiDedupStream> reads all
+   nodes of <in_stream> and finds the candidates predicted more than once,
+   i.e. whose elements (LTR_retrotransposon features) overlap each other by
+   at least <min_overlap> (a fraction between 0.5 and 1) of both lengths.
+   Of each group of such candidates the best one is kept: the one with the
+   highest score, then the highest LTR similarity, then the most features,
+   then the first one read. The others are deleted or, if <flag> is true,
+   passed on with the location of the kept candidate ("seqid:start-end") in
+   their "duplicate_of" attribute. The candidates are handled in O(n log n)
+   time and counted as done in <stage> of <jp> (if not NULL), afterwards the
+   number of items of <jp> is set to the number of kept candidates and the
+   next stage is started. */
+GtNodeStream* ltrgui_dedup_stream_new(GtNodeStream *in_stream,
+                                      double min_overlap, bool flag,
+                                      JobProgress *jp, guint stage);
+
+/* Returns the number of candidates found to be duplicates. */
+unsigned long ltrgui_dedup_stream_get_duplicates(LTRGuiDedupStream *ds);
+
+int           ltrgui_dedup_stream_unit_test(GtError *err);
+
+#endif
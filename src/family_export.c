@@ -0,0 +1,306 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "family_export.h"
+#include "message_strings.h"
+#include "sequence_export.h"
+#include "support.h"
+
+typedef struct {
+  gchar *name;
+  GtArray *nodes;
+} FamilyExportFamily;
+
+struct FamilyExport {
+  GtArray *families,
+          *regions;
+  GtEncseq *encseq;
+  GMutex *mutex;
+  GtError *err;
+  gchar *prefix,
+        *indexname;
+  unsigned long *progress,
+                total;
+  gboolean annotation,
+           flcands;
+  gint had_err;
+};
+
+FamilyExport* family_export_new(const gchar *prefix, GtArray *regions,
+                                gboolean annotation, const gchar *indexname,
+                                gboolean flcands)
+{
+  FamilyExport *fe = g_slice_new(FamilyExport);
+
+  gt_assert(prefix && (annotation || indexname));
+  fe->families = gt_array_new(sizeof (FamilyExportFamily));
+  fe->regions = snapshot_node_array(regions);
+  fe->encseq = NULL;
+  fe->mutex = NULL;
+  fe->err = NULL;
+  fe->prefix = g_strdup(prefix);
+  fe->indexname = g_strdup(indexname);
+  fe->progress = NULL;
+  fe->total = 0;
+  fe->annotation = annotation;
+  fe->flcands = flcands;
+  fe->had_err = 0;
+  return fe;
+}
+
+void family_export_add(FamilyExport *fe, const gchar *name, GtArray *nodes)
+{
+  FamilyExportFamily family;
+
+  gt_assert(fe && name && nodes);
+  family.name = g_strdup(name);
+  family.nodes = snapshot_node_array(nodes);
+  node_array_ensure_sorted(family.nodes);
+  gt_array_add(fe->families, family);
+  fe->total += gt_array_size(nodes) * ((fe->annotation ? 1 : 0) +
+                                       (fe->indexname ? 1 : 0));
+}
+
+static gchar* family_export_filename(FamilyExport *fe,
+                                     FamilyExportFamily *family,
+                                     const gchar *pattern)
+{
+  /* the file names are made up here, so they follow the general setting */
+  return g_strdup_printf("%s_%s%s%s", fe->prefix, family->name, pattern,
+                         compression_threads() > 0 ? GZ_PATTERN : "");
+}
+
+unsigned long family_export_num_existing(FamilyExport *fe)
+{
+  FamilyExportFamily *family;
+  gchar *filename;
+  unsigned long i,
+                existing = 0;
+
+  for (i = 0; i < gt_array_size(fe->families); i++) {
+    family = (FamilyExportFamily*) gt_array_get(fe->families, i);
+    if (fe->annotation) {
+      filename = family_export_filename(fe, family, GFF3_PATTERN);
+      if (g_file_test(filename, G_FILE_TEST_EXISTS))
+        existing++;
+      g_free(filename);
+    }
+    if (fe->indexname) {
+      filename = family_export_filename(fe, family, FAS_PATTERN);
+      if (g_file_test(filename, G_FILE_TEST_EXISTS))
+        existing++;
+      g_free(filename);
+    }
+  }
+  return existing;
+}
+
+unsigned long family_export_total(FamilyExport *fe)
+{
+  gt_assert(fe);
+  return fe->total;
+}
+
+static void family_export_add_progress(FamilyExport *fe, unsigned long n)
+{
+  g_mutex_lock(fe->mutex);
+  if (fe->progress)
+    *fe->progress += n;
+  g_mutex_unlock(fe->mutex);
+}
+
+static gboolean family_export_is_flcand(GtGenomeNode *gn)
+{
+  return (gt_feature_node_get_attribute((GtFeatureNode*) gn,
+                                        ATTR_FULLLEN) != NULL);
+}
+
+/* the nodes are only read by the GFF3 visitor, so the nodes shared by all
+   families (i.e. the regions) can be written by several threads at once */
+static gint family_export_annotation(FamilyExport *fe,
+                                     FamilyExportFamily *family,
+                                     GtError *err)
+{
+  GtNodeVisitor *gff3_visitor = NULL;
+  GtGenomeNode *gn;
+  GtFile *outfp;
+  gchar *filename,
+        *plainfile = NULL;
+  unsigned long i;
+  gint had_err = 0;
+
+  filename = family_export_filename(fe, family, GFF3_PATTERN);
+  outfp = gff3_output_new(filename, &plainfile, err);
+  if (!outfp)
+    had_err = -1;
+
+  if (!had_err)
+    gff3_visitor = gt_gff3_visitor_new(outfp);
+  for (i = 0; !had_err && i < gt_array_size(fe->regions); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(fe->regions, i);
+    had_err = gt_genome_node_accept(gn, gff3_visitor, err);
+  }
+  for (i = 0; !had_err && i < gt_array_size(family->nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(family->nodes, i);
+    if (!fe->flcands || family_export_is_flcand(gn))
+      had_err = gt_genome_node_accept(gn, gff3_visitor, err);
+    family_export_add_progress(fe, 1);
+  }
+  gt_node_visitor_delete(gff3_visitor);
+  if (outfp || plainfile)
+    had_err = gff3_output_finish(outfp, filename, plainfile, FALSE, had_err,
+                                 err);
+  g_free(filename);
+  return had_err;
+}
+
+static gint family_export_sequences(FamilyExport *fe,
+                                    FamilyExportFamily *family, GtError *err)
+{
+  SequenceExport *se;
+  GtFile *outfp = NULL;
+  gchar *filename,
+        *plainfile = NULL;
+  gint had_err = 0;
+
+  filename = family_export_filename(fe, family, FAS_PATTERN);
+  se = sequence_export_new();
+  had_err = sequence_export_add_nodes(se, family->nodes, fe->encseq,
+                                      fe->flcands, err);
+  if (!had_err) {
+    outfp = gff3_output_new(filename, &plainfile, err);
+    if (!outfp)
+      had_err = -1;
+  }
+  /* the families are the unit of parallelism here, so each family is
+     extracted by its own thread only */
+  if (!had_err)
+    had_err = sequence_export_write(se, fe->encseq, outfp, 1, err);
+  if (outfp || plainfile)
+    had_err = gff3_output_finish(outfp, filename, plainfile, FALSE, had_err,
+                                 err);
+  if (!had_err)
+    family_export_add_progress(fe, gt_array_size(family->nodes));
+  sequence_export_delete(se);
+  g_free(filename);
+  return had_err;
+}
+
+static void family_export_worker(gpointer data, gpointer user_data)
+{
+  FamilyExportFamily *family = (FamilyExportFamily*) data;
+  FamilyExport *fe = (FamilyExport*) user_data;
+  GtError *err;
+  gint had_err;
+
+  /* the remaining families are skipped after the first error */
+  g_mutex_lock(fe->mutex);
+  had_err = fe->had_err;
+  g_mutex_unlock(fe->mutex);
+  if (had_err)
+    return;
+
+  err = gt_error_new();
+  if (fe->annotation)
+    had_err = family_export_annotation(fe, family, err);
+  if (!had_err && fe->indexname)
+    had_err = family_export_sequences(fe, family, err);
+
+  if (had_err) {
+    g_mutex_lock(fe->mutex);
+    if (!fe->had_err) {
+      gt_error_set(fe->err, "Could not export family %s: %s", family->name,
+                   gt_error_get(err));
+      fe->had_err = had_err;
+    }
+    g_mutex_unlock(fe->mutex);
+  }
+  gt_error_delete(err);
+}
+
+gint family_export_run(FamilyExport *fe, guint num_threads,
+                       unsigned long *progress, GtError *err)
+{
+  GtEncseqLoader *el = NULL;
+  GThreadPool *pool = NULL;
+  GError *gerr = NULL;
+  unsigned long i;
+  gint had_err = 0;
+
+  gt_assert(fe && !fe->mutex);
+  if (num_threads == 0)
+    num_threads = 1;
+  fe->progress = progress;
+  fe->err = err;
+  fe->had_err = 0;
+
+  /* the encoded sequence is shared by all families */
+  if (fe->indexname) {
+    el = gt_encseq_loader_new();
+    if (!(fe->encseq = gt_encseq_loader_load(el, fe->indexname, err)))
+      had_err = -1;
+  }
+
+  if (!had_err) {
+    fe->mutex = g_mutex_new();
+    pool = g_thread_pool_new(family_export_worker, fe, (gint) num_threads,
+                             TRUE, &gerr);
+    if (!pool) {
+      gt_error_set(err, "Could not create export threads: %s",
+                   gerr->message);
+      g_error_free(gerr);
+      had_err = -1;
+    }
+  }
+  if (!had_err) {
+    for (i = 0; i < gt_array_size(fe->families); i++)
+      g_thread_pool_push(pool, gt_array_get(fe->families, i), NULL);
+    /* waits until all families are written */
+    g_thread_pool_free(pool, FALSE, TRUE);
+    had_err = fe->had_err;
+  }
+
+  if (fe->mutex) {
+    g_mutex_free(fe->mutex);
+    fe->mutex = NULL;
+  }
+  gt_encseq_delete(fe->encseq);
+  fe->encseq = NULL;
+  gt_encseq_loader_delete(el);
+  fe->progress = NULL;
+  fe->err = NULL;
+  return had_err;
+}
+
+void family_export_delete(FamilyExport *fe)
+{
+  FamilyExportFamily *family;
+  unsigned long i;
+
+  if (!fe)
+    return;
+  for (i = 0; i < gt_array_size(fe->families); i++) {
+    family = (FamilyExportFamily*) gt_array_get(fe->families, i);
+    g_free(family->name);
+    snapshot_node_array_delete(family->nodes);
+  }
+  gt_array_delete(fe->families);
+  snapshot_node_array_delete(fe->regions);
+  g_free(fe->prefix);
+  g_free(fe->indexname);
+  g_slice_free(FamilyExport, fe);
+}
@@ -0,0 +1,57 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAMILY_EXPORT_H
+#define FAMILY_EXPORT_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <FamilyExport> writes the annotation and/or the sequences of several
+   families to one file per family (<prefix>_<family>.gff3 and
+   <prefix>_<family>.fas, followed by .gz if LTRSIFT_COMPRESS_THREADS is
+   set), exporting the families in parallel. */
+typedef struct FamilyExport FamilyExport;
+
+/* If <indexname> is NULL, no sequences are exported. The annotation files
+   contain all of <regions>. Only full-length candidates are exported if
+   <flcands> is TRUE. */
+FamilyExport* family_export_new(const gchar *prefix, GtArray *regions,
+                                gboolean annotation, const gchar *indexname,
+                                gboolean flcands);
+
+/* Adds the family <name> with its candidates <nodes>. The candidates are
+   referenced by <fe>, so the family may be changed during the export. */
+void          family_export_add(FamilyExport *fe, const gchar *name,
+                                GtArray *nodes);
+
+/* Returns the number of files which would be overwritten. */
+unsigned long family_export_num_existing(FamilyExport *fe);
+
+/* Returns the number of steps counted in the <progress> of
+   family_export_run(). */
+unsigned long family_export_total(FamilyExport *fe);
+
+/* Exports all families with <num_threads> threads, the encoded sequence is
+   loaded once for all families. <progress> is increased by the number of
+   candidates written. */
+gint          family_export_run(FamilyExport *fe, guint num_threads,
+                                unsigned long *progress, GtError *err);
+
+void          family_export_delete(FamilyExport *fe);
+
+#endif
@@ -0,0 +1,399 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include "family_stats.h"
+#include "flcand.h"
+
+/* the lengths are kept in treaps, binary search trees balanced by random
+   priorities, whose nodes know the size of their subtrees, so the k-th
+   smallest length is found in O(log n) time */
+typedef struct FamilyStatsNode FamilyStatsNode;
+
+struct FamilyStatsNode {
+  FamilyStatsNode *left,
+                  *right;
+  gfloat key;
+  guint32 priority;
+  unsigned long count,
+                size;
+};
+
+/* all candidates with the same number of domains */
+typedef struct {
+  FamilyStatsNode *ltr_lengths,
+                  *elem_lengths;
+  unsigned long size;
+} FamilyStatsGroup;
+
+struct FamilyStats {
+  GtHashmap *infos;
+  GtArray *groups;
+  unsigned long size;
+};
+
+static unsigned long family_stats_node_size(FamilyStatsNode *node)
+{
+  return node ? node->size : 0;
+}
+
+static void family_stats_node_update(FamilyStatsNode *node)
+{
+  node->size = node->count + family_stats_node_size(node->left) +
+               family_stats_node_size(node->right);
+}
+
+static FamilyStatsNode* family_stats_rotate_right(FamilyStatsNode *node)
+{
+  FamilyStatsNode *left = node->left;
+
+  node->left = left->right;
+  left->right = node;
+  family_stats_node_update(node);
+  family_stats_node_update(left);
+  return left;
+}
+
+static FamilyStatsNode* family_stats_rotate_left(FamilyStatsNode *node)
+{
+  FamilyStatsNode *right = node->right;
+
+  node->right = right->left;
+  right->left = node;
+  family_stats_node_update(node);
+  family_stats_node_update(right);
+  return right;
+}
+
+static FamilyStatsNode* family_stats_tree_insert(FamilyStatsNode *node,
+                                                 gfloat key)
+{
+  if (!node) {
+    node = g_slice_new(FamilyStatsNode);
+    node->left = node->right = NULL;
+    node->key = key;
+    node->priority = g_random_int();
+    node->count = node->size = 1;
+    return node;
+  }
+  if (key == node->key)
+    node->count++;
+  else if (key < node->key) {
+    node->left = family_stats_tree_insert(node->left, key);
+    if (node->left->priority > node->priority)
+      node = family_stats_rotate_right(node);
+  } else {
+    node->right = family_stats_tree_insert(node->right, key);
+    if (node->right->priority > node->priority)
+      node = family_stats_rotate_left(node);
+  }
+  family_stats_node_update(node);
+  return node;
+}
+
+/* removes <node> by rotating it down until one of its subtrees is empty */
+static FamilyStatsNode* family_stats_tree_unlink(FamilyStatsNode *node)
+{
+  FamilyStatsNode *child;
+
+  if (!node->left || !node->right) {
+    child = node->left ? node->left : node->right;
+    g_slice_free(FamilyStatsNode, node);
+    return child;
+  }
+  if (node->left->priority > node->right->priority) {
+    node = family_stats_rotate_right(node);
+    node->right = family_stats_tree_unlink(node->right);
+  } else {
+    node = family_stats_rotate_left(node);
+    node->left = family_stats_tree_unlink(node->left);
+  }
+  family_stats_node_update(node);
+  return node;
+}
+
+static FamilyStatsNode* family_stats_tree_remove(FamilyStatsNode *node,
+                                                 gfloat key)
+{
+  if (!node)
+    return NULL;
+  if (key < node->key)
+    node->left = family_stats_tree_remove(node->left, key);
+  else if (key > node->key)
+    node->right = family_stats_tree_remove(node->right, key);
+  else if (node->count > 1)
+    node->count--;
+  else
+    return family_stats_tree_unlink(node);
+  family_stats_node_update(node);
+  return node;
+}
+
+/* returns the <k>-th smallest key, counting from zero */
+static gfloat family_stats_tree_kth(FamilyStatsNode *node, unsigned long k)
+{
+  unsigned long left_size;
+
+  while (node) {
+    left_size = family_stats_node_size(node->left);
+    if (k < left_size)
+      node = node->left;
+    else if (k < left_size + node->count)
+      return node->key;
+    else {
+      k -= left_size + node->count;
+      node = node->right;
+    }
+  }
+  return 0.0;
+}
+
+static gfloat family_stats_tree_median(FamilyStatsNode *node)
+{
+  unsigned long n = family_stats_node_size(node);
+
+  if (n == 0)
+    return 0.0;
+  if (n % 2 != 0)
+    return family_stats_tree_kth(node, n / 2);
+  return (family_stats_tree_kth(node, n / 2 - 1) +
+          family_stats_tree_kth(node, n / 2)) / 2.0;
+}
+
+static void family_stats_tree_delete(FamilyStatsNode *node)
+{
+  if (!node)
+    return;
+  family_stats_tree_delete(node->left);
+  family_stats_tree_delete(node->right);
+  g_slice_free(FamilyStatsNode, node);
+}
+
+static void family_stats_free_info(void *info)
+{
+  g_slice_free(FLCandInfo, info);
+}
+
+FamilyStats* family_stats_new(void)
+{
+  FamilyStats *fs = g_slice_new(FamilyStats);
+
+  fs->infos = gt_hashmap_new(GT_HASH_DIRECT, NULL, family_stats_free_info);
+  fs->groups = gt_array_new(sizeof (FamilyStatsGroup));
+  fs->size = 0;
+  return fs;
+}
+
+static void family_stats_insert(FamilyStats *fs, FLCandInfo *info)
+{
+  FamilyStatsGroup *group,
+                   empty = {NULL, NULL, 0};
+
+  while (gt_array_size(fs->groups) <= info->num_domains)
+    gt_array_add(fs->groups, empty);
+  group = (FamilyStatsGroup*) gt_array_get(fs->groups, info->num_domains);
+  group->ltr_lengths = family_stats_tree_insert(group->ltr_lengths,
+                                                info->ltr_length);
+  group->elem_lengths = family_stats_tree_insert(group->elem_lengths,
+                                                 info->elem_length);
+  group->size++;
+  fs->size++;
+}
+
+static void family_stats_erase(FamilyStats *fs, FLCandInfo *info)
+{
+  FamilyStatsGroup *group;
+
+  gt_assert(info->num_domains < gt_array_size(fs->groups));
+  group = (FamilyStatsGroup*) gt_array_get(fs->groups, info->num_domains);
+  group->ltr_lengths = family_stats_tree_remove(group->ltr_lengths,
+                                                info->ltr_length);
+  group->elem_lengths = family_stats_tree_remove(group->elem_lengths,
+                                                 info->elem_length);
+  group->size--;
+  fs->size--;
+}
+
+void family_stats_add(FamilyStats *fs, GtGenomeNode *gn)
+{
+  FLCandInfo *info;
+
+  gt_assert(fs && gn);
+  if (gt_hashmap_get(fs->infos, gn))
+    return;
+  info = g_slice_new(FLCandInfo);
+  flcand_get_info(gn, info);
+  gt_hashmap_add(fs->infos, gn, info);
+  family_stats_insert(fs, info);
+}
+
+void family_stats_add_array(FamilyStats *fs, GtArray *nodes)
+{
+  unsigned long i;
+
+  for (i = 0; i < gt_array_size(nodes); i++)
+    family_stats_add(fs, *(GtGenomeNode**) gt_array_get(nodes, i));
+}
+
+void family_stats_remove(FamilyStats *fs, GtGenomeNode *gn)
+{
+  FLCandInfo *info;
+
+  gt_assert(fs && gn);
+  if (!(info = (FLCandInfo*) gt_hashmap_get(fs->infos, gn)))
+    return;
+  family_stats_erase(fs, info);
+  gt_hashmap_remove(fs->infos, gn);
+}
+
+void family_stats_remove_array(FamilyStats *fs, GtArray *nodes)
+{
+  unsigned long i;
+
+  for (i = 0; i < gt_array_size(nodes); i++)
+    family_stats_remove(fs, *(GtGenomeNode**) gt_array_get(nodes, i));
+}
+
+void family_stats_update(FamilyStats *fs, GtGenomeNode *gn)
+{
+  FLCandInfo *info,
+             new_info;
+
+  gt_assert(fs && gn);
+  if (!(info = (FLCandInfo*) gt_hashmap_get(fs->infos, gn)))
+    return;
+  flcand_get_info(gn, &new_info);
+  if (new_info.num_domains == info->num_domains &&
+      new_info.ltr_length == info->ltr_length &&
+      new_info.elem_length == info->elem_length)
+    return;
+  family_stats_erase(fs, info);
+  *info = new_info;
+  family_stats_insert(fs, info);
+}
+
+unsigned long family_stats_size(FamilyStats *fs)
+{
+  gt_assert(fs);
+  return fs->size;
+}
+
+/* candidates without domains never count as full length candidates, so they
+   are left out here */
+static FamilyStatsGroup* family_stats_mode_group(FamilyStats *fs,
+                                                 unsigned long *num_domains)
+{
+  FamilyStatsGroup *group,
+                   *mode = NULL;
+  unsigned long i;
+
+  *num_domains = 0;
+  for (i = 1; i < gt_array_size(fs->groups); i++) {
+    group = (FamilyStatsGroup*) gt_array_get(fs->groups, i);
+    if (group->size > 0 && (!mode || group->size >= mode->size)) {
+      mode = group;
+      *num_domains = i;
+    }
+  }
+  return mode;
+}
+
+unsigned long family_stats_num_domains_mode(FamilyStats *fs,
+                                            unsigned long *count)
+{
+  FamilyStatsGroup *mode;
+  unsigned long num_domains;
+
+  gt_assert(fs);
+  mode = family_stats_mode_group(fs, &num_domains);
+  if (count)
+    *count = mode ? mode->size : 0;
+  return num_domains;
+}
+
+gfloat family_stats_ltr_length_median(FamilyStats *fs)
+{
+  FamilyStatsGroup *mode;
+  unsigned long num_domains;
+
+  gt_assert(fs);
+  mode = family_stats_mode_group(fs, &num_domains);
+  return mode ? family_stats_tree_median(mode->ltr_lengths) : 0.0;
+}
+
+gfloat family_stats_elem_length_median(FamilyStats *fs)
+{
+  FamilyStatsGroup *mode;
+  unsigned long num_domains;
+
+  gt_assert(fs);
+  mode = family_stats_mode_group(fs, &num_domains);
+  return mode ? family_stats_tree_median(mode->elem_lengths) : 0.0;
+}
+
+unsigned long family_stats_select_flcands(FamilyStats *fs, GtArray *nodes,
+                                          gfloat ltrtolerance,
+                                          gfloat lentolerance,
+                                          gboolean *flags)
+{
+  FamilyStatsGroup *mode;
+  FLCandInfo *info;
+  gfloat ltrlen_median,
+         elemlen_median;
+  unsigned long i,
+                num_domains,
+                flcands = 0;
+
+  gt_assert(fs && nodes && flags);
+  for (i = 0; i < gt_array_size(nodes); i++)
+    flags[i] = FALSE;
+  if (!(mode = family_stats_mode_group(fs, &num_domains)))
+    return 0;
+  ltrlen_median = family_stats_tree_median(mode->ltr_lengths);
+  elemlen_median = family_stats_tree_median(mode->elem_lengths);
+
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    info = (FLCandInfo*) gt_hashmap_get(fs->infos,
+                                        *(GtGenomeNode**) gt_array_get(nodes,
+                                                                       i));
+    gt_assert(info);
+    if (info->num_domains == num_domains &&
+        fabsf(info->ltr_length - ltrlen_median) <= ltrtolerance &&
+        fabsf(info->elem_length - elemlen_median) <= lentolerance) {
+      flags[i] = TRUE;
+      flcands++;
+    }
+  }
+  return flcands;
+}
+
+void family_stats_delete(FamilyStats *fs)
+{
+  FamilyStatsGroup *group;
+  unsigned long i;
+
+  if (!fs)
+    return;
+  for (i = 0; i < gt_array_size(fs->groups); i++) {
+    group = (FamilyStatsGroup*) gt_array_get(fs->groups, i);
+    family_stats_tree_delete(group->ltr_lengths);
+    family_stats_tree_delete(group->elem_lengths);
+  }
+  gt_array_delete(fs->groups);
+  gt_hashmap_delete(fs->infos);
+  g_slice_free(FamilyStats, fs);
+}
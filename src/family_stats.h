@@ -0,0 +1,70 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FAMILY_STATS_H
+#define FAMILY_STATS_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <FamilyStats> keeps the numbers used to determine the full length
+   candidates of a family (see flcand.h) up to date while candidates are
+   added and removed: a histogram of the numbers of domains and, for each
+   number of domains, the LTR and element lengths ordered by size. Adding or
+   removing a candidate takes O(log n) time. */
+typedef struct FamilyStats FamilyStats;
+
+FamilyStats*  family_stats_new(void);
+
+/* Adds the candidate <gn>, nothing is done if <gn> was added before. */
+void          family_stats_add(FamilyStats *fs, GtGenomeNode *gn);
+
+void          family_stats_add_array(FamilyStats *fs, GtArray *nodes);
+
+/* Removes the candidate <gn> as it was when it was added, nothing is done
+   if <gn> has not been added. */
+void          family_stats_remove(FamilyStats *fs, GtGenomeNode *gn);
+
+void          family_stats_remove_array(FamilyStats *fs, GtArray *nodes);
+
+/* Updates the statistics after the features of <gn> have been changed. */
+void          family_stats_update(FamilyStats *fs, GtGenomeNode *gn);
+
+unsigned long family_stats_size(FamilyStats *fs);
+
+/* Returns the most frequent number of domains (the larger one on ties) and
+   stores the number of candidates having it in <count>. */
+unsigned long family_stats_num_domains_mode(FamilyStats *fs,
+                                            unsigned long *count);
+
+/* The medians are taken over the candidates with the most frequent number of
+   domains. */
+gfloat        family_stats_ltr_length_median(FamilyStats *fs);
+
+gfloat        family_stats_elem_length_median(FamilyStats *fs);
+
+/* Sets <flags>[i] to TRUE if the i-th candidate of <nodes>, which all have to
+   be added to <fs>, is a full length candidate. Returns the number of full
+   length candidates, the result is the same as of flcand_select(). */
+unsigned long family_stats_select_flcands(FamilyStats *fs, GtArray *nodes,
+                                          gfloat ltrtolerance,
+                                          gfloat lentolerance,
+                                          gboolean *flags);
+
+void          family_stats_delete(FamilyStats *fs);
+
+#endif
@@ -0,0 +1,165 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "filter_cache.h"
+#include "symbols.h"
+
+#define FILTER_CACHE_USER_DATA "filter_cache"
+#define FILTER_CACHE_MAX_ENTRIES 16
+
+typedef struct {
+  const gchar *key;
+  unsigned long version;
+  bool result;
+} FilterCacheEntry;
+
+typedef struct {
+  FilterCacheEntry *entries;
+  unsigned long version;
+  guint num_entries;
+} FilterCacheNode;
+
+/* the entries may be read and written by the filter job and the preview at
+   the same time */
+G_LOCK_DEFINE_STATIC(filter_cache);
+
+static void filter_cache_node_free(void *data)
+{
+  FilterCacheNode *fcn = (FilterCacheNode*) data;
+  g_free(fcn->entries);
+  g_slice_free(FilterCacheNode, fcn);
+}
+
+static FilterCacheNode* filter_cache_get_node(GtGenomeNode *gn)
+{
+  return (FilterCacheNode*) gt_genome_node_get_user_data(gn,
+                                                       FILTER_CACHE_USER_DATA);
+}
+
+void filter_cache_attach(GtGenomeNode *gn)
+{
+  FilterCacheNode *fcn;
+
+  gt_assert(gn);
+  if (filter_cache_get_node(gn))
+    return;
+  fcn = g_slice_new(FilterCacheNode);
+  fcn->entries = NULL;
+  fcn->version = 1;
+  fcn->num_entries = 0;
+  gt_genome_node_add_user_data(gn, FILTER_CACHE_USER_DATA, fcn,
+                               filter_cache_node_free);
+}
+
+void filter_cache_node_changed(GtGenomeNode *gn)
+{
+  FilterCacheNode *fcn;
+
+  gt_assert(gn);
+  if (!(fcn = filter_cache_get_node(gn)))
+    return;
+  G_LOCK(filter_cache);
+  fcn->version++;
+  G_UNLOCK(filter_cache);
+}
+
+unsigned long filter_cache_get_version(GtGenomeNode *gn)
+{
+  FilterCacheNode *fcn;
+  unsigned long version;
+
+  gt_assert(gn);
+  if (!(fcn = filter_cache_get_node(gn)))
+    return 0;
+  G_LOCK(filter_cache);
+  version = fcn->version;
+  G_UNLOCK(filter_cache);
+  return version;
+}
+
+const gchar* filter_cache_key(const gchar *filename, GtError *err)
+{
+  GError *gerr = NULL;
+  gchar *contents,
+        *checksum;
+  const gchar *key;
+  gsize length;
+
+  gt_error_check(err);
+  gt_assert(filename);
+  if (!g_file_get_contents(filename, &contents, &length, &gerr)) {
+    gt_error_set(err, "Could not read filter file: %s", gerr->message);
+    g_error_free(gerr);
+    return NULL;
+  }
+  checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA1, (guchar*) contents,
+                                         length);
+  key = symbols_intern(checksum);
+  g_free(checksum);
+  g_free(contents);
+  return key;
+}
+
+gboolean filter_cache_lookup(GtGenomeNode *gn, const gchar *key, bool *result)
+{
+  FilterCacheNode *fcn;
+  gboolean found = FALSE;
+  guint i;
+
+  gt_assert(gn && key && result);
+  if (!(fcn = filter_cache_get_node(gn)))
+    return FALSE;
+  G_LOCK(filter_cache);
+  for (i = 0; i < fcn->num_entries; i++) {
+    if (fcn->entries[i].key == key) {
+      if (fcn->entries[i].version == fcn->version) {
+        *result = fcn->entries[i].result;
+        found = TRUE;
+      }
+      break;
+    }
+  }
+  G_UNLOCK(filter_cache);
+  return found;
+}
+
+void filter_cache_store(GtGenomeNode *gn, const gchar *key, bool result)
+{
+  FilterCacheNode *fcn;
+  guint i;
+
+  gt_assert(gn && key);
+  if (!(fcn = filter_cache_get_node(gn)))
+    return;
+  G_LOCK(filter_cache);
+  for (i = 0; i < fcn->num_entries; i++) {
+    if (fcn->entries[i].key == key)
+      break;
+  }
+  /* a candidate is usually filtered with a handful of filters only, the
+     results of filters which have been edited too often are dropped */
+  if (i == FILTER_CACHE_MAX_ENTRIES)
+    i = fcn->num_entries = 0;
+  if (i == fcn->num_entries) {
+    fcn->num_entries++;
+    fcn->entries = g_renew(FilterCacheEntry, fcn->entries, fcn->num_entries);
+    fcn->entries[i].key = key;
+  }
+  fcn->entries[i].version = fcn->version;
+  fcn->entries[i].result = result;
+  G_UNLOCK(filter_cache);
+}
@@ -0,0 +1,57 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FILTER_CACHE_H
+#define FILTER_CACHE_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* The results of the script filters are cached at the candidates, so that
+   applying the same filters again only runs them on the candidates which
+   have changed since. A result is valid as long as the contents of the filter
+   file (given by its key) and the version of the candidate are the same.
+   The version of a candidate has to be increased whenever its features or
+   attributes change. Results of filters looking at anything else than the
+   candidate itself (e.g. other files) are cached all the same. */
+
+/* Prepares the candidate <gn> (a top level node) to keep filter results.
+   Must be called by the thread owning <gn> before it can be filtered from
+   another thread, results for candidates without it are not cached. */
+void          filter_cache_attach(GtGenomeNode *gn);
+
+/* Increases the version of the candidate <gn>, which outdates all of its
+   cached results. */
+void          filter_cache_node_changed(GtGenomeNode *gn);
+
+/* Returns the version of the candidate <gn>, 0 if it keeps no results. */
+unsigned long filter_cache_get_version(GtGenomeNode *gn);
+
+/* Returns the key of the filter file <filename>, a checksum of its contents.
+   Keys are interned and can be compared with ==. Returns NULL and sets <err>
+   if the file cannot be read. */
+const gchar*  filter_cache_key(const gchar *filename, GtError *err);
+
+/* Sets <result> to the cached result of the filter with <key> for <gn> and
+   returns TRUE, or returns FALSE if there is no valid result. */
+gboolean      filter_cache_lookup(GtGenomeNode *gn, const gchar *key,
+                                  bool *result);
+
+void          filter_cache_store(GtGenomeNode *gn, const gchar *key,
+                                 bool result);
+
+#endif
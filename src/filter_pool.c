@@ -0,0 +1,165 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <glib/gstdio.h>
+#include "filter_cache.h"
+#include "filter_pool.h"
+
+typedef struct {
+  FilterScript script;
+  gchar *filename;
+  time_t mtime;
+  goffset size;
+  bool in_use,
+       pooled;
+} FilterPoolEntry;
+
+/* maps the file names to the loaded scripts */
+static GtHashmap *filter_pool = NULL;
+G_LOCK_DEFINE_STATIC(filter_pool);
+
+static void filter_pool_entry_delete(FilterPoolEntry *entry)
+{
+  if (entry->script.script_filter)
+    gt_script_filter_delete(entry->script.script_filter);
+  batch_filter_delete(entry->script.batch_filter);
+  g_free(entry->filename);
+  g_slice_free(FilterPoolEntry, entry);
+}
+
+static FilterPoolEntry* filter_pool_entry_new(const gchar *filename,
+                                              const GStatBuf *statbuf,
+                                              GtError *err)
+{
+  FilterPoolEntry *entry;
+  GtScriptFilter *sf = NULL;
+  BatchFilter *bf = NULL;
+  const gchar *key;
+
+  if ((key = filter_cache_key(filename, err)) &&
+      !(bf = batch_filter_new(filename, err)) && !gt_error_is_set(err))
+    sf = gt_script_filter_new(filename, err);
+  if (!sf && !bf)
+    return NULL;
+  entry = g_slice_new(FilterPoolEntry);
+  entry->script.script_filter = sf;
+  entry->script.batch_filter = bf;
+  entry->script.key = key;
+  entry->filename = g_strdup(filename);
+  entry->mtime = statbuf->st_mtime;
+  entry->size = (goffset) statbuf->st_size;
+  entry->in_use = true;
+  entry->pooled = false;
+  return entry;
+}
+
+/* removes <entry> from the pool, it is deleted when it is no longer used;
+   the pool must be locked */
+static void filter_pool_drop(FilterPoolEntry *entry)
+{
+  gt_hashmap_remove(filter_pool, entry->filename);
+  entry->pooled = false;
+  if (!entry->in_use)
+    filter_pool_entry_delete(entry);
+}
+
+FilterScript* filter_pool_acquire(const gchar *filename, GtError *err)
+{
+  FilterPoolEntry *entry = NULL;
+  GStatBuf statbuf;
+  const gchar *key = NULL;
+  bool changed = false;
+
+  gt_error_check(err);
+  gt_assert(filename);
+  if (g_stat(filename, &statbuf) != 0) {
+    gt_error_set(err, "Could not access %s: %s", filename, g_strerror(errno));
+    return NULL;
+  }
+  G_LOCK(filter_pool);
+  if (!filter_pool)
+    filter_pool = gt_hashmap_new(GT_HASH_STRING, NULL, NULL);
+  entry = (FilterPoolEntry*) gt_hashmap_get(filter_pool, filename);
+  if (entry && !entry->in_use) {
+    changed = (entry->mtime != statbuf.st_mtime ||
+               entry->size != (goffset) statbuf.st_size);
+    entry->in_use = true;
+  } else
+    entry = NULL;
+  G_UNLOCK(filter_pool);
+
+  /* a file which has only been touched keeps its script */
+  if (entry && changed) {
+    if (!(key = filter_cache_key(filename, err))) {
+      filter_pool_release(&entry->script);
+      return NULL;
+    }
+    if (key == entry->script.key) {
+      entry->mtime = statbuf.st_mtime;
+      entry->size = (goffset) statbuf.st_size;
+    } else {
+      G_LOCK(filter_pool);
+      filter_pool_drop(entry);
+      G_UNLOCK(filter_pool);
+      filter_pool_release(&entry->script);
+      entry = NULL;
+    }
+  }
+  if (entry)
+    return &entry->script;
+
+  if (!(entry = filter_pool_entry_new(filename, &statbuf, err)))
+    return NULL;
+  G_LOCK(filter_pool);
+  if (!gt_hashmap_get(filter_pool, filename)) {
+    gt_hashmap_add(filter_pool, entry->filename, entry);
+    entry->pooled = true;
+  }
+  G_UNLOCK(filter_pool);
+  return &entry->script;
+}
+
+void filter_pool_release(FilterScript *fs)
+{
+  FilterPoolEntry *entry = (FilterPoolEntry*) fs;
+  bool delete;
+
+  if (!fs)
+    return;
+  /* the candidates of the finished run are not kept alive by the script */
+  if (fs->batch_filter)
+    batch_filter_collect(fs->batch_filter);
+  G_LOCK(filter_pool);
+  entry->in_use = false;
+  delete = !entry->pooled;
+  G_UNLOCK(filter_pool);
+  if (delete)
+    filter_pool_entry_delete(entry);
+}
+
+void filter_pool_invalidate(const gchar *filename)
+{
+  FilterPoolEntry *entry;
+
+  gt_assert(filename);
+  G_LOCK(filter_pool);
+  if (filter_pool &&
+      (entry = (FilterPoolEntry*) gt_hashmap_get(filter_pool, filename)))
+    filter_pool_drop(entry);
+  G_UNLOCK(filter_pool);
+}
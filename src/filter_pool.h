@@ -0,0 +1,49 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FILTER_POOL_H
+#define FILTER_POOL_H
+
+#include <glib.h>
+#include "batch_filter.h"
+#include "genometools.h"
+
+/* A filter script loaded and compiled, ready to be run. It is loaded once,
+   as a batch filter if LTRsift supports these, else as a script filter. */
+typedef struct {
+  GtScriptFilter *script_filter;  /* NULL if loaded as a batch filter */
+  BatchFilter *batch_filter;      /* NULL if loaded as a script filter */
+  const gchar *key;            /* see filter_cache_key() */
+} FilterScript;
+
+/* The filter scripts are kept loaded for the whole session, so that applying
+   filters again does not parse and compile their files again. A loaded
+   script is used as long as its file has the same modification time and
+   size, or, if these have changed, the same contents. */
+
+/* Returns the loaded filter script <filename> for the exclusive use of the
+   caller until it is given back with filter_pool_release(). If the script
+   is in use elsewhere (e.g. by another thread), a copy of it is loaded.
+   Returns NULL and sets <err> if the script cannot be loaded. */
+FilterScript* filter_pool_acquire(const gchar *filename, GtError *err);
+
+void          filter_pool_release(FilterScript *fs);
+
+/* Drops the loaded script <filename>, which has been changed. */
+void          filter_pool_invalidate(const gchar *filename);
+
+#endif
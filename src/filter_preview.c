@@ -0,0 +1,222 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "filter_preview.h"
+#include "message_strings.h"
+#include "script_filter_stream.h"
+#include "symbols.h"
+
+/* the candidates counted in one call from the main loop, few enough to keep
+   the windows responsive */
+#define FILTER_PREVIEW_CHUNK_SIZE 50
+
+typedef struct FilterPreviewJob FilterPreviewJob;
+
+struct FilterPreview {
+  FilterPreviewJob *job;  /* the running count, NULL if there is none */
+  FilterPreviewReadyFunc ready;
+  gpointer data;
+};
+
+struct FilterPreviewJob {
+  GtArray *nodes,
+          *node_families,
+          *families,
+          *chunk,
+          *selected;
+  GtNodeStream *select;  /* NULL if the filters could not be loaded */
+  GtBittab *negate;
+  GtError *err;
+  unsigned long matches,
+                next;
+  guint source;
+};
+
+static void filter_preview_job_delete(FilterPreviewJob *job)
+{
+  unsigned long i;
+
+  for (i = 0; i < gt_array_size(job->nodes); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(job->nodes, i));
+  gt_array_delete(job->nodes);
+  gt_array_delete(job->node_families);
+  gt_array_delete(job->families);
+  gt_array_delete(job->chunk);
+  gt_array_delete(job->selected);
+  /* the scripts go back to the filter pool */
+  gt_node_stream_delete(job->select);
+  gt_bittab_delete(job->negate);
+  gt_error_delete(job->err);
+  g_slice_free(FilterPreviewJob, job);
+}
+
+static int filter_preview_count_cmp(const void *a, const void *b)
+{
+  const FilterPreviewCount *ca = (const FilterPreviewCount*) a,
+                           *cb = (const FilterPreviewCount*) b;
+
+  return strcmp(ca->family, cb->family);
+}
+
+/* <selected> holds the matching candidates in the order of the job */
+static void filter_preview_count(FilterPreviewJob *job, GtArray *selected)
+{
+  GtHashmap *index;
+  FilterPreviewCount count,
+                     *cur;
+  GtGenomeNode *gn;
+  const gchar *family;
+  gpointer pos;
+  unsigned long i, j;
+
+  /* the families are kept by their position + 1 */
+  index = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  for (i = j = 0; i < gt_array_size(job->nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(job->nodes, i);
+    family = *(const gchar**) gt_array_get(job->node_families, i);
+    if (!(pos = gt_hashmap_get(index, family))) {
+      count.family = family;
+      count.matches = count.total = 0;
+      gt_array_add(job->families, count);
+      pos = GSIZE_TO_POINTER(gt_array_size(job->families));
+      gt_hashmap_add(index, (gpointer) family, pos);
+    }
+    cur = (FilterPreviewCount*) gt_array_get(job->families,
+                                             GPOINTER_TO_SIZE(pos) - 1);
+    cur->total++;
+    if (j < gt_array_size(selected) &&
+        *(GtGenomeNode**) gt_array_get(selected, j) == gn) {
+      cur->matches++;
+      job->matches++;
+      j++;
+    }
+  }
+  gt_hashmap_delete(index);
+  if (gt_array_size(job->families) > 0)
+    qsort(gt_array_get_space(job->families), gt_array_size(job->families),
+          sizeof (FilterPreviewCount), filter_preview_count_cmp);
+}
+
+/* filters the next candidates of the running count, the count is finished
+   after the last of them */
+static gboolean filter_preview_job_step(gpointer data)
+{
+  FilterPreview *fp = (FilterPreview*) data;
+  FilterPreviewJob *job = fp->job;
+  unsigned long last;
+  int had_err;
+
+  gt_assert(job);
+  had_err = job->select ? 0 : -1;
+  if (!had_err) {
+    last = MIN(job->next + FILTER_PREVIEW_CHUNK_SIZE,
+               gt_array_size(job->nodes));
+    gt_array_reset(job->chunk);
+    for (; job->next < last; job->next++)
+      gt_array_add(job->chunk,
+                   *(GtGenomeNode**) gt_array_get(job->nodes, job->next));
+    had_err = ltrgui_script_filter_select(job->select, job->chunk,
+                                          job->selected, job->err);
+  }
+  if (!had_err && job->next < gt_array_size(job->nodes))
+    return TRUE;
+  if (!had_err)
+    filter_preview_count(job, job->selected);
+  /* the ready function may start the next count, which can use the scripts
+     of this one then */
+  gt_node_stream_delete(job->select);
+  job->select = NULL;
+  fp->job = NULL;
+  fp->ready(job->matches, gt_array_size(job->nodes), job->families,
+            had_err ? job->err : NULL, fp->data);
+  filter_preview_job_delete(job);
+  return FALSE;
+}
+
+FilterPreview* filter_preview_new(FilterPreviewReadyFunc ready, gpointer data)
+{
+  FilterPreview *fp = g_slice_new(FilterPreview);
+
+  gt_assert(ready);
+  fp->job = NULL;
+  fp->ready = ready;
+  fp->data = data;
+  return fp;
+}
+
+void filter_preview_start(FilterPreview *fp, GtArray *nodes,
+                          GtStrArray *filter_files, GtBittab *negate,
+                          int logic)
+{
+  FilterPreviewJob *job;
+  GtGenomeNode *gn;
+  GtFeatureNode *fn;
+  const gchar *family;
+  unsigned long i;
+
+  gt_assert(fp && nodes && filter_files && negate);
+  filter_preview_stop(fp);
+  job = g_slice_new(FilterPreviewJob);
+  job->nodes = gt_array_new(sizeof (GtGenomeNode*));
+  job->node_families = gt_array_new(sizeof (const gchar*));
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+    fn = gt_feature_node_try_cast(gn);
+    family = fn ? gt_feature_node_get_attribute(fn, ATTR_LTRFAM) : NULL;
+    family = symbols_intern(family ? family : "");
+    gt_array_add(job->nodes, gn);
+    gt_array_add(job->node_families, family);
+    (void) gt_genome_node_ref(gn);
+  }
+  job->families = gt_array_new(sizeof (FilterPreviewCount));
+  job->chunk = gt_array_new(sizeof (GtGenomeNode*));
+  job->selected = gt_array_new(sizeof (GtGenomeNode*));
+  job->negate = gt_bittab_new(gt_bittab_size(negate));
+  for (i = 0; i < gt_bittab_size(negate); i++) {
+    if (gt_bittab_bit_is_set(negate, i))
+      gt_bittab_set_bit(job->negate, i);
+  }
+  job->err = gt_error_new();
+  /* the scripts are loaded once for all chunks, an error is reported when
+     the count has finished */
+  job->select = ltrgui_script_filter_select_new(filter_files, job->negate,
+                                                logic, job->err);
+  job->matches = 0;
+  job->next = 0;
+  fp->job = job;
+  job->source = g_idle_add(filter_preview_job_step, fp);
+}
+
+void filter_preview_stop(FilterPreview *fp)
+{
+  gt_assert(fp);
+  if (!fp->job)
+    return;
+  g_source_remove(fp->job->source);
+  filter_preview_job_delete(fp->job);
+  fp->job = NULL;
+}
+
+void filter_preview_delete(FilterPreview *fp)
+{
+  if (!fp)
+    return;
+  filter_preview_stop(fp);
+  g_slice_free(FilterPreview, fp);
+}
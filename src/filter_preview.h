@@ -0,0 +1,64 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FILTER_PREVIEW_H
+#define FILTER_PREVIEW_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <FilterPreview> counts how many candidates a combination of script
+   filters selects, a few candidates at a time whenever the main loop is
+   idle and without changing the candidates. Starting a new count cancels
+   the one running. The filter results are cached at the candidates, so that
+   the filters are not run again when the filtering is applied afterwards.
+   It must only be used from the main thread. */
+typedef struct FilterPreview FilterPreview;
+
+typedef struct {
+  const gchar *family;  /* interned, "" for unclassified candidates */
+  unsigned long matches,
+                total;
+} FilterPreviewCount;
+
+/* Called from the main loop when the last started count has finished. The
+   counts per family are given in <families> ordered by their names, if
+   <err> is set the candidates could not be filtered. */
+typedef void (*FilterPreviewReadyFunc)(unsigned long matches,
+                                       unsigned long total,
+                                       GtArray *families, GtError *err,
+                                       gpointer data);
+
+FilterPreview* filter_preview_new(FilterPreviewReadyFunc ready,
+                                  gpointer data);
+
+/* Starts counting which of the candidates in <nodes> are selected by the
+   filters in <filter_files> (inverted as given by <negate>) combined by
+   <logic>, see <ltrgui_script_filter_stream_new()>. <nodes> is copied, the
+   candidates and the loaded filter scripts are kept until the count has
+   finished or has been stopped. The candidates
+   must not be changed before the count has finished or has been stopped. */
+void           filter_preview_start(FilterPreview *fp, GtArray *nodes,
+                                    GtStrArray *filter_files,
+                                    GtBittab *negate, int logic);
+
+/* Cancels the running count, no candidate is filtered by it anymore. */
+void           filter_preview_stop(FilterPreview *fp);
+
+void           filter_preview_delete(FilterPreview *fp);
+
+#endif
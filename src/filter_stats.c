@@ -0,0 +1,64 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "filter_stats.h"
+#include "genometools.h"
+
+/* the statistics are kept for the whole session, filters which have been
+   edited are counted as new filters */
+static GtHashmap *filter_stats = NULL;
+G_LOCK_DEFINE_STATIC(filter_stats);
+
+static void filter_stats_free(void *data)
+{
+  g_slice_free(FilterStats, data);
+}
+
+void filter_stats_add(const gchar *key, const FilterStats *stats)
+{
+  FilterStats *total;
+
+  gt_assert(key && stats);
+  G_LOCK(filter_stats);
+  if (!filter_stats)
+    filter_stats = gt_hashmap_new(GT_HASH_DIRECT, NULL, filter_stats_free);
+  if (!(total = (FilterStats*) gt_hashmap_get(filter_stats, (void*) key))) {
+    total = g_slice_new0(FilterStats);
+    gt_hashmap_add(filter_stats, (void*) key, total);
+  }
+  total->runs += stats->runs;
+  total->passes += stats->passes;
+  total->seconds += stats->seconds;
+  G_UNLOCK(filter_stats);
+}
+
+void filter_stats_get(const gchar *key, FilterStats *stats)
+{
+  FilterStats *total = NULL;
+
+  gt_assert(key && stats);
+  G_LOCK(filter_stats);
+  if (filter_stats)
+    total = (FilterStats*) gt_hashmap_get(filter_stats, (void*) key);
+  if (total)
+    *stats = *total;
+  else {
+    stats->runs = stats->passes = 0;
+    stats->seconds = 0.0;
+  }
+  G_UNLOCK(filter_stats);
+}
@@ -0,0 +1,40 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FILTER_STATS_H
+#define FILTER_STATS_H
+
+#include <glib.h>
+
+/* The statistics of a script filter collected during a session: how often it
+   has been run on a candidate, how often the candidate passed (before
+   inverting the result) and the time spent running it. */
+typedef struct {
+  unsigned long runs,
+                passes;
+  double seconds;
+} FilterStats;
+
+/* Adds <stats> to the statistics of the filter with <key> (as returned by
+   filter_cache_key()). Can be called from any thread. */
+void filter_stats_add(const gchar *key, const FilterStats *stats);
+
+/* Sets <stats> to the statistics of the filter with <key>, which are all 0 if
+   it has not been run yet. */
+void filter_stats_get(const gchar *key, FilterStats *stats);
+
+#endif
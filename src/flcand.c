@@ -0,0 +1,320 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include "filter_cache.h"
+#include "flcand.h"
+#include "message_strings.h"
+#include "support.h"
+#include "symbols.h"
+
+typedef struct {
+  GtArray *nodes;
+  gboolean *flags;
+} FLCandFamily;
+
+struct FLCandBatch {
+  GtArray *families;
+  GMutex *mutex;
+  unsigned long *progress,
+                size;
+  gfloat ltrtolerance,
+         lentolerance;
+};
+
+/* collects everything needed for the selection in one walk over the
+   candidate */
+void flcand_get_info(GtGenomeNode *gn, FLCandInfo *info)
+{
+  GtFeatureNode *curnode;
+  GtFeatureNodeIterator *fni;
+  FeatureSymbol sym;
+
+  info->num_domains = 0;
+  info->ltr_length = info->elem_length = 0.0;
+  fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
+  while ((curnode = gt_feature_node_iterator_next(fni))) {
+    sym = symbols_feature_type(curnode);
+    if (sym == SYMBOL_LTRRETRO) {
+      info->num_domains = gt_feature_node_number_of_children(curnode);
+      info->elem_length =
+                  (gfloat) gt_genome_node_get_length((GtGenomeNode*) curnode);
+    } else if (sym == SYMBOL_LTR) {
+      info->ltr_length =
+                  (gfloat) gt_genome_node_get_length((GtGenomeNode*) curnode);
+      break;
+    }
+  }
+  gt_feature_node_iterator_delete(fni);
+}
+
+/* returns the <k>-th smallest of the <n> <values>, which are reordered so
+   that no value before position <k> is larger */
+static gfloat flcand_select_kth(gfloat *values, glong n, glong k)
+{
+  glong left = 0,
+        right = n - 1,
+        i, j;
+  gfloat pivot,
+         tmp;
+
+  while (left < right) {
+    pivot = values[left + (right - left) / 2];
+    i = left;
+    j = right;
+    do {
+      while (values[i] < pivot)
+        i++;
+      while (pivot < values[j])
+        j--;
+      if (i <= j) {
+        tmp = values[i];
+        values[i] = values[j];
+        values[j] = tmp;
+        i++;
+        j--;
+      }
+    } while (i <= j);
+    if (k <= j)
+      right = j;
+    else if (k >= i)
+      left = i;
+    else
+      break;
+  }
+  return values[k];
+}
+
+static gfloat flcand_median(gfloat *values, glong n)
+{
+  gfloat upper,
+         lower;
+  glong i;
+
+  upper = flcand_select_kth(values, n, n / 2);
+  if (n % 2 != 0)
+    return upper;
+  /* the lower middle value is the largest value before the upper one */
+  lower = values[0];
+  for (i = 1; i < n / 2; i++) {
+    if (values[i] > lower)
+      lower = values[i];
+  }
+  return (lower + upper) / 2.0;
+}
+
+unsigned long flcand_select(GtArray *nodes, gfloat ltrtolerance,
+                            gfloat lentolerance, gboolean *flags)
+{
+  GtGenomeNode *gn;
+  FLCandInfo *infos;
+  gfloat *ltr_lengths,
+         *elem_lengths,
+         ltrlen_median,
+         elemlen_median;
+  unsigned long i,
+                n = gt_array_size(nodes),
+                *num_domains_freq,
+                max_num_domains = 0,
+                most_freq_num_domains = 0,
+                mode_size = 0,
+                flcands = 0;
+
+  for (i = 0; i < n; i++)
+    flags[i] = FALSE;
+  if (n == 0)
+    return 0;
+
+  infos = g_malloc(n * sizeof (FLCandInfo));
+  for (i = 0; i < n; i++) {
+    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+    flcand_get_info(gn, &infos[i]);
+    if (infos[i].num_domains > max_num_domains)
+      max_num_domains = infos[i].num_domains;
+  }
+
+  /* on ties the larger number of domains wins */
+  num_domains_freq = g_malloc0((max_num_domains + 1) * sizeof (unsigned long));
+  for (i = 0; i < n; i++)
+    num_domains_freq[infos[i].num_domains]++;
+  for (i = 1; i <= max_num_domains; i++) {
+    if (num_domains_freq[i] >= mode_size) {
+      most_freq_num_domains = i;
+      mode_size = num_domains_freq[i];
+    }
+  }
+  g_free(num_domains_freq);
+  if (mode_size == 0) {
+    g_free(infos);
+    return 0;
+  }
+
+  ltr_lengths = g_malloc(mode_size * sizeof (gfloat));
+  elem_lengths = g_malloc(mode_size * sizeof (gfloat));
+  mode_size = 0;
+  for (i = 0; i < n; i++) {
+    if (infos[i].num_domains == most_freq_num_domains) {
+      ltr_lengths[mode_size] = infos[i].ltr_length;
+      elem_lengths[mode_size] = infos[i].elem_length;
+      mode_size++;
+    }
+  }
+  ltrlen_median = flcand_median(ltr_lengths, (glong) mode_size);
+  elemlen_median = flcand_median(elem_lengths, (glong) mode_size);
+
+  for (i = 0; i < n; i++) {
+    if (infos[i].num_domains == most_freq_num_domains &&
+        fabsf(infos[i].ltr_length - ltrlen_median) <= ltrtolerance &&
+        fabsf(infos[i].elem_length - elemlen_median) <= lentolerance) {
+      flags[i] = TRUE;
+      flcands++;
+    }
+  }
+
+  g_free(elem_lengths);
+  g_free(ltr_lengths);
+  g_free(infos);
+  return flcands;
+}
+
+gboolean flcand_set(GtGenomeNode *gn, gboolean flcand)
+{
+  GtFeatureNode *fn = (GtFeatureNode*) gn;
+  gboolean marked;
+
+  /* the mark is kept at the top level feature */
+  marked = (gt_feature_node_get_attribute(fn, ATTR_FULLLEN) != NULL);
+  if (flcand == marked)
+    return FALSE;
+  if (flcand)
+    gt_feature_node_set_attribute(fn, ATTR_FULLLEN, "yes");
+  else
+    gt_feature_node_remove_attribute(fn, ATTR_FULLLEN);
+  filter_cache_node_changed(gn);
+  return TRUE;
+}
+
+FLCandBatch* flcand_batch_new(gfloat ltrtolerance, gfloat lentolerance)
+{
+  FLCandBatch *batch = g_slice_new(FLCandBatch);
+
+  batch->families = gt_array_new(sizeof (FLCandFamily));
+  batch->mutex = NULL;
+  batch->progress = NULL;
+  batch->size = 0;
+  batch->ltrtolerance = ltrtolerance;
+  batch->lentolerance = lentolerance;
+  return batch;
+}
+
+void flcand_batch_add(FLCandBatch *batch, GtArray *nodes)
+{
+  FLCandFamily family;
+
+  gt_assert(batch && nodes);
+  family.nodes = snapshot_node_array(nodes);
+  family.flags = g_malloc0(MAX(gt_array_size(nodes), 1) * sizeof (gboolean));
+  gt_array_add(batch->families, family);
+  batch->size += gt_array_size(nodes);
+}
+
+unsigned long flcand_batch_size(FLCandBatch *batch)
+{
+  gt_assert(batch);
+  return batch->size;
+}
+
+static void flcand_batch_worker(gpointer data, gpointer user_data)
+{
+  FLCandFamily *family = (FLCandFamily*) data;
+  FLCandBatch *batch = (FLCandBatch*) user_data;
+
+  (void) flcand_select(family->nodes, batch->ltrtolerance,
+                       batch->lentolerance, family->flags);
+  g_mutex_lock(batch->mutex);
+  if (batch->progress)
+    *batch->progress += gt_array_size(family->nodes);
+  g_mutex_unlock(batch->mutex);
+}
+
+void flcand_batch_run(FLCandBatch *batch, guint num_threads,
+                      unsigned long *progress)
+{
+  GThreadPool *pool = NULL;
+  GError *gerr = NULL;
+  unsigned long i;
+
+  gt_assert(batch && !batch->mutex);
+  batch->progress = progress;
+  batch->mutex = g_mutex_new();
+  if (num_threads > 1) {
+    pool = g_thread_pool_new(flcand_batch_worker, batch, (gint) num_threads,
+                             TRUE, &gerr);
+    /* without threads the families are simply handled one after another */
+    if (!pool)
+      g_error_free(gerr);
+  }
+  for (i = 0; i < gt_array_size(batch->families); i++) {
+    if (pool)
+      g_thread_pool_push(pool, gt_array_get(batch->families, i), NULL);
+    else
+      flcand_batch_worker(gt_array_get(batch->families, i), batch);
+  }
+  if (pool)
+    g_thread_pool_free(pool, FALSE, TRUE);
+  g_mutex_free(batch->mutex);
+  batch->mutex = NULL;
+  batch->progress = NULL;
+}
+
+unsigned long flcand_batch_apply(FLCandBatch *batch, FLCandChangedFunc func,
+                                 gpointer data)
+{
+  FLCandFamily *family;
+  GtGenomeNode *gn;
+  unsigned long i, j,
+                flcands = 0;
+
+  gt_assert(batch);
+  for (i = 0; i < gt_array_size(batch->families); i++) {
+    family = (FLCandFamily*) gt_array_get(batch->families, i);
+    for (j = 0; j < gt_array_size(family->nodes); j++) {
+      gn = *(GtGenomeNode**) gt_array_get(family->nodes, j);
+      if (flcand_set(gn, family->flags[j]) && func)
+        func(gn, data);
+      if (family->flags[j])
+        flcands++;
+    }
+  }
+  return flcands;
+}
+
+void flcand_batch_delete(FLCandBatch *batch)
+{
+  FLCandFamily *family;
+  unsigned long i;
+
+  if (!batch)
+    return;
+  for (i = 0; i < gt_array_size(batch->families); i++) {
+    family = (FLCandFamily*) gt_array_get(batch->families, i);
+    snapshot_node_array_delete(family->nodes);
+    g_free(family->flags);
+  }
+  gt_array_delete(batch->families);
+  g_slice_free(FLCandBatch, batch);
+}
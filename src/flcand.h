@@ -0,0 +1,77 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FLCAND_H
+#define FLCAND_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* Full length candidates of a family are the candidates with the most
+   frequent number of domains whose LTR and element lengths deviate from the
+   medians of those candidates by at most the given tolerances. */
+
+typedef struct {
+  unsigned long num_domains;
+  gfloat ltr_length,
+         elem_length;
+} FLCandInfo;
+
+/* Stores the number of domains and the LTR and element lengths of the
+   candidate <gn> in <info>, candidates without LTR retrotransposon have no
+   domains. */
+void          flcand_get_info(GtGenomeNode *gn, FLCandInfo *info);
+
+/* Sets <flags>[i] to TRUE if the i-th candidate of <nodes> is a full length
+   candidate and returns the number of full length candidates. The nodes are
+   only read, so several families can be handled at once. */
+unsigned long flcand_select(GtArray *nodes, gfloat ltrtolerance,
+                            gfloat lentolerance, gboolean *flags);
+
+/* Marks (or unmarks) the candidate <gn> as full length candidate. Returns
+   TRUE if the mark was changed. */
+gboolean      flcand_set(GtGenomeNode *gn, gboolean flcand);
+
+/* <FLCandBatch> determines the full length candidates of several families in
+   parallel. The marks are only set by flcand_batch_apply(), which is meant
+   to be called from the thread owning the candidates. */
+typedef struct FLCandBatch FLCandBatch;
+
+typedef void (*FLCandChangedFunc)(GtGenomeNode *gn, gpointer data);
+
+FLCandBatch*  flcand_batch_new(gfloat ltrtolerance, gfloat lentolerance);
+
+/* Adds the family <nodes>, which are referenced by <batch>. */
+void          flcand_batch_add(FLCandBatch *batch, GtArray *nodes);
+
+/* Returns the number of candidates added to <batch>. */
+unsigned long flcand_batch_size(FLCandBatch *batch);
+
+/* Selects the full length candidates of all families with <num_threads>
+   threads, <progress> is increased by the number of candidates handled. */
+void          flcand_batch_run(FLCandBatch *batch, guint num_threads,
+                               unsigned long *progress);
+
+/* Marks the candidates selected by flcand_batch_run() and calls <func> for
+   every candidate whose mark was changed. Returns the number of full length
+   candidates. */
+unsigned long flcand_batch_apply(FLCandBatch *batch, FLCandChangedFunc func,
+                                 gpointer data);
+
+void          flcand_batch_delete(FLCandBatch *batch);
+
+#endif
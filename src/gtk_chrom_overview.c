@@ -0,0 +1,633 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include "bgzf.h"
+#include "gtk_chrom_overview.h"
+#include "message_strings.h"
+#include "symbols.h"
+
+#define OVERVIEW_RULER_HEIGHT    18
+#define OVERVIEW_TILE_HEIGHT     120
+/* up to this zoom level the diagram of the loaded candidates is shown */
+#define OVERVIEW_DIAGRAM_LEVEL   3
+/* missing tiles are replaced by tiles of up to this many levels above */
+#define OVERVIEW_FALLBACK_LEVELS 6
+#define OVERVIEW_MAX_TILES       192
+/* ticks of the ruler are at least this many pixels apart */
+#define OVERVIEW_TICK_DISTANCE   100
+
+static unsigned long overview_length(GtkChromOverview *overview)
+{
+  if (!overview->co || !overview->seqid)
+    return 0;
+  return chrom_overview_get_length(overview->co, overview->seqid);
+}
+
+/* returns the level at which the whole sequence fits into the area */
+static guint overview_max_level(GtkChromOverview *overview)
+{
+  unsigned long length = overview_length(overview),
+                width = MAX(overview->area->allocation.width, 1);
+  guint level = 0;
+
+  while (level < CHROM_OVERVIEW_MAX_LEVEL && (length >> level) > width)
+    level++;
+  return level;
+}
+
+static void overview_update_range(GtkChromOverview *overview)
+{
+  unsigned long bpp = 1UL << overview->level,
+                length = overview_length(overview),
+                start, end;
+  gchar text[BUFSIZ];
+
+  if (!overview->seqid) {
+    gtk_label_set_text(GTK_LABEL(overview->range), "");
+    return;
+  }
+  start = MIN(overview->offset * bpp + 1, length);
+  end = MIN((overview->offset + overview->area->allocation.width) * bpp,
+            length);
+  g_snprintf(text, BUFSIZ, OVERVIEW_RANGE, overview->seqid, start, end,
+             chrom_overview_num_candidates(overview->co, overview->seqid));
+  gtk_label_set_text(GTK_LABEL(overview->range), text);
+}
+
+static void overview_clamp(GtkChromOverview *overview)
+{
+  unsigned long bpp;
+  glong maxoffset;
+
+  overview->level = MIN(overview->level, overview_max_level(overview));
+  bpp = 1UL << overview->level;
+  maxoffset = (glong) ((overview_length(overview) + bpp - 1) / bpp) -
+              overview->area->allocation.width;
+  overview->offset = CLAMP(overview->offset, 0, MAX(maxoffset, 0));
+}
+
+/* changes the zoom level, keeping the position under <x> in place */
+static void overview_set_level(GtkChromOverview *overview, guint level,
+                               gdouble x)
+{
+  gdouble pos;
+
+  pos = ((gdouble) overview->offset + x) * (1UL << overview->level);
+  overview->offset = (glong) (pos / (1UL << level) - x);
+  if (level != overview->level) {
+    overview->level = level;
+    chrom_tiles_new_view(overview->tiles);
+  }
+  overview_clamp(overview);
+  overview_update_range(overview);
+  gtk_widget_queue_draw(overview->area);
+}
+
+static void overview_show_all(GtkChromOverview *overview)
+{
+  overview->level = overview_max_level(overview);
+  overview->offset = 0;
+  chrom_tiles_new_view(overview->tiles);
+  overview_clamp(overview);
+  overview_update_range(overview);
+  gtk_widget_queue_draw(overview->area);
+}
+
+/* takes a new snapshot of the project if it has changed since the last one */
+static void overview_update(GtkChromOverview *overview)
+{
+  GtkLTRFamilies *ltrfams = overview->ltrfams;
+  ChromOverview *co;
+  GtkTreeModel *model;
+  const gchar *seqid;
+  unsigned long i, generation;
+  gint active = -1;
+
+  if (!gtk_ltr_families_get_nodes(ltrfams))
+    return;
+  generation = gtk_ltr_families_get_generation(ltrfams);
+  if (overview->co && generation == overview->generation &&
+      ltrfams->unloaded_cands == overview->unloaded_cands) {
+    return;
+  }
+  co = gtk_ltr_families_new_overview(ltrfams);
+  chrom_tiles_set_overview(overview->tiles, co);
+  chrom_overview_delete(overview->co);
+  overview->co = co;
+  overview->generation = generation;
+  overview->unloaded_cands = ltrfams->unloaded_cands;
+  gt_diagram_delete(overview->diagram);
+  overview->diagram = NULL;
+
+  overview->updating = TRUE;
+  model = gtk_combo_box_get_model(GTK_COMBO_BOX(overview->seqids));
+  gtk_list_store_clear(GTK_LIST_STORE(model));
+  for (i = 0; i < chrom_overview_num_seqids(co); i++) {
+    seqid = chrom_overview_get_seqid(co, i);
+    gtk_combo_box_append_text(GTK_COMBO_BOX(overview->seqids), seqid);
+    /* sequence names are interned */
+    if (seqid == overview->seqid)
+      active = (gint) i;
+  }
+  if (active == -1 && chrom_overview_num_seqids(co) > 0) {
+    overview->seqid = chrom_overview_get_seqid(co, 0);
+    active = 0;
+  }
+  gtk_combo_box_set_active(GTK_COMBO_BOX(overview->seqids), active);
+  overview->updating = FALSE;
+  if (active == -1)
+    overview->seqid = NULL;
+  overview_show_all(overview);
+}
+
+static void overview_draw_ruler(GtkChromOverview *overview, cairo_t *cr,
+                                gint width)
+{
+  static const unsigned long steps[] = {1, 2, 5};
+  unsigned long bpp = 1UL << overview->level,
+                length = overview_length(overview),
+                base = 1,
+                step, pos;
+  gchar text[32];
+  gdouble x;
+  guint i = 0;
+
+  /* ticks are put at multiples of 1, 2 or 5 times a power of ten */
+  while (base * steps[i] < OVERVIEW_TICK_DISTANCE * bpp) {
+    if (++i == G_N_ELEMENTS(steps)) {
+      i = 0;
+      base *= 10;
+    }
+  }
+  step = base * steps[i];
+  cairo_set_source_rgb(cr, 0.3, 0.3, 0.3);
+  cairo_set_line_width(cr, 1);
+  cairo_select_font_face(cr, "sans", CAIRO_FONT_SLANT_NORMAL,
+                         CAIRO_FONT_WEIGHT_NORMAL);
+  cairo_set_font_size(cr, 9);
+  cairo_move_to(cr, 0, OVERVIEW_RULER_HEIGHT - 0.5);
+  cairo_line_to(cr, width, OVERVIEW_RULER_HEIGHT - 0.5);
+  cairo_stroke(cr);
+  for (pos = (overview->offset * bpp / step + 1) * step; pos <= length;
+       pos += step) {
+    x = (gdouble) pos / bpp - overview->offset;
+    if (x >= width)
+      break;
+    cairo_move_to(cr, floor(x) + 0.5, OVERVIEW_RULER_HEIGHT - 6);
+    cairo_line_to(cr, floor(x) + 0.5, OVERVIEW_RULER_HEIGHT);
+    cairo_stroke(cr);
+    g_snprintf(text, sizeof (text), "%lu", pos);
+    cairo_move_to(cr, x + 2, OVERVIEW_RULER_HEIGHT - 7);
+    cairo_show_text(cr, text);
+  }
+}
+
+static void overview_draw_tile(GtkChromOverview *overview, cairo_t *cr,
+                               unsigned long tileno, glong x)
+{
+  cairo_surface_t *surface;
+  unsigned long sub;
+  guint k;
+
+  surface = chrom_tiles_get(overview->tiles, overview->seqid, overview->level,
+                            tileno, OVERVIEW_TILE_HEIGHT, TRUE);
+  cairo_save(cr);
+  cairo_rectangle(cr, x, OVERVIEW_RULER_HEIGHT, CHROM_OVERVIEW_TILE_WIDTH,
+                  OVERVIEW_TILE_HEIGHT);
+  cairo_clip(cr);
+  if (surface) {
+    cairo_set_source_surface(cr, surface, x, OVERVIEW_RULER_HEIGHT);
+    cairo_paint(cr);
+    cairo_restore(cr);
+    return;
+  }
+  /* until the tile is rendered, the part of a coarser tile showing the same
+     positions is stretched over it */
+  for (k = 1; k <= OVERVIEW_FALLBACK_LEVELS &&
+              overview->level + k <= CHROM_OVERVIEW_MAX_LEVEL; k++) {
+    surface = chrom_tiles_get(overview->tiles, overview->seqid,
+                              overview->level + k, tileno >> k,
+                              OVERVIEW_TILE_HEIGHT, FALSE);
+    if (!surface)
+      continue;
+    sub = tileno & ((1UL << k) - 1);
+    cairo_translate(cr, x - (gdouble) sub * CHROM_OVERVIEW_TILE_WIDTH,
+                    OVERVIEW_RULER_HEIGHT);
+    cairo_scale(cr, 1UL << k, 1);
+    cairo_set_source_surface(cr, surface, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+    cairo_paint(cr);
+    cairo_restore(cr);
+    return;
+  }
+  cairo_set_source_rgb(cr, 0.95, 0.95, 0.95);
+  cairo_paint(cr);
+  cairo_restore(cr);
+}
+
+static void overview_set_height(GtkWidget *area, gint height)
+{
+  gint current;
+
+  gtk_widget_get_size_request(area, NULL, &current);
+  if (current != height)
+    gtk_widget_set_size_request(area, -1, height);
+}
+
+/* returns TRUE if a diagram of the shown range could be made */
+static gboolean overview_update_diagram(GtkChromOverview *overview,
+                                        gint width)
+{
+  unsigned long bpp = 1UL << overview->level;
+  GtRange range;
+
+  range.start = overview->offset * bpp + 1;
+  range.end = MIN((overview->offset + width) * bpp,
+                  overview_length(overview));
+  if (range.start > range.end)
+    return FALSE;
+  if (overview->diagram && overview->diagram_range.start == range.start &&
+      overview->diagram_range.end == range.end) {
+    return TRUE;
+  }
+  gt_diagram_delete(overview->diagram);
+  overview->diagram = gtk_ltr_families_new_diagram(overview->ltrfams,
+                                                   overview->seqid, &range);
+  overview->diagram_range = range;
+  return overview->diagram != NULL;
+}
+
+static gboolean overview_draw_diagram(GtkChromOverview *overview,
+                                      GtkWidget *area, cairo_t *cr)
+{
+  GtStyle *style = gtk_ltr_families_get_style(overview->ltrfams);
+  GtLayout *layout;
+  GtCanvas *canvas;
+  GtError *err;
+  unsigned long height;
+  gint width = area->allocation.width;
+  gboolean drawn = FALSE;
+
+  if (!overview_update_diagram(overview, width))
+    return FALSE;
+  err = gt_error_new();
+  layout = gt_layout_new(overview->diagram, width, style, err);
+  if (layout && !gt_layout_get_height(layout, &height, err)) {
+    overview_set_height(area, OVERVIEW_RULER_HEIGHT + height);
+    canvas = gt_canvas_cairo_context_new(style, cr, OVERVIEW_RULER_HEIGHT,
+                                         width, height, NULL, err);
+    if (canvas) {
+      drawn = !gt_layout_sketch(layout, canvas, err);
+      gt_canvas_delete(canvas);
+    }
+  }
+  if (layout)
+    gt_layout_delete(layout);
+  gt_error_delete(err);
+  return drawn;
+}
+
+static gboolean overview_area_expose_event(GtkWidget *area,
+                                           GdkEventExpose *event,
+                                           GtkChromOverview *overview)
+{
+  cairo_t *cr;
+  unsigned long first, last, tileno;
+  gint width = area->allocation.width;
+
+  overview_update(overview);
+  cr = gdk_cairo_create(area->window);
+  cairo_rectangle(cr, event->area.x, event->area.y, event->area.width,
+                  event->area.height);
+  cairo_clip(cr);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_paint(cr);
+  if (!overview->co || !overview->seqid || width <= 1) {
+    cairo_destroy(cr);
+    return FALSE;
+  }
+  overview_clamp(overview);
+  overview_draw_ruler(overview, cr, width);
+  if (overview->level <= OVERVIEW_DIAGRAM_LEVEL &&
+      overview_draw_diagram(overview, area, cr)) {
+    cairo_destroy(cr);
+    return FALSE;
+  }
+  gt_diagram_delete(overview->diagram);
+  overview->diagram = NULL;
+  overview_set_height(area, OVERVIEW_RULER_HEIGHT + OVERVIEW_TILE_HEIGHT);
+  first = overview->offset / CHROM_OVERVIEW_TILE_WIDTH;
+  last = (overview->offset + width - 1) / CHROM_OVERVIEW_TILE_WIDTH;
+  for (tileno = first; tileno <= last; tileno++) {
+    overview_draw_tile(overview, cr, tileno,
+                       (glong) (tileno * CHROM_OVERVIEW_TILE_WIDTH) -
+                       overview->offset);
+  }
+  /* the neighbouring tiles are rendered ahead for panning */
+  if (first > 0)
+    chrom_tiles_get(overview->tiles, overview->seqid, overview->level,
+                    first - 1, OVERVIEW_TILE_HEIGHT, TRUE);
+  chrom_tiles_get(overview->tiles, overview->seqid, overview->level, last + 1,
+                  OVERVIEW_TILE_HEIGHT, TRUE);
+  cairo_destroy(cr);
+  return FALSE;
+}
+
+/* clicking a candidate selects it, clicking the density zooms in */
+static void overview_click(GtkChromOverview *overview, gdouble x, gdouble y)
+{
+  const ChromOverviewCand *cand;
+  unsigned long bpp = 1UL << overview->level,
+                pos, start, end;
+  gdouble laneheight;
+
+  if (!overview->co || !overview->seqid || overview->diagram ||
+      y < OVERVIEW_RULER_HEIGHT) {
+    return;
+  }
+  if (overview->level >= CHROM_OVERVIEW_BIN_LEVEL) {
+    overview_set_level(overview, overview->level - 2, x);
+    return;
+  }
+  laneheight = chrom_overview_lane_height(overview->co, overview->seqid,
+                                          OVERVIEW_TILE_HEIGHT);
+  pos = (unsigned long) ((overview->offset + x) * bpp);
+  /* small candidates are hit within two pixels */
+  start = pos > 2 * bpp ? pos - 2 * bpp + 1 : 1;
+  end = pos + 2 * bpp;
+  cand = chrom_overview_find(overview->co, overview->seqid, start, end,
+                             (guint) ((y - OVERVIEW_RULER_HEIGHT) /
+                                      laneheight));
+  if (cand) {
+    start = cand->start;
+    end = cand->end;
+    gtk_ltr_families_show_candidate(overview->ltrfams, overview->seqid,
+                                    start, end);
+  }
+}
+
+static gboolean overview_area_button_press(GT_UNUSED GtkWidget *area,
+                                           GdkEventButton *event,
+                                           GtkChromOverview *overview)
+{
+  if (event->button != 1 || event->type != GDK_BUTTON_PRESS)
+    return FALSE;
+  overview->dragging = TRUE;
+  overview->dragged = FALSE;
+  overview->drag_x = event->x;
+  overview->drag_offset = overview->offset;
+  return TRUE;
+}
+
+static gboolean overview_area_motion_notify(GT_UNUSED GtkWidget *area,
+                                            GdkEventMotion *event,
+                                            GtkChromOverview *overview)
+{
+  gdouble dx;
+
+  if (!overview->dragging)
+    return FALSE;
+  dx = event->x - overview->drag_x;
+  if (fabs(dx) > 3)
+    overview->dragged = TRUE;
+  if (overview->dragged) {
+    overview->offset = overview->drag_offset - (glong) dx;
+    overview_clamp(overview);
+    overview_update_range(overview);
+    gtk_widget_queue_draw(overview->area);
+  }
+  return TRUE;
+}
+
+static gboolean overview_area_button_release(GT_UNUSED GtkWidget *area,
+                                             GdkEventButton *event,
+                                             GtkChromOverview *overview)
+{
+  if (event->button != 1 || !overview->dragging)
+    return FALSE;
+  overview->dragging = FALSE;
+  if (!overview->dragged)
+    overview_click(overview, event->x, event->y);
+  return TRUE;
+}
+
+static gboolean overview_area_scroll(GT_UNUSED GtkWidget *area,
+                                     GdkEventScroll *event,
+                                     GtkChromOverview *overview)
+{
+  if (!overview->co || !overview->seqid)
+    return FALSE;
+  if (event->direction == GDK_SCROLL_UP && overview->level > 0)
+    overview_set_level(overview, overview->level - 1, event->x);
+  else if (event->direction == GDK_SCROLL_DOWN)
+    overview_set_level(overview, MIN(overview->level + 1,
+                                     overview_max_level(overview)),
+                       event->x);
+  return TRUE;
+}
+
+static void overview_zoom_in_clicked(GT_UNUSED GtkWidget *button,
+                                     GtkChromOverview *overview)
+{
+  if (overview->level > 0)
+    overview_set_level(overview, overview->level - 1,
+                       overview->area->allocation.width / 2.0);
+}
+
+static void overview_zoom_out_clicked(GT_UNUSED GtkWidget *button,
+                                      GtkChromOverview *overview)
+{
+  overview_set_level(overview, MIN(overview->level + 1,
+                                   overview_max_level(overview)),
+                     overview->area->allocation.width / 2.0);
+}
+
+static void overview_zoom_all_clicked(GT_UNUSED GtkWidget *button,
+                                      GtkChromOverview *overview)
+{
+  overview_show_all(overview);
+}
+
+static void overview_seqids_changed(GtkComboBox *combob,
+                                    GtkChromOverview *overview)
+{
+  gchar *seqid;
+
+  if (overview->updating)
+    return;
+  if (!(seqid = gtk_combo_box_get_active_text(combob)))
+    return;
+  overview->seqid = symbols_intern(seqid);
+  g_free(seqid);
+  gt_diagram_delete(overview->diagram);
+  overview->diagram = NULL;
+  overview_show_all(overview);
+}
+
+static void overview_tiles_ready(gpointer data)
+{
+  GtkChromOverview *overview = GTK_CHROM_OVERVIEW(data);
+
+  gtk_widget_queue_draw(overview->area);
+}
+
+void gtk_chrom_overview_drop_tiles(GtkChromOverview *overview)
+{
+  if (overview->tiles)
+    chrom_tiles_set_overview(overview->tiles, overview->co);
+  gt_diagram_delete(overview->diagram);
+  overview->diagram = NULL;
+}
+
+gsize gtk_chrom_overview_memory(GtkChromOverview *overview)
+{
+  gsize bytes = 0;
+
+  if (overview->co)
+    bytes += chrom_overview_memory(overview->co);
+  if (overview->tiles)
+    bytes += chrom_tiles_memory(overview->tiles);
+  return bytes;
+}
+
+static void gtk_chrom_overview_destroy(GtkObject *object,
+                                       GT_UNUSED gpointer data)
+{
+  GtkChromOverview *overview = GTK_CHROM_OVERVIEW(object);
+
+  chrom_tiles_delete(overview->tiles);
+  overview->tiles = NULL;
+  chrom_overview_delete(overview->co);
+  overview->co = NULL;
+  gt_diagram_delete(overview->diagram);
+  overview->diagram = NULL;
+}
+
+static void gtk_chrom_overview_init(GtkChromOverview *overview)
+{
+  GtkWidget *toolbar,
+            *sw;
+  GtkToolItem *item;
+
+  overview->ltrfams = NULL;
+  overview->co = NULL;
+  overview->diagram = NULL;
+  overview->seqid = NULL;
+  overview->generation = overview->unloaded_cands = 0;
+  overview->level = 0;
+  overview->offset = overview->drag_offset = 0;
+  overview->drag_x = 0;
+  overview->dragging = overview->dragged = overview->updating = FALSE;
+  overview->tiles = chrom_tiles_new(bgzf_default_threads(),
+                                    OVERVIEW_MAX_TILES, overview_tiles_ready,
+                                    overview);
+
+  toolbar = gtk_toolbar_new();
+  gtk_toolbar_set_show_arrow(GTK_TOOLBAR(toolbar), TRUE);
+  gtk_toolbar_set_style(GTK_TOOLBAR(toolbar), GTK_TOOLBAR_ICONS);
+  item = gtk_tool_item_new();
+  overview->seqids = gtk_combo_box_new_text();
+  gtk_container_add(GTK_CONTAINER(item), overview->seqids);
+  gtk_tool_item_set_tooltip_text(item, OVERVIEW_SEQID);
+  gtk_toolbar_insert(GTK_TOOLBAR(toolbar), item, 0);
+  g_signal_connect(G_OBJECT(overview->seqids), "changed",
+                   G_CALLBACK(overview_seqids_changed), overview);
+  item = gtk_tool_button_new_from_stock(GTK_STOCK_ZOOM_IN);
+  gtk_tool_item_set_tooltip_text(item, OVERVIEW_ZOOM_IN);
+  gtk_toolbar_insert(GTK_TOOLBAR(toolbar), item, 1);
+  g_signal_connect(G_OBJECT(item), "clicked",
+                   G_CALLBACK(overview_zoom_in_clicked), overview);
+  item = gtk_tool_button_new_from_stock(GTK_STOCK_ZOOM_OUT);
+  gtk_tool_item_set_tooltip_text(item, OVERVIEW_ZOOM_OUT);
+  gtk_toolbar_insert(GTK_TOOLBAR(toolbar), item, 2);
+  g_signal_connect(G_OBJECT(item), "clicked",
+                   G_CALLBACK(overview_zoom_out_clicked), overview);
+  item = gtk_tool_button_new_from_stock(GTK_STOCK_ZOOM_FIT);
+  gtk_tool_item_set_tooltip_text(item, OVERVIEW_ZOOM_ALL);
+  gtk_toolbar_insert(GTK_TOOLBAR(toolbar), item, 3);
+  g_signal_connect(G_OBJECT(item), "clicked",
+                   G_CALLBACK(overview_zoom_all_clicked), overview);
+  gtk_toolbar_insert(GTK_TOOLBAR(toolbar), gtk_separator_tool_item_new(), 4);
+  item = gtk_tool_item_new();
+  overview->range = gtk_label_new("");
+  gtk_container_add(GTK_CONTAINER(item), overview->range);
+  gtk_toolbar_insert(GTK_TOOLBAR(toolbar), item, 5);
+
+  sw = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(sw),
+                                 GTK_POLICY_NEVER,
+                                 GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request(sw, -1,
+                              OVERVIEW_RULER_HEIGHT + OVERVIEW_TILE_HEIGHT + 4);
+  overview->area = gtk_drawing_area_new();
+  gtk_widget_set_size_request(overview->area, -1,
+                              OVERVIEW_RULER_HEIGHT + OVERVIEW_TILE_HEIGHT);
+  gtk_widget_set_tooltip_text(overview->area, OVERVIEW_AREA);
+  gtk_widget_add_events(overview->area,
+                        GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK |
+                        GDK_BUTTON1_MOTION_MASK | GDK_SCROLL_MASK);
+  g_signal_connect(G_OBJECT(overview->area), "expose-event",
+                   G_CALLBACK(overview_area_expose_event), overview);
+  g_signal_connect(G_OBJECT(overview->area), "button-press-event",
+                   G_CALLBACK(overview_area_button_press), overview);
+  g_signal_connect(G_OBJECT(overview->area), "motion-notify-event",
+                   G_CALLBACK(overview_area_motion_notify), overview);
+  g_signal_connect(G_OBJECT(overview->area), "button-release-event",
+                   G_CALLBACK(overview_area_button_release), overview);
+  g_signal_connect(G_OBJECT(overview->area), "scroll-event",
+                   G_CALLBACK(overview_area_scroll), overview);
+  gtk_scrolled_window_add_with_viewport(GTK_SCROLLED_WINDOW(sw),
+                                        overview->area);
+
+  gtk_box_pack_start(GTK_BOX(overview), toolbar, FALSE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(overview), sw, TRUE, TRUE, 0);
+  g_signal_connect(G_OBJECT(overview), "destroy",
+                   G_CALLBACK(gtk_chrom_overview_destroy), NULL);
+  gtk_widget_show_all(GTK_WIDGET(overview));
+}
+
+GType gtk_chrom_overview_get_type(void)
+{
+  static GType overview_type = 0;
+
+  if (!overview_type) {
+    const GTypeInfo overview_info =
+    {
+      sizeof (GtkChromOverviewClass),
+      NULL, /* base_init */
+      NULL, /* base_finalize */
+      NULL, /* (GClassInitFunc) gtk_chrom_overview_class_init, */
+      NULL, /* class_finalize */
+      NULL, /* class_data */
+      sizeof (GtkChromOverview),
+      0,    /* n_preallocs */
+      (GInstanceInitFunc) gtk_chrom_overview_init,
+    };
+    overview_type = g_type_register_static(GTK_TYPE_VBOX, "GtkChromOverview",
+                                           &overview_info, 0);
+  }
+  return overview_type;
+}
+
+GtkWidget* gtk_chrom_overview_new(GtkLTRFamilies *ltrfams)
+{
+  GtkChromOverview *overview;
+  overview = gtk_type_new(GTK_CHROM_OVERVIEW_TYPE);
+  overview->ltrfams = ltrfams;
+  return GTK_WIDGET(overview);
+}
@@ -0,0 +1,89 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GTK_CHROM_OVERVIEW_H
+#define GTK_CHROM_OVERVIEW_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+#include "chrom_overview.h"
+#include "gtk_ltr_families.h"
+
+#define GTK_CHROM_OVERVIEW_TYPE\
+        gtk_chrom_overview_get_type()
+#define GTK_CHROM_OVERVIEW(obj)\
+        G_TYPE_CHECK_INSTANCE_CAST((obj), GTK_CHROM_OVERVIEW_TYPE,\
+                                   GtkChromOverview)
+#define GTK_CHROM_OVERVIEW_CLASS(klass)\
+        G_TYPE_CHECK_CLASS_CAST((klass),\
+                                GTK_CHROM_OVERVIEW_TYPE, GtkChromOverviewClass)
+#define IS_GTK_CHROM_OVERVIEW(obj)\
+        G_TYPE_CHECK_INSTANCE_TYPE((obj), GTK_CHROM_OVERVIEW_TYPE)
+#define IS_GTK_CHROM_OVERVIEW_CLASS(klass)\
+        G_TYPE_CHECK_CLASS_TYPE((klass), GTK_CHROM_OVERVIEW_TYPE)
+
+typedef struct _GtkChromOverview GtkChromOverview;
+typedef struct _GtkChromOverviewClass GtkChromOverviewClass;
+
+/* <GtkChromOverview> shows the candidates of one sequence of a project at
+   any zoom level. Coarse levels show the density of the candidates, finer
+   levels the candidates themselves, and the finest levels the diagram of the
+   loaded candidates. The tiles of the overview are rendered in the
+   background from a snapshot of the project, which is taken again when the
+   project has changed. */
+struct _GtkChromOverview
+{
+  GtkVBox vbox;
+  GtkWidget *seqids;
+  GtkWidget *range;
+  GtkWidget *area;
+  GtkLTRFamilies *ltrfams;
+  ChromOverview *co;
+  ChromTiles *tiles;
+  GtDiagram *diagram;
+  GtRange diagram_range;
+  const gchar *seqid;
+  unsigned long generation,
+                unloaded_cands;
+  guint level;
+  glong offset,
+        drag_offset;
+  gdouble drag_x;
+  gboolean dragging,
+           dragged,
+           updating;
+};
+
+struct _GtkChromOverviewClass
+{
+  GtkVBoxClass parent_class;
+  void (* gtk_chrom_overview) (GtkChromOverview *overview);
+};
+
+GType      gtk_chrom_overview_get_type(void);
+
+/* Drops the rendered tiles and the diagram, they are rendered again when
+   they are shown next time. */
+void       gtk_chrom_overview_drop_tiles(GtkChromOverview *overview);
+
+/* Returns the number of bytes used by the snapshot and the rendered tiles. */
+gsize      gtk_chrom_overview_memory(GtkChromOverview *overview);
+
+GtkWidget* gtk_chrom_overview_new(GtkLTRFamilies *ltrfams);
+
+#endif
@@ -50,6 +50,23 @@ gboolean gtk_ltr_assistant_get_clustering(GtkLTRAssistant *ltrassi)
     gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ltrassi->checkb_clustering));
 }
 
+gboolean gtk_ltr_assistant_get_dedup(GtkLTRAssistant *ltrassi)
+{
+  return gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ltrassi->checkb_dedup));
+}
+
+gdouble gtk_ltr_assistant_get_dedup_overlap(GtkLTRAssistant *ltrassi)
+{
+  return
+    gtk_spin_button_get_value(GTK_SPIN_BUTTON(ltrassi->spinb_dedup)) / 100.0;
+}
+
+gboolean gtk_ltr_assistant_get_dedup_flag(GtkLTRAssistant *ltrassi)
+{
+  return gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+                                                   ltrassi->checkb_dedupflag));
+}
+
 gint gtk_ltr_assistant_get_gapopen(GtkLTRAssistant *ltrassi)
 {
   if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ltrassi->checkb_gapopen)))
@@ -713,6 +730,24 @@ static void checkb_clustering_toggled(GtkToggleButton *togglebutton,
   update_cluster_overview(ltrassi);
 }
 
+static void dedup_settings_changed(GT_UNUSED GtkWidget *widget,
+                                   GtkLTRAssistant *ltrassi)
+{
+  gchar buffer[BUFSIZ];
+  gboolean active;
+
+  active = gtk_ltr_assistant_get_dedup(ltrassi);
+  gtk_widget_set_sensitive(ltrassi->spinb_dedup, active);
+  gtk_widget_set_sensitive(ltrassi->checkb_dedupflag, active);
+  if (active)
+    g_snprintf(buffer, BUFSIZ, "Yes (%.0f%% overlap, %s)",
+               gtk_ltr_assistant_get_dedup_overlap(ltrassi) * 100.0,
+               gtk_ltr_assistant_get_dedup_flag(ltrassi) ? "flag" : "remove");
+  else
+    g_snprintf(buffer, BUFSIZ, "No");
+  gtk_label_set_label(GTK_LABEL(ltrassi->label_dodedup), buffer);
+}
+
 static void checkb_classification_toggled(GtkToggleButton *togglebutton,
                                    GtkLTRAssistant *ltrassi)
 {
@@ -1154,6 +1189,22 @@ static void gtk_ltr_assistant_init(GtkLTRAssistant *ltrassi)
                          gtk_check_button_new_with_label("Perform clustering?");
   gtk_box_pack_start(GTK_BOX(page_info[PAGE_GENERAL].widget),
                      ltrassi->checkb_clustering, FALSE, FALSE, 1);
+  hbox = gtk_hbox_new(FALSE, 5);
+  ltrassi->checkb_dedup =
+      gtk_check_button_new_with_label("Merge candidates overlapping by (%):");
+  gtk_box_pack_start(GTK_BOX(hbox), ltrassi->checkb_dedup, FALSE, FALSE, 1);
+  adjust = gtk_adjustment_new(90.0, 50.0, 100.0, 1.0, 10.0, 0.0);
+  ltrassi->spinb_dedup = gtk_spin_button_new(GTK_ADJUSTMENT(adjust), 1.0, 0);
+  gtk_widget_set_sensitive(ltrassi->spinb_dedup, FALSE);
+  gtk_box_pack_start(GTK_BOX(hbox), ltrassi->spinb_dedup, FALSE, FALSE, 1);
+  ltrassi->checkb_dedupflag =
+               gtk_check_button_new_with_label("Keep and flag duplicates");
+  gtk_widget_set_sensitive(ltrassi->checkb_dedupflag, FALSE);
+  gtk_box_pack_start(GTK_BOX(hbox), ltrassi->checkb_dedupflag, FALSE, FALSE,
+                     1);
+  gtk_widget_set_tooltip_text(hbox, DEDUP_TOOLTIP);
+  gtk_box_pack_start(GTK_BOX(page_info[PAGE_GENERAL].widget),
+                     hbox, FALSE, FALSE, 1);
 
   /* Matching/Clustering settings page */
   page_info[PAGE_CLUSTERING].widget = gtk_vbox_new(FALSE, 5);
@@ -1529,6 +1580,11 @@ static void gtk_ltr_assistant_init(GtkLTRAssistant *ltrassi)
   align = gtk_alignment_new(0.0, 0.5, 0.0, 0.0);
   gtk_container_add(GTK_CONTAINER(align), label);
   gtk_box_pack_start(GTK_BOX(vbox1), align, FALSE, FALSE, 1);
+  label = gtk_label_new("Merge overlapping candidates?");
+  gtk_label_set_justify(GTK_LABEL(label), GTK_JUSTIFY_LEFT);
+  align = gtk_alignment_new(0.0, 0.5, 0.0, 0.0);
+  gtk_container_add(GTK_CONTAINER(align), label);
+  gtk_box_pack_start(GTK_BOX(vbox1), align, FALSE, FALSE, 1);
   label = gtk_label_new("Run clustering component?");
   gtk_label_set_justify(GTK_LABEL(label), GTK_JUSTIFY_LEFT);
   align = gtk_alignment_new(0.0, 0.5, 0.0, 0.0);
@@ -1550,6 +1606,11 @@ static void gtk_ltr_assistant_init(GtkLTRAssistant *ltrassi)
   align = gtk_alignment_new(1.0, 0.5, 0.0, 0.0);
   gtk_container_add(GTK_CONTAINER(align), label);
   gtk_box_pack_start(GTK_BOX(vbox2), align, FALSE, FALSE, 1);
+  label = ltrassi->label_dodedup = gtk_label_new("No");
+  gtk_label_set_justify(GTK_LABEL(label), GTK_JUSTIFY_RIGHT);
+  align = gtk_alignment_new(1.0, 0.5, 0.0, 0.0);
+  gtk_container_add(GTK_CONTAINER(align), label);
+  gtk_box_pack_start(GTK_BOX(vbox2), align, FALSE, FALSE, 1);
   label = ltrassi->label_doclustering = gtk_label_new("No");
   gtk_label_set_justify(GTK_LABEL(label), GTK_JUSTIFY_RIGHT);
   align = gtk_alignment_new(1.0, 0.5, 0.0, 0.0);
@@ -1793,6 +1854,12 @@ static void gtk_ltr_assistant_init(GtkLTRAssistant *ltrassi)
   /* connect signals */
   g_signal_connect(G_OBJECT(ltrassi->checkb_clustering), "toggled",
                    G_CALLBACK(checkb_clustering_toggled), (gpointer) ltrassi);
+  g_signal_connect(G_OBJECT(ltrassi->checkb_dedup), "toggled",
+                   G_CALLBACK(dedup_settings_changed), (gpointer) ltrassi);
+  g_signal_connect(G_OBJECT(ltrassi->spinb_dedup), "value-changed",
+                   G_CALLBACK(dedup_settings_changed), (gpointer) ltrassi);
+  g_signal_connect(G_OBJECT(ltrassi->checkb_dedupflag), "toggled",
+                   G_CALLBACK(dedup_settings_changed), (gpointer) ltrassi);
   g_signal_connect(G_OBJECT(ltrassi->spinb_matchscore), "value-changed",
                    G_CALLBACK(cluster_settings_adjustment_value_changed),
                    (gpointer) ltrassi);
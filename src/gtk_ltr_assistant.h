@@ -57,6 +57,9 @@ struct _GtkLTRAssistant
   GtkWidget *list_view_gff3files;
   GtkWidget *label_indexname;
   GtkWidget *checkb_clustering;
+  GtkWidget *checkb_dedup;
+  GtkWidget *spinb_dedup;
+  GtkWidget *checkb_dedupflag;
   /* Matching/Clustering settings page */
   GtkWidget *spinb_matchscore;
   GtkWidget *checkb_matchscore;
@@ -96,6 +99,7 @@ struct _GtkLTRAssistant
   GtkWidget *label_projectfile2;
   GtkWidget *label_gff3files;
   GtkWidget *label_indexname2;
+  GtkWidget *label_dodedup;
   GtkWidget *label_doclustering;
   GtkWidget *label_gapopen;
   GtkWidget *label_gapextend;
@@ -138,6 +142,12 @@ const gchar* gtk_ltr_assistant_get_indexname(GtkLTRAssistant *ltrassi);
 
 gboolean     gtk_ltr_assistant_get_clustering(GtkLTRAssistant *ltrassi);
 
+gboolean     gtk_ltr_assistant_get_dedup(GtkLTRAssistant *ltrassi);
+
+gdouble      gtk_ltr_assistant_get_dedup_overlap(GtkLTRAssistant *ltrassi);
+
+gboolean     gtk_ltr_assistant_get_dedup_flag(GtkLTRAssistant *ltrassi);
+
 gint         gtk_ltr_assistant_get_xgapless(GtkLTRAssistant *ltrassi);
 
 gint         gtk_ltr_assistant_get_xgapped(GtkLTRAssistant *ltrassi);
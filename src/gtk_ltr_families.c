@@ -17,20 +17,39 @@
 */
 
 #include <string.h>
+#include "arena.h"
+#include "bgzf.h"
 #include "error.h"
 #include "default_style.h"
+#include "filter_cache.h"
+#include "gtk_chrom_overview.h"
 #include "gtk_ltr_families.h"
 #include "message_strings.h"
 #include "statusbar.h"
 #include "support.h"
+#include "symbols.h"
 #include "ltr/ltr_orf_annotator_stream_api.h"
 
+/* the candidate data of a project is allocated in blocks of this size */
+#define LTRFAMS_ARENA_BLOCK_SIZE 65536
+
+/* the memory usage is updated (and the budget enforced) in this interval of
+   seconds */
+#define LTRFAMS_MEMORY_INTERVAL  5
+/* estimated bytes per list store row and per cell of a row */
+#define LTRFAMS_ROW_SIZE         64
+#define LTRFAMS_CELL_SIZE        32
+
 /* function prototypes start */
 static gint notebook_list_view_sort_function(GtkTreeModel*, GtkTreeIter*,
                                              GtkTreeIter*, gpointer);
 
 static void tree_view_details_clear_on_equal_nodes(GtkLTRFamilies*,
                                                    GtGenomeNode*);
+
+static void list_view_families_update_stats(GtkLTRFamilies*);
+
+static void gtk_ltr_families_drop_caches(GtkLTRFamilies*);
 /* function prototypes end */
 
 /* get functions start */
@@ -54,16 +73,41 @@ GtArray* gtk_ltr_families_get_nodes(GtkLTRFamilies *ltrfams)
   return ltrfams->nodes;
 }
 
+MemoryUsage* gtk_ltr_families_get_memory_usage(GtkLTRFamilies *ltrfams)
+{
+  return ltrfams->memory;
+}
+
 GtArray* gtk_ltr_families_get_regions(GtkLTRFamilies *ltrfams)
 {
   return ltrfams->regions;
 }
 
+GtStyle* gtk_ltr_families_get_style(GtkLTRFamilies *ltrfams)
+{
+  return ltrfams->style;
+}
+
+GtHashmap* gtk_ltr_families_get_features(GtkLTRFamilies *ltrfams)
+{
+  return ltrfams->features;
+}
+
 gboolean gtk_ltr_families_get_modified(GtkLTRFamilies *ltrfams)
 {
   return ltrfams->modified;
 }
 
+unsigned long gtk_ltr_families_get_generation(GtkLTRFamilies *ltrfams)
+{
+  return ltrfams->generation;
+}
+
+ProjectIndex* gtk_ltr_families_get_index(GtkLTRFamilies *ltrfams)
+{
+  return ltrfams->index;
+}
+
 gchar* gtk_ltr_families_get_projectfile(GtkLTRFamilies *ltrfams)
 {
   return ltrfams->projectfile;
@@ -85,7 +129,101 @@ gint gtk_ltr_families_get_vpaned_position(GtkLTRFamilies *ltrfams)
 }
 /* get functions end */
 
+/* candidates belong to the family their <cdata->fam_ref> points to and the
+   name is only kept in that row, so renaming, merging and moving families
+   does not touch the candidates. The families are remembered here and their
+   ltrfam attributes are brought up to date by
+   gtk_ltr_families_sync_family_names() */
+static void gtk_ltr_families_family_name_changed(GtkLTRFamilies *ltrfams,
+                                                 GtkTreeModel *model,
+                                                 GtkTreeIter *iter)
+{
+  GtkTreeRowReference *rowref;
+  GtkTreePath *path;
+
+  path = gtk_tree_model_get_path(model, iter);
+  rowref = gtk_tree_row_reference_new(model, path);
+  gt_array_add(ltrfams->outdated_families, rowref);
+  gtk_tree_path_free(path);
+}
+
+/* writes the ltrfam attributes of the families renamed, merged or extended
+   since the last call, before the candidates are saved, exported or
+   filtered */
+void gtk_ltr_families_sync_family_names(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeModel *model;
+  GtkTreeRowReference *rowref;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  GtArray *nodes;
+  GtFeatureNode *fn;
+  gchar *name;
+  const gchar *attr;
+  unsigned long i, j;
+
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  for (j = 0; j < gt_array_size(ltrfams->outdated_families); j++) {
+    rowref = *(GtkTreeRowReference**) gt_array_get(ltrfams->outdated_families,
+                                                   j);
+    /* families removed in the meantime have nothing left to update */
+    path = gtk_tree_row_reference_get_path(rowref);
+    gtk_tree_row_reference_free(rowref);
+    if (!path)
+      continue;
+    gtk_tree_model_get_iter(model, &iter, path);
+    gtk_tree_path_free(path);
+    gtk_tree_model_get(model, &iter,
+                       LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                       LTRFAMS_FAM_LV_OLDNAME, &name,
+                       -1);
+    for (i = 0; nodes && name && i < gt_array_size(nodes); i++) {
+      /* the family name is kept at the top level feature */
+      fn = *(GtFeatureNode**) gt_array_get(nodes, i);
+      attr = gt_feature_node_get_attribute(fn, ATTR_LTRFAM);
+      if (g_strcmp0(attr, name) != 0) {
+        gt_feature_node_set_attribute(fn, ATTR_LTRFAM, name);
+        filter_cache_node_changed((GtGenomeNode*) fn);
+      }
+    }
+    g_free(name);
+  }
+  gt_array_reset(ltrfams->outdated_families);
+}
+
 /* set functions start */
+/* saves the performance logs of the finished jobs, the logs which cannot be
+   saved yet (e.g. the project has no database yet) are kept for the next
+   time */
+static void gtk_ltr_families_flush_perf_logs(GtkLTRFamilies *ltrfams)
+{
+  PerfLog *perf;
+  unsigned long i, j;
+
+  if (!ltrfams->rdb)
+    return;
+  for (i = j = 0; i < gt_array_size(ltrfams->perf_logs); i++) {
+    perf = *(PerfLog**) gt_array_get(ltrfams->perf_logs, i);
+    if (perf_log_save(perf, ltrfams->rdb, ltrfams->err) == 0)
+      perf_log_delete(perf);
+    else {
+      gt_error_unset(ltrfams->err);
+      *(PerfLog**) gt_array_get(ltrfams->perf_logs, j++) = perf;
+    }
+  }
+  gt_array_set_size(ltrfams->perf_logs, j);
+}
+
+void gtk_ltr_families_log_perf(GtkLTRFamilies *ltrfams, PerfLog *perf,
+                               gboolean failed)
+{
+  if (!perf)
+    return;
+  perf_log_finish(perf, failed);
+  gt_array_add(ltrfams->perf_logs, perf);
+  gtk_ltr_families_flush_perf_logs(ltrfams);
+}
+
 void gtk_ltr_families_set_rdb(GtRDB *rdb, GtkLTRFamilies *ltrfams)
 {
   ltrfams->rdb = rdb;
@@ -94,6 +232,12 @@ void gtk_ltr_families_set_rdb(GtRDB *rdb, GtkLTRFamilies *ltrfams)
 void gtk_ltr_families_set_modified(GtkLTRFamilies *ltrfams, gboolean modified)
 {
   ltrfams->modified = modified;
+  /* every edit starts a new generation, so a save can tell whether the data
+     changed while it was running */
+  if (modified) {
+    ltrfams->generation++;
+    list_view_families_update_stats(ltrfams);
+  }
 
   GtkWidget *toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
   gchar buffer[BUFSIZ], *f;
@@ -118,6 +262,28 @@ void gtk_ltr_families_set_modified(GtkLTRFamilies *ltrfams, gboolean modified)
   }
 }
 
+void gtk_ltr_families_set_index(GtkLTRFamilies *ltrfams, ProjectIndex *index)
+{
+  ProjectIndexEntry *entry;
+  unsigned long i;
+
+  /* families read through the old index are in memory already */
+  if (ltrfams->index) {
+    project_index_copy_loaded(index, ltrfams->index);
+    project_index_delete(ltrfams->index);
+  }
+  ltrfams->index = index;
+  /* candidates which have not been read yet are located through their
+     index entries */
+  location_index_delete(ltrfams->index_locations);
+  ltrfams->index_locations = location_index_new();
+  for (i = 0; i < project_index_size(index); i++) {
+    entry = project_index_get_entry(index, i);
+    location_index_add(ltrfams->index_locations, entry->seqid, entry->start,
+                       entry->end, NULL, (gpointer) entry);
+  }
+}
+
 void gtk_ltr_families_set_projectfile(GtkLTRFamilies *ltrfams,
                                       gchar *projectfile)
 {
@@ -303,7 +469,7 @@ void update_main_tab_label(GtkLTRFamilies *ltrfams)
                                     main_tab_no);
   tab_label = gtk_notebook_get_tab_label(GTK_NOTEBOOK(ltrfams->nb_family),
                                          child);
-  size = gt_array_size(ltrfams->nodes);
+  size = gt_array_size(ltrfams->nodes) + ltrfams->unloaded_cands;
   if (size == 0)
     size = 1;
   percent = ((gfloat) ltrfams->unclassified_cands /
@@ -320,7 +486,7 @@ void gtk_ltr_families_update_unclassified_cands(GtkLTRFamilies *ltrfams,
   ltrfams->unclassified_cands += amount;
   update_main_tab_label(ltrfams);
   g_snprintf(sb_text, BUFSIZ, STATUSBAR_NUM_OF_CANDS,
-             gt_array_size(ltrfams->nodes));
+             gt_array_size(ltrfams->nodes) + ltrfams->unloaded_cands);
   statusbar_set_status(ltrfams->statusbar, sb_text);
 }
 
@@ -468,8 +634,7 @@ get_features_and_prefix_for_classification(GtkLTRFamilies *ltrfams,
 
 void free_tdata(FamilyTransferData *tdata)
 {
-  g_list_foreach(tdata->references, (GFunc) gtk_tree_row_reference_free, NULL);
-  g_list_free(tdata->references);
+  cand_selection_delete(tdata->selection);
   gt_array_delete(tdata->nodes);
   tdata->rowref = NULL;
   tdata->list_view = NULL;
@@ -517,36 +682,29 @@ static void update_list_view_with_flcand(GtkListStore *store,
   gt_feature_node_iterator_delete(fni);
 }
 
-static void remove_candidate(GtkTreeRowReference *rowref)
+/* detaches the candidate in the row <iter> of <model> before the row is
+   removed */
+static void remove_candidate(GtkTreeModel *model, GtkTreeIter *iter,
+                             GT_UNUSED gpointer data)
 {
   CandidateData *cdata;
   GtGenomeNode *gn;
-  GtkTreeIter iter;
-  GtkTreePath *path;
-  GtkTreeModel *model;
-  gboolean valid;
 
-  model = gtk_tree_row_reference_get_model(rowref);
-  path = gtk_tree_row_reference_get_path(rowref);
-  valid = gtk_tree_model_get_iter(model, &iter, path);
-  if (!valid)
-    g_warning("%s", "Remove candidate - Programming error!");
-  else {
-    gtk_tree_model_get(model, &iter, LTRFAMS_LV_NODE, &gn, -1);
-    cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
-    if (cdata) {
-      cdata->cand_ref = NULL;
-      cdata->fam_ref = NULL;
-    }
-    gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
+  gtk_tree_model_get(model, iter, LTRFAMS_LV_NODE, &gn, -1);
+  cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+  if (cdata) {
+    if (cdata->cand_ref)
+      gtk_tree_row_reference_free(cdata->cand_ref);
+    cdata->cand_ref = NULL;
+    cdata->fam_ref = NULL;
   }
-  gtk_tree_path_free(path);
 }
 
 static void remove_merged_family(GtkTreeRowReference *rowref,
                                  GtkLTRFamilies *ltrfams)
 {
   GtArray *nodes;
+  FamilyStats *stats;
   GtkTreePath *path;
   GtkTreeModel *model;
   GtkWidget *tab_label;
@@ -558,8 +716,10 @@ static void remove_merged_family(GtkTreeRowReference *rowref,
   gtk_tree_model_get(model, &iter,
                      LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
                      LTRFAMS_FAM_LV_TAB_LABEL, &tab_label,
+                     LTRFAMS_FAM_LV_STATS, &stats,
                      -1);
   gt_array_delete(nodes);
+  family_stats_delete(stats);
   if (tab_label) {
     gtk_notebook_remove_page(GTK_NOTEBOOK(ltrfams->nb_family),
                 GPOINTER_TO_INT(
@@ -573,6 +733,7 @@ static void remove_merged_family(GtkTreeRowReference *rowref,
 static void remove_family(GtkTreeRowReference *rowref, GtkLTRFamilies *ltrfams)
 {
   GtArray *nodes;
+  FamilyStats *stats;
   GList *children;
   GtkTreeView *list_view;
   GtkTreePath *path;
@@ -589,8 +750,17 @@ static void remove_family(GtkTreeRowReference *rowref, GtkLTRFamilies *ltrfams)
   model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
   path = gtk_tree_row_reference_get_path(rowref);
   gtk_tree_model_get_iter(model, &iter, path);
+  if (gtk_ltr_families_load_family(ltrfams, model, &iter)) {
+    gtk_tree_path_free(path);
+    return;
+  }
   gtk_tree_model_get(model, &iter,
                      LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                     LTRFAMS_FAM_LV_STATS, &stats,
+                     -1);
+  family_stats_delete(stats);
+  gtk_list_store_set(GTK_LIST_STORE(model), &iter,
+                     LTRFAMS_FAM_LV_STATS, NULL,
                      -1);
   ltrfams->unclassified_cands += gt_array_size(nodes);
   if (gtk_notebook_get_n_pages(GTK_NOTEBOOK(ltrfams->nb_family)) != 0) {
@@ -612,6 +782,7 @@ static void remove_family(GtkTreeRowReference *rowref, GtkLTRFamilies *ltrfams)
       attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN);
       if (attr)
         gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
+      filter_cache_node_changed(gn);
       gtk_ltr_families_notebook_list_view_append_gn(ltrfams, list_view, gn,
                                                     NULL, NULL, NULL, NULL);
       gt_feature_node_iterator_delete(fni);
@@ -632,41 +803,34 @@ static void remove_family(GtkTreeRowReference *rowref, GtkLTRFamilies *ltrfams)
   gtk_tree_path_free(path);
 }
 
-static void update_genomenode_famname(GtArray *nodes, const char *newname)
-{
-  GtGenomeNode *gn;
-  GtFeatureNode *curnode;
-  GtFeatureNodeIterator *fni;
-  unsigned long i;
-
-  for (i = 0; i < gt_array_size(nodes); i++) {
-    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
-    fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
-    curnode = gt_feature_node_iterator_next(fni);
-    gt_feature_node_set_attribute(curnode, ATTR_LTRFAM, newname);
-    gt_feature_node_iterator_delete(fni);
-  }
-}
-
+/* removes the nodes of <nodes2> from <nodes1> in one pass over both
+   arrays, keeping the order of the remaining nodes */
 static void remove_nodes_from_array(GtArray *nodes1, GtArray *nodes2,
                                     gboolean delete_gn, GtFeatureIndex *fi)
 {
-  GtFeatureNode *tmp1, *tmp2;
-  unsigned long i, j;
+  GtHashmap *remove;
+  GtFeatureNode *tmp;
+  GtFeatureNode **space;
+  unsigned long i, kept = 0;
 
-  for (i = 0; i < gt_array_size(nodes2); i++) {
-    tmp2 = *(GtFeatureNode**) gt_array_get(nodes2, i);
-    for (j = 0; j < gt_array_size(nodes1); j++) {
-      tmp1 = *(GtFeatureNode**) gt_array_get(nodes1, j);
-      if (gt_genome_node_cmp((GtGenomeNode*) tmp1, (GtGenomeNode*) tmp2) == 0) {
-        gt_array_rem(nodes1, j);
-        if (delete_gn && fi) {
-          gt_feature_index_remove_node(fi, tmp1, NULL);
-        }
-        break;
-      }
+  if (gt_array_size(nodes2) == 0)
+    return;
+  remove = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  for (i = 0; i < gt_array_size(nodes2); i++)
+    gt_hashmap_add(remove, *(GtFeatureNode**) gt_array_get(nodes2, i),
+                   (void*) 1);
+  space = (GtFeatureNode**) gt_array_get_space(nodes1);
+  for (i = 0; i < gt_array_size(nodes1); i++) {
+    tmp = space[i];
+    if (gt_hashmap_get(remove, tmp)) {
+      if (delete_gn && fi)
+        gt_feature_index_remove_node(fi, tmp, NULL);
+      continue;
     }
+    space[kept++] = tmp;
   }
+  gt_array_set_size(nodes1, kept);
+  gt_hashmap_delete(remove);
 }
 
 static void free_str_hash(void *elem)
@@ -678,21 +842,290 @@ static void free_iter_hash(void *elem)
 {
   gtk_tree_iter_free((GtkTreeIter*) elem);
 }
+
+/* candidates are found by the ID of their LTR_retrotransposon feature */
+static const gchar* candidate_location_id(GtGenomeNode *gn)
+{
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *curnode;
+  const gchar *id = NULL;
+
+  fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
+  while ((curnode = gt_feature_node_iterator_next(fni))) {
+    if (symbols_feature_type(curnode) == SYMBOL_LTRRETRO) {
+      id = gt_feature_node_get_attribute(curnode, ATTR_RID);
+      break;
+    }
+  }
+  gt_feature_node_iterator_delete(fni);
+  return id;
+}
+
+static void candidate_location_add(GtkLTRFamilies *ltrfams, GtGenomeNode *gn)
+{
+  GtRange range = gt_genome_node_get_range(gn);
+
+  location_index_add(ltrfams->locations,
+                     gt_str_get(gt_genome_node_get_seqid(gn)), range.start,
+                     range.end, candidate_location_id(gn), gn);
+}
+
+static void candidate_location_remove(GtkLTRFamilies *ltrfams,
+                                      GtGenomeNode *gn)
+{
+  GtRange range = gt_genome_node_get_range(gn);
+
+  location_index_remove(ltrfams->locations,
+                        gt_str_get(gt_genome_node_get_seqid(gn)), range.start,
+                        range.end, candidate_location_id(gn), gn);
+}
+
+/* the jobs changing the features or attributes of <nodes> outdate the
+   cached filter results of them */
+static void candidates_changed(GtArray *nodes)
+{
+  unsigned long i;
+
+  for (i = 0; i < gt_array_size(nodes); i++)
+    filter_cache_node_changed(*(GtGenomeNode**) gt_array_get(nodes, i));
+}
+
+/* attaches new candidate data to <gn>, which has just become part of the
+   project, the data of unloaded candidates is reused */
+static CandidateData* candidate_data_new(GtkLTRFamilies *ltrfams,
+                                         GtGenomeNode *gn)
+{
+  CandidateData *cdata;
+
+  if (gt_array_size(ltrfams->spare_cdata) > 0)
+    cdata = *(CandidateData**) gt_array_pop(ltrfams->spare_cdata);
+  else
+    cdata = arena_new0(ltrfams->arena, CandidateData);
+  cdata->fam_ref = NULL;
+  cdata->cand_ref = NULL;
+  gt_genome_node_add_user_data(gn, "cdata", (gpointer) cdata, NULL);
+  filter_cache_attach(gn);
+  attach_node_copy(gn);
+  candidate_location_add(ltrfams, gn);
+  memory_usage_add(ltrfams->memory, MEMORY_NODES,
+                   memory_usage_estimate_node(gn) + sizeof (CandidateData));
+  return cdata;
+}
+
+/* deletes the candidate <gn> which leaves the project */
+static void candidate_data_delete(GtkLTRFamilies *ltrfams, GtGenomeNode *gn)
+{
+  CandidateData *cdata;
+
+  cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+  candidate_location_remove(ltrfams, gn);
+  memory_usage_sub(ltrfams->memory, MEMORY_NODES,
+                   memory_usage_estimate_node(gn) + sizeof (CandidateData));
+  if (cdata) {
+    if (cdata->cand_ref)
+      gtk_tree_row_reference_free(cdata->cand_ref);
+    gt_array_add(ltrfams->spare_cdata, cdata);
+  }
+  drop_node_copy(gn, ltrfams->memory);
+  delete_gt_genome_node(gn);
+}
+
+/* removes the unclassified candidate <gn> from the project */
+void gtk_ltr_families_remove_candidate(GtkLTRFamilies *ltrfams,
+                                       GtGenomeNode *gn)
+{
+  candidate_location_remove(ltrfams, gn);
+  drop_node_copy(gn, ltrfams->memory);
+  remove_node_from_array(ltrfams->nodes, gn);
+}
 /* "support" functions end */
 
+/* <selection> related functions start */
+static void selection_add_row(GT_UNUSED GtkTreeModel *model, GtkTreePath *path,
+                              GT_UNUSED GtkTreeIter *iter, gpointer data)
+{
+  cand_selection_add((CandSelection*) data,
+                     (unsigned long) gtk_tree_path_get_indices(path)[0]);
+}
+
+CandSelection* gtk_ltr_families_get_selection(GtkTreeView *list_view)
+{
+  GtkTreeModel *model;
+  CandSelection *cs;
+
+  model = gtk_tree_view_get_model(list_view);
+  cs = cand_selection_new((unsigned long)
+                          gtk_tree_model_iter_n_children(model, NULL));
+  gtk_tree_selection_selected_foreach(gtk_tree_view_get_selection(list_view),
+                                      selection_add_row, cs);
+  return cs;
+}
+
+/* every run of selected rows is selected at once */
+void gtk_ltr_families_set_selection(GtkTreeView *list_view, CandSelection *cs)
+{
+  GtkTreeSelection *sel;
+  GtkTreePath *first,
+              *last;
+  unsigned long row, end;
+
+  sel = gtk_tree_view_get_selection(list_view);
+  gtk_tree_selection_unselect_all(sel);
+  for (row = cand_selection_next(cs, 0); row < cand_selection_size(cs);
+       row = cand_selection_next(cs, end + 1)) {
+    end = cand_selection_run_end(cs, row);
+    first = gtk_tree_path_new_from_indices((gint) row, -1);
+    last = gtk_tree_path_new_from_indices((gint) end, -1);
+    gtk_tree_selection_select_range(sel, first, last);
+    gtk_tree_path_free(first);
+    gtk_tree_path_free(last);
+  }
+}
+
+/* sets <iter> to the selected <row> of <model>, which follows <prev> */
+static gboolean selection_iter(GtkTreeModel *model, GtkTreeIter *iter,
+                               unsigned long row, unsigned long prev)
+{
+  if (row == prev + 1)
+    return gtk_tree_model_iter_next(model, iter);
+  return gtk_tree_model_iter_nth_child(model, iter, NULL, (gint) row);
+}
+
+void gtk_ltr_families_get_selected_nodes(GtkTreeView *list_view,
+                                         CandSelection *cs, GtArray *nodes)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtGenomeNode *gn;
+  unsigned long row, prev = G_MAXULONG - 1;
+  gboolean valid = TRUE;
+
+  model = gtk_tree_view_get_model(list_view);
+  for (row = cand_selection_next(cs, 0);
+       valid && row < cand_selection_size(cs);
+       prev = row, row = cand_selection_next(cs, row + 1)) {
+    if (!(valid = selection_iter(model, &iter, row, prev)))
+      break;
+    gtk_tree_model_get(model, &iter, LTRFAMS_LV_NODE, &gn, -1);
+    gt_array_add(nodes, gn);
+  }
+}
+
+/* returns the rows of <list_view> whose candidates fulfill <predicate> */
+static CandSelection* selection_new_by(GtkTreeView *list_view,
+                                       CandPredicate predicate, gpointer data)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtGenomeNode *gn;
+  CandSelection *cs;
+  unsigned long row = 0;
+  gboolean valid;
+
+  model = gtk_tree_view_get_model(list_view);
+  cs = cand_selection_new((unsigned long)
+                          gtk_tree_model_iter_n_children(model, NULL));
+  valid = gtk_tree_model_get_iter_first(model, &iter);
+  while (valid) {
+    gtk_tree_model_get(model, &iter, LTRFAMS_LV_NODE, &gn, -1);
+    if (predicate(gn, data))
+      cand_selection_add(cs, row);
+    row++;
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  return cs;
+}
+
+void gtk_ltr_families_select_by(GtkTreeView *list_view,
+                                CandPredicate predicate, gpointer data)
+{
+  CandSelection *cs = selection_new_by(list_view, predicate, data);
+  gtk_ltr_families_set_selection(list_view, cs);
+  cand_selection_delete(cs);
+}
+
+/* removes the rows of <cs> from the list store of <list_view>, calling
+   <func> for every row before it is removed. The model is detached while the
+   rows are removed, so that the view is not updated row by row. */
+static void selection_remove_rows(GtkTreeView *list_view, CandSelection *cs,
+                                  void (*func)(GtkTreeModel*, GtkTreeIter*,
+                                               gpointer),
+                                  gpointer data)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  unsigned long row, removed = 0;
+  gboolean valid = FALSE;
+
+  model = g_object_ref(gtk_tree_view_get_model(list_view));
+  gtk_tree_view_set_model(list_view, NULL);
+  for (row = cand_selection_next(cs, 0); row < cand_selection_size(cs);
+       row = cand_selection_next(cs, row + 1)) {
+    /* after a removal <iter> points to the following row */
+    if (!valid || !cand_selection_contains(cs, row - 1))
+      valid = gtk_tree_model_iter_nth_child(model, &iter, NULL,
+                                            (gint) (row - removed));
+    if (!valid)
+      break;
+    if (func)
+      func(model, &iter, data);
+    valid = gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
+    removed++;
+  }
+  gtk_tree_view_set_model(list_view, model);
+  g_object_unref(model);
+}
+
+static gboolean candidate_in_set(GtGenomeNode *gn, gpointer data)
+{
+  return gt_hashmap_get((GtHashmap*) data, gn) != NULL;
+}
+
+static gboolean candidate_is_flcand(GtGenomeNode *gn, GT_UNUSED gpointer data)
+{
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *curnode;
+  gboolean flcand;
+
+  fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
+  curnode = gt_feature_node_iterator_next(fni);
+  flcand = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN) != NULL;
+  gt_feature_node_iterator_delete(fni);
+  return flcand;
+}
+/* <selection> related functions end */
+
 /* thread related functions start */
 static gboolean classify_nodes_finished(gpointer data)
 {
     ThreadData *threaddata = (ThreadData*) data;
 
+    perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
     g_source_remove(GPOINTER_TO_INT(
                                  g_object_get_data(G_OBJECT(threaddata->window),
                                                    "source_id")));
     gtk_widget_destroy(threaddata->window);
     reset_progressbar(threaddata->progressbar);
+    gtk_ltr_families_release_candidates(threaddata->ltrfams);
+    candidates_changed(threaddata->old_nodes);
 
     if (!threaddata->had_err) {
-      g_list_foreach(threaddata->references, (GFunc) remove_candidate, NULL);
+      GtHashmap *classified;
+      CandSelection *cs;
+      unsigned long i;
+
+      /* the list may have changed while the job was running, so the rows
+         of the classified candidates are looked up again */
+      classified = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+      for (i = 0; i < gt_array_size(threaddata->old_nodes); i++)
+        gt_hashmap_add(classified,
+                       *(GtGenomeNode**) gt_array_get(threaddata->old_nodes, i),
+                       (void*) 1);
+      cs = selection_new_by(threaddata->list_view, candidate_in_set,
+                            classified);
+      selection_remove_rows(threaddata->list_view, cs, remove_candidate, NULL);
+      cand_selection_delete(cs);
+      gt_hashmap_delete(classified);
       threaddata->ltrfams->unclassified_cands -=
                                            gt_array_size(threaddata->new_nodes);
       gtk_ltr_families_notebook_list_view_append_array(threaddata->ltrfams,
@@ -700,6 +1133,7 @@ static gboolean classify_nodes_finished(gpointer data)
                                               threaddata->new_nodes,
                                               NULL);
       update_main_tab_label(threaddata->ltrfams);
+      gtk_ltr_families_set_modified(threaddata->ltrfams, TRUE);
     } else {
       gt_error_set(threaddata->ltrfams->err,
                   "Could not classify the selected data: %s",
@@ -707,6 +1141,10 @@ static gboolean classify_nodes_finished(gpointer data)
       error_handle(gtk_widget_get_toplevel(GTK_WIDGET(threaddata->ltrfams)),
                    threaddata->ltrfams->err);
     }
+    perf_log_add_items(threaddata->perf, gt_array_size(threaddata->new_nodes));
+    gtk_ltr_families_log_perf(threaddata->ltrfams, threaddata->perf,
+                              threaddata->had_err != 0);
+    threaddata->perf = NULL;
     threaddata_delete(threaddata);
     return FALSE;
 }
@@ -731,6 +1169,7 @@ static gpointer classify_nodes_start(gpointer data)
                                              threaddata->new_nodes,
                                              threaddata->err);
   threaddata->had_err = gt_node_stream_pull(array_out_stream, threaddata->err);
+  perf_log_add_items(threaddata->perf, gt_array_size(threaddata->old_nodes));
 
   gt_node_stream_delete(classify_stream);
   gt_node_stream_delete(array_in_stream);
@@ -786,6 +1225,8 @@ static void draw_image(GtkLTRFamilies *ltrfams, GtGenomeNode *gn)
    gt_diagram_set_track_selector_func(ltrfams->diagram,
                                       ltrsift_track_selector_func,
                                       NULL);
+  memory_usage_set(ltrfams->memory, MEMORY_DIAGRAM,
+                   memory_usage_estimate_node(gn));
   gtk_widget_queue_draw_area(a, 0, 0, a->allocation.width,
                              a->allocation.height);
   gt_feature_index_delete(features);
@@ -830,50 +1271,141 @@ static gboolean image_area_expose_event(GtkWidget *widget,
 }
 /* <image_area> related functions end */
 
-/* drag'n'drop related functions start */
-static void on_drag_data_get(GtkWidget *widget,
-                             GT_UNUSED GdkDragContext *drag_context,
-                             GtkSelectionData *sdata,
-                             GT_UNUSED guint info,
-                             GT_UNUSED guint time,
-                             GT_UNUSED gpointer user_data)
+/* <overview> related functions start */
+/* the overview shows all candidates, the loaded ones with the name of their
+   family, the others with the family given by their index entry */
+ChromOverview* gtk_ltr_families_new_overview(GtkLTRFamilies *ltrfams)
 {
-  GtkTreeIter iter;
+  ChromOverview *co;
   GtkTreeModel *model;
-  GtkTreeSelection *sel;
-  GtkTreeRowReference *rowref;
-  FamilyTransferData *tdata;
+  GtkTreeIter iter;
+  GtArray *nodes,
+          *unloaded;
   GtGenomeNode *gn;
-  GList *rows, *tmp;
-
-  /* retrieve data from selected row, do nothing if no row is selected */
-  sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(widget));
-  model = gtk_tree_view_get_model(GTK_TREE_VIEW(widget));
-  if (gtk_tree_selection_count_selected_rows(sel) < 1)
-    return;
-  tdata = g_slice_new(FamilyTransferData);
-  tdata->nodes = gt_array_new(sizeof (GtGenomeNode*));
-  tdata->references = NULL;
-  tdata->list_view = GTK_TREE_VIEW(widget);
-
-  rows = gtk_tree_selection_get_selected_rows(sel, &model);
-  tmp = rows;
+  CandidateData *cdata;
+  ProjectIndexEntry *entry;
+  GtRange range;
+  gchar *name;
+  gboolean valid;
+  unsigned long i;
 
-  while (tmp != NULL) {
-    rowref = gtk_tree_row_reference_new(model, (GtkTreePath*) tmp->data);
-    tdata->references = g_list_prepend(tdata->references,
-                                       gtk_tree_row_reference_copy(rowref));
-    gtk_tree_row_reference_free(rowref);
-    gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-    gtk_tree_model_get(model, &iter,
-                       LTRFAMS_LV_NODE, &gn,
-                       LTRFAMS_LV_ROWREF, &tdata->rowref,
-                       -1);
-    gt_array_add(tdata->nodes, gn);
-    tmp = tmp->next;
+  co = chrom_overview_new();
+  if (!ltrfams->nodes) {
+    chrom_overview_finish(co);
+    return co;
   }
-  g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
-  g_list_free(rows);
+  for (i = 0; i < gt_array_size(ltrfams->regions); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(ltrfams->regions, i);
+    range = gt_genome_node_get_range(gn);
+    chrom_overview_set_length(co, gt_str_get(gt_genome_node_get_seqid(gn)),
+                              range.end);
+  }
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  valid = model ? gtk_tree_model_get_iter_first(model, &iter) : FALSE;
+  while (valid) {
+    gtk_tree_model_get(model, &iter,
+                       LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                       LTRFAMS_FAM_LV_OLDNAME, &name,
+                       -1);
+    for (i = 0; nodes && i < gt_array_size(nodes); i++) {
+      gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+      range = gt_genome_node_get_range(gn);
+      chrom_overview_add(co, gt_str_get(gt_genome_node_get_seqid(gn)),
+                         range.start, range.end, name, TRUE);
+    }
+    g_free(name);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  for (i = 0; i < gt_array_size(ltrfams->nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(ltrfams->nodes, i);
+    cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+    if (cdata && cdata->fam_ref)
+      continue;
+    range = gt_genome_node_get_range(gn);
+    chrom_overview_add(co, gt_str_get(gt_genome_node_get_seqid(gn)),
+                       range.start, range.end, NULL, TRUE);
+  }
+  if (ltrfams->index) {
+    unloaded = project_index_get_unloaded(ltrfams->index);
+    for (i = 0; i < gt_array_size(unloaded); i++) {
+      entry = project_index_get_entry(ltrfams->index,
+                                   *(unsigned long*) gt_array_get(unloaded, i));
+      chrom_overview_add(co, entry->seqid, entry->start, entry->end,
+                         entry->family, FALSE);
+    }
+    gt_array_delete(unloaded);
+  }
+  chrom_overview_finish(co);
+  return co;
+}
+
+/* returns a diagram of the loaded candidates overlapping <range> of <seqid>,
+   NULL if there are none */
+GtDiagram* gtk_ltr_families_new_diagram(GtkLTRFamilies *ltrfams,
+                                        const gchar *seqid, GtRange *range)
+{
+  GtFeatureIndex *features;
+  GtDiagram *diagram = NULL;
+  GtArray *nodes;
+  unsigned long i;
+  gint had_err = 0;
+
+  nodes = gt_array_new(sizeof (GtGenomeNode*));
+  location_index_find_range(ltrfams->locations, seqid, range->start,
+                            range->end, nodes);
+  if (gt_array_size(nodes) == 0 || !ltrfams->style) {
+    gt_array_delete(nodes);
+    return NULL;
+  }
+  features = gt_feature_index_memory_new();
+  for (i = 0; !had_err && i < gt_array_size(nodes); i++) {
+    had_err = gt_feature_index_add_feature_node(features,
+                                   *(GtFeatureNode**) gt_array_get(nodes, i),
+                                                ltrfams->err);
+  }
+  if (!had_err)
+    diagram = gt_diagram_new(features, seqid, range, ltrfams->style,
+                             ltrfams->err);
+  if (diagram)
+    gt_diagram_set_track_selector_func(diagram, ltrsift_track_selector_func,
+                                       NULL);
+  else
+    gt_error_unset(ltrfams->err);
+  gt_feature_index_delete(features);
+  gt_array_delete(nodes);
+  return diagram;
+}
+/* <overview> related functions end */
+
+/* drag'n'drop related functions start */
+static void on_drag_data_get(GtkWidget *widget,
+                             GT_UNUSED GdkDragContext *drag_context,
+                             GtkSelectionData *sdata,
+                             GT_UNUSED guint info,
+                             GT_UNUSED guint time,
+                             GT_UNUSED gpointer user_data)
+{
+  GtkTreeIter iter;
+  GtkTreeModel *model;
+  CandSelection *cs;
+  FamilyTransferData *tdata;
+
+  /* retrieve data from selected rows, do nothing if no row is selected */
+  cs = gtk_ltr_families_get_selection(GTK_TREE_VIEW(widget));
+  if (cand_selection_count(cs) < 1) {
+    cand_selection_delete(cs);
+    return;
+  }
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(widget));
+  tdata = g_slice_new(FamilyTransferData);
+  tdata->nodes = gt_array_new(sizeof (GtGenomeNode*));
+  tdata->selection = cs;
+  tdata->list_view = GTK_TREE_VIEW(widget);
+  gtk_ltr_families_get_selected_nodes(tdata->list_view, cs, tdata->nodes);
+  /* all rows of a list belong to the same family */
+  gtk_tree_model_iter_nth_child(model, &iter, NULL,
+                                (gint) cand_selection_next(cs, 0));
+  gtk_tree_model_get(model, &iter, LTRFAMS_LV_ROWREF, &tdata->rowref, -1);
 
   /* add retrieved data to GtkSelectionData object */
   gtk_selection_data_set(sdata,
@@ -931,6 +1463,7 @@ static void on_drag_data_received(GtkWidget *widget,
   GtFeatureNodeIterator *fni;
   GtGenomeNode *gn;
   GtArray *nodes;
+  FamilyStats *stats;
   gchar *oldname,
         curname[BUFSIZ];
   unsigned long i;
@@ -956,10 +1489,16 @@ static void on_drag_data_received(GtkWidget *widget,
   }
   gtk_tree_path_free(path);
 
+  /* the dropped candidates are added to the complete family */
+  if (gtk_ltr_families_load_family(ltrfams, model, &iter)) {
+    free_tdata(tdata);
+    return;
+  }
   gtk_tree_model_get(model, &iter,
                      LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
                      LTRFAMS_FAM_LV_TAB_CHILD, &tab_child,
                      LTRFAMS_FAM_LV_OLDNAME, &oldname,
+                     LTRFAMS_FAM_LV_STATS, &stats,
                      -1);
 
   /* tdata->rowref points to family in <list_view_families>. If <nodes> was
@@ -969,6 +1508,7 @@ static void on_drag_data_received(GtkWidget *widget,
     GtkTreePath *tv_path;
     GtkTreeIter tv_iter;
     GtArray *tmp_nodes;
+    FamilyStats *tmp_stats;
     char *tmp_oldname,
          tmp_curname[BUFSIZ];
 
@@ -977,8 +1517,11 @@ static void on_drag_data_received(GtkWidget *widget,
     gtk_tree_model_get(model, &tv_iter,
                        LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes,
                        LTRFAMS_FAM_LV_OLDNAME, &tmp_oldname,
+                       LTRFAMS_FAM_LV_STATS, &tmp_stats,
                        -1);
     remove_nodes_from_array(tmp_nodes, tdata->nodes, FALSE, NULL);
+    if (tmp_stats)
+      family_stats_remove_array(tmp_stats, tdata->nodes);
     g_snprintf(tmp_curname, BUFSIZ, "%s (%lu)",
                tmp_oldname, gt_array_size(tmp_nodes));
     gtk_list_store_set(GTK_LIST_STORE(model), &tv_iter,
@@ -992,7 +1535,8 @@ static void on_drag_data_received(GtkWidget *widget,
   }
 
   /* remove rows from drag source */
-  g_list_foreach(tdata->references, (GFunc) remove_candidate, NULL);
+  selection_remove_rows(tdata->list_view, tdata->selection, remove_candidate,
+                        NULL);
 
   for (i = 0; i < gt_array_size(tdata->nodes); i++) {
     CandidateData *cdata;
@@ -1004,10 +1548,11 @@ static void on_drag_data_received(GtkWidget *widget,
     tree_view_details_clear_on_equal_nodes(ltrfams, gn);
     fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
     curnode = gt_feature_node_iterator_next(fni);
-    gt_feature_node_set_attribute(curnode, ATTR_LTRFAM, oldname);
     attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN);
-    if (attr)
+    if (attr) {
       gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
+      filter_cache_node_changed(gn);
+    }
     gt_feature_node_iterator_delete(fni);
     path = gtk_tree_model_get_path(model, &iter);
     tv_ref2 = gtk_tree_row_reference_new(model, path);
@@ -1015,6 +1560,8 @@ static void on_drag_data_received(GtkWidget *widget,
     cdata->fam_ref = tv_ref2;
     cdata->cand_ref = NULL;
     gt_array_add(nodes, gn);
+    if (stats)
+      family_stats_add(stats, gn);
     if (tab_child)
       gtk_ltr_families_notebook_list_view_append_gn(ltrfams,
                                                     GTK_TREE_VIEW(tab_child),
@@ -1028,21 +1575,56 @@ static void on_drag_data_received(GtkWidget *widget,
                      LTRFAMS_FAM_LV_CURNAME, curname,
                      -1);
   gtk_tree_selection_set_mode(sel, GTK_SELECTION_MULTIPLE);
+  gtk_ltr_families_family_name_changed(ltrfams, model, &iter);
+  gtk_ltr_families_set_modified(ltrfams, TRUE);
   g_free(oldname);
   free_tdata(tdata);
 }
 /* drag'n'drop related functions end */
 
+/* refreshes the family statistics of <nodes> after features were added to
+   them by a background job */
+static void update_family_stats_of_nodes(GtArray *nodes)
+{
+  GtkTreeModel *model;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  GtGenomeNode *gn;
+  CandidateData *cdata;
+  FamilyStats *stats;
+  unsigned long i;
+
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+    cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+    if (!cdata || !cdata->fam_ref ||
+        !gtk_tree_row_reference_valid(cdata->fam_ref))
+      continue;
+    model = gtk_tree_row_reference_get_model(cdata->fam_ref);
+    path = gtk_tree_row_reference_get_path(cdata->fam_ref);
+    if (gtk_tree_model_get_iter(model, &iter, path)) {
+      gtk_tree_model_get(model, &iter, LTRFAMS_FAM_LV_STATS, &stats, -1);
+      if (stats)
+        family_stats_update(stats, gn);
+    }
+    gtk_tree_path_free(path);
+  }
+}
+
 /* RefSeqMatch related functions start */
 static gboolean refseq_match_cands_finished(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
 
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
   g_source_remove(GPOINTER_TO_INT(
                                g_object_get_data(G_OBJECT(threaddata->window),
                                                  "source_id")));
   gtk_widget_destroy(threaddata->window);
   reset_progressbar(threaddata->progressbar);
+  gtk_ltr_families_release_candidates(threaddata->ltrfams);
+  /* the candidates may have been changed before an error */
+  candidates_changed(threaddata->nodes);
 
   if (threaddata->had_err) {
     if (threaddata->set_id != GT_UNDEF_ULONG) {
@@ -1063,7 +1645,13 @@ static gboolean refseq_match_cands_finished(gpointer data)
     error_handle(gtk_widget_get_toplevel(GTK_WIDGET(threaddata->ltrfams)),
                  threaddata->ltrfams->err);
     gdk_threads_leave();
+  } else {
+    update_family_stats_of_nodes(threaddata->nodes);
+    gtk_ltr_families_set_modified(threaddata->ltrfams, TRUE);
   }
+  gtk_ltr_families_log_perf(threaddata->ltrfams, threaddata->perf,
+                            threaddata->had_err != 0);
+  threaddata->perf = NULL;
   gt_array_delete(threaddata->nodes);
   threaddata_delete(threaddata);
   return FALSE;
@@ -1138,6 +1726,8 @@ static gpointer refseq_match_cands_start(gpointer data)
     g_snprintf(seq_out_file, BUFSIZ, SEQFILE_FOR_REFSEQ,
                g_get_home_dir());
   if (!threaddata->had_err) {
+    perf_log_stage(threaddata->perf, PERF_STAGE_MATCH);
+    perf_log_add_items(threaddata->perf, gt_array_size(threaddata->nodes));
     array_in_stream = gt_array_in_stream_new(threaddata->nodes,
                                              NULL, threaddata->err);
     refseq_match_stream = gt_ltr_refseq_match_stream_new(array_in_stream,
@@ -1536,6 +2126,7 @@ void gtk_ltr_families_refseq_match(GtArray *nodes, GtkLTRFamilies *ltrfams)
   threaddata->match = TRUE;
   threaddata->progress = 0;
   threaddata->err = gt_error_new();
+  threaddata->perf = perf_log_new(PERF_JOB_MATCH);
 
   if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(checkb))) {
     gchar *tmp;
@@ -1548,10 +2139,12 @@ void gtk_ltr_families_refseq_match(GtArray *nodes, GtkLTRFamilies *ltrfams)
     threaddata->set_id = result;
   progress_dialog_init(threaddata, toplevel);
 
+  gtk_ltr_families_hold_candidates(ltrfams);
   if (!g_thread_create(refseq_match_cands_start, (gpointer) threaddata, FALSE,
                        NULL)) {
     gt_error_set(ltrfams->err, "Could not create new thread.");
     error_handle(toplevel, ltrfams->err);
+    gtk_ltr_families_release_candidates(ltrfams);
   }
 }
 /* RefSeqMatch related functions end */
@@ -1560,11 +2153,15 @@ static gboolean orffind_finished(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
 
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
   g_source_remove(GPOINTER_TO_INT(
                                g_object_get_data(G_OBJECT(threaddata->window),
                                                  "source_id")));
   gtk_widget_destroy(threaddata->window);
   reset_progressbar(threaddata->progressbar);
+  gtk_ltr_families_release_candidates(threaddata->ltrfams);
+  /* the candidates may have been changed before an error */
+  candidates_changed(threaddata->nodes);
 
   if (threaddata->had_err) {
     gt_error_set(threaddata->ltrfams->err,
@@ -1574,7 +2171,13 @@ static gboolean orffind_finished(gpointer data)
     error_handle(gtk_widget_get_toplevel(GTK_WIDGET(threaddata->ltrfams)),
                  threaddata->ltrfams->err);
     gdk_threads_leave();
+  } else {
+    update_family_stats_of_nodes(threaddata->nodes);
+    gtk_ltr_families_set_modified(threaddata->ltrfams, TRUE);
   }
+  gtk_ltr_families_log_perf(threaddata->ltrfams, threaddata->perf,
+                            threaddata->had_err != 0);
+  threaddata->perf = NULL;
   gt_array_delete(threaddata->nodes);
   threaddata_delete(threaddata);
   return FALSE;
@@ -1592,6 +2195,7 @@ static gpointer orffind_start(gpointer data)
   gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
                             "Detecting ORFs");
 
+  perf_log_stage(threaddata->perf, PERF_STAGE_ENCSEQ);
   if (!threaddata->had_err) {
     indexname =
       gtk_project_settings_get_indexname(GTK_PROJECT_SETTINGS(threaddata->ltrfams->projset));
@@ -1603,6 +2207,8 @@ static gpointer orffind_start(gpointer data)
   if (!threaddata->had_err) {
     GtGenomeNode *gn;
     gt_assert(encseq);
+    perf_log_stage(threaddata->perf, PERF_STAGE_ORFS);
+    perf_log_add_items(threaddata->perf, gt_array_size(threaddata->nodes));
 
     array_in_stream = gt_array_in_stream_new(threaddata->nodes,
                                              NULL, threaddata->err);
@@ -1643,12 +2249,15 @@ void gtk_ltr_families_orffind(GtArray *nodes, GtkLTRFamilies *ltrfams)
   threaddata->nodes = nodes;
   threaddata->orf = TRUE;
   threaddata->err = gt_error_new();
+  threaddata->perf = perf_log_new(PERF_JOB_ORFFIND);
   progress_dialog_init(threaddata, toplevel);
 
+  gtk_ltr_families_hold_candidates(ltrfams);
   if (!g_thread_create(orffind_start, (gpointer) threaddata, FALSE,
                        NULL)) {
     gt_error_set(ltrfams->err, "Could not create new thread.");
     error_handle(toplevel, ltrfams->err);
+    gtk_ltr_families_release_candidates(ltrfams);
   }
 }
 
@@ -1657,13 +2266,10 @@ static void notebook_list_view_menu_match_clicked(GT_UNUSED GtkWidget *menuitem,
                                                   GtkLTRFamilies *ltrfams)
 {
   GtkTreeView *list_view;
-  GtkTreeSelection *sel;
-  GtkTreeModel *model;
-  GtkTreeIter iter;
   GtkWidget *tab_child;
+  CandSelection *cs;
   GtArray *nodes;
-  GtGenomeNode *gn;
-  GList *children, *rows, *tmp;
+  GList *children;
   gint tab_no;
 
   nodes = gt_array_new(sizeof (GtGenomeNode*));
@@ -1672,24 +2278,51 @@ static void notebook_list_view_menu_match_clicked(GT_UNUSED GtkWidget *menuitem,
                                         tab_no);
   children = gtk_container_get_children(GTK_CONTAINER(tab_child));
   list_view = GTK_TREE_VIEW(g_list_first(children)->data);
-  model = gtk_tree_view_get_model(list_view);
-  sel = gtk_tree_view_get_selection(list_view);
-  rows = gtk_tree_selection_get_selected_rows(sel, &model);
-  tmp = rows;
-  while (tmp != NULL) {
-    gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-    gtk_tree_model_get(model, &iter,
-                       LTRFAMS_FAM_LV_NODE_ARRAY, &gn, -1);
-    gt_array_add(nodes, gn);
-    tmp = tmp->next;
-  }
+  cs = gtk_ltr_families_get_selection(list_view);
+  gtk_ltr_families_get_selected_nodes(list_view, cs, nodes);
+  cand_selection_delete(cs);
   gt_genome_nodes_sort_stable(nodes);
-  g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
-  g_list_free(rows);
+  g_list_free(children);
 
   gtk_ltr_families_refseq_match(nodes, ltrfams);
 }
 
+static GtkTreeView* notebook_current_list_view(GtkLTRFamilies *ltrfams)
+{
+  GtkWidget *tab_child;
+  GtkTreeView *list_view;
+  GList *children;
+  gint tab_no;
+
+  tab_no = gtk_notebook_get_current_page(GTK_NOTEBOOK(ltrfams->nb_family));
+  tab_child = gtk_notebook_get_nth_page(GTK_NOTEBOOK(ltrfams->nb_family),
+                                        tab_no);
+  children = gtk_container_get_children(GTK_CONTAINER(tab_child));
+  list_view = GTK_TREE_VIEW(g_list_first(children)->data);
+  g_list_free(children);
+  return list_view;
+}
+
+static void notebook_list_view_menu_invert_clicked(GT_UNUSED GtkWidget *m,
+                                                   GtkLTRFamilies *ltrfams)
+{
+  GtkTreeView *list_view;
+  CandSelection *cs;
+
+  list_view = notebook_current_list_view(ltrfams);
+  cs = gtk_ltr_families_get_selection(list_view);
+  cand_selection_invert(cs);
+  gtk_ltr_families_set_selection(list_view, cs);
+  cand_selection_delete(cs);
+}
+
+static void notebook_list_view_menu_select_fl_clicked(GT_UNUSED GtkWidget *m,
+                                                      GtkLTRFamilies *ltrfams)
+{
+  gtk_ltr_families_select_by(notebook_current_list_view(ltrfams),
+                             candidate_is_flcand, NULL);
+}
+
 static void
 notebook_list_view_menu_filter_clicked(GT_UNUSED GtkWidget *menuitem,
                                        GtkLTRFamilies *ltrfams)
@@ -1725,15 +2358,16 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
   GtkTreeView *list_view,
               *tmp_view;
   GtkTreeModel *model;
-  GtkTreeSelection *sel;
   GtkTreeIter iter;
-  GtkTreeRowReference *rowref, *tmp_rowref;
+  GtkTreeRowReference *tmp_rowref;
+  CandSelection *cs;
   GtArray *nodes;
-  GList *children, *rows, *tmp, *tmp_children, *references = NULL;
+  GList *children, *tmp_children;
   GtGenomeNode *gn;
   gchar tmp_curname[BUFSIZ];
   gint main_tab_no,
        tab_no;
+  unsigned long i;
 
   tab_no = gtk_notebook_get_current_page(GTK_NOTEBOOK(ltrfams->nb_family));
   tab_child = gtk_notebook_get_nth_page(GTK_NOTEBOOK(ltrfams->nb_family),
@@ -1743,9 +2377,12 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
   children = gtk_container_get_children(GTK_CONTAINER(tab_child));
   list_view = GTK_TREE_VIEW(g_list_first(children)->data);
   model = gtk_tree_view_get_model(list_view);
-  sel = gtk_tree_view_get_selection(list_view);
-  if (gtk_tree_selection_count_selected_rows(sel) == 0)
+  cs = gtk_ltr_families_get_selection(list_view);
+  if (cand_selection_count(cs) == 0) {
+    cand_selection_delete(cs);
+    g_list_free(children);
     return;
+  }
 
   dialog = gtk_message_dialog_new(NULL,
                                   GTK_DIALOG_MODAL |
@@ -1758,6 +2395,8 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
   gtk_window_set_position(GTK_WINDOW(dialog), GTK_WIN_POS_CENTER_ALWAYS);
   if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_YES) {
     gtk_widget_destroy(dialog);
+    cand_selection_delete(cs);
+    g_list_free(children);
     return;
   } else {
     nodes = gt_array_new(sizeof(GtGenomeNode*));
@@ -1765,16 +2404,13 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
                                          main_tab_no);
     tmp_children = gtk_container_get_children(GTK_CONTAINER(main_tab));
     tmp_view = GTK_TREE_VIEW(g_list_first(tmp_children)->data);
-    rows = gtk_tree_selection_get_selected_rows(sel, &model);
-    tmp = rows;
-    while (tmp != NULL) {
-      rowref = gtk_tree_row_reference_new(model, (GtkTreePath*) tmp->data);
-      gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-      gtk_tree_model_get(model, &iter,
-                         LTRFAMS_LV_NODE, &gn,
-                         LTRFAMS_LV_ROWREF, &tmp_rowref,
-                         -1);
-      gt_array_add(nodes, gn);
+    gtk_ltr_families_get_selected_nodes(list_view, cs, nodes);
+    /* all rows of a list belong to the same family */
+    gtk_tree_model_iter_nth_child(model, &iter, NULL,
+                                  (gint) cand_selection_next(cs, 0));
+    gtk_tree_model_get(model, &iter, LTRFAMS_LV_ROWREF, &tmp_rowref, -1);
+    for (i = 0; i < gt_array_size(nodes); i++) {
+      gn = *(GtGenomeNode**) gt_array_get(nodes, i);
       tree_view_details_clear_on_equal_nodes(ltrfams, gn);
       if (tab_no != main_tab_no) {
         GtFeatureNode *curnode;
@@ -1786,20 +2422,18 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
         gt_feature_node_remove_attribute(curnode, ATTR_LTRFAM);
         if ((attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN)))
           gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
+        filter_cache_node_changed(gn);
         gtk_ltr_families_notebook_list_view_append_gn(ltrfams, tmp_view, gn,
                                                       NULL, NULL, NULL, NULL);
         gt_feature_node_iterator_delete(fni);
       }
-      references = g_list_prepend(references,
-                                  gtk_tree_row_reference_copy(rowref));
-      gtk_tree_row_reference_free(rowref);
-      tmp = tmp->next;
     }
     if (tmp_rowref) {
       GtkTreeModel *model2;
       GtkTreePath *tv_path;
       GtkTreeIter tv_iter;
       GtArray *tmp_nodes;
+      FamilyStats *tmp_stats;
       gchar *tmp_oldname;
       model2 =
             gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
@@ -1808,8 +2442,11 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
       gtk_tree_model_get(model2, &tv_iter,
                          LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes,
                          LTRFAMS_FAM_LV_OLDNAME, &tmp_oldname,
+                         LTRFAMS_FAM_LV_STATS, &tmp_stats,
                          -1);
       remove_nodes_from_array(tmp_nodes, nodes, FALSE, NULL);
+      if (tmp_stats)
+        family_stats_remove_array(tmp_stats, nodes);
       ltrfams->unclassified_cands += gt_array_size(nodes);
       update_main_tab_label(ltrfams);
       g_snprintf(tmp_curname, BUFSIZ, "%s (%lu)",
@@ -1820,17 +2457,18 @@ notebook_list_view_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
       gtk_tree_path_free(tv_path);
       g_free(tmp_oldname);
     } else {
+      for (i = 0; i < gt_array_size(nodes); i++)
+        candidate_location_remove(ltrfams,
+                                  *(GtGenomeNode**) gt_array_get(nodes, i));
       remove_nodes_from_array(ltrfams->nodes, nodes, TRUE, NULL);
       gtk_ltr_families_update_unclassified_cands(ltrfams,
                                                  (-1) * gt_array_size(nodes));
     }
-    g_list_foreach(references, (GFunc) remove_row, NULL);
-    g_list_foreach(references, (GFunc) gtk_tree_row_reference_free, NULL);
-    g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
-    g_list_free(references);
-    g_list_free(rows);
+    selection_remove_rows(list_view, cs, NULL, NULL);
+    cand_selection_delete(cs);
     g_list_free(tmp_children);
     gt_array_delete(nodes);
+    gtk_ltr_families_set_modified(ltrfams, TRUE);
   }
   g_list_free(children);
   gtk_widget_destroy(dialog);
@@ -1866,6 +2504,20 @@ static void notebook_list_view_menu(GT_UNUSED GtkWidget *tree_view,
                    G_CALLBACK(notebook_list_view_menu_remove_clicked), ltrfams);
   gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
 
+  menuitem = gtk_separator_menu_item_new();
+  gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+
+  menuitem = gtk_menu_item_new_with_label(LTR_FAMILIES_INVERT_SELECTION);
+  g_signal_connect(menuitem, "activate",
+                   G_CALLBACK(notebook_list_view_menu_invert_clicked), ltrfams);
+  gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+
+  menuitem = gtk_menu_item_new_with_label(LTR_FAMILIES_SELECT_FLCANDS);
+  g_signal_connect(menuitem, "activate",
+                   G_CALLBACK(notebook_list_view_menu_select_fl_clicked),
+                   ltrfams);
+  gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+
   gtk_widget_show_all(menu);
   gtk_menu_popup(GTK_MENU(menu), NULL, NULL, NULL, NULL,
                  (event != NULL) ? event->button : 0,
@@ -1932,6 +2584,103 @@ static void list_view_families_menu_edit_clicked(GT_UNUSED GtkWidget *menuitem,
   gtk_tree_path_free(path);
 }
 
+/* reads the candidates of all selected families which are still unloaded */
+static gint list_view_families_load_selected(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeSelection *sel;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GList *rows, *tmp;
+  gint had_err = 0;
+
+  if (!ltrfams->index)
+    return 0;
+  sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(ltrfams->list_view_families));
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  rows = gtk_tree_selection_get_selected_rows(sel, &model);
+  tmp = rows;
+  while (!had_err && tmp != NULL) {
+    gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
+    had_err = gtk_ltr_families_load_family(ltrfams, model, &iter);
+    tmp = tmp->next;
+  }
+  g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
+  g_list_free(rows);
+  return had_err;
+}
+
+/* number of candidates of a family, whether it has been loaded or not */
+static unsigned long list_view_families_get_size(GtkLTRFamilies *ltrfams,
+                                                 GtkTreeModel *model,
+                                                 GtkTreeIter *iter)
+{
+  GtArray *nodes;
+  gchar *name;
+  unsigned long size;
+
+  gtk_tree_model_get(model, iter,
+                     LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                     LTRFAMS_FAM_LV_OLDNAME, &name,
+                     -1);
+  size = nodes ? gt_array_size(nodes) : 0;
+  if (ltrfams->index && name &&
+      !project_index_family_is_loaded(ltrfams->index, name))
+    size = project_index_family_size(ltrfams->index, name);
+  g_free(name);
+  return size;
+}
+
+/* shows the statistics of the selected family, they are maintained with
+   every change of the family, so they are shown without recomputation */
+static void list_view_families_update_stats(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeSelection *sel;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  FamilyStats *stats = NULL;
+  GList *rows;
+  gchar *name = NULL,
+        text[BUFSIZ];
+  unsigned long num_domains,
+                count;
+
+  if (!ltrfams->family_stats)
+    return;
+  sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(ltrfams->list_view_families));
+  if (gtk_tree_selection_count_selected_rows(sel) != 1) {
+    gtk_label_set_text(GTK_LABEL(ltrfams->family_stats), FAMS_STATS_NONE);
+    return;
+  }
+  rows = gtk_tree_selection_get_selected_rows(sel, &model);
+  gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) rows->data);
+  gtk_tree_model_get(model, &iter,
+                     LTRFAMS_FAM_LV_STATS, &stats,
+                     LTRFAMS_FAM_LV_OLDNAME, &name,
+                     -1);
+  if (ltrfams->index && name &&
+      !project_index_family_is_loaded(ltrfams->index, name)) {
+    g_snprintf(text, BUFSIZ, FAMS_STATS_UNLOADED,
+               list_view_families_get_size(ltrfams, model, &iter));
+  } else if (stats) {
+    num_domains = family_stats_num_domains_mode(stats, &count);
+    g_snprintf(text, BUFSIZ, FAMS_STATS, family_stats_size(stats),
+               num_domains, count, family_stats_ltr_length_median(stats),
+               family_stats_elem_length_median(stats));
+  } else
+    g_snprintf(text, BUFSIZ, "%s", FAMS_STATS_NONE);
+  gtk_label_set_text(GTK_LABEL(ltrfams->family_stats), text);
+  g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
+  g_list_free(rows);
+  g_free(name);
+}
+
+static void list_view_families_selection_changed(GT_UNUSED
+                                                 GtkTreeSelection *sel,
+                                                 GtkLTRFamilies *ltrfams)
+{
+  list_view_families_update_stats(ltrfams);
+}
+
 static void list_view_families_menu_match_clicked(GT_UNUSED GtkWidget *m,
                                                   GtkLTRFamilies *ltrfams)
 {
@@ -1944,6 +2693,8 @@ static void list_view_families_menu_match_clicked(GT_UNUSED GtkWidget *m,
   sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(ltrfams->list_view_families));
   if (gtk_tree_selection_count_selected_rows(sel) == 0)
     return;
+  if (list_view_families_load_selected(ltrfams))
+    return;
 
   nodes = gt_array_new(sizeof (GtGenomeNode*));
   model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
@@ -1970,7 +2721,6 @@ static void list_view_families_menu_filter_clicked(GT_UNUSED GtkWidget *m,
   GtkTreeModel *model;
   GtkTreeIter iter;
   GtkTreeSelection *sel;
-  GtArray *nodes;
   GList *rows, *tmp;
   gchar text[BUFSIZ];
   unsigned long cands = 0;
@@ -1981,9 +2731,7 @@ static void list_view_families_menu_filter_clicked(GT_UNUSED GtkWidget *m,
   tmp = rows;
   while (tmp != NULL) {
     gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-    gtk_tree_model_get(model, &iter,
-                       LTRFAMS_FAM_LV_NODE_ARRAY, &nodes, -1);
-    cands += gt_array_size(nodes);
+    cands += list_view_families_get_size(ltrfams, model, &iter);
     tmp = tmp->next;
   }
   g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
@@ -2007,6 +2755,8 @@ static void list_view_families_menu_merge_clicked(GT_UNUSED GtkWidget *menuitem,
   GtkTreePath *path;
   GtkTreeRowReference *rowref;
   GtArray *nodes, *tmp_nodes;
+  FamilyStats *stats = NULL, *tmp_stats;
+  GtkTreeIter stats_iter;
   gchar cur_name[BUFSIZ];
   GtFeatureNode *curnode;
   GtFeatureNodeIterator *fni;
@@ -2026,7 +2776,8 @@ static void list_view_families_menu_merge_clicked(GT_UNUSED GtkWidget *menuitem,
   gtk_box_pack_start_defaults(GTK_BOX(GTK_DIALOG(dialog)->vbox), label);
   gtk_box_pack_start_defaults(GTK_BOX(GTK_DIALOG(dialog)->vbox), entry);
   gtk_widget_show_all(dialog);
-  if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_OK) {
+  if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_OK ||
+      list_view_families_load_selected(ltrfams)) {
     gtk_widget_destroy(dialog);
     return;
   }
@@ -2041,10 +2792,26 @@ static void list_view_families_menu_merge_clicked(GT_UNUSED GtkWidget *menuitem,
     references = g_list_prepend(references,
                                 gtk_tree_row_reference_copy(rowref));
     gtk_tree_row_reference_free(rowref);
-    gtk_tree_model_get(model, &iter, LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes, -1);
+    gtk_tree_model_get(model, &iter,
+                       LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes,
+                       LTRFAMS_FAM_LV_STATS, &tmp_stats,
+                       -1);
     gt_array_add_array(nodes, tmp_nodes);
+    /* the statistics of the largest family are reused for the merged one */
+    if (tmp_stats && (!stats ||
+                      family_stats_size(tmp_stats) > family_stats_size(stats))) {
+      stats = tmp_stats;
+      stats_iter = iter;
+    }
     tmp = tmp->next;
   }
+  if (stats) {
+    gtk_list_store_set(GTK_LIST_STORE(model), &stats_iter,
+                       LTRFAMS_FAM_LV_STATS, NULL,
+                       -1);
+  } else
+    stats = family_stats_new();
+  family_stats_add_array(stats, nodes);
   gtk_list_store_append(GTK_LIST_STORE(model), &iter);
   path = gtk_tree_model_get_path(model, &iter);
   rowref = gtk_tree_row_reference_new(model, path);
@@ -2056,11 +2823,11 @@ static void list_view_families_menu_merge_clicked(GT_UNUSED GtkWidget *menuitem,
     cdata->cand_ref = NULL;
     fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
     curnode = gt_feature_node_iterator_next(fni);
-    gt_feature_node_set_attribute(curnode, ATTR_LTRFAM,
-                                  gtk_entry_get_text(GTK_ENTRY(entry)));
     attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN);
-    if (attr)
+    if (attr) {
       gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
+      filter_cache_node_changed(gn);
+    }
     gt_feature_node_iterator_delete(fni);
 
   }
@@ -2074,6 +2841,7 @@ static void list_view_families_menu_merge_clicked(GT_UNUSED GtkWidget *menuitem,
                      LTRFAMS_FAM_LV_OLDNAME,
                      gtk_entry_get_text(GTK_ENTRY(entry)),
                      LTRFAMS_FAM_LV_ROWREF, rowref,
+                     LTRFAMS_FAM_LV_STATS, stats,
                      -1);
   gtk_widget_destroy(dialog);
   g_list_foreach(references, (GFunc) remove_merged_family, ltrfams);
@@ -2081,6 +2849,8 @@ static void list_view_families_menu_merge_clicked(GT_UNUSED GtkWidget *menuitem,
   g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
   g_list_free(references);
   g_list_free(rows);
+  gtk_ltr_families_family_name_changed(ltrfams, model, &iter);
+  gtk_ltr_families_set_modified(ltrfams, TRUE);
 }
 
 static void
@@ -2128,10 +2898,126 @@ list_view_families_menu_remove_clicked(GT_UNUSED GtkWidget *menuitem,
     g_list_free(references);
     g_list_free(rows);
     update_main_tab_label(ltrfams);
+    gtk_ltr_families_set_modified(ltrfams, TRUE);
   }
   gtk_widget_destroy(dialog);
 }
 
+static gboolean export_families_finished(gpointer data)
+{
+  ThreadData *threaddata = (ThreadData*) data;
+
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
+  g_source_remove(GPOINTER_TO_INT(
+                               g_object_get_data(G_OBJECT(threaddata->window),
+                                                 "source_id")));
+  gtk_widget_destroy(threaddata->window);
+  reset_progressbar(threaddata->progressbar);
+  gtk_ltr_families_release_candidates(threaddata->ltrfams);
+
+  if (threaddata->had_err) {
+    gt_error_set(threaddata->ltrfams->err, "error exporting families: %s",
+                 gt_error_get(threaddata->err));
+    gdk_threads_enter();
+    error_handle(gtk_widget_get_toplevel(GTK_WIDGET(threaddata->ltrfams)),
+                 threaddata->ltrfams->err);
+    gdk_threads_leave();
+  }
+  gtk_ltr_families_log_perf(threaddata->ltrfams, threaddata->perf,
+                            threaddata->had_err != 0);
+  threaddata->perf = NULL;
+  family_export_delete(threaddata->famexport);
+  threaddata_delete(threaddata);
+  return FALSE;
+}
+
+static gpointer export_families_start(gpointer data)
+{
+  ThreadData *threaddata = (ThreadData*) data;
+
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
+                            "Exporting families");
+  perf_log_stage(threaddata->perf, PERF_STAGE_EXPORT);
+  perf_log_add_items(threaddata->perf,
+                     family_export_total(threaddata->famexport));
+  threaddata->had_err = family_export_run(threaddata->famexport,
+                                          bgzf_default_threads(),
+                                          &threaddata->progress,
+                                          threaddata->err);
+  g_idle_add(export_families_finished, data);
+  return NULL;
+}
+
+/* adds the selected families to <fe> and writes them in the background,
+   one file per family and several families at once */
+static void list_view_families_export_multiple(GtkLTRFamilies *ltrfams,
+                                               FamilyExport *fe)
+{
+  ThreadData *threaddata;
+  GtkWidget *toplevel,
+            *dialog;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtkTreeSelection *sel;
+  GtArray *nodes;
+  GList *rows,
+        *tmp;
+  gchar *famname;
+  unsigned long existing;
+
+  toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
+  sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(
+                                                ltrfams->list_view_families));
+  rows = gtk_tree_selection_get_selected_rows(sel, &model);
+  tmp = rows;
+  while (tmp != NULL) {
+    gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
+    gtk_tree_model_get(model, &iter,
+                       LTRFAMS_FAM_LV_OLDNAME, &famname,
+                       LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                       -1);
+    family_export_add(fe, famname, nodes);
+    g_free(famname);
+    tmp = tmp->next;
+  }
+  g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
+  g_list_free(rows);
+
+  /* the overwrite question is asked once for all files */
+  if ((existing = family_export_num_existing(fe)) > 0) {
+    dialog = gtk_message_dialog_new(GTK_WINDOW(toplevel),
+                                    GTK_DIALOG_MODAL |
+                                    GTK_DIALOG_DESTROY_WITH_PARENT,
+                                    GTK_MESSAGE_QUESTION, GTK_BUTTONS_YES_NO,
+                                    FAMS_EXPORT_EXISTING, existing);
+    gtk_window_set_title(GTK_WINDOW(dialog), "Attention!");
+    gtk_window_set_position(GTK_WINDOW(dialog), GTK_WIN_POS_CENTER_ALWAYS);
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_YES) {
+      gtk_widget_destroy(dialog);
+      family_export_delete(fe);
+      return;
+    }
+    gtk_widget_destroy(dialog);
+  }
+
+  threaddata = threaddata_new();
+  threaddata->ltrfams = ltrfams;
+  threaddata->progressbar = ltrfams->progressbar;
+  threaddata->progress = 0;
+  threaddata->famexport = fe;
+  threaddata->err = gt_error_new();
+  threaddata->perf = perf_log_new(PERF_JOB_EXPORT);
+  progress_dialog_init(threaddata, toplevel);
+
+  gtk_ltr_families_hold_candidates(ltrfams);
+  if (!g_thread_create(export_families_start, (gpointer) threaddata, FALSE,
+                       NULL)) {
+    gt_error_set(ltrfams->err, "Could not create new thread.");
+    error_handle(toplevel, ltrfams->err);
+    gtk_ltr_families_release_candidates(ltrfams);
+  }
+}
+
 static void list_view_families_menu_export_annotation(GtkLTRFamilies *ltrfams,
                                                       gboolean multi)
 {
@@ -2185,6 +3071,11 @@ static void list_view_families_menu_export_annotation(GtkLTRFamilies *ltrfams,
     gtk_widget_destroy(filechooser);
     return;
   }
+  if (list_view_families_load_selected(ltrfams)) {
+    g_free(filename);
+    return;
+  }
+  gtk_ltr_families_sync_family_names(ltrfams);
 
   if (!multi) {
     nodes = gt_array_new(sizeof (GtGenomeNode*));
@@ -2205,27 +3096,11 @@ static void list_view_families_menu_export_annotation(GtkLTRFamilies *ltrfams,
     gt_array_delete(nodes);
     g_free(filename);
   } else {
-    rows = gtk_tree_selection_get_selected_rows(sel, &model);
-    tmp = rows;
-    while (tmp != NULL) {
-      gchar *famname,
-            *filen;
-
-      gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-      gtk_tree_model_get(model, &iter,
-                         LTRFAMS_FAM_LV_OLDNAME, &famname,
-                         LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
-                         -1);
-      gt_genome_nodes_sort_stable(nodes);
-      filen = g_strdup_printf("%s_%s", filename, famname);
-      export_annotation(nodes, regions, filename, flcands,
-                        gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)));
-      g_free(famname);
-      g_free(filen);
-      tmp = tmp->next;
-    }
+    list_view_families_export_multiple(ltrfams,
+                                       family_export_new(filename, regions,
+                                                         TRUE, NULL,
+                                                         flcands));
     g_free(filename);
-    g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
   }
 }
 
@@ -2343,6 +3218,11 @@ static void list_view_families_menu_export_sequences(GtkLTRFamilies *ltrfams,
     gtk_widget_destroy(filechooser);
     return;
   }
+  if (list_view_families_load_selected(ltrfams)) {
+    g_free(filename);
+    return;
+  }
+  gtk_ltr_families_sync_family_names(ltrfams);
 
   if (!multi) {
     nodes = gt_array_new(sizeof(GtGenomeNode*));
@@ -2363,27 +3243,12 @@ static void list_view_families_menu_export_sequences(GtkLTRFamilies *ltrfams,
     gt_array_delete(nodes);
     g_free(filename);
   } else {
-    rows = gtk_tree_selection_get_selected_rows(sel, &model);
-    tmp = rows;
-    while (tmp != NULL) {
-      gchar *famname,
-            *filen;
-
-      gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-      gtk_tree_model_get(model, &iter,
-                         LTRFAMS_FAM_LV_OLDNAME, &famname,
-                         LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
-                         -1);
-      gt_genome_nodes_sort_stable(nodes);
-      filen = g_strdup_printf("%s_%s", filename, famname);
-      export_sequences(nodes, filen, indexname, flcands,
-                       gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)));
-      g_free(famname);
-      g_free(filen);
-      tmp = tmp->next;
-    }
+    list_view_families_export_multiple(ltrfams,
+                                       family_export_new(filename,
+                                                         ltrfams->regions,
+                                                         FALSE, indexname,
+                                                         flcands));
     g_free(filename);
-    g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
   }
 }
 
@@ -2571,25 +3436,28 @@ void gtk_ltr_families_notebook_list_view_append_array(GtkLTRFamilies *ltrfams,
       if (tmp_iter) {
         CandidateData *cdata;
         GtkTreeRowReference *fam_ref;
+        FamilyStats *stats;
 
         gtk_tree_model_get(model, tmp_iter,
                            LTRFAMS_FAM_LV_NODE_ARRAY, &fam_nodes,
                            LTRFAMS_FAM_LV_OLDNAME, &tmp_oldname,
                            LTRFAMS_FAM_LV_ROWREF, &fam_ref,
+                           LTRFAMS_FAM_LV_STATS, &stats,
                            -1);
 
         cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
         if (!cdata) {
-          cdata = g_slice_new(CandidateData);
+          cdata = candidate_data_new(ltrfams, gn);
           cdata->fam_ref = fam_ref;
           cdata->cand_ref = NULL;
-          gt_genome_node_add_user_data(gn, "cdata", (gpointer) cdata, NULL);
         } else {
           cdata->fam_ref = fam_ref;
           cdata->cand_ref = NULL;
         }
 
         gt_array_add(fam_nodes, gn);
+        if (stats)
+          family_stats_add(stats, gn);
         g_snprintf(tmp_curname, BUFSIZ, "%s (%lu)",
                    tmp_oldname, gt_array_size(fam_nodes));
         gtk_list_store_set(GTK_LIST_STORE(model), tmp_iter,
@@ -2600,9 +3468,12 @@ void gtk_ltr_families_notebook_list_view_append_array(GtkLTRFamilies *ltrfams,
         CandidateData *cdata;
         GtkTreeRowReference *fam_ref;
         GtkTreePath *path;
+        FamilyStats *stats;
 
         fam_nodes = gt_array_new(sizeof(GtGenomeNode*));
         gt_array_add(fam_nodes, gn);
+        stats = family_stats_new();
+        family_stats_add(stats, gn);
         g_snprintf(tmp_curname, BUFSIZ, "%s (%lu)",
                    fam, gt_array_size(fam_nodes));
         gtk_list_store_append(GTK_LIST_STORE(model), &iter);
@@ -2611,10 +3482,9 @@ void gtk_ltr_families_notebook_list_view_append_array(GtkLTRFamilies *ltrfams,
 
         cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
         if (!cdata) {
-          cdata = g_slice_new(CandidateData);
+          cdata = candidate_data_new(ltrfams, gn);
           cdata->fam_ref = fam_ref;
           cdata->cand_ref = NULL;
-          gt_genome_node_add_user_data(gn, "cdata", (gpointer) cdata, NULL);
         } else {
           cdata->fam_ref = fam_ref;
           cdata->cand_ref = NULL;
@@ -2627,6 +3497,7 @@ void gtk_ltr_families_notebook_list_view_append_array(GtkLTRFamilies *ltrfams,
                            LTRFAMS_FAM_LV_CURNAME, tmp_curname,
                            LTRFAMS_FAM_LV_OLDNAME, fam,
                            LTRFAMS_FAM_LV_ROWREF, fam_ref,
+                           LTRFAMS_FAM_LV_STATS, stats,
                            -1);
         gt_hashmap_add(iter_hash,
                        (void*) fam,
@@ -2639,57 +3510,21 @@ void gtk_ltr_families_notebook_list_view_append_array(GtkLTRFamilies *ltrfams,
   gt_hashmap_delete(iter_hash);
 }
 
-static void notebook_toolbar_flcand_clicked(GT_UNUSED GtkWidget *button,
-                                            GtkLTRFamilies *ltrfams)
+/* asks for the tolerances used to determine the full length candidates,
+   returns FALSE if the dialog was cancelled */
+static gboolean flcand_tolerance_dialog(GtkWidget *toplevel,
+                                        gfloat *ltrtolerance,
+                                        gfloat *lentolerance)
 {
-  GtkNotebook *notebook;
-  GtkTreeView *list_view;
-  GtkTreeModel *model1,
-               *model2;
-  GtkTreeIter iter1,
-              iter2;
-  GtkTreeRowReference *rowref;
-  GtkTreePath *path;
-  GtkWidget *tab,
-            *dialog,
+  GtkWidget *dialog,
             *label,
             *vbox,
             *spinb1,
             *spinb2,
             *align,
-            *hbox,
-            *toplevel;
+            *hbox;
   GtkObject *adjust;
-  GtArray *nodes;
-  GtGenomeNode *gn;
-  GList *children;
-  gboolean valid;
-  gchar buffer[BUFSIZ];
-  gint curtab_no;
-  gfloat ltrtolerance,
-         lentolerance;
-  unsigned long flcands;
 
-  notebook = GTK_NOTEBOOK(ltrfams->nb_family);
-  curtab_no = gtk_notebook_get_current_page(notebook);
-  tab = gtk_notebook_get_nth_page(notebook, curtab_no);
-  children = gtk_container_get_children(GTK_CONTAINER(tab));
-  list_view = GTK_TREE_VIEW(g_list_first(children)->data);
-  model1 = gtk_tree_view_get_model(list_view);
-  valid = gtk_tree_model_get_iter_first(model1, &iter1);
-  if (!valid)
-    return; /* TODO: show dialog */
-  gtk_tree_model_get(model1, &iter1, LTRFAMS_LV_ROWREF, &rowref, -1);
-  model2 = gtk_tree_row_reference_get_model(rowref);
-  path = gtk_tree_row_reference_get_path(rowref);
-  if (!gtk_tree_model_get_iter(model2, &iter2, path)) {
-    /* report programming error */
-    return;
-  }
-  gtk_tree_model_get(model2, &iter2, LTRFAMS_FAM_LV_NODE_ARRAY, &nodes, -1);
-  gtk_tree_path_free(path);
-
-  toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
   dialog = gtk_dialog_new_with_buttons(INFORMATION,
                                        GTK_WINDOW(toplevel),
                                        GTK_DIALOG_MODAL, GTK_STOCK_CANCEL,
@@ -2724,23 +3559,94 @@ static void notebook_toolbar_flcand_clicked(GT_UNUSED GtkWidget *button,
 
   if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_OK) {
     gtk_widget_destroy(dialog);
+    return FALSE;
+  }
+
+  *ltrtolerance = (gfloat) gtk_spin_button_get_value(GTK_SPIN_BUTTON(spinb1));
+  *lentolerance = (gfloat) gtk_spin_button_get_value(GTK_SPIN_BUTTON(spinb2));
+  gtk_widget_destroy(dialog);
+  return TRUE;
+}
+
+static void flcand_result_dialog(GtkWidget *toplevel, unsigned long flcands)
+{
+  GtkWidget *dialog;
+  gchar buffer[BUFSIZ];
+
+  g_snprintf(buffer, BUFSIZ, FLCAND_RESULT, flcands);
+  dialog = gtk_message_dialog_new(GTK_WINDOW(toplevel),
+                                  GTK_DIALOG_MODAL |
+                                  GTK_DIALOG_DESTROY_WITH_PARENT,
+                                  GTK_MESSAGE_INFO, GTK_BUTTONS_OK,
+                                  "%s", buffer);
+  gtk_window_set_title(GTK_WINDOW(dialog), "Results");
+  gtk_dialog_run(GTK_DIALOG(dialog));
+  gtk_widget_destroy(dialog);
+}
+
+static void notebook_toolbar_flcand_clicked(GT_UNUSED GtkWidget *button,
+                                            GtkLTRFamilies *ltrfams)
+{
+  GtkNotebook *notebook;
+  GtkTreeView *list_view;
+  GtkTreeModel *model1,
+               *model2;
+  GtkTreeIter iter1,
+              iter2;
+  GtkTreeRowReference *rowref;
+  GtkTreePath *path;
+  GtkWidget *tab,
+            *toplevel;
+  GtArray *nodes;
+  GtGenomeNode *gn;
+  FamilyStats *stats;
+  GList *children;
+  gboolean valid,
+           *flags;
+  gint curtab_no;
+  gfloat ltrtolerance,
+         lentolerance;
+  unsigned long i,
+                flcands;
+
+  notebook = GTK_NOTEBOOK(ltrfams->nb_family);
+  curtab_no = gtk_notebook_get_current_page(notebook);
+  tab = gtk_notebook_get_nth_page(notebook, curtab_no);
+  children = gtk_container_get_children(GTK_CONTAINER(tab));
+  list_view = GTK_TREE_VIEW(g_list_first(children)->data);
+  model1 = gtk_tree_view_get_model(list_view);
+  valid = gtk_tree_model_get_iter_first(model1, &iter1);
+  if (!valid)
+    return; /* TODO: show dialog */
+  gtk_tree_model_get(model1, &iter1, LTRFAMS_LV_ROWREF, &rowref, -1);
+  model2 = gtk_tree_row_reference_get_model(rowref);
+  path = gtk_tree_row_reference_get_path(rowref);
+  if (!gtk_tree_model_get_iter(model2, &iter2, path)) {
+    /* report programming error */
     return;
   }
+  gtk_tree_model_get(model2, &iter2,
+                     LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                     LTRFAMS_FAM_LV_STATS, &stats,
+                     -1);
+  gtk_tree_path_free(path);
 
-  ltrtolerance = (gfloat) gtk_spin_button_get_value(GTK_SPIN_BUTTON(spinb1));
-  lentolerance = (gfloat) gtk_spin_button_get_value(GTK_SPIN_BUTTON(spinb2));
-  gtk_widget_destroy(dialog);
-  flcands = determine_full_length_candidates(nodes, ltrtolerance, lentolerance);
-
-  g_snprintf(buffer, BUFSIZ, FLCAND_RESULT, flcands);
-  dialog = gtk_message_dialog_new(GTK_WINDOW(toplevel),
-                                  GTK_DIALOG_MODAL |
-                                  GTK_DIALOG_DESTROY_WITH_PARENT,
-                                  GTK_MESSAGE_INFO, GTK_BUTTONS_OK,
-                                  "%s", buffer);
-  gtk_window_set_title(GTK_WINDOW(dialog), "Results");
-  gtk_dialog_run(GTK_DIALOG(dialog));
-  gtk_widget_destroy(dialog);
+  toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
+  if (!flcand_tolerance_dialog(toplevel, &ltrtolerance, &lentolerance))
+    return;
+  if (stats) {
+    /* the medians are already known, so only the candidates are compared */
+    flags = g_malloc(MAX(gt_array_size(nodes), 1) * sizeof (gboolean));
+    flcands = family_stats_select_flcands(stats, nodes, ltrtolerance,
+                                          lentolerance, flags);
+    for (i = 0; i < gt_array_size(nodes); i++)
+      (void) flcand_set(*(GtGenomeNode**) gt_array_get(nodes, i), flags[i]);
+    g_free(flags);
+  } else
+    flcands = determine_full_length_candidates(nodes, ltrtolerance,
+                                               lentolerance);
+  gtk_ltr_families_set_modified(ltrfams, TRUE);
+  flcand_result_dialog(toplevel, flcands);
 
   valid = gtk_tree_model_get_iter_first(model1, &iter1);
   if (!valid) {
@@ -2763,19 +3669,13 @@ notebook_toolbar_search_cand_group_clicked(GT_UNUSED GtkWidget *button,
 {
   GtkNotebook *notebook;
   GtkTreeView *list_view;
-  GtkTreeModel *model;
-  GtkTreeIter iter;
   GtkTreeSelection *sel;
-  GtkTreeRowReference *rowref;
   GtkWidget *tab, *dialog, *toplevel;
-  GtGenomeNode *gn;
+  CandSelection *cs;
   GtArray *nodes;
   GtHashmap *sel_features = NULL;
   ThreadData *threaddata;
-  GList *rows,
-        *tmp,
-        *references = NULL,
-        *children;
+  GList *children;
   gchar *fam_prefix = NULL;
   gint curtab_no;
 
@@ -2839,19 +3739,9 @@ notebook_toolbar_search_cand_group_clicked(GT_UNUSED GtkWidget *button,
   }
 
   nodes = gt_array_new(sizeof(GtGenomeNode*));
-  model = gtk_tree_view_get_model(list_view);
-  rows = gtk_tree_selection_get_selected_rows(sel, &model);
-  tmp = rows;
-  while (tmp != NULL) {
-    rowref = gtk_tree_row_reference_new(model, (GtkTreePath*) tmp->data);
-    gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-    gtk_tree_model_get(model, &iter, LTRFAMS_LV_NODE, &gn, -1);
-    gt_array_add(nodes, gn);
-    references = g_list_prepend(references,
-                                gtk_tree_row_reference_copy(rowref));
-    gtk_tree_row_reference_free(rowref);
-    tmp = tmp->next;
-  }
+  cs = gtk_ltr_families_get_selection(list_view);
+  gtk_ltr_families_get_selected_nodes(list_view, cs, nodes);
+  cand_selection_delete(cs);
   gt_genome_nodes_sort_stable(nodes);
 
   threaddata = threaddata_new();
@@ -2862,23 +3752,23 @@ notebook_toolbar_search_cand_group_clicked(GT_UNUSED GtkWidget *button,
   threaddata->err = gt_error_new();
   threaddata->classification = TRUE;
   threaddata->current_state = gt_cstr_dup(START_CLASSIF);
-  threaddata->references = references;
   threaddata->list_view = list_view;
   threaddata->sel_features = sel_features;
   threaddata->fam_prefix = fam_prefix;
+  threaddata->perf = perf_log_new(PERF_JOB_CLASSIFY);
 
   progress_dialog_init(threaddata,
                        gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)));
 
+  gtk_ltr_families_hold_candidates(ltrfams);
   if (!g_thread_create(classify_nodes_start, (gpointer) threaddata, FALSE,
                        NULL)) {
     gt_error_set(ltrfams->err,
                 "Could not create new thread.");
     error_handle(gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)), ltrfams->err);
+    gtk_ltr_families_release_candidates(ltrfams);
   }
 
-  g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
-  g_list_free(rows);
   g_list_free(children);
 }
 
@@ -2946,31 +3836,51 @@ static void notebook_list_view_set_visible_columns(GtkNotebook *notebook,
   g_list_free(columns);
 }
 
-/* XXX: make this more efficient by not opening a new GtEncseq instance
-        per sequence */
-static gint extract_feature_sequence(GtStr *seqid, GtRange *range,
-                                     gchar *sequence, const gchar *indexname,
-                                     GtError *err)
+/* the sequence index stays loaded between calls, it is dropped by
+   gtk_ltr_families_drop_caches() */
+static gint extract_feature_sequence(GtkLTRFamilies *ltrfams, GtStr *seqid,
+                                     GtRange *range, gchar *sequence,
+                                     const gchar *indexname, GtError *err)
 {
   GtEncseqLoader *el = NULL;
-  GtEncseq *encseq = NULL;
-  unsigned long seqnum, startpos;
+  gchar *key,
+        *cached;
+  unsigned long seqnum, startpos,
+                length = gt_range_length(range);
   gint had_err = 0;
 
-  if (!had_err) {
+  key = g_strdup_printf("%s:%lu-%lu", gt_str_get(seqid), range->start,
+                        range->end);
+  if ((cached = (gchar*) gt_hashmap_get(ltrfams->sequences, key))) {
+    memcpy(sequence, cached, length);
+    g_free(key);
+    return 0;
+  }
+  if (ltrfams->encseq && g_strcmp0(ltrfams->encseq_index, indexname) != 0)
+    gtk_ltr_families_drop_caches(ltrfams);
+  if (!ltrfams->encseq) {
     el = gt_encseq_loader_new();
-    encseq = gt_encseq_loader_load(el, indexname, err);
-    if (!encseq)
+    ltrfams->encseq = gt_encseq_loader_load(el, indexname, err);
+    gt_encseq_loader_delete(el);
+    if (!ltrfams->encseq)
       had_err = -1;
+    else {
+      ltrfams->encseq_index = g_strdup(indexname);
+      memory_usage_set(ltrfams->memory, MEMORY_ENCSEQ,
+                       memory_usage_estimate_encseq(indexname));
+    }
   }
   if (!had_err) {
     (void) sscanf(gt_str_get(seqid), "seq%lu", &seqnum);
-    startpos = gt_encseq_seqstartpos(encseq, seqnum);
-    gt_encseq_extract_decoded(encseq, sequence, startpos + range->start - 1,
+    startpos = gt_encseq_seqstartpos(ltrfams->encseq, seqnum);
+    gt_encseq_extract_decoded(ltrfams->encseq, sequence,
+                              startpos + range->start - 1,
                               startpos + range->end - 1);
-  }
-  gt_encseq_delete(encseq);
-  gt_encseq_loader_delete(el);
+    memory_usage_add(ltrfams->memory, MEMORY_SEQUENCES,
+                     strlen(key) + length + 2);
+    gt_hashmap_add(ltrfams->sequences, key, g_strndup(sequence, length));
+  } else
+    g_free(key);
   return had_err;
 }
 
@@ -2993,6 +3903,7 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
   gboolean first_ltr = TRUE;
   gchar *sequence = NULL;
   const char *fnt, *global_parent = NULL, *indexname = NULL;
+  FeatureSymbol sym;
 
   selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(list_view));
   if (gtk_tree_selection_count_selected_rows(selection) != 1)
@@ -3045,12 +3956,13 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
       GtStrArray *attr_list;
       gchar score[BUFSIZ];
       fnt = gt_feature_node_get_type(curnode);
+      sym = symbols_feature_type(curnode);
       attr_list = gt_feature_node_get_attribute_list(curnode);
       if (gt_feature_node_score_is_defined(curnode))
         g_snprintf(score, BUFSIZ, "%lg", gt_feature_node_get_score(curnode));
       else
         score[0] = '\0';
-      if (g_strcmp0(fnt, FNT_REPEATR) == 0) {
+      if (sym == SYMBOL_REPEATR) {
         seqid = gt_genome_node_get_seqid((GtGenomeNode*) curnode);
         range = gt_genome_node_get_range((GtGenomeNode*) curnode);
         gtk_tree_store_append(store, &iter, NULL);
@@ -3080,9 +3992,9 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
           string = g_string_new("");
           range = gt_genome_node_get_range((GtGenomeNode*) curnode);
           gtk_tree_store_append(store, &child, tmp_iter);
-          if (g_strcmp0(fnt, FNT_LTRRETRO) == 0)
+          if (sym == SYMBOL_LTRRETRO)
             strand = gt_feature_node_get_strand(curnode);
-          if (g_strcmp0(fnt, FNT_TSD) == 0) {
+          if (sym == SYMBOL_TSD) {
             fnt = "TSD";
             for (i = 0; i < gt_str_array_size(attr_list); i++) {
               const gchar *tmp_attr;
@@ -3094,8 +4006,8 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
             if (indexname) {
               sequence = gt_calloc((size_t) gt_range_length(&range) + 1,
                                    sizeof (gchar));
-              extract_feature_sequence(seqid, &range, sequence, indexname,
-                                       ltrfams->err);
+              extract_feature_sequence(ltrfams, seqid, &range, sequence,
+                                       indexname, ltrfams->err);
               if (strand == GT_STRAND_REVERSE)
                 gt_reverse_complement(sequence, gt_range_length(&range),
                                       ltrfams->err);
@@ -3108,7 +4020,7 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
                                  LTRFAMS_DETAIL_TV_SEQ, "No index!",
                                  -1);
             }
-          } else if (g_strcmp0(fnt, FNT_LTR) == 0) {
+          } else if (sym == SYMBOL_LTR) {
             switch (strand) {
               case GT_STRAND_FORWARD:
                 if (first_ltr) {
@@ -3135,7 +4047,7 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
                 continue;
               append_attribute_to_string(string, curnode, tmp_attr);
             }
-          } else if (g_strcmp0(fnt, FNT_PROTEINM) == 0) {
+          } else if (sym == SYMBOL_PROTEINM) {
             fnt = gt_feature_node_get_attribute(curnode, ATTR_PFAMN);
             for (i = 0; i < gt_str_array_size(attr_list); i++) {
               const gchar *tmp_attr;
@@ -3145,7 +4057,7 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
                 continue;
               append_attribute_to_string(string, curnode, tmp_attr);
             }
-          } else if (g_strcmp0(fnt, FNT_PBS) == 0) {
+          } else if (sym == SYMBOL_PBS) {
             gchar tmp[BUFSIZ];
             g_snprintf(tmp, BUFSIZ, "PBS %s",
                        gt_feature_node_get_attribute(curnode, ATTR_TRNA));
@@ -3161,8 +4073,8 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
             if (indexname) {
               sequence = gt_calloc((size_t) gt_range_length(&range) + 1,
                                    sizeof (gchar));
-              extract_feature_sequence(seqid, &range, sequence, indexname,
-                                       ltrfams->err);
+              extract_feature_sequence(ltrfams, seqid, &range, sequence,
+                                       indexname, ltrfams->err);
               if (strand == GT_STRAND_REVERSE)
                 gt_reverse_complement(sequence, gt_range_length(&range),
                                       ltrfams->err);
@@ -3175,7 +4087,7 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
                                  LTRFAMS_DETAIL_TV_SEQ, "No index!",
                                  -1);
             }
-          } else if (g_strcmp0(fnt, FNT_PPT) == 0) {
+          } else if (sym == SYMBOL_PPT) {
             fnt = "PPT";
             for (i = 0; i < gt_str_array_size(attr_list); i++) {
               const gchar *tmp_attr;
@@ -3187,8 +4099,8 @@ static void notebook_list_view_cursor_changed(GtkTreeView *list_view,
             if (indexname && seqid) {
               sequence = gt_calloc((size_t) gt_range_length(&range) + 1,
                                    sizeof (gchar));
-              extract_feature_sequence(seqid, &range, sequence, indexname,
-                                       ltrfams->err);
+              extract_feature_sequence(ltrfams, seqid, &range, sequence,
+                                       indexname, ltrfams->err);
               if (strand == GT_STRAND_REVERSE)
                 gt_reverse_complement(sequence, gt_range_length(&range),
                                       ltrfams->err);
@@ -3252,6 +4164,7 @@ void gtk_ltr_families_notebook_list_view_append_gn(GtkLTRFamilies *ltrfams,
   GtkListStore *store;
   GtError *err = gt_error_new();
   const char *fnt;
+  FeatureSymbol sym;
   unsigned long cno = 0;
   gboolean first_ltr = TRUE;
 
@@ -3269,7 +4182,8 @@ void gtk_ltr_families_notebook_list_view_append_gn(GtkLTRFamilies *ltrfams,
 
   while ((curnode = gt_feature_node_iterator_next(fni))) {
     fnt = gt_feature_node_get_type(curnode);
-    if ((g_strcmp0(fnt, FNT_REPEATR) == 0)) {
+    sym = symbols_feature_type(curnode);
+    if (sym == SYMBOL_REPEATR) {
       CandidateData *cdata;
       GtkTreePath *path;
       GtkTreeRowReference *cand_ref;
@@ -3289,17 +4203,16 @@ void gtk_ltr_families_notebook_list_view_append_gn(GtkLTRFamilies *ltrfams,
                          -1);
       cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
       if (!cdata) {
-        cdata = g_slice_new(CandidateData);
+        cdata = candidate_data_new(ltrfams, gn);
         cdata->fam_ref = rowref;
         cdata->cand_ref = cand_ref;
-        gt_genome_node_add_user_data(gn, "cdata", (gpointer) cdata, NULL);
       } else {
         cdata->fam_ref = rowref;
         gtk_tree_row_reference_free(cdata->cand_ref);
         cdata->cand_ref = cand_ref;
       }
       gtk_tree_path_free(path);
-    } else if (g_strcmp0(fnt, FNT_PROTEINM) == 0) {
+    } else if (sym == SYMBOL_PROTEINM) {
       fnt = gt_feature_node_get_attribute(curnode, ATTR_PFAMN);
       if (!fnt)
         continue;
@@ -3309,7 +4222,7 @@ void gtk_ltr_families_notebook_list_view_append_gn(GtkLTRFamilies *ltrfams,
         cno = (unsigned long) gt_hashmap_get(features, fnt);
         gtk_list_store_set(store, &iter, cno, clid, -1);
       }
-    } else if (g_strcmp0(fnt, FNT_LTRRETRO) == 0) {
+    } else if (sym == SYMBOL_LTRRETRO) {
       GtRange range;
       GtStrand strand = gt_feature_node_get_strand(curnode);
       gchar c[2];
@@ -3326,7 +4239,7 @@ void gtk_ltr_families_notebook_list_view_append_gn(GtkLTRFamilies *ltrfams,
                          LTRFAMS_LV_END, range.end,
                          LTRFAMS_LV_ELEMLEN, gt_range_length(&range),
                          -1);
-    } else if (g_strcmp0(fnt, FNT_LTR) == 0) {
+    } else if (sym == SYMBOL_LTR) {
       GtRange range;
       if (first_ltr) {
         range = gt_genome_node_get_range((GtGenomeNode*) curnode);
@@ -3754,6 +4667,10 @@ void gtk_ltr_families_notebook_add_tab(GtkTreeModel *model, GtkTreeIter *iter,
   gchar *name,
         *file;
 
+  /* candidates of indexed projects are read when their family is shown for
+     the first time, <nodes> is filled in place */
+  if (gtk_ltr_families_load_family(ltrfams, model, iter))
+    return;
   gtk_tree_model_get(model, iter,
                      LTRFAMS_FAM_LV_OLDNAME, &name,
                      -1);
@@ -3796,43 +4713,429 @@ void gtk_ltr_families_notebook_add_tab(GtkTreeModel *model, GtkTreeIter *iter,
   }
   gtk_tree_path_free(path);
 
-  label = gtk_label_close_new(name, G_CALLBACK(notebook_close_tab_clicked),
-                              ltrfams);
-  nbpage = gtk_notebook_append_page(GTK_NOTEBOOK(ltrfams->nb_family),
-                                    child,
-                                    label);
-  gtk_label_close_set_button_data(GTK_LABEL_CLOSE(label),
-                                  "nbpage",
-                                  GINT_TO_POINTER(nbpage));
-  gtk_notebook_set_tab_reorderable(GTK_NOTEBOOK(ltrfams->nb_family),
-                                   child,
-                                   TRUE);
-  gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                     LTRFAMS_FAM_LV_TAB_CHILD, list_view,
-                     LTRFAMS_FAM_LV_TAB_LABEL, label,
-                     -1);
-  notebook_list_view_set_visible_columns(GTK_NOTEBOOK(ltrfams->nb_family),
-                                         GTK_TREE_VIEW(list_view));
-  gtk_notebook_set_current_page(GTK_NOTEBOOK(ltrfams->nb_family), nbpage);
-  file = gtk_ltr_families_get_projectfile(ltrfams);
-  if (file && !load) {
-    GtRDBStmt *stmt = NULL;
-    gchar query[BUFSIZ];
-    gint had_err = 0;
+  label = gtk_label_close_new(name, G_CALLBACK(notebook_close_tab_clicked),
+                              ltrfams);
+  nbpage = gtk_notebook_append_page(GTK_NOTEBOOK(ltrfams->nb_family),
+                                    child,
+                                    label);
+  gtk_label_close_set_button_data(GTK_LABEL_CLOSE(label),
+                                  "nbpage",
+                                  GINT_TO_POINTER(nbpage));
+  gtk_notebook_set_tab_reorderable(GTK_NOTEBOOK(ltrfams->nb_family),
+                                   child,
+                                   TRUE);
+  gtk_list_store_set(GTK_LIST_STORE(model), iter,
+                     LTRFAMS_FAM_LV_TAB_CHILD, list_view,
+                     LTRFAMS_FAM_LV_TAB_LABEL, label,
+                     -1);
+  notebook_list_view_set_visible_columns(GTK_NOTEBOOK(ltrfams->nb_family),
+                                         GTK_TREE_VIEW(list_view));
+  gtk_notebook_set_current_page(GTK_NOTEBOOK(ltrfams->nb_family), nbpage);
+  file = gtk_ltr_families_get_projectfile(ltrfams);
+  if (file && !load) {
+    GtRDBStmt *stmt = NULL;
+    gchar query[BUFSIZ];
+    gint had_err = 0;
+
+    g_snprintf(query, BUFSIZ,
+               "INSERT OR IGNORE INTO notebook_tabs "
+               " (name, position) values (\"%s\", %d)",
+               name, nbpage);
+    stmt = gt_rdb_prepare(ltrfams->rdb, query, -1, ltrfams->err);
+    if (stmt) {
+      had_err = gt_rdb_stmt_exec(stmt, ltrfams->err);
+      gt_rdb_stmt_delete(stmt);
+    } else had_err = -1;
+    if (had_err == -1)
+      error_handle(gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)), ltrfams->err);
+  }
+  g_free(name);
+}
+
+/* returns the list view showing the family of the candidate data <cdata>,
+   the tab of the family is opened if necessary */
+static GtkTreeView* locate_show_family(GtkLTRFamilies *ltrfams,
+                                       CandidateData *cdata)
+{
+  GtkNotebook *notebook;
+  GtkTreeModel *model;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  GtkWidget *tab_label,
+            *tab_child;
+  GtArray *nodes;
+  GList *children;
+  GtkTreeView *list_view;
+  gint nbpage;
+
+  notebook = GTK_NOTEBOOK(ltrfams->nb_family);
+  if (!cdata->fam_ref) {
+    nbpage = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(notebook),
+                                               "main_tab"));
+    gtk_notebook_set_current_page(notebook, nbpage);
+    tab_child = gtk_notebook_get_nth_page(notebook, nbpage);
+    children = gtk_container_get_children(GTK_CONTAINER(tab_child));
+    list_view = GTK_TREE_VIEW(g_list_first(children)->data);
+    g_list_free(children);
+    return list_view;
+  }
+  model = gtk_tree_row_reference_get_model(cdata->fam_ref);
+  if (!(path = gtk_tree_row_reference_get_path(cdata->fam_ref)))
+    return NULL;
+  gtk_tree_model_get_iter(model, &iter, path);
+  gtk_tree_path_free(path);
+  gtk_tree_model_get(model, &iter,
+                     LTRFAMS_FAM_LV_TAB_LABEL, &tab_label,
+                     LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                     -1);
+  if (tab_label) {
+    nbpage =
+     GPOINTER_TO_INT(gtk_label_close_get_button_data(GTK_LABEL_CLOSE(tab_label),
+                                                     "nbpage"));
+    gtk_notebook_set_current_page(notebook, nbpage);
+  } else
+    gtk_ltr_families_notebook_add_tab(model, &iter, nodes, FALSE, ltrfams);
+  gtk_tree_model_get(model, &iter,
+                     LTRFAMS_FAM_LV_TAB_CHILD, &tab_child,
+                     -1);
+  return tab_child ? GTK_TREE_VIEW(tab_child) : NULL;
+}
+
+/* shows the row of the loaded candidate <gn> in the tab of its family */
+static void locate_show_candidate(GtkLTRFamilies *ltrfams, GtGenomeNode *gn)
+{
+  CandidateData *cdata;
+  GtkTreeView *list_view;
+  GtkTreePath *path;
+
+  cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+  if (!cdata || !(list_view = locate_show_family(ltrfams, cdata)))
+    return;
+  /* the row is created when the tab of the family is opened */
+  if (!cdata->cand_ref || !(path = gtk_tree_row_reference_get_path(
+                                                             cdata->cand_ref)))
+    return;
+  gtk_tree_view_scroll_to_cell(list_view, path, NULL, TRUE, 0.5, 0.0);
+  gtk_tree_view_set_cursor(list_view, path, NULL, FALSE);
+  gtk_widget_grab_focus(GTK_WIDGET(list_view));
+  gtk_tree_path_free(path);
+}
+
+/* reads the family of the index entry <entry> and shows the candidate it
+   describes */
+static void locate_show_entry(GtkLTRFamilies *ltrfams,
+                              ProjectIndexEntry *entry)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtArray *nodes;
+  GtGenomeNode *gn;
+  GtRange range;
+  gchar *name;
+  gboolean valid;
+  unsigned long i;
+
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  valid = gtk_tree_model_get_iter_first(model, &iter);
+  while (valid) {
+    gtk_tree_model_get(model, &iter, LTRFAMS_FAM_LV_OLDNAME, &name, -1);
+    if (g_strcmp0(name, entry->family) == 0) {
+      g_free(name);
+      break;
+    }
+    g_free(name);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  if (!valid || gtk_ltr_families_load_family(ltrfams, model, &iter))
+    return;
+  nodes = gt_array_new(sizeof (GtGenomeNode*));
+  location_index_find_range(ltrfams->locations, entry->seqid, entry->start,
+                            entry->end, nodes);
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+    range = gt_genome_node_get_range(gn);
+    if (range.start == entry->start && range.end == entry->end) {
+      locate_show_candidate(ltrfams, gn);
+      break;
+    }
+  }
+  gt_array_delete(nodes);
+}
+
+static void locate_append_hit(GtkListStore *store, GtGenomeNode *gn,
+                              ProjectIndexEntry *entry)
+{
+  CandidateData *cdata;
+  GtkTreeModel *model;
+  GtkTreePath *path;
+  GtkTreeIter iter,
+              fam_iter;
+  GtRange range;
+  gchar *family = NULL;
+  const gchar *id = NULL;
+
+  gtk_list_store_append(store, &iter);
+  if (gn) {
+    cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+    if (cdata && cdata->fam_ref &&
+        (path = gtk_tree_row_reference_get_path(cdata->fam_ref))) {
+      model = gtk_tree_row_reference_get_model(cdata->fam_ref);
+      gtk_tree_model_get_iter(model, &fam_iter, path);
+      gtk_tree_model_get(model, &fam_iter,
+                         LTRFAMS_FAM_LV_OLDNAME, &family,
+                         -1);
+      gtk_tree_path_free(path);
+    }
+    range = gt_genome_node_get_range(gn);
+    id = candidate_location_id(gn);
+    gtk_list_store_set(store, &iter,
+                       LTRFAMS_LOCATE_SEQID,
+                       gt_str_get(gt_genome_node_get_seqid(gn)),
+                       LTRFAMS_LOCATE_START, range.start,
+                       LTRFAMS_LOCATE_END, range.end,
+                       -1);
+  } else {
+    if (*entry->family != '\0')
+      family = g_strdup(entry->family);
+    gtk_list_store_set(store, &iter,
+                       LTRFAMS_LOCATE_SEQID, entry->seqid,
+                       LTRFAMS_LOCATE_START, entry->start,
+                       LTRFAMS_LOCATE_END, entry->end,
+                       -1);
+  }
+  gtk_list_store_set(store, &iter,
+                     LTRFAMS_LOCATE_ID, id ? id : "",
+                     LTRFAMS_LOCATE_FAMILY, family ? family : MAIN_TAB_LABEL,
+                     LTRFAMS_LOCATE_NODE, gn,
+                     LTRFAMS_LOCATE_ENTRY, entry,
+                     -1);
+  g_free(family);
+}
+
+static void locate_dialog_row_activated(GT_UNUSED GtkTreeView *tree_view,
+                                        GT_UNUSED GtkTreePath *path,
+                                        GT_UNUSED GtkTreeViewColumn *column,
+                                        GtkWidget *dialog)
+{
+  gtk_dialog_response(GTK_DIALOG(dialog), GTK_RESPONSE_OK);
+}
+
+/* lets the user choose one of the candidates in <store> */
+static gboolean locate_dialog(GtkLTRFamilies *ltrfams, GtkListStore *store,
+                              const gchar *text, GtkTreeIter *iter)
+{
+  GtkWidget *dialog,
+            *toplevel,
+            *sw,
+            *tree_view;
+  GtkCellRenderer *renderer;
+  GtkTreeModel *model;
+  GtkTreeSelection *sel;
+  gchar title[BUFSIZ];
+  gint i, response;
+  const gchar *captions[] = {LOCATE_CAPTION_SEQID, LOCATE_CAPTION_START,
+                             LOCATE_CAPTION_END, LOCATE_CAPTION_ID,
+                             LOCATE_CAPTION_FAMILY};
+
+  g_snprintf(title, BUFSIZ, LOCATE_TITLE, text);
+  toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
+  dialog = gtk_dialog_new_with_buttons(title, GTK_WINDOW(toplevel),
+                                       GTK_DIALOG_MODAL |
+                                       GTK_DIALOG_DESTROY_WITH_PARENT,
+                                       GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+                                       GTK_STOCK_JUMP_TO, GTK_RESPONSE_OK,
+                                       NULL);
+  gtk_window_set_default_size(GTK_WINDOW(dialog), 550, 350);
+  tree_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+  renderer = gtk_cell_renderer_text_new();
+  for (i = 0; i < (gint) G_N_ELEMENTS(captions); i++) {
+    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(tree_view), -1,
+                                                captions[i], renderer,
+                                                "text", i, NULL);
+    gtk_tree_view_column_set_sort_column_id(
+                        gtk_tree_view_get_column(GTK_TREE_VIEW(tree_view), i),
+                                            i);
+  }
+  gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store),
+                                       LTRFAMS_LOCATE_START,
+                                       GTK_SORT_ASCENDING);
+  sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(tree_view));
+  model = GTK_TREE_MODEL(store);
+  if (gtk_tree_model_get_iter_first(model, iter))
+    gtk_tree_selection_select_iter(sel, iter);
+  g_signal_connect(G_OBJECT(tree_view), "row-activated",
+                   G_CALLBACK(locate_dialog_row_activated), dialog);
+  sw = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(sw),
+                                 GTK_POLICY_AUTOMATIC,
+                                 GTK_POLICY_AUTOMATIC);
+  gtk_container_add(GTK_CONTAINER(sw), tree_view);
+  gtk_box_pack_start_defaults(GTK_BOX(GTK_DIALOG(dialog)->vbox), sw);
+  gtk_widget_show_all(dialog);
+
+  response = gtk_dialog_run(GTK_DIALOG(dialog));
+  if (response == GTK_RESPONSE_OK &&
+      !gtk_tree_selection_get_selected(sel, NULL, iter))
+    response = GTK_RESPONSE_CANCEL;
+  gtk_widget_destroy(dialog);
+  return response == GTK_RESPONSE_OK;
+}
+
+static void locate_message(GtkLTRFamilies *ltrfams, const gchar *format,
+                           const gchar *text)
+{
+  GtkWidget *dialog,
+            *toplevel;
+  gchar buffer[BUFSIZ];
+
+  g_snprintf(buffer, BUFSIZ, format, text);
+  toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
+  dialog = gtk_message_dialog_new(GTK_WINDOW(toplevel),
+                                  GTK_DIALOG_MODAL |
+                                  GTK_DIALOG_DESTROY_WITH_PARENT,
+                                  GTK_MESSAGE_INFO, GTK_BUTTONS_OK,
+                                  "%s", buffer);
+  gtk_window_set_title(GTK_WINDOW(dialog), INFORMATION);
+  gtk_dialog_run(GTK_DIALOG(dialog));
+  gtk_widget_destroy(dialog);
+}
+
+/* <text> is either a location (seqid:start-end), an ID or a seqid; loaded
+   candidates are found in <ltrfams->locations>, candidates of families
+   which have not been read yet through their index entries */
+static void notebook_toolbar_locate_activate(GtkEntry *entry,
+                                             GtkLTRFamilies *ltrfams)
+{
+  GtkListStore *store;
+  GtkTreeIter iter;
+  GtArray *nodes,
+          *entries;
+  GtGenomeNode *gn;
+  ProjectIndexEntry *ientry;
+  gchar *text,
+        *seqid = NULL;
+  unsigned long i, j, start, end;
+
+  if (!ltrfams->nodes)
+    return;
+  text = g_strstrip(g_strdup(gtk_entry_get_text(entry)));
+  if (*text == '\0') {
+    g_free(text);
+    return;
+  }
+  nodes = gt_array_new(sizeof (GtGenomeNode*));
+  entries = gt_array_new(sizeof (ProjectIndexEntry*));
+  if (strchr(text, ':')) {
+    if (!location_index_parse(text, &seqid, &start, &end)) {
+      locate_message(ltrfams, LOCATE_INVALID, text);
+      gt_array_delete(entries);
+      gt_array_delete(nodes);
+      g_free(text);
+      return;
+    }
+  } else {
+    location_index_find_id(ltrfams->locations, text, nodes);
+    if (gt_array_size(nodes) == 0) {
+      seqid = g_strdup(text);
+      start = 1;
+      end = G_MAXULONG;
+    }
+  }
+  if (seqid) {
+    location_index_find_range(ltrfams->locations, seqid, start, end, nodes);
+    if (ltrfams->index_locations) {
+      location_index_find_range(ltrfams->index_locations, seqid, start, end,
+                                entries);
+      /* loaded candidates have been found above already */
+      for (i = 0, j = 0; i < gt_array_size(entries); i++) {
+        ientry = *(ProjectIndexEntry**) gt_array_get(entries, i);
+        if (!project_index_family_is_loaded(ltrfams->index, ientry->family)) {
+          *(ProjectIndexEntry**) gt_array_get(entries, j) = ientry;
+          j++;
+        }
+      }
+      gt_array_set_size(entries, j);
+    }
+  }
+
+  if (gt_array_size(nodes) + gt_array_size(entries) == 0)
+    locate_message(ltrfams, LOCATE_NO_HITS, text);
+  else if (gt_array_size(nodes) == 1 && gt_array_size(entries) == 0)
+    locate_show_candidate(ltrfams, *(GtGenomeNode**) gt_array_get(nodes, 0));
+  else if (gt_array_size(nodes) == 0 && gt_array_size(entries) == 1)
+    locate_show_entry(ltrfams,
+                      *(ProjectIndexEntry**) gt_array_get(entries, 0));
+  else {
+    store = gtk_list_store_new(LTRFAMS_LOCATE_N_COLUMS,
+                               G_TYPE_STRING,
+                               G_TYPE_ULONG,
+                               G_TYPE_ULONG,
+                               G_TYPE_STRING,
+                               G_TYPE_STRING,
+                               G_TYPE_POINTER,
+                               G_TYPE_POINTER);
+    for (i = 0; i < gt_array_size(nodes); i++)
+      locate_append_hit(store, *(GtGenomeNode**) gt_array_get(nodes, i),
+                        NULL);
+    for (i = 0; i < gt_array_size(entries); i++)
+      locate_append_hit(store, NULL,
+                        *(ProjectIndexEntry**) gt_array_get(entries, i));
+    if (locate_dialog(ltrfams, store, text, &iter)) {
+      gtk_tree_model_get(GTK_TREE_MODEL(store), &iter,
+                         LTRFAMS_LOCATE_NODE, &gn,
+                         LTRFAMS_LOCATE_ENTRY, &ientry,
+                         -1);
+      if (gn)
+        locate_show_candidate(ltrfams, gn);
+      else
+        locate_show_entry(ltrfams, ientry);
+    }
+    g_object_unref(store);
+  }
+  gt_array_delete(entries);
+  gt_array_delete(nodes);
+  g_free(seqid);
+  g_free(text);
+}
+
+/* selects the candidate from <start> to <end> on <seqid>, reading its family
+   if necessary */
+void gtk_ltr_families_show_candidate(GtkLTRFamilies *ltrfams,
+                                     const gchar *seqid, unsigned long start,
+                                     unsigned long end)
+{
+  GtArray *found;
+  GtGenomeNode *gn;
+  ProjectIndexEntry *entry;
+  GtRange range;
+  unsigned long i;
 
-    g_snprintf(query, BUFSIZ,
-               "INSERT OR IGNORE INTO notebook_tabs "
-               " (name, position) values (\"%s\", %d)",
-               name, nbpage);
-    stmt = gt_rdb_prepare(ltrfams->rdb, query, -1, ltrfams->err);
-    if (stmt) {
-      had_err = gt_rdb_stmt_exec(stmt, ltrfams->err);
-      gt_rdb_stmt_delete(stmt);
-    } else had_err = -1;
-    if (had_err == -1)
-      error_handle(gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)), ltrfams->err);
+  if (!ltrfams->nodes)
+    return;
+  found = gt_array_new(sizeof (gpointer));
+  location_index_find_range(ltrfams->locations, seqid, start, end, found);
+  for (i = 0; i < gt_array_size(found); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(found, i);
+    range = gt_genome_node_get_range(gn);
+    if (range.start == start && range.end == end) {
+      locate_show_candidate(ltrfams, gn);
+      gt_array_delete(found);
+      return;
+    }
   }
-  g_free(name);
+  gt_array_reset(found);
+  if (ltrfams->index_locations)
+    location_index_find_range(ltrfams->index_locations, seqid, start, end,
+                              found);
+  for (i = 0; i < gt_array_size(found); i++) {
+    entry = *(ProjectIndexEntry**) gt_array_get(found, i);
+    if (entry->start == start && entry->end == end &&
+        !project_index_family_is_loaded(ltrfams->index, entry->family)) {
+      locate_show_entry(ltrfams, entry);
+      break;
+    }
+  }
+  gt_array_delete(found);
 }
 
 static void notebook_page_reordered(GtkNotebook *notebook,
@@ -3945,6 +5248,7 @@ static void tree_view_details_clear_on_equal_nodes(GtkLTRFamilies *ltrfams,
       gtk_tree_store_clear(GTK_TREE_STORE(model));
       gt_diagram_delete(ltrfams->diagram);
       ltrfams->diagram = NULL;
+      memory_usage_set(ltrfams->memory, MEMORY_DIAGRAM, 0);
       gtk_widget_queue_draw(ltrfams->image_area);
       gtk_layout_set_size(GTK_LAYOUT(ltrfams->image_area), 100, 100);
     }
@@ -4102,6 +5406,7 @@ static void list_view_families_toolbar_add_clicked(GT_UNUSED GtkWidget *button,
                      LTRFAMS_FAM_LV_NODE_ARRAY, NULL,
                      LTRFAMS_FAM_LV_TAB_CHILD, NULL,
                      LTRFAMS_FAM_LV_TAB_LABEL, NULL,
+                     LTRFAMS_FAM_LV_STATS, NULL,
                      -1);
 
   path = gtk_tree_model_get_path(model, &iter);
@@ -4136,13 +5441,13 @@ list_view_families_toolbar_remove_clicked(GT_UNUSED GtkWidget *button,
   gtk_tree_model_get(model, &iter,
                      LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
                      -1);
-  if (nodes && gt_array_size(nodes) < 3)
+  if (nodes && list_view_families_get_size(ltrfams, model, &iter) < 3)
     gtk_tree_selection_select_iter(sel, &iter);
   while (gtk_tree_model_iter_next(model, &iter)) {
     gtk_tree_model_get(model, &iter,
                        LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
                        -1);
-    if (nodes && gt_array_size(nodes) < 3)
+    if (nodes && list_view_families_get_size(ltrfams, model, &iter) < 3)
       gtk_tree_selection_select_iter(sel, &iter);
   }
   if (gtk_tree_selection_count_selected_rows(sel) == 0)
@@ -4182,6 +5487,7 @@ list_view_families_toolbar_remove_clicked(GT_UNUSED GtkWidget *button,
     g_list_free(references);
     g_list_free(rows);
     update_main_tab_label(ltrfams);
+    gtk_ltr_families_set_modified(ltrfams, TRUE);
   }
 }
 
@@ -4238,6 +5544,9 @@ static void list_view_families_cell_edited(GT_UNUSED GtkCellRendererText *cell,
       gtk_dialog_run(GTK_DIALOG(dialog));
       gtk_widget_destroy(dialog);
       g_signal_emit_by_name(ltrfams->lv_fams_renderer, "editing-canceled");
+    } else if (gtk_ltr_families_load_family(ltrfams, model, &iter)) {
+      /* the family name is stored with every candidate */
+      g_signal_emit_by_name(ltrfams->lv_fams_renderer, "editing-canceled");
     } else {
       char tmp_name[BUFSIZ];
       gtk_tree_model_get(model, &iter,
@@ -4247,9 +5556,10 @@ static void list_view_families_cell_edited(GT_UNUSED GtkCellRendererText *cell,
         nodes = gt_array_new(sizeof(GtGenomeNode*));
         gtk_list_store_set(GTK_LIST_STORE(model), &iter,
                            LTRFAMS_FAM_LV_NODE_ARRAY, nodes,
+                           LTRFAMS_FAM_LV_STATS, family_stats_new(),
                            -1);
       } else
-        update_genomenode_famname(nodes, new_name);
+        gtk_ltr_families_family_name_changed(ltrfams, model, &iter);
       g_snprintf(tmp_name, BUFSIZ, "%s (%lu)", new_name, gt_array_size(nodes));
       gtk_list_store_set(GTK_LIST_STORE(model), &iter,
                          LTRFAMS_FAM_LV_CURNAME, tmp_name,
@@ -4260,6 +5570,7 @@ static void list_view_families_cell_edited(GT_UNUSED GtkCellRendererText *cell,
                          -1);
       if (label)
         gtk_label_close_set_text(GTK_LABEL_CLOSE(label), new_name);
+      gtk_ltr_families_set_modified(ltrfams, TRUE);
 
       g_free(iter_str);
     }
@@ -4391,6 +5702,7 @@ static void list_view_families_create(GtkLTRFamilies *ltrfams)
                              G_TYPE_POINTER,
                              G_TYPE_STRING,
                              G_TYPE_STRING,
+                             G_TYPE_POINTER,
                              G_TYPE_POINTER);
 
   gtk_tree_view_set_model(GTK_TREE_VIEW(ltrfams->list_view_families),
@@ -4406,32 +5718,438 @@ static void list_view_families_create(GtkLTRFamilies *ltrfams)
   g_signal_connect(G_OBJECT(ltrfams->list_view_families), "drag-motion",
                    G_CALLBACK(on_drag_motion), NULL);
 }
+/* families which have not been read yet are listed with the number of
+   candidates given by the index and an empty node array */
+static void list_view_families_append_index(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtkTreePath *path;
+  GtkTreeRowReference *fam_ref;
+  GtStrArray *families;
+  const gchar *fam;
+  gchar curname[BUFSIZ];
+  unsigned long i, size;
+
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  families = project_index_get_families(ltrfams->index);
+  for (i = 0; i < gt_str_array_size(families); i++) {
+    fam = gt_str_array_get(families, i);
+    if (project_index_family_is_loaded(ltrfams->index, fam))
+      continue;
+    size = project_index_family_size(ltrfams->index, fam);
+    g_snprintf(curname, BUFSIZ, "%s (%lu)", fam, size);
+    gtk_list_store_append(GTK_LIST_STORE(model), &iter);
+    path = gtk_tree_model_get_path(model, &iter);
+    fam_ref = gtk_tree_row_reference_new(model, path);
+    gtk_list_store_set(GTK_LIST_STORE(model), &iter,
+                       LTRFAMS_FAM_LV_NODE_ARRAY,
+                       gt_array_new(sizeof (GtGenomeNode*)),
+                       LTRFAMS_FAM_LV_TAB_CHILD, NULL,
+                       LTRFAMS_FAM_LV_TAB_LABEL, NULL,
+                       LTRFAMS_FAM_LV_CURNAME, curname,
+                       LTRFAMS_FAM_LV_OLDNAME, fam,
+                       LTRFAMS_FAM_LV_ROWREF, fam_ref,
+                       LTRFAMS_FAM_LV_STATS, family_stats_new(),
+                       -1);
+    gtk_tree_path_free(path);
+    ltrfams->unloaded_cands += size;
+  }
+}
+
+gint gtk_ltr_families_load_family(GtkLTRFamilies *ltrfams, GtkTreeModel *model,
+                                  GtkTreeIter *iter)
+{
+  GtArray *fam_nodes,
+          *nodes,
+          *merged;
+  GtkTreeRowReference *fam_ref;
+  GtGenomeNode *gn;
+  CandidateData *cdata;
+  FamilyStats *stats;
+  gchar *name,
+        curname[BUFSIZ],
+        sb_text[BUFSIZ];
+  unsigned long i, size;
+  gint had_err = 0;
+
+  if (!ltrfams->index)
+    return 0;
+  gtk_tree_model_get(model, iter,
+                     LTRFAMS_FAM_LV_NODE_ARRAY, &fam_nodes,
+                     LTRFAMS_FAM_LV_OLDNAME, &name,
+                     LTRFAMS_FAM_LV_ROWREF, &fam_ref,
+                     LTRFAMS_FAM_LV_STATS, &stats,
+                     -1);
+  if (project_index_family_is_loaded(ltrfams->index, name)) {
+    g_free(name);
+    return 0;
+  }
+
+  nodes = gt_array_new(sizeof (GtGenomeNode*));
+  had_err = project_index_read_family(ltrfams->index, name, nodes, NULL,
+                                      ltrfams->err);
+  if (!had_err) {
+    node_array_ensure_sorted(nodes);
+    if (!stats) {
+      stats = family_stats_new();
+      gtk_list_store_set(GTK_LIST_STORE(model), iter,
+                         LTRFAMS_FAM_LV_STATS, stats,
+                         -1);
+    }
+    for (i = 0; i < gt_array_size(nodes); i++) {
+      gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+      cdata = candidate_data_new(ltrfams, gn);
+      cdata->fam_ref = fam_ref;
+      cdata->cand_ref = NULL;
+      gt_array_add(fam_nodes, gn);
+      family_stats_add(stats, gn);
+    }
+    /* <ltrfams->nodes> is referenced by running jobs, so it is updated in
+       place instead of being replaced */
+    merged = merge_sorted_node_arrays(ltrfams->nodes, nodes);
+    gt_array_reset(ltrfams->nodes);
+    gt_array_add_array(ltrfams->nodes, merged);
+    gt_array_delete(merged);
+
+    size = project_index_family_size(ltrfams->index, name);
+    ltrfams->unloaded_cands -= MIN(size, ltrfams->unloaded_cands);
+    g_snprintf(curname, BUFSIZ, "%s (%lu)", name, gt_array_size(fam_nodes));
+    gtk_list_store_set(GTK_LIST_STORE(model), iter,
+                       LTRFAMS_FAM_LV_CURNAME, curname,
+                       -1);
+    g_snprintf(sb_text, BUFSIZ, STATUSBAR_NUM_OF_CANDS,
+               gt_array_size(ltrfams->nodes) + ltrfams->unloaded_cands);
+    statusbar_set_status(ltrfams->statusbar, sb_text);
+  } else
+    error_handle(gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)), ltrfams->err);
+
+  gt_array_delete(nodes);
+  g_free(name);
+  return had_err;
+}
+
+gint gtk_ltr_families_load_all_families(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  gboolean valid;
+  gint had_err = 0;
+
+  if (!ltrfams->index || ltrfams->unloaded_cands == 0)
+    return 0;
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  valid = gtk_tree_model_get_iter_first(model, &iter);
+  while (!had_err && valid) {
+    had_err = gtk_ltr_families_load_family(ltrfams, model, &iter);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  return had_err;
+}
+
+/* drops the candidates of the family at <iter> from memory, they are read
+   from the project file again when the family is used next time. This is
+   only possible if the candidates are exactly as in the file and are not
+   shown anywhere. */
+static gboolean gtk_ltr_families_unload_family(GtkLTRFamilies *ltrfams,
+                                               GtkTreeModel *model,
+                                               GtkTreeIter *iter)
+{
+  GtArray *fam_nodes;
+  GtHashmap *unloaded;
+  GtGenomeNode *gn;
+  GtkWidget *tab_child;
+  CandidateData *cdata;
+  FamilyStats *stats;
+  gchar *name;
+  unsigned long i, j, size;
+
+  if (!ltrfams->index || ltrfams->modified)
+    return FALSE;
+  gtk_tree_model_get(model, iter,
+                     LTRFAMS_FAM_LV_NODE_ARRAY, &fam_nodes,
+                     LTRFAMS_FAM_LV_TAB_CHILD, &tab_child,
+                     LTRFAMS_FAM_LV_OLDNAME, &name,
+                     LTRFAMS_FAM_LV_STATS, &stats,
+                     -1);
+  size = fam_nodes ? gt_array_size(fam_nodes) : 0;
+  if (tab_child || size == 0 ||
+      !project_index_family_is_loaded(ltrfams->index, name) ||
+      project_index_family_size(ltrfams->index, name) != size) {
+    g_free(name);
+    return FALSE;
+  }
+  for (i = 0; i < size; i++) {
+    gn = *(GtGenomeNode**) gt_array_get(fam_nodes, i);
+    cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+    if (cdata && cdata->cand_ref &&
+        gtk_tree_row_reference_valid(cdata->cand_ref)) {
+      g_free(name);
+      return FALSE;
+    }
+  }
+
+  unloaded = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  for (i = 0; i < size; i++) {
+    gn = *(GtGenomeNode**) gt_array_get(fam_nodes, i);
+    gt_hashmap_add(unloaded, gn, gn);
+    tree_view_details_clear_on_equal_nodes(ltrfams, gn);
+  }
+  for (i = 0, j = 0; i < gt_array_size(ltrfams->nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(ltrfams->nodes, i);
+    if (!gt_hashmap_get(unloaded, gn)) {
+      *(GtGenomeNode**) gt_array_get(ltrfams->nodes, j) = gn;
+      j++;
+    }
+  }
+  gt_array_set_size(ltrfams->nodes, j);
+  gt_hashmap_delete(unloaded);
+
+  if (stats)
+    family_stats_remove_array(stats, fam_nodes);
+  for (i = 0; i < size; i++)
+    candidate_data_delete(ltrfams,
+                          *(GtGenomeNode**) gt_array_get(fam_nodes, i));
+  gt_array_reset(fam_nodes);
+  project_index_unload_family(ltrfams->index, name);
+  ltrfams->unloaded_cands += size;
+  g_free(name);
+  return TRUE;
+}
+
+static void gtk_ltr_families_drop_caches(GtkLTRFamilies *ltrfams)
+{
+  gt_hashmap_reset(ltrfams->sequences);
+  memory_usage_set(ltrfams->memory, MEMORY_SEQUENCES, 0);
+  gt_encseq_delete(ltrfams->encseq);
+  ltrfams->encseq = NULL;
+  g_free(ltrfams->encseq_index);
+  ltrfams->encseq_index = NULL;
+  memory_usage_set(ltrfams->memory, MEMORY_ENCSEQ, 0);
+}
+
+/* the rows of the list stores are estimated from their number of columns */
+static gsize list_store_estimate_size(GtkTreeModel *model)
+{
+  if (!model)
+    return 0;
+  return (gsize) gtk_tree_model_iter_n_children(model, NULL) *
+         (LTRFAMS_ROW_SIZE +
+          gtk_tree_model_get_n_columns(model) * LTRFAMS_CELL_SIZE);
+}
+
+static gsize gtk_ltr_families_estimate_list_stores(GtkLTRFamilies *ltrfams)
+{
+  GtkWidget *tab;
+  GList *children;
+  gsize bytes;
+  gint i;
+
+  bytes = list_store_estimate_size(
+           gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families)));
+  for (i = 0; i < gtk_notebook_get_n_pages(GTK_NOTEBOOK(ltrfams->nb_family));
+       i++) {
+    tab = gtk_notebook_get_nth_page(GTK_NOTEBOOK(ltrfams->nb_family), i);
+    children = gtk_container_get_children(GTK_CONTAINER(tab));
+    if (children && GTK_IS_TREE_VIEW(children->data)) {
+      bytes += list_store_estimate_size(
+                      gtk_tree_view_get_model(GTK_TREE_VIEW(children->data)));
+    }
+    g_list_free(children);
+  }
+  return bytes;
+}
+
+/* caches are dropped first, then closed families are unloaded until the
+   budget is met again */
+static void gtk_ltr_families_enforce_memory_budget(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  gboolean valid,
+           unloaded = FALSE;
+  gchar sb_text[BUFSIZ];
+  unsigned long i;
+
+  if (!memory_usage_exceeded(ltrfams->memory))
+    return;
+  gtk_ltr_families_drop_caches(ltrfams);
+  gtk_chrom_overview_drop_tiles(GTK_CHROM_OVERVIEW(ltrfams->overview));
+  memory_usage_set(ltrfams->memory, MEMORY_OVERVIEW,
+                   gtk_chrom_overview_memory(
+                                      GTK_CHROM_OVERVIEW(ltrfams->overview)));
+  /* the copies kept for saving are made again by the next save */
+  for (i = 0; i < gt_array_size(ltrfams->nodes); i++)
+    drop_node_copy(*(GtGenomeNode**) gt_array_get(ltrfams->nodes, i),
+                   ltrfams->memory);
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  if (!model)
+    return;
+  valid = gtk_tree_model_get_iter_first(model, &iter);
+  while (valid && memory_usage_exceeded(ltrfams->memory)) {
+    if (gtk_ltr_families_unload_family(ltrfams, model, &iter))
+      unloaded = TRUE;
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  if (unloaded) {
+    g_snprintf(sb_text, BUFSIZ, STATUSBAR_NUM_OF_CANDS,
+               gt_array_size(ltrfams->nodes) + ltrfams->unloaded_cands);
+    statusbar_set_status(ltrfams->statusbar, sb_text);
+  }
+}
+
+void gtk_ltr_families_update_memory_usage(GtkLTRFamilies *ltrfams)
+{
+  memory_usage_set(ltrfams->memory, MEMORY_LIST_STORES,
+                   gtk_ltr_families_estimate_list_stores(ltrfams));
+  memory_usage_set(ltrfams->memory, MEMORY_LOCATIONS,
+                   location_index_memory(ltrfams->locations) +
+                   (ltrfams->index_locations
+                    ? location_index_memory(ltrfams->index_locations) : 0));
+  memory_usage_set(ltrfams->memory, MEMORY_OVERVIEW,
+                   gtk_chrom_overview_memory(
+                                      GTK_CHROM_OVERVIEW(ltrfams->overview)));
+  /* candidates must not be unloaded while a job is working on them */
+  if (ltrfams->nodes && ltrfams->holds == 0)
+    gtk_ltr_families_enforce_memory_budget(ltrfams);
+  statusbar_set_memory_usage(ltrfams->statusbar, ltrfams->memory);
+}
+
+/* every job that works on the candidates holds them until it has finished,
+   families are not unloaded in the meantime */
+void gtk_ltr_families_hold_candidates(GtkLTRFamilies *ltrfams)
+{
+  ltrfams->holds++;
+}
+
+void gtk_ltr_families_release_candidates(GtkLTRFamilies *ltrfams)
+{
+  gt_assert(ltrfams->holds > 0);
+  ltrfams->holds--;
+}
+
+static gboolean memory_usage_timeout(gpointer data)
+{
+  gtk_ltr_families_update_memory_usage(GTK_LTR_FAMILIES(data));
+  return TRUE;
+}
 /* <list_view_families> related functions end */
 
+/* refreshes the "*" column of the candidate row showing <gn>, if any */
+static void flcand_changed(GtGenomeNode *gn, GT_UNUSED gpointer data)
+{
+  CandidateData *cdata;
+  GtkTreeModel *model;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+
+  cdata = (CandidateData*) gt_genome_node_get_user_data(gn, "cdata");
+  if (!cdata || !cdata->cand_ref ||
+      !gtk_tree_row_reference_valid(cdata->cand_ref))
+    return;
+  model = gtk_tree_row_reference_get_model(cdata->cand_ref);
+  path = gtk_tree_row_reference_get_path(cdata->cand_ref);
+  if (gtk_tree_model_get_iter(model, &iter, path))
+    update_list_view_with_flcand(GTK_LIST_STORE(model), &iter, gn);
+  gtk_tree_path_free(path);
+}
+
+static gboolean determine_fl_cands_finished(gpointer data)
+{
+  ThreadData *threaddata = (ThreadData*) data;
+  GtkLTRFamilies *ltrfams = threaddata->ltrfams;
+  unsigned long flcands;
+
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
+  g_source_remove(GPOINTER_TO_INT(
+                               g_object_get_data(G_OBJECT(threaddata->window),
+                                                 "source_id")));
+  gtk_widget_destroy(threaddata->window);
+  reset_progressbar(threaddata->progressbar);
+  gtk_ltr_families_release_candidates(threaddata->ltrfams);
+
+  /* the candidates are only changed here, in the main thread, and the open
+     family tabs are updated at once */
+  flcands = flcand_batch_apply(threaddata->flcands, flcand_changed, NULL);
+  gtk_ltr_families_set_modified(ltrfams, TRUE);
+  gtk_ltr_families_log_perf(ltrfams, threaddata->perf, FALSE);
+  threaddata->perf = NULL;
+  gdk_threads_enter();
+  flcand_result_dialog(gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)), flcands);
+  gdk_threads_leave();
+
+  flcand_batch_delete(threaddata->flcands);
+  threaddata_delete(threaddata);
+  return FALSE;
+}
+
+static gpointer determine_fl_cands_start(gpointer data)
+{
+  ThreadData *threaddata = (ThreadData*) data;
+
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
+                            "Determining full length candidates");
+  perf_log_stage(threaddata->perf, PERF_STAGE_FLCANDS);
+  perf_log_add_items(threaddata->perf,
+                     flcand_batch_size(threaddata->flcands));
+  flcand_batch_run(threaddata->flcands, bgzf_default_threads(),
+                   &threaddata->progress);
+  g_idle_add(determine_fl_cands_finished, data);
+  return NULL;
+}
+
 void gtk_ltr_families_determine_fl_cands(GtkLTRFamilies *ltrfams,
                                          gfloat ltrtolerance,
                                          gfloat lentolerance)
 {
+  ThreadData *threaddata;
+  GtkWidget *toplevel;
   GtkTreeModel *model;
   GtkTreeIter iter;
   GtArray *nodes;
+  FLCandBatch *batch;
   gboolean valid;
-  GT_UNUSED unsigned long flcands;
 
+  if (gtk_ltr_families_load_all_families(ltrfams))
+    return;
+  batch = flcand_batch_new(ltrtolerance, lentolerance);
   model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
   valid = gtk_tree_model_get_iter_first(model, &iter);
-  if (valid) {
+  while (valid) {
     gtk_tree_model_get(model, &iter, LTRFAMS_FAM_LV_NODE_ARRAY, &nodes, -1);
-    flcands = determine_full_length_candidates(nodes, ltrtolerance,
-                                               lentolerance);
-    while (gtk_tree_model_iter_next(model, &iter)) {
-      gtk_tree_model_get(model, &iter, LTRFAMS_FAM_LV_NODE_ARRAY, &nodes, -1);
-      flcands = determine_full_length_candidates(nodes, ltrtolerance,
-                                                 lentolerance);
-    }
+    if (nodes)
+      flcand_batch_add(batch, nodes);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+
+  toplevel = gtk_widget_get_toplevel(GTK_WIDGET(ltrfams));
+  threaddata = threaddata_new();
+  threaddata->ltrfams = ltrfams;
+  threaddata->progressbar = ltrfams->progressbar;
+  threaddata->progress = 0;
+  threaddata->flcands = batch;
+  threaddata->perf = perf_log_new(PERF_JOB_FLCANDS);
+  progress_dialog_init(threaddata, toplevel);
+
+  gtk_ltr_families_hold_candidates(ltrfams);
+  if (!g_thread_create(determine_fl_cands_start, (gpointer) threaddata, FALSE,
+                       NULL)) {
+    gt_error_set(ltrfams->err, "Could not create new thread.");
+    error_handle(toplevel, ltrfams->err);
+    gtk_ltr_families_release_candidates(ltrfams);
   }
 }
 
+void gtk_ltr_families_recompute_fl_cands(GtkLTRFamilies *ltrfams)
+{
+  gfloat ltrtolerance,
+         lentolerance;
+
+  if (flcand_tolerance_dialog(gtk_widget_get_toplevel(GTK_WIDGET(ltrfams)),
+                              &ltrtolerance, &lentolerance))
+    gtk_ltr_families_determine_fl_cands(ltrfams, ltrtolerance, lentolerance);
+}
+
 void gtk_ltr_families_fill_with_data(GtkLTRFamilies *ltrfams,
                                      GtArray *nodes,
                                      GtArray *regions,
@@ -4441,6 +6159,10 @@ void gtk_ltr_families_fill_with_data(GtkLTRFamilies *ltrfams,
   gchar sb_text[BUFSIZ];
   gint had_err = 0;
 
+  /* candidates and regions are kept in genomic order, candidates are only
+     ever removed from <nodes>, so saving does not need to sort them */
+  node_array_ensure_sorted(nodes);
+  node_array_ensure_sorted(regions);
   ltrfams->nodes = nodes;
   ltrfams->regions = regions;
   ltrfams->features = features;
@@ -4460,14 +6182,62 @@ void gtk_ltr_families_fill_with_data(GtkLTRFamilies *ltrfams,
     gt_assert(!had_err);
   }
   notebook_create(ltrfams);
+  if (ltrfams->index)
+    list_view_families_append_index(ltrfams);
   update_main_tab_label(ltrfams);
   gtk_widget_set_sensitive(GTK_WIDGET(ltrfams->new_fam), TRUE);
+  gtk_widget_set_sensitive(ltrfams->locate, TRUE);
   gtk_widget_set_sensitive(GTK_WIDGET(ltrfams->tb_lv_families), TRUE);
   g_snprintf(sb_text, BUFSIZ, STATUSBAR_NUM_OF_CANDS,
-             gt_array_size(ltrfams->nodes));
+             gt_array_size(ltrfams->nodes) + ltrfams->unloaded_cands);
   statusbar_set_status(ltrfams->statusbar, sb_text);
 }
 
+/* the models are taken away from the views before anything is freed, so
+   the views are not updated row by row while the project is torn down */
+static void gtk_ltr_families_detach_views(GtkLTRFamilies *ltrfams)
+{
+  GtkWidget *tab;
+  GList *children;
+  gint i;
+
+  for (i = 0; i < gtk_notebook_get_n_pages(GTK_NOTEBOOK(ltrfams->nb_family));
+       i++) {
+    tab = gtk_notebook_get_nth_page(GTK_NOTEBOOK(ltrfams->nb_family), i);
+    children = gtk_container_get_children(GTK_CONTAINER(tab));
+    if (children && GTK_IS_TREE_VIEW(children->data))
+      gtk_tree_view_set_model(GTK_TREE_VIEW(children->data), NULL);
+    g_list_free(children);
+  }
+  gtk_tree_view_set_model(GTK_TREE_VIEW(ltrfams->tree_view_details), NULL);
+}
+
+static void gtk_ltr_families_free_families(GtkLTRFamilies *ltrfams)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtArray *nodes;
+  FamilyStats *stats;
+  gboolean valid;
+
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfams->list_view_families));
+  if (!model)
+    return;
+  g_object_ref(model);
+  gtk_tree_view_set_model(GTK_TREE_VIEW(ltrfams->list_view_families), NULL);
+  valid = gtk_tree_model_get_iter_first(model, &iter);
+  while (valid) {
+    gtk_tree_model_get(model, &iter,
+                       LTRFAMS_FAM_LV_NODE_ARRAY, &nodes,
+                       LTRFAMS_FAM_LV_STATS, &stats,
+                       -1);
+    gt_array_delete(nodes);
+    family_stats_delete(stats);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  g_object_unref(model);
+}
+
 static gboolean gtk_ltr_families_destroy(GtkWidget *widget,
                                          GT_UNUSED GdkEvent *event,
                                          GT_UNUSED gpointer user_data)
@@ -4479,6 +6249,12 @@ static gboolean gtk_ltr_families_destroy(GtkWidget *widget,
 
   g_signal_handler_disconnect((gpointer) ltrfams->nb_family,
                               ltrfams->sig_handler);
+  g_source_remove(ltrfams->memory_sid);
+  statusbar_set_memory_usage(ltrfams->statusbar, NULL);
+  gtk_ltr_families_detach_views(ltrfams);
+  gtk_ltr_families_free_families(ltrfams);
+  /* the diagram of the overview refers to the candidates */
+  gtk_chrom_overview_drop_tiles(GTK_CHROM_OVERVIEW(ltrfams->overview));
   gt_style_delete(ltrfams->style);
   gt_diagram_delete(ltrfams->diagram);
   gt_hashmap_delete(ltrfams->features);
@@ -4488,6 +6264,23 @@ static gboolean gtk_ltr_families_destroy(GtkWidget *widget,
     delete_gt_genome_node(gn);
   }
   gt_array_delete(ltrfams->nodes);
+  /* the candidate data of all candidates is released at once */
+  gt_array_delete(ltrfams->spare_cdata);
+  arena_delete(ltrfams->arena);
+  ltrfams->arena = NULL;
+  gtk_ltr_families_drop_caches(ltrfams);
+  gt_hashmap_delete(ltrfams->sequences);
+  memory_usage_delete(ltrfams->memory);
+  for (i = 0; i < gt_array_size(ltrfams->outdated_families); i++)
+    gtk_tree_row_reference_free(*(GtkTreeRowReference**)
+                                gt_array_get(ltrfams->outdated_families, i));
+  gt_array_delete(ltrfams->outdated_families);
+  for (i = 0; i < gt_array_size(ltrfams->perf_logs); i++)
+    perf_log_delete(*(PerfLog**) gt_array_get(ltrfams->perf_logs, i));
+  gt_array_delete(ltrfams->perf_logs);
+  project_index_delete(ltrfams->index);
+  location_index_delete(ltrfams->index_locations);
+  location_index_delete(ltrfams->locations);
   g_free(ltrfams->projectfile);
 
   return FALSE;
@@ -4518,6 +6311,8 @@ static void gtk_ltr_families_init(GtkLTRFamilies *ltrfams)
   GtkWidget *vbox1,
             *vbox2,
             *vbox3,
+            *vbox4,
+            *expander,
             *label,
             *sw1,
             *sw2,
@@ -4530,7 +6325,8 @@ static void gtk_ltr_families_init(GtkLTRFamilies *ltrfams)
 
   GtkAdjustment *vadj = NULL;
   GtkToolItem *add,
-              *remove;
+              *remove,
+              *locate;
   GdkColor color;
   GtkTreeSelection *selection;
 
@@ -4558,6 +6354,8 @@ static void gtk_ltr_families_init(GtkLTRFamilies *ltrfams)
   gtk_tree_selection_set_mode(selection, GTK_SELECTION_MULTIPLE);
   g_signal_connect(G_OBJECT(ltrfams->list_view_families), "key-press-event",
                    G_CALLBACK(gtk_ltr_families_lv_fams_key_pressed), ltrfams);
+  g_signal_connect(G_OBJECT(selection), "changed",
+                   G_CALLBACK(list_view_families_selection_changed), ltrfams);
   g_signal_connect(G_OBJECT(add), "clicked",
                    G_CALLBACK(list_view_families_toolbar_add_clicked),
                    ltrfams);
@@ -4566,9 +6364,12 @@ static void gtk_ltr_families_init(GtkLTRFamilies *ltrfams)
                    ltrfams);
   gtk_container_add(GTK_CONTAINER(sw1), ltrfams->list_view_families);
   hsep1 = gtk_hseparator_new();
+  ltrfams->family_stats = gtk_label_new(FAMS_STATS_NONE);
+  gtk_misc_set_alignment(GTK_MISC(ltrfams->family_stats), 0.0, 0.0);
   gtk_box_pack_start(GTK_BOX(vbox1), ltrfams->tb_lv_families, FALSE, TRUE, 1);
   gtk_box_pack_start(GTK_BOX(vbox1), hsep1, FALSE, FALSE, 1);
   gtk_box_pack_start(GTK_BOX(vbox1), sw1, TRUE, TRUE, 1);
+  gtk_box_pack_start(GTK_BOX(vbox1), ltrfams->family_stats, FALSE, FALSE, 1);
 
   gtk_paned_add1(GTK_PANED(ltrfams), vbox1);
 
@@ -4589,8 +6390,19 @@ static void gtk_ltr_families_init(GtkLTRFamilies *ltrfams)
   gtk_toolbar_insert(GTK_TOOLBAR(ltrfams->tb_nb_family), ltrfams->fl_cands, 1);
   g_signal_connect(G_OBJECT(ltrfams->fl_cands), "clicked",
                    G_CALLBACK(notebook_toolbar_flcand_clicked), ltrfams);
+  gtk_toolbar_insert(GTK_TOOLBAR(ltrfams->tb_nb_family),
+                     gtk_separator_tool_item_new(), 2);
+  locate = gtk_tool_item_new();
+  ltrfams->locate = gtk_entry_new();
+  gtk_entry_set_width_chars(GTK_ENTRY(ltrfams->locate), 24);
+  gtk_container_add(GTK_CONTAINER(locate), ltrfams->locate);
+  gtk_tool_item_set_tooltip_text(locate, TB_NB_LOCATE);
+  gtk_toolbar_insert(GTK_TOOLBAR(ltrfams->tb_nb_family), locate, 3);
+  g_signal_connect(G_OBJECT(ltrfams->locate), "activate",
+                   G_CALLBACK(notebook_toolbar_locate_activate), ltrfams);
   gtk_widget_set_sensitive(GTK_WIDGET(ltrfams->new_fam), FALSE);
   gtk_widget_set_sensitive(GTK_WIDGET(ltrfams->fl_cands), FALSE);
+  gtk_widget_set_sensitive(ltrfams->locate, FALSE);
   ltrfams->nb_family = gtk_notebook_new();
   ltrfams->sig_handler = g_signal_connect(G_OBJECT(ltrfams->nb_family),
                                           "page-removed",
@@ -4637,7 +6449,14 @@ static void gtk_ltr_families_init(GtkLTRFamilies *ltrfams)
 
   gtk_paned_add2(GTK_PANED(ltrfams->hpaned), sw3);
 
-  gtk_paned_add2(GTK_PANED(ltrfams->vpaned), ltrfams->hpaned);
+  vbox4 = gtk_vbox_new(FALSE, 0);
+  expander = gtk_expander_new(OVERVIEW_EXPANDER);
+  ltrfams->overview = gtk_chrom_overview_new(ltrfams);
+  gtk_container_add(GTK_CONTAINER(expander), ltrfams->overview);
+  gtk_box_pack_start(GTK_BOX(vbox4), expander, FALSE, TRUE, 1);
+  gtk_box_pack_start(GTK_BOX(vbox4), ltrfams->hpaned, TRUE, TRUE, 0);
+
+  gtk_paned_add2(GTK_PANED(ltrfams->vpaned), vbox4);
 
   gtk_paned_add2(GTK_PANED(ltrfams), ltrfams->vpaned);
 
@@ -4687,12 +6506,30 @@ GtkWidget* gtk_ltr_families_new(GtkWidget *statusbar,
                    G_CALLBACK(gtk_ltr_families_destroy), NULL);
   ltrfams->projectfile = NULL;
   ltrfams->unclassified_cands = 0;
+  ltrfams->unloaded_cands = 0;
+  ltrfams->generation = 0;
+  ltrfams->index = NULL;
+  ltrfams->locations = location_index_new();
+  ltrfams->index_locations = NULL;
+  ltrfams->arena = arena_new(LTRFAMS_ARENA_BLOCK_SIZE);
+  ltrfams->spare_cdata = gt_array_new(sizeof (CandidateData*));
+  ltrfams->memory = memory_usage_new(memory_usage_budget_from_env());
+  ltrfams->holds = 0;
+  ltrfams->encseq = NULL;
+  ltrfams->encseq_index = NULL;
+  ltrfams->sequences = gt_hashmap_new(GT_HASH_STRING, g_free, g_free);
+  ltrfams->perf_logs = gt_array_new(sizeof (PerfLog*));
   ltrfams->modified = FALSE;
+  ltrfams->outdated_families = gt_array_new(sizeof (GtkTreeRowReference*));
   ltrfams->statusbar = statusbar;
   ltrfams->progressbar = progressbar;
   ltrfams->projset = projset;
   ltrfams->style_file = style_file;
   ltrfams->err = err;
+  ltrfams->memory_sid =
+                  gdk_threads_add_timeout_seconds(LTRFAMS_MEMORY_INTERVAL,
+                                                  memory_usage_timeout,
+                                                  ltrfams);
 
   return GTK_WIDGET(ltrfams);
 }
@@ -22,8 +22,16 @@
 #include <glib.h>
 #include <glib-object.h>
 #include <gtk/gtk.h>
+#include "arena.h"
+#include "cand_selection.h"
+#include "chrom_overview.h"
 #include "gtk_label_close.h"
+#include "family_stats.h"
 #include "genometools.h"
+#include "location_index.h"
+#include "memory_usage.h"
+#include "perf_log.h"
+#include "project_index.h"
 
 #define GTK_LTR_FAMILIES_TYPE\
         gtk_ltr_families_get_type()
@@ -41,6 +49,8 @@ typedef struct _FamilyTransferData  FamilyTransferData;
 typedef struct _GtkLTRFamilies      GtkLTRFamilies;
 typedef struct _GtkLTRFamiliesClass GtkLTRFamiliesClass;
 
+typedef gboolean (*CandPredicate)(GtGenomeNode *gn, gpointer data);
+
 enum {
   LTRFAMS_LV_NODE = 0,
   LTRFAMS_LV_ROWREF,
@@ -73,14 +83,26 @@ enum {
   LTRFAMS_FAM_LV_CURNAME,
   LTRFAMS_FAM_LV_OLDNAME,
   LTRFAMS_FAM_LV_ROWREF,
+  LTRFAMS_FAM_LV_STATS,
   LTRFAMS_FAM_LV_N_COLUMS
 };
 
+enum {
+  LTRFAMS_LOCATE_SEQID = 0,
+  LTRFAMS_LOCATE_START,
+  LTRFAMS_LOCATE_END,
+  LTRFAMS_LOCATE_ID,
+  LTRFAMS_LOCATE_FAMILY,
+  LTRFAMS_LOCATE_NODE,
+  LTRFAMS_LOCATE_ENTRY,
+  LTRFAMS_LOCATE_N_COLUMS
+};
+
 struct _FamilyTransferData
 {
   GtArray *nodes;
   GtkTreeRowReference *rowref;
-  GList *references;
+  CandSelection *selection;
   GtkTreeView *list_view;
 };
 
@@ -98,14 +120,17 @@ struct _GtkLTRFamilies
   GtkHPaned hpane;
 
   GtkWidget *list_view_families;
+  GtkWidget *family_stats;
   GtkCellRenderer *lv_fams_renderer;
   GtkWidget *tb_lv_families;
   GtkWidget *nb_family;
   GtkWidget *tb_nb_family;
   GtkToolItem *new_fam;
   GtkToolItem *fl_cands;
+  GtkWidget *locate;
   GtkWidget *tree_view_details;
   GtkWidget *image_area;
+  GtkWidget *overview;
   GtkWidget *hpaned;
   GtkWidget *vpaned;
   GtRDB *rdb;
@@ -117,8 +142,23 @@ struct _GtkLTRFamilies
   GtHashmap *features,
             *colors;
   GtError *err;
+  ProjectIndex *index;
+  LocationIndex *locations,
+                *index_locations;
+  Arena *arena;
+  GtArray *spare_cdata;
+  MemoryUsage *memory;
+  GtEncseq *encseq;
+  gchar *encseq_index;
+  GtHashmap *sequences;
+  guint memory_sid,
+        holds;
+  GtArray *perf_logs,
+          *outdated_families;
   unsigned long n_features,
-                unclassified_cands;
+                unclassified_cands,
+                unloaded_cands,
+                generation;
   gboolean modified;
   gchar *projectfile;
   gchar *style_file;
@@ -158,14 +198,73 @@ void            gtk_ltr_families_determine_fl_cands(GtkLTRFamilies *ltrfams,
                                                     gfloat ltrtolerance,
                                                     gfloat lentolerance);
 
+void            gtk_ltr_families_recompute_fl_cands(GtkLTRFamilies *ltrfams);
+
 GtkNotebook*    gtk_ltr_families_get_notebook(GtkLTRFamilies *ltrfams);
 
 GtArray*        gtk_ltr_families_get_nodes(GtkLTRFamilies *ltrfams);
 
+void            gtk_ltr_families_remove_candidate(GtkLTRFamilies *ltrfams,
+                                                  GtGenomeNode *gn);
+
+CandSelection*  gtk_ltr_families_get_selection(GtkTreeView *list_view);
+
+void            gtk_ltr_families_set_selection(GtkTreeView *list_view,
+                                               CandSelection *cs);
+
+void            gtk_ltr_families_get_selected_nodes(GtkTreeView *list_view,
+                                                    CandSelection *cs,
+                                                    GtArray *nodes);
+
+void            gtk_ltr_families_select_by(GtkTreeView *list_view,
+                                           CandPredicate predicate,
+                                           gpointer data);
+
 GtArray*        gtk_ltr_families_get_regions(GtkLTRFamilies *ltrfams);
 
+ChromOverview*  gtk_ltr_families_new_overview(GtkLTRFamilies *ltrfams);
+
+GtDiagram*      gtk_ltr_families_new_diagram(GtkLTRFamilies *ltrfams,
+                                             const gchar *seqid,
+                                             GtRange *range);
+
+void            gtk_ltr_families_show_candidate(GtkLTRFamilies *ltrfams,
+                                                const gchar *seqid,
+                                                unsigned long start,
+                                                unsigned long end);
+
+GtStyle*        gtk_ltr_families_get_style(GtkLTRFamilies *ltrfams);
+
+GtHashmap*      gtk_ltr_families_get_features(GtkLTRFamilies *ltrfams);
+
 gboolean        gtk_ltr_families_get_modified(GtkLTRFamilies *ltrfams);
 
+void            gtk_ltr_families_sync_family_names(GtkLTRFamilies *ltrfams);
+
+unsigned long   gtk_ltr_families_get_generation(GtkLTRFamilies *ltrfams);
+
+ProjectIndex*   gtk_ltr_families_get_index(GtkLTRFamilies *ltrfams);
+
+void            gtk_ltr_families_set_index(GtkLTRFamilies *ltrfams,
+                                           ProjectIndex *index);
+
+gint            gtk_ltr_families_load_family(GtkLTRFamilies *ltrfams,
+                                             GtkTreeModel *model,
+                                             GtkTreeIter *iter);
+
+gint            gtk_ltr_families_load_all_families(GtkLTRFamilies *ltrfams);
+
+void            gtk_ltr_families_update_memory_usage(GtkLTRFamilies *ltrfams);
+
+void            gtk_ltr_families_hold_candidates(GtkLTRFamilies *ltrfams);
+
+void            gtk_ltr_families_release_candidates(GtkLTRFamilies *ltrfams);
+
+MemoryUsage*    gtk_ltr_families_get_memory_usage(GtkLTRFamilies *ltrfams);
+
+void            gtk_ltr_families_log_perf(GtkLTRFamilies *ltrfams,
+                                          PerfLog *perf, gboolean failed);
+
 gchar*          gtk_ltr_families_get_projectfile(GtkLTRFamilies *ltrfams);
 
 void            gtk_ltr_families_set_projectfile(GtkLTRFamilies *ltrfams,
@@ -17,6 +17,9 @@
 */
 
 #include "error.h"
+#include "filter_cache.h"
+#include "filter_pool.h"
+#include "filter_stats.h"
 #include "gtk_ltr_filter.h"
 #include "message_strings.h"
 #include "support.h"
@@ -260,6 +263,7 @@ static void delete_from_family(CandidateData *cdata, GtGenomeNode *gn,
   GtkTreeIter iter;
   GtkWidget *tab_label;
   GtArray *tmp_nodes;
+  FamilyStats *stats;
   gboolean valid;
   gchar *old_name, cur_name[BUFSIZ];
 
@@ -273,8 +277,11 @@ static void delete_from_family(CandidateData *cdata, GtGenomeNode *gn,
                        LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes,
                        LTRFAMS_FAM_LV_OLDNAME, &old_name,
                        LTRFAMS_FAM_LV_TAB_LABEL, &tab_label,
+                       LTRFAMS_FAM_LV_STATS, &stats,
                        -1);
     remove_node_from_array(tmp_nodes, gn);
+    if (stats)
+      family_stats_remove(stats, gn);
     if (gt_array_size(tmp_nodes) == 0) {
       if (tab_label) {
         gtk_notebook_remove_page(notebook,
@@ -284,6 +291,7 @@ static void delete_from_family(CandidateData *cdata, GtGenomeNode *gn,
       }
       remove_row(cdata->fam_ref);
       gt_array_delete(tmp_nodes);
+      family_stats_delete(stats);
     } else {
       g_snprintf(cur_name, BUFSIZ, "%s (%lu)", old_name,
                  gt_array_size(tmp_nodes));
@@ -306,6 +314,220 @@ void gtk_ltr_filter_set_ltrfams(GtkLTRFilter *ltrfilt, GtkWidget *ltrfams)
   ltrfilt->ltrfams = ltrfams;
 }
 
+/* returns the selected filter files (NULL if there are none) and sets
+   <negate> to the filters to invert */
+static GtStrArray* gtk_ltr_filter_get_filter_files(GtkLTRFilter *ltrfilt,
+                                                   GtBittab **negate)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtStrArray *filter_files;
+  gboolean valid, negate_filter;
+  gchar *filter_file;
+  unsigned long i = 0;
+
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfilt->list_view_sel));
+  if (!(valid = gtk_tree_model_get_iter_first(model, &iter)))
+    return NULL;
+  *negate =
+     gt_bittab_new((unsigned long) gtk_tree_model_iter_n_children(model, NULL));
+  filter_files = gt_str_array_new();
+  while (valid) {
+    gtk_tree_model_get(model, &iter,
+                       LTR_FILTER_LV_FILE, &filter_file,
+                       LTR_FILTER_LV_SEL_NOT, &negate_filter, -1);
+    if (negate_filter)
+      gt_bittab_set_bit(*negate, i);
+    i++;
+    gt_str_array_add_cstr(filter_files, filter_file);
+    g_free(filter_file);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  return filter_files;
+}
+
+static gint gtk_ltr_filter_get_logic(GtkLTRFilter *ltrfilt)
+{
+  if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ltrfilt->filter_logic)))
+    return LTR_FILTER_LOGIC_AND;
+  return LTR_FILTER_LOGIC_OR;
+}
+
+/* stores the keys of the selected filters, under which their statistics are
+   kept; a filter file which cannot be read has no key */
+static void gtk_ltr_filter_update_keys(GtkLTRFilter *ltrfilt)
+{
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtError *err;
+  gboolean valid;
+  gchar *file;
+
+  err = gt_error_new();
+  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfilt->list_view_sel));
+  valid = gtk_tree_model_get_iter_first(model, &iter);
+  while (valid) {
+    gtk_tree_model_get(model, &iter, LTR_FILTER_LV_FILE, &file, -1);
+    gtk_list_store_set(GTK_LIST_STORE(model), &iter,
+                       LTR_FILTER_LV_SEL_KEY, filter_cache_key(file, err), -1);
+    gt_error_unset(err);
+    g_free(file);
+    valid = gtk_tree_model_iter_next(model, &iter);
+  }
+  gt_error_delete(err);
+}
+
+/* returns the candidates of the range to filter, sorted. For the project
+   these are all loaded candidates, the array belongs to the families view.
+   Otherwise a new array is returned, the selected families are loaded. */
+static GtArray* gtk_ltr_filter_get_range_nodes(GtkLTRFilter *ltrfilt)
+{
+  GtkNotebook *notebook;
+  GtkTreeView *list_view;
+  GtkTreeModel *model;
+  GtkTreeIter iter;
+  GtkTreeSelection *sel;
+  CandSelection *selection;
+  GtkWidget *tab_child;
+  GtArray *nodes = NULL,
+          *tmp_nodes = NULL;
+  GList *rows, *tmp, *children;
+  gint tab_no;
+
+  switch (ltrfilt->range) {
+    case LTR_FILTER_RANGE_PROJECT:
+      nodes = gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+      break;
+    case LTR_FILTER_RANGE_FAMILIES:
+      nodes = gt_array_new(sizeof (GtGenomeNode*));
+      list_view = gtk_ltr_families_get_list_view_families(
+                                            GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+      model = gtk_tree_view_get_model(GTK_TREE_VIEW(list_view));
+      sel = gtk_tree_view_get_selection(list_view);
+      rows = gtk_tree_selection_get_selected_rows(sel, &model);
+      tmp = rows;
+      while (tmp != NULL) {
+        gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
+        (void) gtk_ltr_families_load_family(GTK_LTR_FAMILIES(ltrfilt->ltrfams),
+                                            model, &iter);
+        gtk_tree_model_get(model, &iter,
+                           LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes, -1);
+        gt_array_add_array(nodes, tmp_nodes);
+        tmp = tmp->next;
+      }
+      gt_genome_nodes_sort_stable(nodes);
+      g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
+      g_list_free(rows);
+      break;
+    case LTR_FILTER_RANGE_CANDIDATES:
+      nodes = gt_array_new(sizeof (GtGenomeNode*));
+      notebook =
+              gtk_ltr_families_get_notebook(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+      tab_no = gtk_notebook_get_current_page(notebook);
+      tab_child = gtk_notebook_get_nth_page(notebook, tab_no);
+      children = gtk_container_get_children(GTK_CONTAINER(tab_child));
+      list_view = GTK_TREE_VIEW(g_list_first(children)->data);
+      selection = gtk_ltr_families_get_selection(list_view);
+      gtk_ltr_families_get_selected_nodes(list_view, selection, nodes);
+      cand_selection_delete(selection);
+      gt_genome_nodes_sort_stable(nodes);
+      g_list_free(children);
+      break;
+    default:
+      break;
+  }
+  return nodes;
+}
+
+static void gtk_ltr_filter_preview_ready(unsigned long matches,
+                                         unsigned long total,
+                                         GtArray *families, GtError *err,
+                                         gpointer data)
+{
+  GtkLTRFilter *ltrfilt = GTK_LTR_FILTER(data);
+  FilterPreviewCount *count;
+  GString *tooltip;
+  gchar text[BUFSIZ];
+  unsigned long i;
+
+  if (ltrfilt->preview_held) {
+    gtk_ltr_families_release_candidates(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+    ltrfilt->preview_held = FALSE;
+  }
+  if (err) {
+    g_snprintf(text, BUFSIZ, LTR_FILTER_PREVIEW_ERROR, gt_error_get(err));
+    gtk_label_set_text(GTK_LABEL(ltrfilt->label_preview), text);
+    gtk_widget_set_tooltip_text(ltrfilt->label_preview, NULL);
+    return;
+  }
+  if (ltrfilt->preview_unloaded > 0)
+    g_snprintf(text, BUFSIZ, LTR_FILTER_PREVIEW_LOADED, matches, total,
+               ltrfilt->preview_unloaded);
+  else
+    g_snprintf(text, BUFSIZ, LTR_FILTER_PREVIEW, matches, total);
+  gtk_label_set_text(GTK_LABEL(ltrfilt->label_preview), text);
+  tooltip = g_string_new(NULL);
+  for (i = 0; i < gt_array_size(families); i++) {
+    count = (FilterPreviewCount*) gt_array_get(families, i);
+    if (i > 0)
+      g_string_append_c(tooltip, '\n');
+    g_string_append_printf(tooltip, LTR_FILTER_PREVIEW_FAMILY,
+                           *count->family ? count->family : MAIN_TAB_LABEL,
+                           count->matches, count->total);
+  }
+  gtk_widget_set_tooltip_text(ltrfilt->label_preview,
+                              tooltip->len > 0 ? tooltip->str : NULL);
+  g_string_free(tooltip, TRUE);
+}
+
+/* stops the running count, the candidates can be unloaded again */
+static void gtk_ltr_filter_stop_preview(GtkLTRFilter *ltrfilt)
+{
+  filter_preview_stop(ltrfilt->preview);
+  if (ltrfilt->preview_held) {
+    gtk_ltr_families_release_candidates(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+    ltrfilt->preview_held = FALSE;
+  }
+}
+
+/* counts the candidates of the range selected by the current filters in the
+   background, the count running is cancelled */
+static void gtk_ltr_filter_update_preview(GtkLTRFilter *ltrfilt)
+{
+  GtStrArray *filter_files;
+  GtBittab *negate = NULL;
+  GtArray *nodes;
+
+  /* the candidates must not be changed while they are filtered */
+  gtk_ltr_filter_stop_preview(ltrfilt);
+  gtk_widget_set_tooltip_text(ltrfilt->label_preview, NULL);
+  if (!(filter_files = gtk_ltr_filter_get_filter_files(ltrfilt, &negate))) {
+    gtk_label_set_text(GTK_LABEL(ltrfilt->label_preview),
+                       LTR_FILTER_PREVIEW_NONE);
+    return;
+  }
+  /* filters may look at the family names of the candidates */
+  gtk_ltr_families_sync_family_names(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+  if ((nodes = gtk_ltr_filter_get_range_nodes(ltrfilt))) {
+    gtk_label_set_text(GTK_LABEL(ltrfilt->label_preview),
+                       LTR_FILTER_PREVIEW_RUNNING);
+    filter_preview_start(ltrfilt->preview, nodes, filter_files, negate,
+                         gtk_ltr_filter_get_logic(ltrfilt));
+    gtk_ltr_families_hold_candidates(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
+    ltrfilt->preview_held = TRUE;
+    /* the families are only loaded when the filters are applied, the count
+       of the project covers the loaded candidates */
+    ltrfilt->preview_unloaded = 0;
+    if (ltrfilt->range == LTR_FILTER_RANGE_PROJECT)
+      ltrfilt->preview_unloaded =
+                        GTK_LTR_FAMILIES(ltrfilt->ltrfams)->unloaded_cands;
+    if (ltrfilt->range != LTR_FILTER_RANGE_PROJECT)
+      gt_array_delete(nodes);
+  }
+  gt_str_array_delete(filter_files);
+  gt_bittab_delete(negate);
+}
+
 static void edit_dialog_delete_event(GtkWidget *widget,
                                      GT_UNUSED GdkEvent *event,
                                      GtkLTRFilter *ltrfilt)
@@ -361,8 +583,13 @@ static gboolean save_filter_file(GtkLTRFilter *ltrfilt)
         gt_error_set(err, "Could not save content to %s",
                      ltrfilt->cur_filename);
         error_handle(GTK_WIDGET(ltrfilt), err);
-      } else
+      } else {
         gtk_text_buffer_set_modified(ltrfilt->text_buffer, FALSE);
+        /* the file may have been saved within the second it was loaded */
+        filter_pool_invalidate(ltrfilt->cur_filename);
+        gtk_ltr_filter_update_keys(ltrfilt);
+        gtk_ltr_filter_update_preview(ltrfilt);
+      }
     } else {
       dialog = gtk_message_dialog_new(GTK_WINDOW(ltrfilt),
                                       GTK_DIALOG_MODAL |
@@ -520,16 +747,11 @@ static void create_edit_dialog(GtkLTRFilter *ltrfilt)
   pango_font_description_free(font_desc);
 }
 
-static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
+static void gtk_ltr_filter_apply(GtkLTRFilter *ltrfilt)
 {
   CandidateData *cdata;
-  GtkNotebook *notebook;
   GtkTreeView *list_view;
-  GtkTreeModel *model;
-  GtkTreeIter iter;
-  GtkTreeSelection *sel;
-  GtkWidget *dialog,
-            *tab_child;
+  GtkWidget *dialog;
   GtStrArray *filter_files = NULL;
   GtError *err = gt_error_new();
   GtFeatureNodeIterator *fni;
@@ -538,111 +760,45 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
                *script_filter_stream = NULL,
                *array_out_stream = NULL;
   GtArray *nodes = NULL,
-          *filtered_nodes = NULL,
-          *tmp_nodes = NULL;
-  GtBittab *negate;
+          *filtered_nodes = NULL;
+  GtBittab *negate = NULL;
   GtGenomeNode *gn;
-  GList *rows, *tmp, *children;
-  gboolean negate_filter;
-  gchar *filter_file,
-        fam_name[BUFSIZ],
+  PerfLog *perf;
+  gchar fam_name[BUFSIZ],
         filter_message[BUFSIZ];
-  gint action, logic, had_err = 0, tab_no;
+  gint action, logic, had_err = 0;
   const char *attr;
   unsigned long total_candidates = 0,
                 unclassified_candidates = 0,
                 deleted_candidates = 0,
                 i = 0;
 
-  model = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfilt->list_view_sel));
-  filtered_nodes = gt_array_new(sizeof (GtGenomeNode*));
-
-  if (!gtk_tree_model_get_iter_first(model, &iter)) {
+  /* the preview must not look at the candidates while they are changed */
+  gtk_ltr_filter_stop_preview(ltrfilt);
+  perf = perf_log_new(PERF_JOB_FILTER);
+  perf_log_stage(perf, PERF_STAGE_LOAD);
+  /* filtering the whole project needs all candidates in memory */
+  if (ltrfilt->range == LTR_FILTER_RANGE_PROJECT &&
+      gtk_ltr_families_load_all_families(GTK_LTR_FAMILIES(ltrfilt->ltrfams))) {
+    perf_log_delete(perf);
     return;
-  } else {
-    gtk_widget_hide(GTK_WIDGET(ltrfilt));
-    negate =
-     gt_bittab_new((unsigned long) gtk_tree_model_iter_n_children(model, NULL));
-    filter_files = gt_str_array_new();
-    gtk_tree_model_get(model, &iter,
-                       LTR_FILTER_LV_FILE, &filter_file,
-                       LTR_FILTER_LV_SEL_NOT, &negate_filter, -1);
-    if (negate_filter)
-      gt_bittab_set_bit(negate, i);
-    i++;
-    gt_str_array_add_cstr(filter_files, filter_file);
-    g_free(filter_file);
-    while (gtk_tree_model_iter_next(model, &iter)) {
-      gtk_tree_model_get(model, &iter,
-                         LTR_FILTER_LV_FILE, &filter_file,
-                         LTR_FILTER_LV_SEL_NOT, &negate_filter, -1);
-      if (negate_filter)
-        gt_bittab_set_bit(negate, i);
-      i++;
-      gt_str_array_add_cstr(filter_files, filter_file);
-      g_free(filter_file);
-    }
   }
-  if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(ltrfilt->filter_logic)))
-    logic = LTR_FILTER_LOGIC_AND;
-  else
-    logic = LTR_FILTER_LOGIC_OR;
-
-  switch (ltrfilt->range) {
-    case LTR_FILTER_RANGE_PROJECT:
-      nodes = gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
-      total_candidates = gt_array_size(nodes);
-      break;
-    case LTR_FILTER_RANGE_FAMILIES:
-      nodes = gt_array_new(sizeof (GtGenomeNode*));
-      list_view = gtk_ltr_families_get_list_view_families(
-                                            GTK_LTR_FAMILIES(ltrfilt->ltrfams));
-      model = gtk_tree_view_get_model(GTK_TREE_VIEW(list_view));
-      sel = gtk_tree_view_get_selection(list_view);
-      rows = gtk_tree_selection_get_selected_rows(sel, &model);
-      tmp = rows;
-      while (tmp != NULL) {
-        gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-        gtk_tree_model_get(model, &iter,
-                           LTRFAMS_FAM_LV_NODE_ARRAY, &tmp_nodes, -1);
-        gt_array_add_array(nodes, tmp_nodes);
-        tmp = tmp->next;
-      }
-      gt_genome_nodes_sort_stable(nodes);
-      total_candidates = gt_array_size(nodes);
-      g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
-      g_list_free(rows);
-      break;
-    case LTR_FILTER_RANGE_CANDIDATES:
-      nodes = gt_array_new(sizeof (GtGenomeNode*));
-      notebook =
-              gtk_ltr_families_get_notebook(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
-      tab_no = gtk_notebook_get_current_page(notebook);
-      tab_child = gtk_notebook_get_nth_page(notebook, tab_no);
-      children = gtk_container_get_children(GTK_CONTAINER(tab_child));
-      list_view = GTK_TREE_VIEW(g_list_first(children)->data);
-      model = gtk_tree_view_get_model(list_view);
-      sel = gtk_tree_view_get_selection(list_view);
-      rows = gtk_tree_selection_get_selected_rows(sel, &model);
-      tmp = rows;
-      while (tmp != NULL) {
-        gtk_tree_model_get_iter(model, &iter, (GtkTreePath*) tmp->data);
-        gtk_tree_model_get(model, &iter,
-                           LTRFAMS_FAM_LV_NODE_ARRAY, &gn, -1);
-        gt_array_add(nodes, gn);
-        tmp = tmp->next;
-      }
-      total_candidates = gt_array_size(nodes);
-      gt_genome_nodes_sort_stable(nodes);
-      g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
-      g_list_free(rows);
-      break;
-    default:
-      break;
+  if (!(filter_files = gtk_ltr_filter_get_filter_files(ltrfilt, &negate))) {
+    perf_log_delete(perf);
+    return;
   }
+  gtk_widget_hide(GTK_WIDGET(ltrfilt));
+  filtered_nodes = gt_array_new(sizeof (GtGenomeNode*));
+  logic = gtk_ltr_filter_get_logic(ltrfilt);
+  if ((nodes = gtk_ltr_filter_get_range_nodes(ltrfilt)))
+    total_candidates = gt_array_size(nodes);
   if (!nodes)
     had_err = -1;
   if (!had_err) {
+    perf_log_stage(perf, PERF_STAGE_FILTER);
+    perf_log_add_items(perf, gt_array_size(nodes));
+    /* filters may look at the family names of the candidates */
+    gtk_ltr_families_sync_family_names(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
     array_in_stream = gt_array_in_stream_new(nodes, NULL, err);
   }
   if (!array_in_stream)
@@ -664,6 +820,8 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
   gt_node_stream_delete(script_filter_stream);
   gt_node_stream_delete(array_in_stream);
   gt_node_stream_delete(array_out_stream);
+  gt_str_array_delete(filter_files);
+  gt_bittab_delete(negate);
   if ((ltrfilt->range == LTR_FILTER_RANGE_FAMILIES) ||
       (ltrfilt->range == LTR_FILTER_RANGE_CANDIDATES)) {
     gt_array_delete(nodes);
@@ -672,9 +830,13 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
   if (!had_err) {
     action = gtk_combo_box_get_active(GTK_COMBO_BOX(ltrfilt->filter_action));
     if (gt_array_size(filtered_nodes) == 0) {
+      gtk_ltr_families_log_perf(GTK_LTR_FAMILIES(ltrfilt->ltrfams), perf,
+                                FALSE);
       gt_array_delete(filtered_nodes);
       return;
     }
+    perf_log_stage(perf, PERF_STAGE_ACTION);
+    perf_log_add_items(perf, gt_array_size(filtered_nodes));
     switch (action) {
       case LTR_FILTER_ACTION_DELETE:
         for (i = 0; i < gt_array_size(filtered_nodes); i++) {
@@ -706,6 +868,7 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
             attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN);
             if (attr)
               gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
+            filter_cache_node_changed(gn);
             gtk_ltr_families_notebook_list_view_append_gn(
                                              GTK_LTR_FAMILIES(ltrfilt->ltrfams),
                                                  list_view, gn, NULL, NULL,
@@ -715,10 +878,9 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
                                              GTK_LTR_FAMILIES(ltrfilt->ltrfams),
                                                        1);
           } else if (!cdata->fam_ref && cdata->cand_ref) {
-            nodes =
-                 gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrfilt->ltrfams));
             remove_row(cdata->cand_ref);
-            remove_node_from_array(nodes, gn);
+            gtk_ltr_families_remove_candidate(
+                                        GTK_LTR_FAMILIES(ltrfilt->ltrfams), gn);
             deleted_candidates++;
             gtk_ltr_families_update_unclassified_cands(
                                              GTK_LTR_FAMILIES(ltrfilt->ltrfams),
@@ -726,6 +888,8 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
 
           }
         }
+        /* the time the result is shown is not part of the job */
+        perf_log_finish(perf, FALSE);
         g_snprintf(filter_message, BUFSIZ, LTR_FILTER_DIALOG,
                    gt_array_size(filtered_nodes), total_candidates,
                    unclassified_candidates, deleted_candidates);
@@ -767,6 +931,7 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
           attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN);
           if (attr)
             gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
+          filter_cache_node_changed(gn);
           gt_feature_node_iterator_delete(fni);
         }
         gtk_ltr_families_notebook_list_view_append_array(
@@ -776,10 +941,46 @@ static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
       default:
         break;
     }
+    gtk_ltr_families_set_modified(GTK_LTR_FAMILIES(ltrfilt->ltrfams), TRUE);
   }
+  gtk_ltr_families_log_perf(GTK_LTR_FAMILIES(ltrfilt->ltrfams), perf,
+                            had_err != 0);
   gt_array_delete(filtered_nodes);
 }
 
+static void apply_clicked(GT_UNUSED GtkButton *button, GtkLTRFilter *ltrfilt)
+{
+  GtkLTRFamilies *ltrfams = GTK_LTR_FAMILIES(ltrfilt->ltrfams);
+
+  /* dialogs shown while filtering run the main loop */
+  gtk_ltr_families_hold_candidates(ltrfams);
+  gtk_ltr_filter_apply(ltrfilt);
+  gtk_ltr_families_release_candidates(ltrfams);
+}
+
+static void gtk_ltr_filter_show(GtkWidget *widget,
+                                GT_UNUSED gpointer user_data)
+{
+  /* the filter files may have been edited elsewhere in the meantime */
+  gtk_ltr_filter_update_keys(GTK_LTR_FILTER(widget));
+  gtk_ltr_filter_update_preview(GTK_LTR_FILTER(widget));
+}
+
+static void gtk_ltr_filter_hide(GtkWidget *widget,
+                                GT_UNUSED gpointer user_data)
+{
+  GtkLTRFilter *ltrfilt = GTK_LTR_FILTER(widget);
+  /* the window is hidden again when it is destroyed */
+  if (ltrfilt->preview)
+    gtk_ltr_filter_stop_preview(ltrfilt);
+}
+
+static void filter_logic_toggled(GT_UNUSED GtkToggleButton *button,
+                                 GtkLTRFilter *ltrfilt)
+{
+  gtk_ltr_filter_update_preview(ltrfilt);
+}
+
 static void cancel_clicked(GT_UNUSED GtkButton *button, gpointer user_data)
 {
   gtk_widget_hide(GTK_WIDGET(user_data));
@@ -949,6 +1150,7 @@ static void back_clicked(GT_UNUSED GtkWidget *button,
   g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
   g_list_free(references);
   g_list_free(rows);
+  gtk_ltr_filter_update_preview(ltrfilt);
 }
 
 static void forward_clicked(GT_UNUSED GtkWidget *button, GtkLTRFilter *ltrfilt)
@@ -957,12 +1159,14 @@ static void forward_clicked(GT_UNUSED GtkWidget *button, GtkLTRFilter *ltrfilt)
   GtkTreeSelection *sel;
   GtkTreeIter iter_all, iter_sel;
   GtkTreePath *path;
+  GtError *err;
   GList *rows, *tmp;
   gchar *file;
 
   sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(ltrfilt->list_view_all));
   if (gtk_tree_selection_count_selected_rows(sel) < 1)
     return;
+  err = gt_error_new();
   model_all = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfilt->list_view_all));
   model_sel = gtk_tree_view_get_model(GTK_TREE_VIEW(ltrfilt->list_view_sel));
   rows = gtk_tree_selection_get_selected_rows(sel, &model_all);
@@ -975,12 +1179,16 @@ static void forward_clicked(GT_UNUSED GtkWidget *button, GtkLTRFilter *ltrfilt)
     gtk_list_store_set(GTK_LIST_STORE(model_sel), &iter_sel,
                        LTR_FILTER_LV_FILE, file,
                        LTR_FILTER_LV_SEL_NOT, FALSE,
+                       LTR_FILTER_LV_SEL_KEY, filter_cache_key(file, err),
                        -1);
+    gt_error_unset(err);
     tmp = tmp->next;
   }
   g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
   g_list_free(rows);
   g_free(file);
+  gt_error_delete(err);
+  gtk_ltr_filter_update_preview(ltrfilt);
 }
 
 static void remove_clicked(GT_UNUSED GtkWidget *button, GtkLTRFilter *ltrfilt)
@@ -1060,6 +1268,8 @@ list_view_selected_filter_not_toggled(GT_UNUSED GtkCellRendererToggle *rend,
     gtk_tree_model_get(model, &iter, LTR_FILTER_LV_SEL_NOT, &value, -1);
     gtk_list_store_set(GTK_LIST_STORE(model), &iter,
                        LTR_FILTER_LV_SEL_NOT, !value, -1);
+    gtk_ltr_filter_update_preview(
+                GTK_LTR_FILTER(gtk_widget_get_toplevel(GTK_WIDGET(treeview))));
   }
 }
 
@@ -1087,6 +1297,32 @@ static void list_view_cell_data_func(GT_UNUSED GtkTreeViewColumn *tree_column,
   gt_error_delete(err);
 }
 
+/* shows the statistics collected while running the filter, which decide the
+   order the filters are run in */
+static void list_view_stats_data_func(GT_UNUSED GtkTreeViewColumn *tree_column,
+                                      GtkCellRenderer *renderer,
+                                      GtkTreeModel *model,
+                                      GtkTreeIter *iter,
+                                      GT_UNUSED gpointer data)
+{
+  FilterStats stats;
+  const gchar *key;
+  gchar text[BUFSIZ];
+
+  gtk_tree_model_get(model, iter, LTR_FILTER_LV_SEL_KEY, &key, -1);
+
+  stats.runs = 0;
+  if (key)
+    filter_stats_get(key, &stats);
+  if (stats.runs == 0)
+    g_snprintf(text, BUFSIZ, "%s", LTR_FILTER_NO_STATS);
+  else
+    g_snprintf(text, BUFSIZ, LTR_FILTER_STATS,
+               stats.seconds * 1000000.0 / stats.runs,
+               100.0 * stats.passes / stats.runs, stats.runs);
+  g_object_set(renderer, "markup", text, NULL);
+}
+
 static void gtk_ltr_filter_init(GtkLTRFilter *ltrfilt)
 {
   GtkWidget *cancel,
@@ -1203,12 +1439,20 @@ static void gtk_ltr_filter_init(GtkLTRFilter *ltrfilt)
                                                     LTR_FILTER_LV_SEL_NOT,
                                                     NULL);
   gtk_tree_view_append_column(GTK_TREE_VIEW(ltrfilt->list_view_sel), column);
+  renderer = gtk_cell_renderer_text_new();
+  column = gtk_tree_view_column_new_with_attributes("Statistics", renderer,
+                                                    NULL);
+  gtk_tree_view_append_column(GTK_TREE_VIEW(ltrfilt->list_view_sel), column);
+  gtk_tree_view_column_set_cell_data_func(column, renderer,
+                                          list_view_stats_data_func, NULL,
+                                          NULL);
   column = gtk_tree_view_column_new();
   gtk_tree_view_append_column(GTK_TREE_VIEW(ltrfilt->list_view_sel), column);
 
   types = g_new0(GType, LTR_FILTER_LV_SEL_N_COLUMNS);
   types[0] = G_TYPE_STRING;
   types[1] = G_TYPE_BOOLEAN;
+  types[2] = G_TYPE_POINTER;
   store = gtk_list_store_newv(LTR_FILTER_LV_SEL_N_COLUMNS, types);
   gtk_tree_view_set_model(GTK_TREE_VIEW(ltrfilt->list_view_sel),
                           GTK_TREE_MODEL(store));
@@ -1228,6 +1472,8 @@ static void gtk_ltr_filter_init(GtkLTRFilter *ltrfilt)
                                         GTK_RADIO_BUTTON(ltrfilt->filter_logic),
                                                       LTR_FILTER_OR);
   gtk_box_pack_start(GTK_BOX(vbox2), radio, FALSE, FALSE, 1);
+  g_signal_connect(G_OBJECT(ltrfilt->filter_logic), "toggled",
+                   G_CALLBACK(filter_logic_toggled), ltrfilt);
 
   hbox = gtk_hbox_new(FALSE, 1);
   label =
@@ -1289,8 +1535,11 @@ static void gtk_ltr_filter_init(GtkLTRFilter *ltrfilt)
   cancel = gtk_button_new_with_mnemonic("_Cancel");
   g_signal_connect(G_OBJECT(cancel), "clicked", G_CALLBACK(cancel_clicked),
                    ltrfilt);
+  ltrfilt->label_preview = gtk_label_new(LTR_FILTER_PREVIEW_NONE);
+  gtk_misc_set_alignment(GTK_MISC(ltrfilt->label_preview), 0.0, 0.5);
   gtk_box_pack_start(GTK_BOX(hbox), ltrfilt->apply, FALSE, FALSE, 1);
   gtk_box_pack_start(GTK_BOX(hbox), cancel, FALSE, FALSE, 1);
+  gtk_box_pack_start(GTK_BOX(hbox), ltrfilt->label_preview, TRUE, TRUE, 5);
   gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, FALSE, 1);
 
   gtk_widget_show_all(vbox);
@@ -1300,6 +1549,9 @@ static void gtk_ltr_filter_init(GtkLTRFilter *ltrfilt)
   g_signal_connect(G_OBJECT(ltrfilt->list_view_all), "cursor-changed",
                    G_CALLBACK(list_view_all_filter_changed), ltrfilt);
   gtk_window_resize(GTK_WINDOW(ltrfilt), 800, 600);
+  ltrfilt->preview = filter_preview_new(gtk_ltr_filter_preview_ready, ltrfilt);
+  ltrfilt->preview_held = FALSE;
+  ltrfilt->preview_unloaded = 0;
 
   pango_attr_list_unref(pattrl);
 }
@@ -1312,6 +1564,10 @@ static gboolean gtk_ltr_filter_destroy(GtkWidget *widget,
   ltrfilt = GTK_LTR_FILTER(widget);
   if (ltrfilt->last_dir)
     g_free(ltrfilt->last_dir);
+  filter_preview_delete(ltrfilt->preview);
+  ltrfilt->preview = NULL;
+  /* the families holding the candidates may already be gone */
+  ltrfilt->preview_held = FALSE;
 
   return FALSE;
 }
@@ -1351,6 +1607,10 @@ GtkWidget* gtk_ltr_filter_new(GtkWidget *ltrfams)
                    G_CALLBACK(delete_event), NULL);
   g_signal_connect(G_OBJECT(ltrfilt), "destroy",
                    G_CALLBACK(gtk_ltr_filter_destroy), NULL);
+  g_signal_connect(G_OBJECT(ltrfilt), "show",
+                   G_CALLBACK(gtk_ltr_filter_show), NULL);
+  g_signal_connect(G_OBJECT(ltrfilt), "hide",
+                   G_CALLBACK(gtk_ltr_filter_hide), NULL);
   gtk_window_set_position(GTK_WINDOW(ltrfilt), GTK_WIN_POS_CENTER);
   gtk_window_set_modal(GTK_WINDOW(ltrfilt), TRUE);
   g_snprintf(title, BUFSIZ, LTRFILT_WINDOW_TITLE, GUI_NAME);
@@ -22,6 +22,7 @@
 #include <glib.h>
 #include <glib-object.h>
 #include <gtk/gtk.h>
+#include "filter_preview.h"
 #include "genometools.h"
 
 #define GTK_LTR_FILTER_TYPE\
@@ -44,6 +45,7 @@ struct _GtkLTRFilter
   GtkWidget *label_descr;
   GtkWidget *label_author;
   GtkWidget *label_email;
+  GtkWidget *label_preview;
   GtkWidget *list_view_all;
   GtkWidget *list_view_sel;
   GtkWidget *edit_dialog;
@@ -53,9 +55,12 @@ struct _GtkLTRFilter
   GtkWidget *ltrfams;
   GtkTextBuffer *text_buffer;
   GtScriptFilter *script_filter;
+  FilterPreview *preview;
   gchar *last_dir;
   gchar *cur_filename;
   gint range;
+  gboolean preview_held;
+  unsigned long preview_unloaded;
 };
 
 struct _GtkLTRFilterClass
@@ -83,6 +88,7 @@ enum {
 enum {
   LTR_FILTER_LV_FILE = 0,
   LTR_FILTER_LV_SEL_NOT,
+  LTR_FILTER_LV_SEL_KEY,
   LTR_FILTER_LV_SEL_N_COLUMNS
 };
 
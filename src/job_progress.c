@@ -0,0 +1,239 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "genometools.h"
+#include "job_progress.h"
+
+/* the ETA is only guessed once this share of the job is done */
+#define JOB_PROGRESS_MIN_FRACTION 0.01
+
+typedef struct {
+  gchar *name;
+  gdouble weight,
+          started;
+  JobProgressUnit unit;
+  const unsigned long *counter;
+  unsigned long divisor,
+                done;
+} JobProgressStage;
+
+struct JobProgress {
+  GMutex *mutex;
+  GTimer *timer;
+  GtArray *stages;
+  gint current;
+  gboolean finished;
+  unsigned long items;
+};
+
+JobProgress* job_progress_new(void)
+{
+  JobProgress *jp = g_slice_new(JobProgress);
+
+  jp->mutex = g_mutex_new();
+  jp->timer = g_timer_new();
+  jp->stages = gt_array_new(sizeof (JobProgressStage));
+  jp->current = -1;
+  jp->finished = FALSE;
+  jp->items = 0;
+  return jp;
+}
+
+guint job_progress_add_stage(JobProgress *jp, const gchar *name,
+                             gdouble weight, JobProgressUnit unit)
+{
+  JobProgressStage stage;
+  guint stage_no;
+
+  gt_assert(jp && name);
+  stage.name = g_strdup(name);
+  stage.weight = weight;
+  stage.started = 0.0;
+  stage.unit = unit;
+  stage.counter = NULL;
+  stage.divisor = 1;
+  stage.done = 0;
+  g_mutex_lock(jp->mutex);
+  gt_array_add(jp->stages, stage);
+  stage_no = gt_array_size(jp->stages) - 1;
+  g_mutex_unlock(jp->mutex);
+  return stage_no;
+}
+
+static JobProgressStage* job_progress_stage(JobProgress *jp, guint stage)
+{
+  gt_assert(stage < gt_array_size(jp->stages));
+  return (JobProgressStage*) gt_array_get(jp->stages, stage);
+}
+
+void job_progress_watch_counter(JobProgress *jp, guint stage,
+                                const unsigned long *counter,
+                                unsigned long divisor)
+{
+  JobProgressStage *s;
+
+  gt_assert(jp && counter && divisor > 0);
+  g_mutex_lock(jp->mutex);
+  s = job_progress_stage(jp, stage);
+  s->counter = counter;
+  s->divisor = divisor;
+  g_mutex_unlock(jp->mutex);
+}
+
+void job_progress_set_items(JobProgress *jp, unsigned long items)
+{
+  gt_assert(jp);
+  g_mutex_lock(jp->mutex);
+  jp->items = items;
+  g_mutex_unlock(jp->mutex);
+}
+
+/* has to be called with the mutex held */
+static void job_progress_poll(JobProgress *jp)
+{
+  JobProgressStage *s;
+
+  if (jp->finished || jp->current < 0 ||
+      jp->current >= (gint) gt_array_size(jp->stages))
+    return;
+  s = job_progress_stage(jp, (guint) jp->current);
+  if (s->counter)
+    s->done = *s->counter / s->divisor;
+}
+
+static void job_progress_start(JobProgress *jp, gint stage)
+{
+  JobProgressStage *s;
+
+  if (jp->finished || stage <= jp->current)
+    return;
+  job_progress_poll(jp);
+  jp->current = MIN(stage, (gint) gt_array_size(jp->stages));
+  if (jp->current < (gint) gt_array_size(jp->stages)) {
+    s = job_progress_stage(jp, (guint) jp->current);
+    s->started = g_timer_elapsed(jp->timer, NULL);
+  }
+}
+
+void job_progress_start_stage(JobProgress *jp, guint stage)
+{
+  gt_assert(jp);
+  g_mutex_lock(jp->mutex);
+  job_progress_start(jp, (gint) stage);
+  g_mutex_unlock(jp->mutex);
+}
+
+void job_progress_next_stage(JobProgress *jp)
+{
+  gt_assert(jp);
+  g_mutex_lock(jp->mutex);
+  job_progress_start(jp, jp->current + 1);
+  g_mutex_unlock(jp->mutex);
+}
+
+void job_progress_add(JobProgress *jp, guint stage, unsigned long done)
+{
+  gt_assert(jp);
+  g_mutex_lock(jp->mutex);
+  if (!jp->finished && (gint) stage == jp->current)
+    job_progress_stage(jp, stage)->done += done;
+  g_mutex_unlock(jp->mutex);
+}
+
+void job_progress_finish(JobProgress *jp)
+{
+  gt_assert(jp);
+  g_mutex_lock(jp->mutex);
+  job_progress_poll(jp);
+  jp->current = (gint) gt_array_size(jp->stages);
+  jp->finished = TRUE;
+  g_timer_stop(jp->timer);
+  g_mutex_unlock(jp->mutex);
+}
+
+void job_progress_get(JobProgress *jp, JobProgressInfo *info)
+{
+  JobProgressStage *s = NULL;
+  gdouble elapsed,
+          weights = 0.0,
+          done_weights = 0.0,
+          stage_fraction = 0.0;
+  guint i;
+
+  gt_assert(jp && info);
+  g_mutex_lock(jp->mutex);
+  job_progress_poll(jp);
+  elapsed = g_timer_elapsed(jp->timer, NULL);
+  for (i = 0; i < gt_array_size(jp->stages); i++) {
+    weights += job_progress_stage(jp, i)->weight;
+    if ((gint) i < jp->current)
+      done_weights += job_progress_stage(jp, i)->weight;
+  }
+  info->num_stages = gt_array_size(jp->stages);
+  info->stage_no = (guint) MAX(jp->current, 0);
+  info->stage = NULL;
+  info->done = info->total = 0;
+  info->indeterminate = FALSE;
+  info->throughput = 0.0;
+  if (jp->current >= 0 && jp->current < (gint) gt_array_size(jp->stages)) {
+    s = job_progress_stage(jp, (guint) jp->current);
+    info->stage = s->name;
+    /* a stage without progress only counts as done once it has ended */
+    info->indeterminate = (s->unit == JOB_PROGRESS_NONE);
+    if (!info->indeterminate) {
+      info->done = s->done;
+      info->total = jp->items;
+      if (elapsed > s->started)
+        info->throughput = s->done / (elapsed - s->started);
+      if (info->total > 0)
+        stage_fraction = MIN((gdouble) s->done / info->total, 1.0);
+    }
+    done_weights += s->weight * stage_fraction;
+  }
+  info->fraction = (weights > 0.0 ? done_weights / weights : 0.0);
+  if (jp->finished)
+    info->fraction = 1.0;
+  if (info->indeterminate)
+    info->eta = -1.0;
+  else if (info->fraction >= JOB_PROGRESS_MIN_FRACTION)
+    info->eta = elapsed * (1.0 - info->fraction) / info->fraction;
+  else
+    info->eta = -1.0;
+  g_mutex_unlock(jp->mutex);
+}
+
+gchar* job_progress_format_eta(gdouble seconds)
+{
+  unsigned long secs = (unsigned long) (seconds + 0.5);
+
+  return g_strdup_printf("%lu:%02lu:%02lu", secs / 3600, (secs / 60) % 60,
+                         secs % 60);
+}
+
+void job_progress_delete(JobProgress *jp)
+{
+  guint i;
+
+  if (!jp)
+    return;
+  for (i = 0; i < gt_array_size(jp->stages); i++)
+    g_free(job_progress_stage(jp, i)->name);
+  gt_array_delete(jp->stages);
+  g_timer_destroy(jp->timer);
+  g_mutex_free(jp->mutex);
+  g_slice_free(JobProgress, jp);
+}
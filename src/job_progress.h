@@ -0,0 +1,87 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOB_PROGRESS_H
+#define JOB_PROGRESS_H
+
+#include <glib.h>
+
+/* <JobProgress> describes the progress of a job running through several
+   stages, one after another. Every stage counts the items done out of the
+   number known for the job, the overall fraction is weighted by the expected
+   share of each stage in the run time. All functions can be called from any
+   thread. */
+typedef struct JobProgress JobProgress;
+
+typedef enum {
+  JOB_PROGRESS_ITEMS, /* a stage handling every item of the job once */
+  JOB_PROGRESS_NONE   /* a stage which does not report its progress */
+} JobProgressUnit;
+
+/* A consistent snapshot of a <JobProgress>. */
+typedef struct {
+  const gchar *stage;
+  guint stage_no,
+        num_stages;
+  unsigned long done,
+                total;      /* 0 if not known yet */
+  gboolean indeterminate;   /* the stage does not report its progress */
+  gdouble fraction,         /* of the whole job */
+          throughput,       /* items or steps per second in the stage */
+          eta;              /* seconds left, negative if not known yet */
+} JobProgressInfo;
+
+JobProgress*  job_progress_new(void);
+
+/* Appends a stage named <name> taking roughly <weight> parts of the run time
+   and returns its number. */
+guint         job_progress_add_stage(JobProgress *jp, const gchar *name,
+                                     gdouble weight, JobProgressUnit unit);
+
+/* Takes the number of items done in <stage> from <counter> divided by
+   <divisor>, for code which only reports its progress that way. <counter>
+   must not be changed after job_progress_finish() has been called. */
+void          job_progress_watch_counter(JobProgress *jp, guint stage,
+                                         const unsigned long *counter,
+                                         unsigned long divisor);
+
+/* Sets the number of items of the job, once they are known or after a stage
+   removed some of them. */
+void          job_progress_set_items(JobProgress *jp, unsigned long items);
+
+/* Ends the current stage and starts <stage>. Nothing is done if <stage> or
+   a later stage is already running. */
+void          job_progress_start_stage(JobProgress *jp, guint stage);
+
+void          job_progress_next_stage(JobProgress *jp);
+
+/* Adds <done> to the progress of <stage>, nothing is done if <stage> is not
+   running. */
+void          job_progress_add(JobProgress *jp, guint stage,
+                               unsigned long done);
+
+/* Ends the job, the watched counters are not read anymore. */
+void          job_progress_finish(JobProgress *jp);
+
+void          job_progress_get(JobProgress *jp, JobProgressInfo *info);
+
+/* Formats <seconds> as "h:mm:ss", the result has to be freed. */
+gchar*        job_progress_format_eta(gdouble seconds);
+
+void          job_progress_delete(JobProgress *jp);
+
+#endif
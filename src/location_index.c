@@ -0,0 +1,384 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "location_index.h"
+#include "symbols.h"
+
+/* the intervals of a sequence are kept in a treap ordered by start, end and
+   value, every node knows the largest end position in its subtree so that
+   subtrees without overlapping intervals can be skipped */
+typedef struct LocationIndexNode LocationIndexNode;
+
+struct LocationIndexNode {
+  LocationIndexNode *left,
+                    *right;
+  unsigned long start,
+                end,
+                max_end;
+  gpointer value;
+  guint32 priority;
+};
+
+typedef struct {
+  LocationIndexNode *root;
+} LocationIndexTree;
+
+struct LocationIndex {
+  GtHashmap *trees,
+            *ids;
+  unsigned long size,
+                num_ids;
+};
+
+static gint location_index_node_cmp(LocationIndexNode *node,
+                                    unsigned long start, unsigned long end,
+                                    gpointer value)
+{
+  if (start != node->start)
+    return start < node->start ? -1 : 1;
+  if (end != node->end)
+    return end < node->end ? -1 : 1;
+  if (value != node->value)
+    return value < node->value ? -1 : 1;
+  return 0;
+}
+
+static void location_index_node_update(LocationIndexNode *node)
+{
+  node->max_end = node->end;
+  if (node->left && node->left->max_end > node->max_end)
+    node->max_end = node->left->max_end;
+  if (node->right && node->right->max_end > node->max_end)
+    node->max_end = node->right->max_end;
+}
+
+static LocationIndexNode* location_index_rotate_right(LocationIndexNode *node)
+{
+  LocationIndexNode *left = node->left;
+
+  node->left = left->right;
+  left->right = node;
+  location_index_node_update(node);
+  location_index_node_update(left);
+  return left;
+}
+
+static LocationIndexNode* location_index_rotate_left(LocationIndexNode *node)
+{
+  LocationIndexNode *right = node->right;
+
+  node->right = right->left;
+  right->left = node;
+  location_index_node_update(node);
+  location_index_node_update(right);
+  return right;
+}
+
+static LocationIndexNode* location_index_tree_insert(LocationIndexNode *node,
+                                                     unsigned long start,
+                                                     unsigned long end,
+                                                     gpointer value,
+                                                     gboolean *added)
+{
+  gint cmp;
+
+  if (!node) {
+    node = g_slice_new(LocationIndexNode);
+    node->left = node->right = NULL;
+    node->start = start;
+    node->end = node->max_end = end;
+    node->value = value;
+    node->priority = g_random_int();
+    *added = TRUE;
+    return node;
+  }
+  cmp = location_index_node_cmp(node, start, end, value);
+  if (cmp == 0)
+    return node;
+  if (cmp < 0) {
+    node->left = location_index_tree_insert(node->left, start, end, value,
+                                            added);
+    if (node->left->priority > node->priority)
+      node = location_index_rotate_right(node);
+  } else {
+    node->right = location_index_tree_insert(node->right, start, end, value,
+                                             added);
+    if (node->right->priority > node->priority)
+      node = location_index_rotate_left(node);
+  }
+  location_index_node_update(node);
+  return node;
+}
+
+/* removes <node> by rotating it down until one of its subtrees is empty */
+static LocationIndexNode* location_index_tree_unlink(LocationIndexNode *node)
+{
+  LocationIndexNode *child;
+
+  if (!node->left || !node->right) {
+    child = node->left ? node->left : node->right;
+    g_slice_free(LocationIndexNode, node);
+    return child;
+  }
+  if (node->left->priority > node->right->priority) {
+    node = location_index_rotate_right(node);
+    node->right = location_index_tree_unlink(node->right);
+  } else {
+    node = location_index_rotate_left(node);
+    node->left = location_index_tree_unlink(node->left);
+  }
+  location_index_node_update(node);
+  return node;
+}
+
+static LocationIndexNode* location_index_tree_remove(LocationIndexNode *node,
+                                                     unsigned long start,
+                                                     unsigned long end,
+                                                     gpointer value,
+                                                     gboolean *removed)
+{
+  gint cmp;
+
+  if (!node)
+    return NULL;
+  cmp = location_index_node_cmp(node, start, end, value);
+  if (cmp < 0)
+    node->left = location_index_tree_remove(node->left, start, end, value,
+                                            removed);
+  else if (cmp > 0)
+    node->right = location_index_tree_remove(node->right, start, end, value,
+                                             removed);
+  else {
+    *removed = TRUE;
+    return location_index_tree_unlink(node);
+  }
+  location_index_node_update(node);
+  return node;
+}
+
+/* visits the subtrees in order, left subtrees are skipped if none of their
+   intervals reaches <start>, right subtrees if their intervals begin after
+   <end> */
+static void location_index_tree_find(LocationIndexNode *node,
+                                     unsigned long start, unsigned long end,
+                                     GtArray *values)
+{
+  if (!node || node->max_end < start)
+    return;
+  location_index_tree_find(node->left, start, end, values);
+  if (node->start > end)
+    return;
+  if (node->end >= start)
+    gt_array_add(values, node->value);
+  location_index_tree_find(node->right, start, end, values);
+}
+
+static void location_index_tree_free(LocationIndexNode *node)
+{
+  if (!node)
+    return;
+  location_index_tree_free(node->left);
+  location_index_tree_free(node->right);
+  g_slice_free(LocationIndexNode, node);
+}
+
+static void location_index_free_tree(void *elem)
+{
+  LocationIndexTree *tree = (LocationIndexTree*) elem;
+
+  location_index_tree_free(tree->root);
+  g_slice_free(LocationIndexTree, tree);
+}
+
+static void location_index_free_values(void *elem)
+{
+  gt_array_delete((GtArray*) elem);
+}
+
+LocationIndex* location_index_new(void)
+{
+  LocationIndex *li = g_slice_new(LocationIndex);
+
+  /* seqids are interned, so they are compared as pointers */
+  li->trees = gt_hashmap_new(GT_HASH_DIRECT, NULL, location_index_free_tree);
+  li->ids = gt_hashmap_new(GT_HASH_STRING, g_free,
+                           location_index_free_values);
+  li->size = li->num_ids = 0;
+  return li;
+}
+
+void location_index_add(LocationIndex *li, const gchar *seqid,
+                        unsigned long start, unsigned long end,
+                        const gchar *id, gpointer value)
+{
+  LocationIndexTree *tree;
+  GtArray *values;
+  gboolean added = FALSE;
+
+  gt_assert(li && seqid && start <= end);
+  seqid = symbols_intern(seqid);
+  if (!(tree = (LocationIndexTree*) gt_hashmap_get(li->trees, seqid))) {
+    tree = g_slice_new(LocationIndexTree);
+    tree->root = NULL;
+    gt_hashmap_add(li->trees, (gpointer) seqid, tree);
+  }
+  tree->root = location_index_tree_insert(tree->root, start, end, value,
+                                          &added);
+  if (!added)
+    return;
+  li->size++;
+  if (!id)
+    return;
+  if (!(values = (GtArray*) gt_hashmap_get(li->ids, id))) {
+    values = gt_array_new(sizeof (gpointer));
+    gt_hashmap_add(li->ids, g_strdup(id), values);
+  }
+  gt_array_add(values, value);
+  li->num_ids++;
+}
+
+void location_index_remove(LocationIndex *li, const gchar *seqid,
+                           unsigned long start, unsigned long end,
+                           const gchar *id, gpointer value)
+{
+  LocationIndexTree *tree;
+  GtArray *values;
+  gboolean removed = FALSE;
+  unsigned long i;
+
+  gt_assert(li && seqid);
+  seqid = symbols_intern(seqid);
+  if (!(tree = (LocationIndexTree*) gt_hashmap_get(li->trees, seqid)))
+    return;
+  tree->root = location_index_tree_remove(tree->root, start, end, value,
+                                          &removed);
+  if (!removed)
+    return;
+  li->size--;
+  if (!id || !(values = (GtArray*) gt_hashmap_get(li->ids, id)))
+    return;
+  for (i = 0; i < gt_array_size(values); i++) {
+    if (*(gpointer*) gt_array_get(values, i) != value)
+      continue;
+    gt_array_rem(values, i);
+    li->num_ids--;
+    break;
+  }
+  if (gt_array_size(values) == 0)
+    gt_hashmap_remove(li->ids, id);
+}
+
+void location_index_find_range(LocationIndex *li, const gchar *seqid,
+                               unsigned long start, unsigned long end,
+                               GtArray *values)
+{
+  LocationIndexTree *tree;
+
+  gt_assert(li && seqid && values);
+  seqid = symbols_intern(seqid);
+  if ((tree = (LocationIndexTree*) gt_hashmap_get(li->trees, seqid)))
+    location_index_tree_find(tree->root, start, end, values);
+}
+
+void location_index_find_id(LocationIndex *li, const gchar *id,
+                            GtArray *values)
+{
+  GtArray *found;
+
+  gt_assert(li && id && values);
+  if ((found = (GtArray*) gt_hashmap_get(li->ids, id)))
+    gt_array_add_array(values, found);
+}
+
+unsigned long location_index_size(LocationIndex *li)
+{
+  gt_assert(li);
+  return li->size;
+}
+
+gsize location_index_memory(LocationIndex *li)
+{
+  gt_assert(li);
+  /* the ID arrays are counted with their entries only, the hash tables by
+     a rough per entry overhead */
+  return sizeof (LocationIndex) +
+         li->size * (sizeof (LocationIndexNode) + 4 * sizeof (gpointer)) +
+         li->num_ids * 4 * sizeof (gpointer);
+}
+
+void location_index_delete(LocationIndex *li)
+{
+  if (!li)
+    return;
+  gt_hashmap_delete(li->ids);
+  gt_hashmap_delete(li->trees);
+  g_slice_free(LocationIndex, li);
+}
+
+static gboolean location_index_parse_number(const gchar *str,
+                                            unsigned long *number)
+{
+  gchar *digits,
+        *endptr;
+  gsize i, j;
+  gboolean valid;
+
+  digits = g_strdup(str);
+  for (i = j = 0; digits[i] != '\0'; i++) {
+    if (digits[i] != ',')
+      digits[j++] = digits[i];
+  }
+  digits[j] = '\0';
+  g_strstrip(digits);
+  valid = g_ascii_isdigit(digits[0]);
+  if (valid) {
+    *number = strtoul(digits, &endptr, 10);
+    valid = (*endptr == '\0' && *number > 0);
+  }
+  g_free(digits);
+  return valid;
+}
+
+gboolean location_index_parse(const gchar *location, gchar **seqid,
+                              unsigned long *start, unsigned long *end)
+{
+  gchar **parts,
+        **range;
+  gboolean valid = FALSE;
+
+  gt_assert(location && seqid && start && end);
+  parts = g_strsplit(location, ":", 2);
+  if (parts[0] && parts[1]) {
+    g_strstrip(parts[0]);
+    range = g_strsplit(parts[1], "-", 2);
+    if (*parts[0] != '\0' && range[0] &&
+        location_index_parse_number(range[0], start)) {
+      if (!range[1]) {
+        *end = *start;
+        valid = TRUE;
+      } else
+        valid = location_index_parse_number(range[1], end) && *start <= *end;
+    }
+    g_strfreev(range);
+  }
+  if (valid)
+    *seqid = g_strdup(parts[0]);
+  g_strfreev(parts);
+  return valid;
+}
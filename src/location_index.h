@@ -0,0 +1,72 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOCATION_INDEX_H
+#define LOCATION_INDEX_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <LocationIndex> finds the values (e.g. candidates) stored for intervals
+   on sequences which overlap a given range, and the values stored under a
+   given ID. The intervals of each sequence are kept in an interval tree
+   (a treap ordered by start position whose nodes know the largest end
+   position of their subtree), so adding and removing an interval takes
+   O(log n) time and finding the k intervals overlapping a range
+   O(log n + k) time. */
+typedef struct LocationIndex LocationIndex;
+
+LocationIndex* location_index_new(void);
+
+/* Adds <value> for the interval from <start> to <end> on <seqid> and, if
+   <id> is not NULL, under <id>. */
+void           location_index_add(LocationIndex *li, const gchar *seqid,
+                                  unsigned long start, unsigned long end,
+                                  const gchar *id, gpointer value);
+
+/* Removes <value> added with the same arguments, nothing is done if there
+   is no such value. */
+void           location_index_remove(LocationIndex *li, const gchar *seqid,
+                                     unsigned long start, unsigned long end,
+                                     const gchar *id, gpointer value);
+
+/* Appends the values whose intervals on <seqid> overlap the range from
+   <start> to <end> to <values> (an array of <gpointer>), ordered by start
+   position. */
+void           location_index_find_range(LocationIndex *li,
+                                         const gchar *seqid,
+                                         unsigned long start,
+                                         unsigned long end, GtArray *values);
+
+/* Appends the values stored under <id> to <values>. */
+void           location_index_find_id(LocationIndex *li, const gchar *id,
+                                      GtArray *values);
+
+unsigned long  location_index_size(LocationIndex *li);
+
+/* Returns the number of bytes used by <li>. */
+gsize          location_index_memory(LocationIndex *li);
+
+void           location_index_delete(LocationIndex *li);
+
+/* Parses a location given as ``seqid:start-end'' or ``seqid:position''
+   (digit grouping commas are allowed). On success, <seqid> is set to a
+   newly allocated string and TRUE is returned. */
+gboolean       location_index_parse(const gchar *location, gchar **seqid,
+                                    unsigned long *start, unsigned long *end);
+
+#endif
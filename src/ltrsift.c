@@ -235,6 +235,8 @@ static gboolean main_window_delete_event(GT_UNUSED GtkWidget *widget,
   GtkWidget *dialog;
   gint response = GTK_RESPONSE_REJECT;
 
+  if (!menubar_wait_for_save(ltrgui))
+    return TRUE;
   if (gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams))) {
     if (!gtk_ltr_families_get_projectfile(
                                       GTK_LTR_FAMILIES(ltrgui->ltrfams))) {
@@ -295,6 +297,9 @@ static void init_gui(GUIData *ltrgui)
                                      ltrgui->ltrfilt);
   ltrgui->assistant = NULL;
   ltrgui->refseq_paramsets = NULL;
+  ltrgui->save_in_progress = FALSE;
+  ltrgui->save_wait_dialog = NULL;
+  menubar_autosave_init(ltrgui);
   gtk_widget_show_all(ltrgui->main_window);
   gtk_widget_hide(ltrgui->progressbar);
 }
@@ -55,6 +55,8 @@ struct _GUIData
   GtkWidget *main_window;
   GtkWidget *assistant;
   guint statusbar_context_id;
+  gboolean save_in_progress;
+  GtkWidget *save_wait_dialog;
   gchar *style_file;
   GtError *err;
   GtHashmap *refseq_paramsets;
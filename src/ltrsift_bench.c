@@ -0,0 +1,449 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sys/resource.h>
+#include "bgzf.h"
+#include "dedup_stream.h"
+#include "message_strings.h"
+#include "project_index.h"
+#include "sequence_export.h"
+#include "support.h"
+
+/* Runs the parts of LTRsift which do not need the user interface on the
+   candidates of a GFF3 file (e.g. written by ltrsift_bench_gen) and prints
+   one line in JSON format per benchmark, giving the number of candidates
+   handled, the time taken and the peak resident set size of the process.
+   GTK+ is linked, but never initialized, so no display is needed. */
+
+#define BENCH_PREPROCESS "preprocess"
+#define BENCH_FILTER     "filter"
+#define BENCH_FLCANDS    "flcands"
+#define BENCH_SAVE       "save"
+#define BENCH_LOAD       "load"
+#define BENCH_EXPORT     "export"
+
+/* the synthetic candidates are unclassified, so the full length candidates
+   are determined for groups of this size in file order */
+#define BENCH_FAMILY_SIZE    100
+#define BENCH_LTRTOLERANCE   50.0
+#define BENCH_LENTOLERANCE   500.0
+
+static const gchar *benchmarks[] = {
+  BENCH_PREPROCESS, BENCH_FILTER, BENCH_FLCANDS, BENCH_SAVE, BENCH_LOAD,
+  BENCH_EXPORT, NULL
+};
+
+typedef struct {
+  const gchar *gff3file,
+              *indexname,
+              *filterfile;
+  gchar *projectfile,
+        *savedfile;
+  GtArray *nodes,
+          *regions;
+  GtHashmap *features;
+  unsigned long n_features;
+  GTimer *timer;
+} Bench;
+
+static void bench_report(Bench *bench, const gchar *name, unsigned long items)
+{
+  struct rusage usage;
+  gdouble seconds = g_timer_elapsed(bench->timer, NULL);
+
+  /* ru_maxrss is given in kilobytes on Linux */
+  getrusage(RUSAGE_SELF, &usage);
+  printf("{\"benchmark\": \"%s\", \"input\": \"%s\", \"items\": %lu, "
+         "\"seconds\": %.6f, \"items_per_second\": %.1f, "
+         "\"peak_rss_kb\": %ld, \"threads\": %u}\n", name, bench->gff3file,
+         items, seconds, seconds > 0.0 ? items / seconds : 0.0,
+         usage.ru_maxrss, bgzf_default_threads());
+  fflush(stdout);
+}
+
+static gint bench_preprocess(Bench *bench, GtError *err)
+{
+  GtNodeStream *in_stream,
+               *preprocess_stream,
+               *array_stream = NULL;
+  gint had_err = 0;
+
+  bench->nodes = gt_array_new(sizeof (GtFeatureNode*));
+  bench->features = gt_hashmap_new(GT_HASH_STRING, free_gt_hash_elem, NULL);
+  bench->n_features = LTRFAMS_LV_N_COLUMS+1;
+  in_stream = gt_gff3_in_stream_new_unsorted(1, &bench->gff3file);
+  preprocess_stream = ltrgui_preprocess_stream_new(in_stream, bench->features,
+                                                   &bench->n_features, FALSE,
+                                                   err);
+  if (!preprocess_stream)
+    had_err = -1;
+  if (!had_err) {
+    array_stream = gt_array_out_stream_new(preprocess_stream, bench->nodes,
+                                           err);
+    if (!array_stream)
+      had_err = -1;
+  }
+  if (!had_err)
+    had_err = gt_node_stream_pull(array_stream, err);
+  if (!had_err) {
+    bench->regions = ltrgui_preprocess_stream_get_region_nodes(
+                                   (LTRGuiPreprocessStream*) preprocess_stream);
+    node_array_ensure_sorted(bench->nodes);
+    node_array_ensure_sorted(bench->regions);
+  }
+  gt_node_stream_delete(array_stream);
+  gt_node_stream_delete(preprocess_stream);
+  gt_node_stream_delete(in_stream);
+  return had_err;
+}
+
+static gint bench_filter(Bench *bench, unsigned long *items, GtError *err)
+{
+  GtNodeStream *array_in_stream,
+               *script_filter_stream = NULL,
+               *array_out_stream = NULL;
+  GtArray *filtered_nodes;
+  GtStrArray *filter_files;
+  GtBittab *negate;
+  gint had_err = 0;
+
+  filter_files = gt_str_array_new();
+  gt_str_array_add_cstr(filter_files, bench->filterfile);
+  negate = gt_bittab_new(1);
+  filtered_nodes = gt_array_new(sizeof (GtGenomeNode*));
+  array_in_stream = gt_array_in_stream_new(bench->nodes, NULL, err);
+  if (!array_in_stream)
+    had_err = -1;
+  if (!had_err) {
+    script_filter_stream = ltrgui_script_filter_stream_new(array_in_stream,
+                                                           filter_files,
+                                                           negate,
+                                                           LTR_FILTER_LOGIC_AND,
+                                                           err);
+    if (!script_filter_stream)
+      had_err = -1;
+  }
+  if (!had_err) {
+    array_out_stream = gt_array_out_stream_new(script_filter_stream,
+                                               filtered_nodes, err);
+    if (!array_out_stream)
+      had_err = -1;
+  }
+  if (!had_err)
+    had_err = gt_node_stream_pull(array_out_stream, err);
+  *items = gt_array_size(bench->nodes);
+
+  gt_node_stream_delete(array_out_stream);
+  gt_node_stream_delete(script_filter_stream);
+  gt_node_stream_delete(array_in_stream);
+  gt_array_delete(filtered_nodes);
+  gt_bittab_delete(negate);
+  gt_str_array_delete(filter_files);
+  return had_err;
+}
+
+static gint bench_flcands(Bench *bench)
+{
+  FLCandBatch *batch;
+  GtArray *family;
+  unsigned long i;
+
+  batch = flcand_batch_new(BENCH_LTRTOLERANCE, BENCH_LENTOLERANCE);
+  family = gt_array_new(sizeof (GtGenomeNode*));
+  for (i = 0; i < gt_array_size(bench->nodes); i++) {
+    gt_array_add(family, *(GtGenomeNode**) gt_array_get(bench->nodes, i));
+    if (gt_array_size(family) == BENCH_FAMILY_SIZE ||
+        i + 1 == gt_array_size(bench->nodes)) {
+      flcand_batch_add(batch, family);
+      gt_array_reset(family);
+    }
+  }
+  flcand_batch_run(batch, bgzf_default_threads(), NULL);
+  (void) flcand_batch_apply(batch, NULL, NULL);
+  gt_array_delete(family);
+  flcand_batch_delete(batch);
+  return 0;
+}
+
+/* writes the candidates like saving a project does, including the index
+   stored in the project file */
+static gint bench_save(Bench *bench, GtError *err)
+{
+  ProjectIndexWriter *piw;
+  GtArray *sorted_nodes;
+  GtFile *outfp;
+  GtRDB *rdb = NULL;
+  ProjectIndex *index = NULL;
+  gchar *plainfile;
+  unsigned long i;
+  gint had_err = 0;
+
+  sorted_nodes = merge_sorted_node_arrays(bench->regions, bench->nodes);
+  bench->savedfile = project_gff3_file(bench->projectfile, TRUE);
+  g_unlink(bench->projectfile);
+  if (!(outfp = gff3_output_new(bench->savedfile, &plainfile, err)))
+    had_err = -1;
+  if (!had_err) {
+    piw = project_index_writer_new(outfp);
+    for (i = 0; !had_err && i < gt_array_size(sorted_nodes); i++)
+      had_err = project_index_writer_add_node(piw, *(GtGenomeNode**)
+                                                 gt_array_get(sorted_nodes, i),
+                                              err);
+    if (!had_err)
+      index = project_index_writer_finish(piw);
+    else
+      project_index_writer_delete(piw);
+    had_err = gff3_output_finish(outfp, bench->savedfile, plainfile, TRUE,
+                                 had_err, err);
+    if (had_err)
+      plainfile = NULL;
+  }
+  if (!had_err && !(rdb = gt_rdb_sqlite_new(bench->projectfile, err)))
+    had_err = -1;
+  if (!had_err)
+    had_err = project_index_save(index, rdb, err);
+  if (!had_err)
+    had_err = project_index_save_features(rdb, bench->features, err);
+
+  if (plainfile)
+    g_unlink(plainfile);
+  g_free(plainfile);
+  project_index_delete(index);
+  gt_rdb_delete(rdb);
+  gt_array_delete(sorted_nodes);
+  return had_err;
+}
+
+/* reads the candidates saved by bench_save() like opening a project does */
+static gint bench_load(Bench *bench, unsigned long *items, GtError *err)
+{
+  GtRDB *rdb;
+  GtArray *nodes = NULL,
+          *regions = NULL;
+  GtHashmap *features = NULL;
+  ProjectIndex *index = NULL;
+  gchar *plainfile = NULL;
+  unsigned long i,
+                n_features = LTRFAMS_LV_N_COLUMS+1;
+  gboolean tmpfile;
+  gint had_err = 0;
+
+  if (!(rdb = gt_rdb_sqlite_new(bench->projectfile, err)))
+    had_err = -1;
+  if (!had_err && !(plainfile = gff3_input_new(bench->savedfile, err)))
+    had_err = -1;
+  if (!had_err) {
+    features = gt_hashmap_new(GT_HASH_STRING, free_gt_hash_elem, NULL);
+    index = project_index_new_from_rdb(rdb, plainfile, features, &n_features,
+                                       err);
+    if (!index) {
+      if (!gt_error_is_set(err))
+        gt_error_set(err, "No candidate index found in %s",
+                     bench->projectfile);
+      had_err = -1;
+    }
+  }
+  if (!had_err) {
+    tmpfile = (g_strcmp0(plainfile, bench->savedfile) != 0);
+    had_err = project_index_set_source(index, plainfile, tmpfile, err);
+    if (!had_err && tmpfile) {
+      g_free(plainfile);
+      plainfile = NULL;
+    }
+  }
+  if (!had_err) {
+    nodes = gt_array_new(sizeof (GtFeatureNode*));
+    had_err = project_index_read_family(index, NULL, nodes, &regions, err);
+  }
+  *items = nodes ? gt_array_size(nodes) : 0;
+
+  for (i = 0; nodes && i < gt_array_size(nodes); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(nodes, i));
+  gt_array_delete(nodes);
+  for (i = 0; regions && i < gt_array_size(regions); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(regions, i));
+  gt_array_delete(regions);
+  project_index_delete(index);
+  if (features)
+    gt_hashmap_delete(features);
+  gff3_input_delete(bench->savedfile, plainfile);
+  gt_rdb_delete(rdb);
+  return had_err;
+}
+
+static gint bench_export(Bench *bench, unsigned long *items, GtError *err)
+{
+  GtEncseqLoader *el;
+  GtEncseq *encseq;
+  SequenceExport *se = NULL;
+  GtFile *outfp = NULL;
+  gchar *filename;
+  gint had_err = 0;
+
+  filename = g_strconcat(bench->projectfile, FAS_PATTERN, NULL);
+  el = gt_encseq_loader_new();
+  if (!(encseq = gt_encseq_loader_load(el, bench->indexname, err)))
+    had_err = -1;
+  if (!had_err) {
+    se = sequence_export_new();
+    had_err = sequence_export_add_nodes(se, bench->nodes, encseq, FALSE, err);
+  }
+  if (!had_err && !(outfp = gt_file_new(filename, "w", err)))
+    had_err = -1;
+  if (!had_err)
+    had_err = sequence_export_write(se, encseq, outfp, bgzf_default_threads(),
+                                    err);
+  *items = se ? sequence_export_size(se) : 0;
+
+  gt_file_delete(outfp);
+  g_unlink(filename);
+  g_free(filename);
+  sequence_export_delete(se);
+  gt_encseq_delete(encseq);
+  gt_encseq_loader_delete(el);
+  return had_err;
+}
+
+static gboolean bench_selected(gchar **selected, const gchar *name)
+{
+  /* without a selection all benchmarks are run */
+  if (!*selected)
+    return TRUE;
+  for (; *selected; selected++) {
+    if (g_strcmp0(*selected, name) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+static gint bench_run(Bench *bench, gchar **selected, GtError *err)
+{
+  unsigned long items = 0;
+  gint had_err = 0;
+
+  /* all other benchmarks work on the preprocessed candidates */
+  g_timer_start(bench->timer);
+  had_err = bench_preprocess(bench, err);
+  if (!had_err && bench_selected(selected, BENCH_PREPROCESS))
+    bench_report(bench, BENCH_PREPROCESS, gt_array_size(bench->nodes));
+
+  if (!had_err && bench_selected(selected, BENCH_FILTER)) {
+    g_timer_start(bench->timer);
+    had_err = bench_filter(bench, &items, err);
+    if (!had_err)
+      bench_report(bench, BENCH_FILTER, items);
+  }
+  if (!had_err && bench_selected(selected, BENCH_FLCANDS)) {
+    g_timer_start(bench->timer);
+    had_err = bench_flcands(bench);
+    if (!had_err)
+      bench_report(bench, BENCH_FLCANDS, gt_array_size(bench->nodes));
+  }
+  /* loading needs a saved project */
+  if (!had_err && (bench_selected(selected, BENCH_SAVE) ||
+                   bench_selected(selected, BENCH_LOAD))) {
+    g_timer_start(bench->timer);
+    had_err = bench_save(bench, err);
+    if (!had_err && bench_selected(selected, BENCH_SAVE))
+      bench_report(bench, BENCH_SAVE, gt_array_size(bench->nodes));
+  }
+  if (!had_err && bench_selected(selected, BENCH_LOAD)) {
+    g_timer_start(bench->timer);
+    had_err = bench_load(bench, &items, err);
+    if (!had_err)
+      bench_report(bench, BENCH_LOAD, items);
+  }
+  if (!had_err && bench_selected(selected, BENCH_EXPORT)) {
+    g_timer_start(bench->timer);
+    had_err = bench_export(bench, &items, err);
+    if (!had_err)
+      bench_report(bench, BENCH_EXPORT, items);
+  }
+  return had_err;
+}
+
+static void bench_cleanup(Bench *bench)
+{
+  unsigned long i;
+
+  if (bench->savedfile) {
+    g_unlink(bench->savedfile);
+    g_free(bench->savedfile);
+  }
+  g_unlink(bench->projectfile);
+  g_free(bench->projectfile);
+  for (i = 0; bench->nodes && i < gt_array_size(bench->nodes); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(bench->nodes, i));
+  gt_array_delete(bench->nodes);
+  for (i = 0; bench->regions && i < gt_array_size(bench->regions); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(bench->regions, i));
+  gt_array_delete(bench->regions);
+  if (bench->features)
+    gt_hashmap_delete(bench->features);
+  g_timer_destroy(bench->timer);
+}
+
+int main(int argc, char *argv[])
+{
+  Bench bench;
+  GtError *err;
+  const gchar **name;
+  int i,
+      had_err = 0;
+
+  if (!g_thread_supported())
+    g_thread_init(NULL);
+  gt_lib_init();
+
+  for (i = 4; i < argc; i++) {
+    for (name = benchmarks; *name && g_strcmp0(*name, argv[i]) != 0; name++);
+    if (!*name)
+      break;
+  }
+  if (argc < 4 || i < argc || !gt_file_exists(argv[1]) ||
+      !gt_file_exists(argv[3])) {
+    fprintf(stderr, "Usage: %s <GFF3 file> <indexname> <filter file> "
+            "[benchmark ...]\n", argv[0]);
+    fprintf(stderr, "Benchmarks: %s %s %s %s %s %s\n", BENCH_PREPROCESS,
+            BENCH_FILTER, BENCH_FLCANDS, BENCH_SAVE, BENCH_LOAD, BENCH_EXPORT);
+    gt_lib_clean();
+    return EXIT_FAILURE;
+  }
+
+  err = gt_error_new();
+  memset(&bench, 0, sizeof (bench));
+  bench.gff3file = argv[1];
+  bench.indexname = argv[2];
+  bench.filterfile = argv[3];
+  /* the project is saved next to the encoded sequence */
+  bench.projectfile = g_strconcat(argv[2], "_bench", SQLITE_PATTERN, NULL);
+  bench.timer = g_timer_new();
+
+  /* results measured with a broken candidate merge would be worthless */
+  had_err = ltrgui_dedup_stream_unit_test(err);
+  if (!had_err)
+    had_err = bench_run(&bench, argv + 4, err);
+  if (had_err)
+    fprintf(stderr, "error: %s\n", gt_error_get(err));
+
+  bench_cleanup(&bench);
+  gt_error_delete(err);
+
+  if (gt_lib_clean())
+    return GT_EXIT_PROGRAMMING_ERROR;
+  return had_err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <glib.h>
+#include "genometools.h"
+
+/* Writes <basename>.gff3 with a given number of synthetic candidates in the
+   format written by LTRharvest/LTRdigest, <basename>.fas with random
+   sequences they refer to and the encoded sequence <basename> used to
+   benchmark LTRsift (see ltrsift_bench.c). */
+
+#define BENCH_GEN_SEQLEN      8000000UL
+#define BENCH_GEN_MAX_SEQS    16UL
+#define BENCH_GEN_SLOT        8000UL
+#define BENCH_GEN_LINE_WIDTH  60
+#define BENCH_GEN_SEED        4711
+
+typedef struct {
+  const gchar *name,
+              *id;
+} BenchGenDomain;
+
+static const BenchGenDomain domains[] = {
+  {"Gag_peptidase", "PF03732.10"},
+  {"RVP",           "PF00077.13"},
+  {"Peptidase_A17", "PF05380.6"},
+  {"RVT_1",         "PF00078.20"},
+  {"RVT_thumb",     "PF06817.7"},
+  {"RNase_H",       "PF00075.17"},
+  {"rve",           "PF00665.19"},
+  {"Integrase_Zn",  "PF02022.12"}
+};
+
+/* the domain sets of the synthetic families, as indices into <domains> */
+static const gint profiles[][6] = {
+  {1, 3, 5, 6, -1},
+  {0, 1, 3, 5, 6, -1},
+  {2, 3, 4, 6, -1},
+  {7, 6, 3, 5, -1},
+  {3, 6, -1}
+};
+
+#define BENCH_GEN_N_PROFILES (sizeof (profiles) / sizeof (profiles[0]))
+
+static unsigned long bench_gen_num_seqs(unsigned long num_cands)
+{
+  unsigned long slots = BENCH_GEN_SEQLEN / BENCH_GEN_SLOT,
+                num_seqs = (num_cands + slots - 1) / slots;
+
+  return CLAMP(num_seqs, 1, BENCH_GEN_MAX_SEQS);
+}
+
+static int bench_gen_sequences(const gchar *filename, unsigned long num_seqs,
+                               GRand *rand, GtError *err)
+{
+  static const gchar bases[] = "acgt";
+  GtFile *outfp;
+  gchar line[BENCH_GEN_LINE_WIDTH + 1];
+  unsigned long i, j, k;
+
+  if (!(outfp = gt_file_new(filename, "w", err)))
+    return -1;
+  line[BENCH_GEN_LINE_WIDTH] = '\0';
+  for (i = 0; i < num_seqs; i++) {
+    gt_file_xprintf(outfp, ">seq%lu synthetic sequence\n", i);
+    for (j = 0; j < BENCH_GEN_SEQLEN; j += BENCH_GEN_LINE_WIDTH) {
+      for (k = 0; k < BENCH_GEN_LINE_WIDTH; k++)
+        line[k] = bases[g_rand_int_range(rand, 0, 4)];
+      gt_file_xprintf(outfp, "%s\n", line);
+    }
+  }
+  gt_file_delete(outfp);
+  return 0;
+}
+
+/* the candidate is placed into the next free slot of BENCH_GEN_SLOT
+   positions; once all slots of the maximal number of sequences are used,
+   further candidates are placed into the same slots again (slightly
+   shifted), so that large data sets do not need huge sequences */
+static void bench_gen_candidate(GtFile *outfp, unsigned long candno,
+                                unsigned long num_seqs, GRand *rand)
+{
+  const gint *profile;
+  unsigned long slots = num_seqs * (BENCH_GEN_SEQLEN / BENCH_GEN_SLOT),
+                slot = candno % slots,
+                seqno = slot / (BENCH_GEN_SEQLEN / BENCH_GEN_SLOT),
+                start, elem_start, elem_end, inner_start, inner_len,
+                ltr1_len, ltr2_len, tsd_len, dom_slot, dom_start, dom_len,
+                id = candno + 1;
+  gint i, num_domains;
+  gchar strand;
+
+  start = (slot % (BENCH_GEN_SEQLEN / BENCH_GEN_SLOT)) * BENCH_GEN_SLOT + 1 +
+          ((candno / slots) * 97) % 500;
+  tsd_len = g_rand_int_range(rand, 4, 7);
+  ltr1_len = g_rand_int_range(rand, 200, 601);
+  ltr2_len = g_rand_int_range(rand, ltr1_len - 10, ltr1_len + 11);
+  inner_len = g_rand_int_range(rand, 3000, 6001);
+  elem_start = start + tsd_len;
+  inner_start = elem_start + ltr1_len;
+  elem_end = inner_start + inner_len + ltr2_len - 1;
+  strand = g_rand_boolean(rand) ? '+' : '-';
+
+  gt_file_xprintf(outfp, "seq%lu\tLTRharvest\trepeat_region\t%lu\t%lu\t.\t?"
+                  "\t.\tID=repeat_region%lu\n", seqno, start,
+                  elem_end + tsd_len, id);
+  gt_file_xprintf(outfp, "seq%lu\tLTRharvest\ttarget_site_duplication\t%lu"
+                  "\t%lu\t.\t?\t.\tParent=repeat_region%lu\n", seqno, start,
+                  elem_start - 1, id);
+  gt_file_xprintf(outfp, "seq%lu\tLTRharvest\tLTR_retrotransposon\t%lu\t%lu"
+                  "\t.\t%c\t.\tID=LTR_retrotransposon%lu;"
+                  "Parent=repeat_region%lu;ltr_similarity=%.2f;"
+                  "seq_number=%lu\n", seqno, elem_start, elem_end, strand, id,
+                  id, g_rand_double_range(rand, 85.0, 100.0), seqno);
+  gt_file_xprintf(outfp, "seq%lu\tLTRharvest\tlong_terminal_repeat\t%lu\t%lu"
+                  "\t.\t?\t.\tParent=LTR_retrotransposon%lu\n", seqno,
+                  elem_start, inner_start - 1, id);
+  if (g_rand_int_range(rand, 0, 4) != 0)
+    gt_file_xprintf(outfp, "seq%lu\tLTRdigest\tprimer_binding_site\t%lu\t%lu"
+                    "\t%.2f\t%c\t.\tParent=LTR_retrotransposon%lu;"
+                    "trna=Lys-TTT;trnalen=73;pbsoffset=2;trnaoffset=0;"
+                    "edist=1\n", seqno, inner_start + 2, inner_start + 19,
+                    g_rand_double_range(rand, 10.0, 20.0), strand, id);
+
+  /* most candidates carry the domains of their family, some miss one */
+  profile = profiles[g_rand_int_range(rand, 0, BENCH_GEN_N_PROFILES)];
+  for (num_domains = 0; profile[num_domains] >= 0; num_domains++);
+  dom_slot = (inner_len - 200) / num_domains;
+  for (i = 0; i < num_domains; i++) {
+    if (g_rand_int_range(rand, 0, 10) == 0)
+      continue;
+    dom_len = g_rand_int_range(rand, 150, MIN(dom_slot, 600) + 1);
+    dom_start = inner_start + 100 + i * dom_slot +
+                g_rand_int_range(rand, 0, dom_slot - dom_len + 1);
+    gt_file_xprintf(outfp, "seq%lu\tLTRdigest\tprotein_match\t%lu\t%lu"
+                    "\t%.2e\t%c\t%d\tParent=LTR_retrotransposon%lu;"
+                    "name=%s;id=%s\n", seqno, dom_start,
+                    dom_start + dom_len - 1,
+                    g_rand_double_range(rand, 1e-50, 1e-5), strand,
+                    g_rand_int_range(rand, 0, 3), id,
+                    domains[profile[i]].name, domains[profile[i]].id);
+  }
+
+  gt_file_xprintf(outfp, "seq%lu\tLTRdigest\tRR_tract\t%lu\t%lu\t.\t%c\t.\t"
+                  "Parent=LTR_retrotransposon%lu\n", seqno,
+                  inner_start + inner_len - 30, inner_start + inner_len - 16,
+                  strand, id);
+  gt_file_xprintf(outfp, "seq%lu\tLTRharvest\tlong_terminal_repeat\t%lu\t%lu"
+                  "\t.\t?\t.\tParent=LTR_retrotransposon%lu\n", seqno,
+                  inner_start + inner_len, elem_end, id);
+  gt_file_xprintf(outfp, "seq%lu\tLTRharvest\ttarget_site_duplication\t%lu"
+                  "\t%lu\t.\t?\t.\tParent=repeat_region%lu\n###\n", seqno,
+                  elem_end + 1, elem_end + tsd_len, id);
+}
+
+static int bench_gen_annotation(const gchar *filename, unsigned long num_cands,
+                                unsigned long num_seqs, GRand *rand,
+                                GtError *err)
+{
+  GtFile *outfp;
+  unsigned long i;
+
+  if (!(outfp = gt_file_new(filename, "w", err)))
+    return -1;
+  gt_file_xfputs("##gff-version   3\n", outfp);
+  for (i = 0; i < num_seqs; i++)
+    gt_file_xprintf(outfp, "##sequence-region   seq%lu 1 %lu\n", i,
+                    BENCH_GEN_SEQLEN);
+  for (i = 0; i < num_cands; i++)
+    bench_gen_candidate(outfp, i, num_seqs, rand);
+  gt_file_delete(outfp);
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  GtEncseqEncoder *e = NULL;
+  GtStrArray *infiles = NULL;
+  GtError *err = NULL;
+  GRand *rand;
+  gchar *gff3file,
+        *fastafile;
+  unsigned long num_cands = 0,
+                num_seqs;
+  int had_err = 0;
+  gt_lib_init();
+
+  if (argc < 3 || !(num_cands = strtoul(argv[1], NULL, 10))) {
+    fprintf(stderr, "Usage: %s <number of candidates> <basename> [seed]\n",
+            argv[0]);
+    gt_lib_clean();
+    return EXIT_FAILURE;
+  }
+
+  err = gt_error_new();
+  rand = g_rand_new_with_seed(argc > 3 ? (guint32) strtoul(argv[3], NULL, 10)
+                                       : BENCH_GEN_SEED);
+  num_seqs = bench_gen_num_seqs(num_cands);
+  gff3file = g_strconcat(argv[2], ".gff3", NULL);
+  fastafile = g_strconcat(argv[2], ".fas", NULL);
+
+  had_err = bench_gen_sequences(fastafile, num_seqs, rand, err);
+  if (!had_err)
+    had_err = bench_gen_annotation(gff3file, num_cands, num_seqs, rand, err);
+  if (!had_err) {
+    infiles = gt_str_array_new();
+    gt_str_array_add_cstr(infiles, fastafile);
+    e = gt_encseq_encoder_new();
+    gt_encseq_encoder_enable_lossless_support(e);
+    had_err = gt_encseq_encoder_encode(e, infiles, argv[2], err);
+  }
+  if (had_err)
+    fprintf(stderr, "error: %s\n", gt_error_get(err));
+
+  gt_str_array_delete(infiles);
+  gt_encseq_encoder_delete(e);
+  g_free(fastafile);
+  g_free(gff3file);
+  g_rand_free(rand);
+  gt_error_delete(err);
+
+  if (gt_lib_clean())
+    return GT_EXIT_PROGRAMMING_ERROR;
+  return had_err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
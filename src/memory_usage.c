@@ -0,0 +1,171 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <glib/gstdio.h>
+#include "memory_usage.h"
+#include "message_strings.h"
+
+/* rough size of a feature node with its attributes and children list */
+#define MEMORY_FEATURE_NODE_SIZE 256
+
+struct MemoryUsage {
+  gsize bytes[MEMORY_NUM],
+        budget;
+};
+
+static const gchar *memory_subsystem_names[MEMORY_NUM] = {
+  "Candidates",
+  "Saved copies",
+  "Lists",
+  "Diagram",
+  "Sequence cache",
+  "Sequence index",
+  "Location index",
+  "Overview"
+};
+
+MemoryUsage* memory_usage_new(gsize budget)
+{
+  MemoryUsage *mu = g_slice_new0(MemoryUsage);
+
+  mu->budget = budget;
+  return mu;
+}
+
+void memory_usage_add(MemoryUsage *mu, MemorySubsystem subsystem, gsize bytes)
+{
+  gt_assert(mu && subsystem < MEMORY_NUM);
+  mu->bytes[subsystem] += bytes;
+}
+
+void memory_usage_sub(MemoryUsage *mu, MemorySubsystem subsystem, gsize bytes)
+{
+  gt_assert(mu && subsystem < MEMORY_NUM);
+  mu->bytes[subsystem] -= MIN(bytes, mu->bytes[subsystem]);
+}
+
+void memory_usage_set(MemoryUsage *mu, MemorySubsystem subsystem, gsize bytes)
+{
+  gt_assert(mu && subsystem < MEMORY_NUM);
+  mu->bytes[subsystem] = bytes;
+}
+
+gsize memory_usage_get(MemoryUsage *mu, MemorySubsystem subsystem)
+{
+  gt_assert(mu && subsystem < MEMORY_NUM);
+  return mu->bytes[subsystem];
+}
+
+gsize memory_usage_total(MemoryUsage *mu)
+{
+  gsize total = 0;
+  guint i;
+
+  gt_assert(mu);
+  for (i = 0; i < MEMORY_NUM; i++)
+    total += mu->bytes[i];
+  return total;
+}
+
+gsize memory_usage_get_budget(MemoryUsage *mu)
+{
+  gt_assert(mu);
+  return mu->budget;
+}
+
+gboolean memory_usage_exceeded(MemoryUsage *mu)
+{
+  gt_assert(mu);
+  return (mu->budget > 0 && memory_usage_total(mu) > mu->budget);
+}
+
+const gchar* memory_usage_subsystem_name(MemorySubsystem subsystem)
+{
+  gt_assert(subsystem < MEMORY_NUM);
+  return memory_subsystem_names[subsystem];
+}
+
+gchar* memory_usage_details(MemoryUsage *mu)
+{
+  GString *details;
+  gchar *size;
+  guint i;
+
+  gt_assert(mu);
+  details = g_string_new("");
+  for (i = 0; i < MEMORY_NUM; i++) {
+    size = g_format_size_for_display((goffset) mu->bytes[i]);
+    g_string_append_printf(details, "%s: %s\n", memory_subsystem_names[i],
+                           size);
+    g_free(size);
+  }
+  if (mu->budget > 0) {
+    size = g_format_size_for_display((goffset) mu->budget);
+    g_string_append_printf(details, MEMORY_BUDGET_TEXT, size);
+    g_free(size);
+  } else
+    g_string_append(details, MEMORY_NO_BUDGET_TEXT);
+  return g_string_free(details, FALSE);
+}
+
+gsize memory_usage_estimate_node(GtGenomeNode *gn)
+{
+  GtFeatureNodeIterator *fni;
+  gsize bytes = 0;
+
+  gt_assert(gn);
+  fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
+  while (gt_feature_node_iterator_next(fni))
+    bytes += MEMORY_FEATURE_NODE_SIZE;
+  gt_feature_node_iterator_delete(fni);
+  return bytes;
+}
+
+gsize memory_usage_estimate_encseq(const gchar *indexname)
+{
+  const gchar *suffixes[] = {ESQ_PATTERN, ".ssp", ".des", ".sds"};
+  GStatBuf buf;
+  gchar *filename;
+  gsize bytes = 0;
+  guint i;
+
+  gt_assert(indexname);
+  for (i = 0; i < G_N_ELEMENTS(suffixes); i++) {
+    filename = g_strconcat(indexname, suffixes[i], NULL);
+    if (g_stat(filename, &buf) == 0)
+      bytes += (gsize) buf.st_size;
+    g_free(filename);
+  }
+  return bytes;
+}
+
+gsize memory_usage_budget_from_env(void)
+{
+  const gchar *budget;
+
+  budget = g_getenv(LTRSIFT_MEMORY_ENV);
+  if (!budget)
+    return 0;
+  return (gsize) g_ascii_strtoull(budget, NULL, 10) * 1024 * 1024;
+}
+
+void memory_usage_delete(MemoryUsage *mu)
+{
+  if (!mu)
+    return;
+  g_slice_free(MemoryUsage, mu);
+}
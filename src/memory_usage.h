@@ -0,0 +1,84 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* The parts of a project whose memory is accounted for. */
+typedef enum {
+  MEMORY_NODES = 0,
+  MEMORY_NODE_COPIES,
+  MEMORY_LIST_STORES,
+  MEMORY_DIAGRAM,
+  MEMORY_SEQUENCES,
+  MEMORY_ENCSEQ,
+  MEMORY_LOCATIONS,
+  MEMORY_OVERVIEW,
+  MEMORY_NUM
+} MemorySubsystem;
+
+/* <MemoryUsage> keeps the (estimated) number of bytes used by each
+   subsystem of a project and the budget they should stay within. The sizes
+   are estimates of the data owned by the project, not measurements of the
+   heap. It must only be used from the main thread. */
+typedef struct MemoryUsage MemoryUsage;
+
+/* Returns a new accounting with the budget <budget> (in bytes, 0 means
+   unlimited). */
+MemoryUsage*  memory_usage_new(gsize budget);
+
+void          memory_usage_add(MemoryUsage *mu, MemorySubsystem subsystem,
+                               gsize bytes);
+
+/* Subtracts <bytes> from <subsystem>, the size never drops below zero. */
+void          memory_usage_sub(MemoryUsage *mu, MemorySubsystem subsystem,
+                               gsize bytes);
+
+void          memory_usage_set(MemoryUsage *mu, MemorySubsystem subsystem,
+                               gsize bytes);
+
+gsize         memory_usage_get(MemoryUsage *mu, MemorySubsystem subsystem);
+
+gsize         memory_usage_total(MemoryUsage *mu);
+
+gsize         memory_usage_get_budget(MemoryUsage *mu);
+
+/* Returns TRUE if a budget is set and the total exceeds it. */
+gboolean      memory_usage_exceeded(MemoryUsage *mu);
+
+const gchar*  memory_usage_subsystem_name(MemorySubsystem subsystem);
+
+/* Returns a newly allocated text listing the size of every subsystem. */
+gchar*        memory_usage_details(MemoryUsage *mu);
+
+/* Returns the estimated number of bytes used by the candidate <gn>. */
+gsize         memory_usage_estimate_node(GtGenomeNode *gn);
+
+/* Returns the number of bytes used by the files of the sequence index
+   <indexname>, which are mapped into memory when it is loaded. */
+gsize         memory_usage_estimate_encseq(const gchar *indexname);
+
+/* Returns the budget (in bytes) given in megabytes by the environment
+   variable LTRSIFT_MEMORY_BUDGET, 0 if it is not set. */
+gsize         memory_usage_budget_from_env(void);
+
+void          memory_usage_delete(MemoryUsage *mu);
+
+#endif
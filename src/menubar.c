@@ -16,6 +16,7 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <errno.h>
 #include <stdio.h>
 #include "error.h"
 #include "genometools.h"
@@ -352,51 +353,95 @@ static gint save_match_param_sets(GUIData *ltrgui)
     return 0;
 }
 
+/* shows <state> in the progress bar, every state is a stage of the job */
+static void set_job_state(ThreadData *threaddata, const gchar *state)
+{
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar), state);
+  perf_log_stage(threaddata->perf, state);
+}
+
 static gboolean save_project_data_finished(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
-  GtkWidget *ltrfams = threaddata->ltrgui->ltrfams;
+  GUIData *ltrgui = threaddata->ltrgui;
+  gboolean current;
 
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
   g_source_remove(GPOINTER_TO_INT(
-                                 g_object_get_data(G_OBJECT(threaddata->window),
-                                                   "source_id")));
-  gtk_widget_destroy(threaddata->window);
+                           g_object_get_data(G_OBJECT(threaddata->progressbar),
+                                             "source_id")));
   reset_progressbar(threaddata->progressbar);
-  if (!threaddata->had_err) {
-    gtk_ltr_families_set_modified(GTK_LTR_FAMILIES(ltrfams), FALSE);
-    threaddata->had_err = save_gui_settings(threaddata->ltrgui);
+  gtk_ltr_families_release_candidates(threaddata->ltrfams);
+  /* the project might have been closed while the snapshot was written */
+  current = (GTK_WIDGET(threaddata->ltrfams) == ltrgui->ltrfams);
+  if (threaddata->had_err)
+    gt_error_set(ltrgui->err, "Could not save project: %s",
+                 gt_error_get(threaddata->err));
+  if (!threaddata->had_err && current) {
+    /* edits made during the save are not part of the snapshot */
+    if (gtk_ltr_families_get_generation(threaddata->ltrfams) ==
+                                                        threaddata->generation)
+      gtk_ltr_families_set_modified(threaddata->ltrfams, FALSE);
+    threaddata->had_err = project_index_save(threaddata->new_index,
+                                             threaddata->rdb, ltrgui->err);
+    if (!threaddata->had_err)
+      threaddata->had_err =
+                project_index_save_features(threaddata->rdb,
+                                            gtk_ltr_families_get_features(
+                                                           threaddata->ltrfams),
+                                            ltrgui->err);
+    /* candidates which are still not loaded are read from the new file */
+    if (!threaddata->had_err &&
+        gtk_ltr_families_get_index(threaddata->ltrfams)) {
+      gtk_ltr_families_set_index(threaddata->ltrfams, threaddata->new_index);
+      threaddata->new_index = NULL;
+    }
+    if (!threaddata->had_err)
+      threaddata->had_err = save_gui_settings(ltrgui);
     if (!threaddata->had_err)
       threaddata->had_err =
                   gtk_project_settings_save_data(GTK_PROJECT_SETTINGS(
-                                                  threaddata->ltrgui->projset),
-                                                  threaddata->rdb,
-                                                  threaddata->ltrgui->err);
+                                                  ltrgui->projset),
+                                  gtk_ltr_families_get_rdb(threaddata->ltrfams),
+                                                  ltrgui->err);
 
     if (!threaddata->had_err)
       threaddata->had_err = gtk_ltr_filter_save_data(
-                                    GTK_LTR_FILTER(threaddata->ltrgui->ltrfilt),
-                                                   threaddata->ltrgui->err);
+                                    GTK_LTR_FILTER(ltrgui->ltrfilt),
+                                                   ltrgui->err);
     if (!threaddata->had_err)
-      threaddata->had_err = save_match_param_sets(threaddata->ltrgui);
+      threaddata->had_err = save_match_param_sets(ltrgui);
+  }
+  /* the log of a closed project is dropped with the project */
+  if (current) {
+    gtk_ltr_families_log_perf(threaddata->ltrfams, threaddata->perf,
+                              threaddata->had_err != 0);
+    threaddata->perf = NULL;
   }
   if (threaddata->had_err) {
     gdk_threads_enter();
-    error_handle(threaddata->ltrgui->main_window, threaddata->ltrgui->err);
+    error_handle(ltrgui->main_window, ltrgui->err);
     gdk_threads_leave();
   }
 
-  gtk_widget_set_sensitive(threaddata->ltrgui->menubar_save, TRUE);
+  if (current)
+    gtk_widget_set_sensitive(ltrgui->menubar_save, TRUE);
+  ltrgui->save_in_progress = FALSE;
+  /* a close or quit waiting for the save can go on */
+  if (ltrgui->save_wait_dialog)
+    gtk_dialog_response(GTK_DIALOG(ltrgui->save_wait_dialog),
+                        GTK_RESPONSE_OK);
+  g_object_unref(threaddata->ltrfams);
   threaddata_delete(threaddata);
   return FALSE;
 }
 
-static gboolean open_project_data_finished(gpointer data)
+/* replaces the current project views with new ones showing the candidates,
+   regions and features given in <threaddata>, which are handed over */
+static void load_project_views(ThreadData *threaddata)
 {
-  ThreadData *threaddata = (ThreadData*) data;
   GtkWidget *ltrfams = threaddata->ltrgui->ltrfams;
 
-  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                            "Building candidate list");
   if (!threaddata->had_err) {
     gtk_widget_destroy(ltrfams);
     gtk_widget_destroy(threaddata->ltrgui->ltrfilt);
@@ -416,6 +461,10 @@ static gboolean open_project_data_finished(gpointer data)
                                        threaddata->ltrgui->ltrfilt);
     gtk_box_pack_start(GTK_BOX(threaddata->ltrgui->vbox), ltrfams, TRUE, TRUE,
                        0);
+    if (threaddata->index) {
+      gtk_ltr_families_set_index(GTK_LTR_FAMILIES(ltrfams), threaddata->index);
+      threaddata->index = NULL;
+    }
     gtk_ltr_families_fill_with_data(GTK_LTR_FAMILIES(ltrfams),
                                     threaddata->nodes,
                                     threaddata->regions,
@@ -451,6 +500,21 @@ static gboolean open_project_data_finished(gpointer data)
     gdk_threads_leave();
   }
   gtk_ltr_families_set_modified(GTK_LTR_FAMILIES(ltrfams), FALSE);
+}
+
+static gboolean open_project_data_finished(gpointer data)
+{
+  ThreadData *threaddata = (ThreadData*) data;
+  gboolean loaded = !threaddata->had_err;
+
+  set_job_state(threaddata, "Building candidate list");
+  load_project_views(threaddata);
+  /* a project which could not be read has no views to log to */
+  if (loaded) {
+    gtk_ltr_families_log_perf(GTK_LTR_FAMILIES(threaddata->ltrgui->ltrfams),
+                              threaddata->perf, threaddata->had_err != 0);
+    threaddata->perf = NULL;
+  }
 
   reset_progressbar(threaddata->progressbar);
   g_source_remove(GPOINTER_TO_INT(
@@ -467,18 +531,28 @@ static gboolean save_as_finished(gpointer data)
   ThreadData *threaddata = (ThreadData*) data;
   GtkWidget *ltrfams = threaddata->ltrgui->ltrfams;
 
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
   g_source_remove(GPOINTER_TO_INT(
                                g_object_get_data(G_OBJECT(threaddata->window),
                                                  "source_id")));
   gtk_widget_destroy(threaddata->window);
   reset_progressbar(threaddata->progressbar);
+  gtk_ltr_families_release_candidates(GTK_LTR_FAMILIES(ltrfams));
 
   if (!threaddata->had_err) {
     gtk_ltr_families_set_projectfile(GTK_LTR_FAMILIES(ltrfams),
                                      threaddata->filename);
+    if (gtk_ltr_families_get_index(GTK_LTR_FAMILIES(ltrfams))) {
+      gtk_ltr_families_set_index(GTK_LTR_FAMILIES(ltrfams),
+                                 threaddata->new_index);
+      threaddata->new_index = NULL;
+    }
     gtk_ltr_families_set_modified(GTK_LTR_FAMILIES(ltrfams), FALSE);
     create_recently_used_resource(threaddata->filename);
   }
+  gtk_ltr_families_log_perf(GTK_LTR_FAMILIES(ltrfams), threaddata->perf,
+                            threaddata->had_err != 0);
+  threaddata->perf = NULL;
 
   if (threaddata->had_err) {
     gdk_threads_enter();
@@ -490,20 +564,123 @@ static gboolean save_as_finished(gpointer data)
   return FALSE;
 }
 
+/* writes <regions> and <nodes> to <gff3file>, the candidates numbered in
+   <unloaded> were never read and are copied from <source> instead. On
+   success <new_index> is set to the index of the written file, which is
+   built while writing. */
+static int write_project_gff3(GtArray *nodes, GtArray *regions,
+                              ProjectIndex *source, GtArray *unloaded,
+                              const gchar *gff3file, unsigned long *progress,
+                              ProjectIndex **new_index, GtError *err)
+{
+  ProjectIndexWriter *piw = NULL;
+  GtArray *sorted_nodes;
+  GtFile *outfp;
+  GtGenomeNode *gn;
+  gchar *plainfile,
+        *targetfile,
+        *stalefile;
+  const gchar *sourcefile;
+  unsigned long i = 0,
+                j = 0,
+                entryno,
+                n_unloaded;
+  gboolean compressed;
+  int had_err = 0;
+
+  *new_index = NULL;
+  /* candidates and regions are kept in genomic order, merging both arrays
+     is enough to get a sorted output without sorting everything again */
+  sorted_nodes = merge_sorted_node_arrays(regions, nodes);
+  n_unloaded = unloaded ? gt_array_size(unloaded) : 0;
+
+  /* <source> might still read from the uncompressed project file, so it is
+     replaced only after it has been written completely; the compressed file
+     is written to a temporary file first by gff3_output_finish() */
+  compressed = g_str_has_suffix(gff3file, GZ_PATTERN);
+  if (compressed)
+    targetfile = g_strdup(gff3file);
+  else
+    targetfile = g_strconcat(gff3file, TMP_PATTERN, NULL);
+
+  outfp = gff3_output_new(targetfile, &plainfile, err);
+  if (!outfp)
+    had_err = -1;
+
+  if (!had_err)
+    piw = project_index_writer_new(outfp);
+
+  while (!had_err && (i < gt_array_size(sorted_nodes) || j < n_unloaded)) {
+    gn = i < gt_array_size(sorted_nodes)
+         ? *(GtGenomeNode**) gt_array_get(sorted_nodes, i) : NULL;
+    entryno = j < n_unloaded ? *(unsigned long*) gt_array_get(unloaded, j) : 0;
+    if (j < n_unloaded &&
+        (!gn || project_index_entry_cmp(source, entryno, gn) <= 0)) {
+      had_err = project_index_writer_copy_entry(piw, source, entryno, err);
+      j++;
+    } else {
+      had_err = project_index_writer_add_node(piw, gn, err);
+      i++;
+    }
+    if (progress)
+      (*progress)++;
+  }
+
+  if (!had_err)
+    *new_index = project_index_writer_finish(piw);
+  else
+    project_index_writer_delete(piw);
+  had_err = gff3_output_finish(outfp, targetfile, plainfile, TRUE, had_err,
+                               err);
+  gt_array_delete(sorted_nodes);
+  /* on error the uncompressed copy is already gone */
+  if (had_err)
+    plainfile = NULL;
+
+  if (!had_err && !compressed && g_rename(targetfile, gff3file) != 0) {
+    gt_error_set(err, "Could not rename %s: %s", targetfile,
+                 g_strerror(errno));
+    had_err = -1;
+  }
+  if (had_err && !compressed)
+    g_unlink(targetfile);
+
+  /* the uncompressed copy of a compressed project is kept as the source of
+     the candidates which are not loaded */
+  if (!had_err) {
+    sourcefile = plainfile ? plainfile : gff3file;
+    had_err = project_index_set_source(*new_index, sourcefile,
+                                       plainfile != NULL, err);
+  }
+  if (had_err) {
+    project_index_delete(*new_index);
+    *new_index = NULL;
+  }
+  if (had_err && plainfile)
+    g_unlink(plainfile);
+  g_free(plainfile);
+
+  /* a compressed GFF3 file is preferred when opening the project, so the
+     file in the other format must not outlive a successful save */
+  if (!had_err) {
+    if (compressed)
+      stalefile = g_strndup(gff3file, strlen(gff3file) - strlen(GZ_PATTERN));
+    else
+      stalefile = g_strconcat(gff3file, GZ_PATTERN, NULL);
+    if (g_file_test(stalefile, G_FILE_TEST_EXISTS))
+      g_unlink(stalefile);
+    g_free(stalefile);
+  }
+  g_free(targetfile);
+
+  return had_err;
+}
+
 static gpointer save_as_start(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
-  GtNodeStream *node_in_stream = NULL,
-               *node_sort_stream = NULL,
-               *regions_in_stream = NULL,
-               *regions_sort_stream = NULL,
-               *merge_stream = NULL,
-               *gff3_out_stream = NULL;
-  GtArray *streams;
-  GtFile *outfp;
 
-  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                            "Saving data");
+  set_job_state(threaddata, "Saving data");
   gt_rdb_delete(threaddata->rdb);
   threaddata->rdb = gt_rdb_sqlite_new(threaddata->filename,
                                       threaddata->ltrgui->err);
@@ -513,49 +690,24 @@ static gpointer save_as_start(gpointer data)
     gtk_ltr_families_set_rdb(threaddata->rdb,
                              GTK_LTR_FAMILIES(threaddata->ltrgui->ltrfams));
 
-  regions_in_stream = gt_array_in_stream_new(threaddata->regions,
+  if (!threaddata->had_err)
+    threaddata->had_err = write_project_gff3(threaddata->nodes,
+                                             threaddata->regions,
+                                             threaddata->index,
+                                             threaddata->unloaded,
+                                             threaddata->gff3file,
                                              &threaddata->progress,
-                                             threaddata->ltrgui->err);
-  regions_sort_stream = gt_sort_stream_new(regions_in_stream);
-  gt_assert(regions_sort_stream);
-
-  node_in_stream = gt_array_in_stream_new(threaddata->nodes,
-                                          &threaddata->progress,
-                                          threaddata->ltrgui->err);
-  node_sort_stream = gt_sort_stream_new(node_in_stream);
-  gt_assert(node_in_stream);
-
-  streams = gt_array_new(sizeof (GtNodeStream*));
-  gt_array_add(streams, node_sort_stream);
-  gt_array_add(streams, regions_sort_stream);
-
-  merge_stream = gt_merge_stream_new(streams);
-
-  outfp = gt_file_new(threaddata->gff3file, "w+", threaddata->err);
-  if (!outfp) {
-    threaddata->had_err = -1;
-  }
-
-  if (!threaddata->had_err) {
-    GtGenomeNode *gn;
-    gt_assert(outfp);
-
-    gff3_out_stream = gt_gff3_out_stream_new(merge_stream, outfp);
-    gt_assert(gff3_out_stream);
-
-    while (!(threaddata->had_err = gt_node_stream_next(gff3_out_stream,
-                                                       &gn,
-                                                       threaddata->err)) && gn);
-  }
-
-  gt_file_delete(outfp);
-  gt_node_stream_delete(gff3_out_stream);
-  gt_node_stream_delete(merge_stream);
-  gt_node_stream_delete(node_in_stream);
-  gt_node_stream_delete(node_sort_stream);
-  gt_node_stream_delete(regions_in_stream);
-  gt_node_stream_delete(regions_sort_stream);
-  gt_array_delete(streams);
+                                             &threaddata->new_index,
+                                             threaddata->err);
+  perf_log_add_items(threaddata->perf, threaddata->progress);
+  if (!threaddata->had_err)
+    threaddata->had_err = project_index_save(threaddata->new_index,
+                                             threaddata->rdb,
+                                             threaddata->err);
+  if (!threaddata->had_err)
+    threaddata->had_err = project_index_save_features(threaddata->rdb,
+                                                      threaddata->features,
+                                                      threaddata->err);
 
   if (!threaddata->had_err) {
     threaddata->had_err =
@@ -583,76 +735,19 @@ static gpointer save_as_start(gpointer data)
 static gpointer save_project_data_start(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
-  GT_UNUSED GtkWidget *ltrfams = threaddata->ltrgui->ltrfams;
-  GtNodeStream *node_in_stream = NULL,
-               *node_sort_stream = NULL,
-               *regions_in_stream = NULL,
-               *regions_sort_stream = NULL,
-               *merge_stream = NULL,
-               *gff3_out_stream = NULL;
-  GtArray *streams;
-
-  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                            "Saving data");
-  (void) extract_match_param_sets(threaddata->ltrgui);
-
-  gtk_widget_set_sensitive(threaddata->ltrgui->menubar_save, FALSE);
-  if (!threaddata->had_err) {
-    GtFile *outfp = NULL;  /* XXX: protect this via mutex */
-    threaddata->progress = 0;
-     threaddata->nodes =
-      gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(threaddata->ltrgui->ltrfams));
-
-    regions_in_stream = gt_array_in_stream_new(threaddata->regions,
-                                               &threaddata->progress,
-                                               threaddata->ltrgui->err);
-    regions_sort_stream = gt_sort_stream_new(regions_in_stream);
-    gt_assert(regions_sort_stream);
-
-    node_in_stream = gt_array_in_stream_new(threaddata->nodes,
-                                            &threaddata->progress,
-                                            threaddata->ltrgui->err);
-    node_sort_stream = gt_sort_stream_new(node_in_stream);
-    gt_assert(node_in_stream);
-
-    streams = gt_array_new(sizeof (GtNodeStream*));
-    gt_array_add(streams, node_sort_stream);
-    gt_array_add(streams, regions_sort_stream);
-
-    merge_stream = gt_merge_stream_new(streams);
-
-    outfp = gt_file_new(threaddata->gff3file, "w+", threaddata->err);
-    if (!outfp) {
-      threaddata->had_err = -1;
-    }
 
-    if (!threaddata->had_err) {
-      GtGenomeNode *gn;
-      gt_assert(outfp);
-
-      gff3_out_stream = gt_gff3_out_stream_new(merge_stream, outfp);
-      gt_assert(gff3_out_stream);
-
-      while (!(threaddata->had_err = gt_node_stream_next(gff3_out_stream,
-                                                       &gn,
-                                                       threaddata->err)) && gn);
-    }
-
-    gt_file_delete(outfp);
-    gt_node_stream_delete(gff3_out_stream);
-    gt_node_stream_delete(merge_stream);
-    gt_node_stream_delete(node_in_stream);
-    gt_node_stream_delete(node_sort_stream);
-    gt_node_stream_delete(regions_in_stream);
-    gt_node_stream_delete(regions_sort_stream);
-    gt_array_delete(streams);
-  }
-
-  if (threaddata->had_err) {
-    gdk_threads_enter();
-    error_handle(threaddata->ltrgui->main_window, threaddata->ltrgui->err);
-    gdk_threads_leave();
-  }
+  /* only the copy taken in save_project_data_run() is used here, no GTK+
+     state is touched until save_project_data_finished() */
+  perf_log_stage(threaddata->perf, PERF_STAGE_WRITE);
+  threaddata->had_err = write_project_gff3(threaddata->nodes,
+                                           threaddata->regions,
+                                           threaddata->index,
+                                           threaddata->unloaded,
+                                           threaddata->gff3file,
+                                           &threaddata->progress,
+                                           &threaddata->new_index,
+                                           threaddata->err);
+  perf_log_add_items(threaddata->perf, threaddata->progress);
 
   g_idle_add(save_project_data_finished, data);
   return NULL;
@@ -666,11 +761,13 @@ static gpointer open_project_data_start(gpointer data)
                *array_stream = NULL;
   GtHashmap *features;
   GtArray *nodes;
+  ProjectIndex *index = NULL;
+  gchar *plainfile = NULL;
   unsigned long n_features;
+  gboolean tmpfile;
   gt_assert(threaddata && threaddata->err);
 
-  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                            "Reading data from file");
+  set_job_state(threaddata, "Reading data from file");
   threaddata->rdb = gt_rdb_sqlite_new(threaddata->filename,
                                       threaddata->ltrgui->err);
   if (!threaddata->rdb)
@@ -679,26 +776,58 @@ static gpointer open_project_data_start(gpointer data)
                            GTK_LTR_FAMILIES(threaddata->ltrgui->ltrfams));
 
   if (!threaddata->had_err) {
-    threaddata->gff3file = g_strndup(threaddata->filename,
-                            strlen(threaddata->filename) - strlen(SQLITE_PATTERN));
-    threaddata->gff3file = g_strconcat(threaddata->gff3file, ".gff3", NULL);
+    threaddata->gff3file = project_gff3_file(threaddata->filename, FALSE);
     if (!gt_file_exists(threaddata->gff3file)) {
       gt_error_set(threaddata->err, "GFF3 file %s does not exist!\n",
                                     threaddata->gff3file);
       threaddata->had_err = -1;
     }
   }
+  if (!threaddata->had_err) {
+    /* compressed projects are decompressed by several threads at once */
+    if (g_str_has_suffix(threaddata->gff3file, GZ_PATTERN))
+      set_job_state(threaddata, "Decompressing data");
+    if (!(plainfile = gff3_input_new(threaddata->gff3file, threaddata->err)))
+      threaddata->had_err = -1;
+  }
 
   if (!threaddata->had_err) {
-    GtGenomeNode *gn = NULL;
     nodes = gt_array_new(sizeof (GtFeatureNode*));
-    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                              "Preprocessing candidates");
     features = gt_hashmap_new(GT_HASH_STRING, free_gt_hash_elem, NULL);
     n_features = LTRFAMS_LV_N_COLUMS+1;
+    index = project_index_new_from_rdb(threaddata->rdb, plainfile, features,
+                                       &n_features, threaddata->err);
+    if (!index && gt_error_is_set(threaddata->err))
+      threaddata->had_err = -1;
+  }
 
-    in_stream = gt_gff3_in_stream_new_unsorted(1,
-                                          (const char**) &threaddata->gff3file);
+  if (!threaddata->had_err && index) {
+    /* only the unclassified candidates are read now, the families are read
+       when they are used for the first time */
+    set_job_state(threaddata, "Reading unclassified candidates");
+    tmpfile = (g_strcmp0(plainfile, threaddata->gff3file) != 0);
+    threaddata->had_err = project_index_set_source(index, plainfile, tmpfile,
+                                                   threaddata->err);
+    if (!threaddata->had_err && tmpfile) {
+      g_free(plainfile);
+      plainfile = NULL;
+    }
+    if (!threaddata->had_err)
+      threaddata->had_err = project_index_read_family(index, NULL, nodes,
+                                                      &threaddata->regions,
+                                                      threaddata->err);
+    if (!threaddata->had_err) {
+      threaddata->nodes = nodes;
+      threaddata->features = features;
+      threaddata->n_features = n_features;
+      threaddata->index = index;
+    } else
+      project_index_delete(index);
+  } else if (!threaddata->had_err) {
+    /* projects saved without an index are read completely */
+    GtGenomeNode *gn = NULL;
+    set_job_state(threaddata, "Preprocessing candidates");
+    in_stream = gt_gff3_in_stream_new_unsorted(1, (const char**) &plainfile);
     preprocess_stream = ltrgui_preprocess_stream_new(in_stream, features,
                                                      &n_features, FALSE,
                                                      threaddata->ltrgui->err);
@@ -707,16 +836,18 @@ static gpointer open_project_data_start(gpointer data)
     while (!(threaddata->had_err = gt_node_stream_next(array_stream,
                                                        &gn,
                                                        threaddata->err)) && gn);
-  }
-  if (!threaddata->had_err) {
-    threaddata->nodes = nodes;
-    threaddata->regions =
+    if (!threaddata->had_err) {
+      threaddata->nodes = nodes;
+      threaddata->regions =
                    ltrgui_preprocess_stream_get_region_nodes(
                                    (LTRGuiPreprocessStream*) preprocess_stream);
-    threaddata->features = features;
-    threaddata->n_features = n_features;
+      threaddata->features = features;
+      threaddata->n_features = n_features;
+    }
   }
 
+  if (threaddata->nodes)
+    perf_log_add_items(threaddata->perf, gt_array_size(threaddata->nodes));
   if (threaddata->had_err) {
     gdk_threads_enter();
     error_handle(threaddata->ltrgui->main_window, threaddata->ltrgui->err);
@@ -726,164 +857,19 @@ static gpointer open_project_data_start(gpointer data)
   gt_node_stream_delete(array_stream);
   gt_node_stream_delete(in_stream);
   gt_node_stream_delete(preprocess_stream);
+  gff3_input_delete(threaddata->gff3file, plainfile);
 
   g_idle_add(open_project_data_finished, data);
   return NULL;
 }
 
-static gpointer save_and_reload_data_start(gpointer data)
-{
-  ThreadData *threaddata = (ThreadData*) data;
-  GtNodeStream *node_in_stream = NULL,
-               *regions_in_stream = NULL,
-               *node_sort_stream = NULL,
-               *regions_sort_stream = NULL,
-               *gff3_out_stream = NULL,
-               *merge_stream = NULL;
-  GtArray *streams;
-  GtFile *outfp;
-
-  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                            "Handling data");
-  threaddata->rdb = gt_rdb_sqlite_new(threaddata->filename,
-                                      threaddata->ltrgui->err);
-  if (!threaddata->rdb)
-    threaddata->had_err = -1;
-  if (!threaddata->had_err)
-    gtk_ltr_families_set_rdb(threaddata->rdb,
-                             GTK_LTR_FAMILIES(threaddata->ltrgui->ltrfams));
-
-  regions_in_stream = gt_array_in_stream_new(threaddata->regions,
-                                             &threaddata->progress,
-                                             threaddata->ltrgui->err);
-  regions_sort_stream = gt_sort_stream_new(regions_in_stream);
-
-  gt_assert(regions_sort_stream);
-
-  node_in_stream = gt_array_in_stream_new(threaddata->nodes,
-                                          &threaddata->progress,
-                                          threaddata->ltrgui->err);
-  node_sort_stream = gt_sort_stream_new(node_in_stream);
-  gt_assert(node_in_stream);
-
-  streams = gt_array_new(sizeof (GtNodeStream*));
-  gt_array_add(streams, node_sort_stream);
-  gt_array_add(streams, regions_sort_stream);
-
-  merge_stream = gt_merge_stream_new(streams);
-
-  outfp = gt_file_new(threaddata->gff3file, "w+", threaddata->err);
-  if (!outfp) {
-    threaddata->had_err = -1;
-  }
-
-  if (!threaddata->had_err) {
-    GtGenomeNode *gn;
-    gt_assert(outfp);
-
-    gff3_out_stream = gt_gff3_out_stream_new(merge_stream, outfp);
-    gt_assert(gff3_out_stream);
-
-    while (!(threaddata->had_err = gt_node_stream_next(gff3_out_stream,
-                                                       &gn,
-                                                       threaddata->err)) && gn);
-  }
-
-  gt_file_delete(outfp);
-  gt_node_stream_delete(gff3_out_stream);
-  gt_node_stream_delete(merge_stream);
-  gt_node_stream_delete(node_in_stream);
-  gt_node_stream_delete(node_sort_stream);
-  gt_node_stream_delete(regions_in_stream);
-  gt_node_stream_delete(regions_sort_stream);
-  gt_array_delete(streams);
-
-  if (!threaddata->had_err) {
-    GtNodeStream *preprocess_stream = NULL,
-                 *array_in_stream = NULL;
-    GtHashmap *features = NULL;
-    GtGenomeNode *gn;
-    unsigned long n_features;
-
-    threaddata->had_err =
-                  gtk_project_settings_save_data(GTK_PROJECT_SETTINGS(
-                                                   threaddata->ltrgui->projset),
-                                                 threaddata->rdb,
-                                                 threaddata->ltrgui->err);
-    if (!threaddata->had_err)
-      threaddata->had_err = save_gui_settings(threaddata->ltrgui);
-    if (!threaddata->had_err)
-      threaddata->had_err = save_match_param_sets(threaddata->ltrgui);
-    if (!threaddata->had_err) {
-      gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
-                                "Preprocessing candidates");
-      features = gt_hashmap_new(GT_HASH_STRING, free_gt_hash_elem, NULL);
-      n_features = LTRFAMS_LV_N_COLUMS+1;
-
-      array_in_stream = gt_array_in_stream_new(threaddata->nodes, NULL,
-                                               threaddata->ltrgui->err);
-      preprocess_stream = ltrgui_preprocess_stream_new(array_in_stream,
-                                                       features, &n_features,
-                                                       FALSE,
-                                                       threaddata->ltrgui->err);
-      while (!(threaddata->had_err = gt_node_stream_next(preprocess_stream,
-                                                         &gn,
-                                                       threaddata->err)) && gn);
-    }
-    if (!threaddata->had_err) {
-      threaddata->regions =
-                   ltrgui_preprocess_stream_get_region_nodes(
-                                   (LTRGuiPreprocessStream*) preprocess_stream);
-      threaddata->features = features;
-      threaddata->n_features = n_features;
-    }
-    if (threaddata->had_err) {
-      gdk_threads_enter();
-      error_handle(threaddata->ltrgui->main_window, threaddata->ltrgui->err);
-      gdk_threads_leave();
-    }
-
-    gt_node_stream_delete(array_in_stream);
-    gt_node_stream_delete(preprocess_stream);
-  }
-  gt_free(threaddata->tmp_filename);
-
-  g_idle_add(open_project_data_finished, data);
-  return NULL;
-}
-
-void first_save_and_reload(GUIData *ltrgui, GtArray *nodes, GtArray *regions,
-                           const gchar *projectfile)
-{
-  ThreadData *threaddata;
-
-  threaddata = threaddata_new();
-  threaddata->regions =
-                gtk_ltr_families_get_regions(GTK_LTR_FAMILIES(ltrgui->ltrfams));
-  threaddata->filename = g_strdup(projectfile);
-  threaddata->gff3file = g_strndup(projectfile,
-                          strlen(projectfile) - strlen(SQLITE_PATTERN));
-  threaddata->gff3file = g_strconcat(threaddata->gff3file, ".gff3", NULL);
-  threaddata->ltrgui = ltrgui;
-  threaddata->progressbar = ltrgui->progressbar;
-  threaddata->progress = 0;
-  threaddata->regions = regions;
-  threaddata->had_err = 0;
-  threaddata->nodes = nodes;
-  progress_dialog_init(threaddata, ltrgui->main_window);
-
-  if (!g_thread_create(save_and_reload_data_start, (gpointer) threaddata,
-                       FALSE, NULL)) {
-    gt_error_set(ltrgui->err, "Could not create new thread.");
-    error_handle(ltrgui->main_window, ltrgui->err);
-  }
-}
-
 static void save_as_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
 {
   ThreadData *threaddata;
   GtkWidget *filechooser,
             *dialog;
+  GtkLTRFamilies *ltrfams = GTK_LTR_FAMILIES(ltrgui->ltrfams);
+  ProjectIndex *index;
   gchar *filename;
   const gchar *projectfile;
   gboolean bakfile = FALSE;
@@ -895,8 +881,7 @@ static void save_as_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
                                             GTK_RESPONSE_CANCEL,
                                             GTK_STOCK_SAVE, GTK_RESPONSE_ACCEPT,
                                             NULL);
-  projectfile =
-       gtk_ltr_families_get_projectfile(GTK_LTR_FAMILIES(ltrgui->ltrfams));
+  projectfile = gtk_ltr_families_get_projectfile(ltrfams);
   if (projectfile != NULL) {
     gtk_file_chooser_set_filename(GTK_FILE_CHOOSER(filechooser), projectfile);
     gtk_file_chooser_set_current_name(GTK_FILE_CHOOSER(filechooser),
@@ -923,8 +908,6 @@ static void save_as_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
   gtk_widget_destroy(filechooser);
 
   threaddata = threaddata_new();
-  threaddata->regions =
-                gtk_ltr_families_get_regions(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   threaddata->tmp_filename = NULL;
   if (g_file_test(filename, G_FILE_TEST_EXISTS)) {
     gchar buffer[BUFSIZ];
@@ -952,52 +935,212 @@ static void save_as_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
   threaddata->save_as = TRUE;
   threaddata->bakfile = bakfile;
   threaddata->had_err = 0;
-  threaddata->nodes = gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams));
-  threaddata->rdb = gtk_ltr_families_get_rdb(GTK_LTR_FAMILIES(ltrgui->ltrfams));
-  threaddata->gff3file = g_strndup(threaddata->filename,
-                          strlen(threaddata->filename) - strlen(SQLITE_PATTERN));
-  threaddata->gff3file = g_strconcat(threaddata->gff3file, ".gff3", NULL);
+  gtk_ltr_families_sync_family_names(ltrfams);
+  threaddata->nodes = copy_node_array(gtk_ltr_families_get_nodes(ltrfams),
+                                   gtk_ltr_families_get_memory_usage(ltrfams));
+  threaddata->regions = copy_node_array(gtk_ltr_families_get_regions(ltrfams),
+                                        NULL);
+  threaddata->rdb = gtk_ltr_families_get_rdb(ltrfams);
+  threaddata->features = gtk_ltr_families_get_features(ltrfams);
+  index = gtk_ltr_families_get_index(ltrfams);
+  if (index) {
+    threaddata->index = project_index_ref(index);
+    threaddata->unloaded = project_index_get_unloaded(index);
+  }
+  threaddata->gff3file = project_gff3_file(threaddata->filename, TRUE);
+  threaddata->perf = perf_log_new(PERF_JOB_SAVE_AS);
   progress_dialog_init(threaddata, ltrgui->main_window);
 
+  gtk_ltr_families_hold_candidates(ltrfams);
   if (!g_thread_create(save_as_start, (gpointer) threaddata,
                        FALSE, NULL)) {
     gt_error_set(ltrgui->err,
                 "Could not create new thread.");
     error_handle(ltrgui->main_window, ltrgui->err);
+    gtk_ltr_families_release_candidates(ltrfams);
   }
 }
 
-void menubar_save_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
+/* writes a snapshot of <nodes> and <regions> to the GFF3 file belonging to
+   <projectfile> in the background. The caller has to set the <ltrfams> and
+   <generation> members of the returned job before returning to the main loop,
+   they are only used by save_project_data_finished() */
+static ThreadData* save_project_data_run(GUIData *ltrgui, GtArray *nodes,
+                                         GtArray *regions,
+                                         ProjectIndex *index,
+                                         const gchar *projectfile,
+                                         GtRDB *rdb, const gchar *text)
 {
   ThreadData *threaddata;
-  gchar *projectfile;
 
-  projectfile =
-            gtk_ltr_families_get_projectfile(GTK_LTR_FAMILIES(ltrgui->ltrfams));
-  gt_assert(projectfile);
+  ltrgui->save_in_progress = TRUE;
+  gtk_widget_set_sensitive(ltrgui->menubar_save, FALSE);
 
   threaddata = threaddata_new();
-  threaddata->filename = projectfile;
   threaddata->ltrgui = ltrgui;
-  threaddata->regions =
-                gtk_ltr_families_get_regions(GTK_LTR_FAMILIES(ltrgui->ltrfams));
+  threaddata->filename = g_strdup(projectfile);
+  /* the candidates are copied here in the main thread, so editing can go on
+     while the copy is written and the file shows the state of this moment;
+     only the candidates changed since the last save are copied again */
+  threaddata->nodes = copy_node_array(nodes,
+                                      gtk_ltr_families_get_memory_usage(
+                                            GTK_LTR_FAMILIES(ltrgui->ltrfams)));
+  threaddata->regions = copy_node_array(regions, NULL);
+  /* candidates of families which were never loaded are copied from the
+     file the project was opened from */
+  if (index) {
+    threaddata->index = project_index_ref(index);
+    threaddata->unloaded = project_index_get_unloaded(index);
+  }
   threaddata->progressbar = ltrgui->progressbar;
   threaddata->save = TRUE;
+  threaddata->background = TRUE;
   threaddata->err = gt_error_new();
   threaddata->progress = 0;
   threaddata->had_err = 0;
-  threaddata->rdb = gtk_ltr_families_get_rdb(GTK_LTR_FAMILIES(ltrgui->ltrfams));
+  threaddata->rdb = rdb;
   gt_assert(threaddata->rdb);
-  threaddata->gff3file = g_strndup(threaddata->filename,
-                          strlen(threaddata->filename) - strlen(SQLITE_PATTERN));
-  threaddata->gff3file = g_strconcat(threaddata->gff3file, ".gff3", NULL);
+  threaddata->gff3file = project_gff3_file(threaddata->filename, TRUE);
+  threaddata->perf = perf_log_new(PERF_JOB_SAVE);
   progress_dialog_init(threaddata, ltrgui->main_window);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar), text);
 
+  /* released by save_project_data_finished(), also if no thread is run */
+  gtk_ltr_families_hold_candidates(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   if (!g_thread_create(save_project_data_start, (gpointer) threaddata,
                        FALSE, NULL)) {
-    gt_error_set(ltrgui->err,"Could not create new thread.");
+    gt_error_set(threaddata->err, "Could not create new thread.");
+    threaddata->had_err = -1;
+    g_idle_add(save_project_data_finished, threaddata);
+  }
+  return threaddata;
+}
+
+static void save_project_data(GUIData *ltrgui, gboolean autosave)
+{
+  ThreadData *threaddata;
+  GtkLTRFamilies *ltrfams = GTK_LTR_FAMILIES(ltrgui->ltrfams);
+  gchar *projectfile;
+
+  projectfile = gtk_ltr_families_get_projectfile(ltrfams);
+  gt_assert(projectfile);
+  if (ltrgui->save_in_progress)
+    return;
+  (void) extract_match_param_sets(ltrgui);
+  gtk_ltr_families_sync_family_names(ltrfams);
+
+  threaddata = save_project_data_run(ltrgui,
+                                     gtk_ltr_families_get_nodes(ltrfams),
+                                     gtk_ltr_families_get_regions(ltrfams),
+                                     gtk_ltr_families_get_index(ltrfams),
+                                     projectfile,
+                                     gtk_ltr_families_get_rdb(ltrfams),
+                                     autosave ? GUI_AUTOSAVING_DATA
+                                              : GUI_SAVING_DATA);
+  threaddata->ltrfams = g_object_ref(ltrfams);
+  threaddata->generation = gtk_ltr_families_get_generation(ltrfams);
+}
+
+void create_new_project(GUIData *ltrgui, GtArray *nodes, GtArray *regions,
+                        GtHashmap *features, unsigned long n_features,
+                        const gchar *projectfile)
+{
+  ThreadData *threaddata,
+             *savedata;
+  GtkLTRFamilies *ltrfams;
+  GtRDB *rdb;
+  unsigned long i;
+  gint had_err = 0;
+
+  rdb = gt_rdb_sqlite_new(projectfile, ltrgui->err);
+  if (!rdb)
+    had_err = -1;
+  if (!had_err) {
+    gtk_ltr_families_set_rdb(rdb, GTK_LTR_FAMILIES(ltrgui->ltrfams));
+    had_err = gtk_project_settings_save_data(GTK_PROJECT_SETTINGS(
+                                                              ltrgui->projset),
+                                             rdb, ltrgui->err);
+  }
+  if (!had_err)
+    had_err = save_gui_settings(ltrgui);
+  if (!had_err)
+    had_err = save_match_param_sets(ltrgui);
+  if (had_err) {
+    gdk_threads_enter();
     error_handle(ltrgui->main_window, ltrgui->err);
+    gdk_threads_leave();
+    for (i = 0; i < gt_array_size(nodes); i++)
+      gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(nodes, i));
+    gt_array_delete(nodes);
+    for (i = 0; i < gt_array_size(regions); i++)
+      gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(regions, i));
+    gt_array_delete(regions);
+    gt_hashmap_delete(features);
+    return;
   }
+
+  /* the wizard pipeline does not deliver its results in genomic order,
+     establish the order the project arrays are kept in from now on */
+  node_array_ensure_sorted(nodes);
+  node_array_ensure_sorted(regions);
+
+  /* the views are built from the wizard results instead of reading them back
+     from the file, the file name is handed over to the families widget */
+  threaddata = threaddata_new();
+  threaddata->ltrgui = ltrgui;
+  threaddata->progressbar = ltrgui->progressbar;
+  threaddata->err = gt_error_new();
+  threaddata->filename = g_strdup(projectfile);
+  threaddata->rdb = rdb;
+  threaddata->nodes = nodes;
+  threaddata->regions = regions;
+  threaddata->features = features;
+  threaddata->n_features = n_features;
+  threaddata->had_err = 0;
+  load_project_views(threaddata);
+  threaddata_delete(threaddata);
+
+  /* the initial save writes a copy of the candidates shown in the views */
+  ltrfams = GTK_LTR_FAMILIES(ltrgui->ltrfams);
+  savedata = save_project_data_run(ltrgui, gtk_ltr_families_get_nodes(ltrfams),
+                                   gtk_ltr_families_get_regions(ltrfams), NULL,
+                                   projectfile, rdb, GUI_SAVING_DATA);
+  savedata->ltrfams = g_object_ref(ltrfams);
+  savedata->generation = gtk_ltr_families_get_generation(ltrfams);
+}
+
+static gboolean autosave_timeout(gpointer data)
+{
+  GUIData *ltrgui = (GUIData*) data;
+  GtkLTRFamilies *ltrfams = GTK_LTR_FAMILIES(ltrgui->ltrfams);
+
+  /* the snapshot is only taken if something was edited since the last save
+     and no other job is working on the data */
+  if (gtk_ltr_families_get_projectfile(ltrfams) &&
+      gtk_ltr_families_get_modified(ltrfams) &&
+      !ltrgui->save_in_progress &&
+      !gtk_widget_get_visible(ltrgui->progressbar))
+    save_project_data(ltrgui, TRUE);
+  return TRUE;
+}
+
+void menubar_autosave_init(GUIData *ltrgui)
+{
+  const gchar *interval;
+  guint64 minutes = 0;
+
+  /* autosave is disabled unless an interval (in minutes) is given */
+  interval = g_getenv(LTRSIFT_AUTOSAVE_ENV);
+  if (interval)
+    minutes = g_ascii_strtoull(interval, NULL, 10);
+  if (minutes > 0)
+    gdk_threads_add_timeout_seconds((guint) minutes * 60, autosave_timeout,
+                                    ltrgui);
+}
+
+void menubar_save_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
+{
+  save_project_data(ltrgui, FALSE);
 }
 
 static void export_gff3_activate(GT_UNUSED GtkMenuItem *menuitem,
@@ -1008,6 +1151,9 @@ static void export_gff3_activate(GT_UNUSED GtkMenuItem *menuitem,
   gchar *filename;
   const gchar *projectfile;
 
+  if (gtk_ltr_families_load_all_families(GTK_LTR_FAMILIES(ltrgui->ltrfams)))
+    return;
+  gtk_ltr_families_sync_family_names(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   nodes = gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   regions = gtk_ltr_families_get_regions(GTK_LTR_FAMILIES(ltrgui->ltrfams));
 
@@ -1095,6 +1241,7 @@ static void open_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
   threaddata->filename = filename;
   threaddata->err = gt_error_new();
   threaddata->open = TRUE;
+  threaddata->perf = perf_log_new(PERF_JOB_OPEN);
   progress_dialog_init(threaddata, ltrgui->main_window);
 
   if (!g_thread_create(open_project_data_start, (gpointer) threaddata,
@@ -1147,11 +1294,40 @@ static void new_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
   gtk_widget_show(ltrgui->assistant);
 }
 
+/* returns TRUE at once if no save is running, else shows a dialog until the
+   save has finished (TRUE) or the user has cancelled waiting (FALSE) */
+gboolean menubar_wait_for_save(GUIData *ltrgui)
+{
+  GtkWidget *dialog;
+  gint response;
+
+  if (!ltrgui->save_in_progress)
+    return TRUE;
+  /* another action is waiting already */
+  if (ltrgui->save_wait_dialog)
+    return FALSE;
+  dialog = gtk_message_dialog_new(GTK_WINDOW(ltrgui->main_window),
+                                  GTK_DIALOG_MODAL |
+                                  GTK_DIALOG_DESTROY_WITH_PARENT,
+                                  GTK_MESSAGE_INFO, GTK_BUTTONS_CANCEL,
+                                  "%s", SAVE_RUNNING_DIALOG);
+  gtk_window_set_title(GTK_WINDOW(dialog), "Information!");
+  gtk_window_set_position(GTK_WINDOW(dialog), GTK_WIN_POS_CENTER_ALWAYS);
+  ltrgui->save_wait_dialog = dialog;
+  response = gtk_dialog_run(GTK_DIALOG(dialog));
+  ltrgui->save_wait_dialog = NULL;
+  gtk_widget_destroy(dialog);
+  return response == GTK_RESPONSE_OK;
+}
+
 static void close_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
 {
   GtkWidget *dialog;
   gint response = GTK_RESPONSE_REJECT;
 
+  /* the project must not be closed while it is written */
+  if (!menubar_wait_for_save(ltrgui))
+    return;
   if (!gtk_ltr_families_get_projectfile(
                                       GTK_LTR_FAMILIES(ltrgui->ltrfams))) {
     dialog = unsaved_changes_dialog(ltrgui, NO_PROJECT_DIALOG);
@@ -1278,6 +1454,7 @@ static void open_recent_activated(GtkRecentChooser *rc, GUIData *ltrgui)
   threaddata->err = gt_error_new();
   threaddata->filename = filename;
   threaddata->open = TRUE;
+  threaddata->perf = perf_log_new(PERF_JOB_OPEN);
   progress_dialog_init(threaddata, ltrgui->main_window);
 
   if (!g_thread_create(open_project_data_start, (gpointer) threaddata,
@@ -1293,6 +1470,9 @@ static void quit_activate(GT_UNUSED GtkMenuItem *menuitem, GUIData *ltrgui)
   GtkWidget *dialog;
   gint response = GTK_RESPONSE_REJECT;
 
+  /* quitting while the project file is written would leave it truncated */
+  if (!menubar_wait_for_save(ltrgui))
+    return;
   if (gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams))) {
     if (!gtk_ltr_families_get_projectfile(
                                         GTK_LTR_FAMILIES(ltrgui->ltrfams))) {
@@ -1334,6 +1514,9 @@ static void export_fasta_activate(GT_UNUSED GtkMenuItem *menuitem,
   const gchar *projectfile,
               *indexname;
 
+  if (gtk_ltr_families_load_all_families(GTK_LTR_FAMILIES(ltrgui->ltrfams)))
+    return;
+  gtk_ltr_families_sync_family_names(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   nodes = gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   indexname = gtk_project_settings_get_indexname(GTK_PROJECT_SETTINGS(projset));
   projectfile =
@@ -1420,12 +1603,106 @@ static void project_settings_activate(GT_UNUSED GtkMenuItem *menuitem,
   gtk_widget_show(ltrgui->projset);
 }
 
+static void project_perf_log_activate(GT_UNUSED GtkMenuItem *menuitem,
+                                      GUIData *ltrgui)
+{
+  GtkWidget *dialog,
+            *sw,
+            *list_view;
+  GtkListStore *store;
+  GtkTreeIter iter;
+  GtRDB *rdb;
+  GtArray *records;
+  PerfLogRecord *record;
+  gchar wall_time[32],
+        cpu_time[32],
+        items[32],
+        throughput[32],
+        *peak_memory;
+  const gchar *titles[] = {PERF_LOG_COLUMN_STARTED, PERF_LOG_COLUMN_JOB,
+                           PERF_LOG_COLUMN_STAGE, PERF_LOG_COLUMN_WALL,
+                           PERF_LOG_COLUMN_CPU, PERF_LOG_COLUMN_ITEMS,
+                           PERF_LOG_COLUMN_THROUGHPUT, PERF_LOG_COLUMN_MEMORY,
+                           PERF_LOG_COLUMN_STATUS};
+  unsigned long i;
+
+  rdb = gtk_ltr_families_get_rdb(GTK_LTR_FAMILIES(ltrgui->ltrfams));
+  if (!rdb) {
+    gt_error_set(ltrgui->err, PERF_LOG_NO_PROJECT_FILE);
+    error_handle(ltrgui->main_window, ltrgui->err);
+    return;
+  }
+  records = perf_log_read(rdb, PERF_LOG_MAX_RECORDS, ltrgui->err);
+  if (!records) {
+    error_handle(ltrgui->main_window, ltrgui->err);
+    return;
+  }
+
+  store = gtk_list_store_new(G_N_ELEMENTS(titles), G_TYPE_STRING,
+                             G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
+                             G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
+                             G_TYPE_STRING, G_TYPE_STRING);
+  for (i = 0; i < gt_array_size(records); i++) {
+    record = (PerfLogRecord*) gt_array_get(records, i);
+    g_snprintf(wall_time, sizeof (wall_time), "%.3f", record->wall_time);
+    g_snprintf(cpu_time, sizeof (cpu_time), "%.3f", record->cpu_time);
+    g_snprintf(items, sizeof (items), "%lu", record->items);
+    if (record->items > 0 && record->wall_time > 0.0)
+      g_snprintf(throughput, sizeof (throughput), "%.1f",
+                 record->items / record->wall_time);
+    else
+      g_strlcpy(throughput, "-", sizeof (throughput));
+    peak_memory = g_format_size_for_display((goffset) record->peak_memory);
+    gtk_list_store_append(store, &iter);
+    gtk_list_store_set(store, &iter,
+                       0, record->started,
+                       1, record->job,
+                       2, record->stage,
+                       3, wall_time,
+                       4, cpu_time,
+                       5, items,
+                       6, throughput,
+                       7, peak_memory,
+                       8, record->failed ? PERF_LOG_FAILED : PERF_LOG_OK,
+                       -1);
+    g_free(peak_memory);
+  }
+  perf_log_records_delete(records);
+
+  list_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+  g_object_unref(store);
+  for (i = 0; i < G_N_ELEMENTS(titles); i++) {
+    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(list_view), -1,
+                                                titles[i],
+                                                gtk_cell_renderer_text_new(),
+                                                "text", (gint) i, NULL);
+  }
+  sw = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(sw),
+                                 GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add(GTK_CONTAINER(sw), list_view);
+
+  dialog = gtk_dialog_new_with_buttons(PERF_LOG_DIALOG_TITLE,
+                                       GTK_WINDOW(ltrgui->main_window),
+                                       GTK_DIALOG_MODAL |
+                                       GTK_DIALOG_DESTROY_WITH_PARENT,
+                                       GTK_STOCK_CLOSE, GTK_RESPONSE_CLOSE,
+                                       NULL);
+  gtk_window_resize(GTK_WINDOW(dialog), 800, 400);
+  gtk_box_pack_start_defaults(GTK_BOX(GTK_DIALOG(dialog)->vbox), sw);
+  gtk_widget_show_all(dialog);
+  gtk_dialog_run(GTK_DIALOG(dialog));
+  gtk_widget_destroy(dialog);
+}
+
 static void project_filter_activate(GT_UNUSED GtkMenuItem *menuitem,
                                     GUIData *ltrgui)
 {
   GtArray *nodes;
   gchar text[BUFSIZ];
 
+  if (gtk_ltr_families_load_all_families(GTK_LTR_FAMILIES(ltrgui->ltrfams)))
+    return;
   nodes = gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams));
   g_snprintf(text, BUFSIZ, LTR_FILTER_APPLY, gt_array_size(nodes));
   gtk_ltr_filter_set_range(GTK_LTR_FILTER(ltrgui->ltrfilt),
@@ -1439,6 +1716,8 @@ static void project_match_activate(GT_UNUSED GtkMenuItem *menuitem,
 {
   GtArray *nodes;
 
+  if (gtk_ltr_families_load_all_families(GTK_LTR_FAMILIES(ltrgui->ltrfams)))
+    return;
   nodes =
     gt_array_ref(gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams)));
   gtk_ltr_families_refseq_match(nodes, GTK_LTR_FAMILIES(ltrgui->ltrfams));
@@ -1447,11 +1726,21 @@ static void project_match_activate(GT_UNUSED GtkMenuItem *menuitem,
 static void project_orf_activate(GT_UNUSED GtkMenuItem *menuitem,
                                  GUIData *ltrgui)
 {
-  GtArray *nodes =
-      gt_array_ref(gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams)));
+  GtArray *nodes;
+
+  if (gtk_ltr_families_load_all_families(GTK_LTR_FAMILIES(ltrgui->ltrfams)))
+    return;
+  nodes =
+    gt_array_ref(gtk_ltr_families_get_nodes(GTK_LTR_FAMILIES(ltrgui->ltrfams)));
   gtk_ltr_families_orffind(nodes, GTK_LTR_FAMILIES(ltrgui->ltrfams));
 }
 
+static void project_flcands_activate(GT_UNUSED GtkMenuItem *menuitem,
+                                     GUIData *ltrgui)
+{
+  gtk_ltr_families_recompute_fl_cands(GTK_LTR_FAMILIES(ltrgui->ltrfams));
+}
+
 void menubar_init(GUIData *ltrgui)
 {
   GtkWidget *rc, *menu, *menuitem, *submenu;
@@ -1651,6 +1940,18 @@ void menubar_init(GUIData *ltrgui)
                    G_CALLBACK(project_orf_activate), ltrgui);
   gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
 
+  menuitem = gtk_menu_item_new_with_mnemonic("Full _length candidates...");
+  g_object_set_data(G_OBJECT(menuitem),
+                    STATUSBAR_MENU_HINT,
+                    (gpointer) STATUSBAR_MENU_HINT_FLCANDS);
+  g_signal_connect(G_OBJECT(menuitem), "enter-notify-event",
+                   G_CALLBACK(statusbar_menuhints), ltrgui);
+  g_signal_connect(G_OBJECT(menuitem), "leave-notify-event",
+                   G_CALLBACK(statusbar_menuhints), ltrgui);
+  g_signal_connect(G_OBJECT(menuitem), "activate",
+                   G_CALLBACK(project_flcands_activate), ltrgui);
+  gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+
   menuitem = gtk_menu_item_new_with_mnemonic("_Settings...");
   g_object_set_data(G_OBJECT(menuitem),
                     STATUSBAR_MENU_HINT,
@@ -1663,6 +1964,18 @@ void menubar_init(GUIData *ltrgui)
                    G_CALLBACK(project_settings_activate), ltrgui);
   gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
 
+  menuitem = gtk_menu_item_new_with_mnemonic("_Performance log...");
+  g_object_set_data(G_OBJECT(menuitem),
+                    STATUSBAR_MENU_HINT,
+                    (gpointer) STATUSBAR_MENU_HINT_PERF_LOG);
+  g_signal_connect(G_OBJECT(menuitem), "enter-notify-event",
+                   G_CALLBACK(statusbar_menuhints), ltrgui);
+  g_signal_connect(G_OBJECT(menuitem), "leave-notify-event",
+                   G_CALLBACK(statusbar_menuhints), ltrgui);
+  g_signal_connect(G_OBJECT(menuitem), "activate",
+                   G_CALLBACK(project_perf_log_activate), ltrgui);
+  gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+
   /* View menu */
   menuitem = gtk_menu_item_new_with_mnemonic("_View");
   menu = gtk_menu_new();
@@ -21,11 +21,16 @@
 
 #include "ltrsift.h"
 
-void first_save_and_reload(GUIData *ltrgui, GtArray *nodes, GtArray *regions,
-                           const gchar *projectfile);
+void create_new_project(GUIData *ltrgui, GtArray *nodes, GtArray *regions,
+                        GtHashmap *features, unsigned long n_features,
+                        const gchar *projectfile);
 
 void menubar_save_activate(GtkMenuItem *menuitem, GUIData *ltrgui);
 
+gboolean menubar_wait_for_save(GUIData *ltrgui);
+
 void menubar_init(GUIData *ltrgui);
 
+void menubar_autosave_init(GUIData *ltrgui);
+
 #endif
@@ -8,10 +8,15 @@
 #define GUI_NAME       "LTRsift"
 #define FAS_PATTERN    ".fas"
 #define GFF3_PATTERN   ".gff3"
+#define GZ_PATTERN     ".gz"
+#define TMP_PATTERN    ".tmp"
 #define ESQ_PATTERN    ".esq"
 #define SQLITE_PATTERN ".ltrsift"
 
 #define LTRSIFT_STYLE_ENV "LTRSIFT_STYLE_FILE"
+#define LTRSIFT_AUTOSAVE_ENV "LTRSIFT_AUTOSAVE_INTERVAL"
+#define LTRSIFT_COMPRESS_ENV "LTRSIFT_COMPRESS_THREADS"
+#define LTRSIFT_MEMORY_ENV "LTRSIFT_MEMORY_BUDGET"
 
 #define GFF3_FILTER_PATTERN "*.gff3"
 #define ESQ_FILTER_PATTERN  "*.esq"
@@ -33,6 +38,8 @@
 #define ATTR_LTRFAM    "ltrfam"
 #define ATTR_PARENT    "Parent"
 #define ATTR_TRNA      "trna"
+#define ATTR_LTRSIM    "ltr_similarity"
+#define ATTR_DUPLICATE "duplicate_of"
 #define FNT_PROTEINM   "protein_match"
 #define FNT_LTR        "long_terminal_repeat"
 #define FNT_PBS        "primer_binding_site"
@@ -97,8 +104,34 @@
 #define TB_FAMS_REMOVE    "Remove families with less than three members"
 #define TB_NB_NEW_FAM     "Search new families for selected candidates"
 #define TB_NB_FL_CANDS    "Determine full length candidates for current family"
+#define TB_NB_LOCATE      "Go to the candidates at a location (seqid:start-end"\
+                          ") or with an ID"
 #define TB_FAMS_REF_MATCH "Match selection against reference sequences"
 
+#define LOCATE_NO_HITS    "No candidates found for '%s'."
+#define LOCATE_INVALID    "'%s' is not a location of the form "\
+                          "seqid:start-end."
+#define LOCATE_TITLE      "Candidates at %s"
+#define LOCATE_CAPTION_SEQID  "Sequence"
+#define LOCATE_CAPTION_START  "Start"
+#define LOCATE_CAPTION_END    "End"
+#define LOCATE_CAPTION_ID     "ID"
+#define LOCATE_CAPTION_FAMILY "Family"
+
+#define OVERVIEW_EXPANDER "Chromosome overview"
+#define OVERVIEW_ZOOM_IN  "Zoom in"
+#define OVERVIEW_ZOOM_OUT "Zoom out"
+#define OVERVIEW_ZOOM_ALL "Show the whole sequence"
+#define OVERVIEW_SEQID    "Sequence shown in the overview"
+#define OVERVIEW_RANGE    "%s:%lu-%lu (%lu candidates on the sequence)"
+#define OVERVIEW_AREA     "Drag to move, scroll to zoom, click a candidate to "\
+                          "select it"
+
+#define DEDUP_TOOLTIP     "Candidates predicted by several GFF3 files are "\
+                          "merged into the best scoring one if they overlap "\
+                          "each other by at least the given percentage of "\
+                          "both lengths"
+
 #define FAMS_RM_DIALOG    "You are about to remove %d family/families. All "\
                           "members (if any) will be unclassified after this "\
                           "action and added to the 'Unclassified' tab.\n\n "\
@@ -108,6 +141,13 @@
 #define NEW_FAM_DIALOG    "Please select at least three candidates for "\
                           "classification"
 
+#define FAMS_STATS_NONE     "Select a family to see its statistics."
+#define FAMS_STATS_UNLOADED "%lu candidates (not loaded yet)"
+#define FAMS_STATS          "%lu candidates\n"\
+                            "Most frequent number of domains: %lu (%lu)\n"\
+                            "Median LTR length: %.1f\n"\
+                            "Median element length: %.1f"
+
 #define CAND_RM_DIALOG "All selected candidates will be deleted from the "\
                        "project. This action cannot be undone!\nAre you sure?"
 #define CAND_UC_DIALOG "All selected members will be unclassified after this "\
@@ -123,11 +163,15 @@
 #define LTR_FAMILIES_FILTER_SELECTION "Filter selection..."
 #define LTR_FAMILIES_MERGE_SELECTION  "Merge selection..."
 #define LTR_FAMILIES_MATCH_SELECTION  "Match selection..."
+#define LTR_FAMILIES_INVERT_SELECTION "Invert selection"
+#define LTR_FAMILIES_SELECT_FLCANDS   "Select full length candidates"
 #define FAMS_EXPORT_SEQS_ONE  "Export sequences (one file)..."
 #define FAMS_EXPORT_SEQS_MULT "Export sequences (multiple files)..."
 #define FAMS_EXPORT_ANNO_ONE  "Export annotation (one file)..."
 #define FAMS_EXPORT_ANNO_MULT "Export annotation (multiple files)..."
 #define FAMS_EXPORT_FLCANDS   "Export _full length candidates only"
+#define FAMS_EXPORT_EXISTING  "%lu of the files to export already exist.\n\n"\
+                              "Do you want to replace them?"
 #define FAMS_EDIT_NAME   "Edit name"
 #define FAMS_REMOVE_SEL  "Remove selection"
 
@@ -171,6 +215,19 @@
 
 #define LTR_FILTER_APPLY "_Run filtering on %lu candidates"
 
+#define LTR_FILTER_STATS    "<small>%.1f us per candidate\n%.1f%% passed " \
+                            "(%lu runs)</small>"
+#define LTR_FILTER_NO_STATS "<small>not run yet</small>"
+
+#define LTR_FILTER_PREVIEW         "%lu of %lu candidates match"
+#define LTR_FILTER_PREVIEW_LOADED  "%lu of %lu loaded candidates match, %lu "\
+                                   "are not loaded"
+#define LTR_FILTER_PREVIEW_RUNNING "Counting matching candidates..."
+#define LTR_FILTER_PREVIEW_NONE    "Select filters to see how many candidates "\
+                                   "match"
+#define LTR_FILTER_PREVIEW_ERROR   "Matching candidates cannot be counted: %s"
+#define LTR_FILTER_PREVIEW_FAMILY  "%s: %lu of %lu"
+
 #define LUA_PATTERN        ".lua"
 #define LUA_FILTER_PATTERN "*.lua"
 
@@ -189,6 +246,8 @@
 #define GUI_DIALOG_OPEN     "Open file..."
 #define GUI_DIALOG_IMPORT   "Import GFF3 file..."
 #define GUI_DIALOG_SAVE_AS  "Save file as..."
+#define GUI_SAVING_DATA     "Saving data"
+#define GUI_AUTOSAVING_DATA "Autosaving data"
 
 /* Information used by gtk_about_dialog */
 #define GUI_VERSION         "1.0.0"
@@ -880,6 +939,8 @@ static const char license[] =           "                    GNU GENERAL PUBLIC
 #define NO_PROJECT_DIALOG       "The data has not been saved as a project yet."\
                                 "\n Do you want to save the data as a project "\
                                 "or discard them?"
+#define SAVE_RUNNING_DIALOG     "The project is being saved.\nPlease wait "\
+                                "until the project file has been written."
 
 /* statusbar_main.h */
 #define STATUSBAR_CONTEXT            "LTRsift"
@@ -902,8 +963,73 @@ static const char license[] =           "                    GNU GENERAL PUBLIC
 #define STATUSBAR_MENU_HINT_FILTER   "Apply filter to the current project."
 #define STATUSBAR_MENU_HINT_MATCH    "Match project data against reference " \
                                      "sequences."
+#define STATUSBAR_MENU_HINT_FLCANDS  "Determine the full length candidates " \
+                                     "of all families."
 #define STATUSBAR_MENU_HINT_COLUMNS  "Show/Hide feature columns."
+#define STATUSBAR_MENU_HINT_PERF_LOG "View the run times of the jobs run "\
+                                     "on the current project."
 #define STATUSBAR_NUM_OF_CANDS       "Total number of candidates: %lu"
+#define STATUSBAR_MEMORY_LABEL       "memorylabel"
+#define STATUSBAR_MEMORY_USAGE       "Memory: %s"
+#define STATUSBAR_MEMORY_EXCEEDED    "Memory: %s (over budget)"
+#define MEMORY_BUDGET_TEXT           "Budget: %s"
+#define MEMORY_NO_BUDGET_TEXT        "No budget set (" LTRSIFT_MEMORY_ENV ")"
+
+/* perf_log.h */
+#define PERF_JOB_CLASSIFY          "Classification"
+#define PERF_JOB_MATCH             "Reference sequence match"
+#define PERF_JOB_ORFFIND           "ORF detection"
+#define PERF_JOB_EXPORT            "Family export"
+#define PERF_JOB_FLCANDS           "Full length candidates"
+#define PERF_JOB_SAVE              "Save"
+#define PERF_JOB_SAVE_AS           "Save as"
+#define PERF_JOB_OPEN              "Open"
+#define PERF_JOB_WIZARD            "Project wizard"
+#define PERF_JOB_FILTER            "Filter"
+#define PERF_STAGE_TOTAL           "Total"
+#define PERF_STAGE_VIEWS           "Updating views"
+#define PERF_STAGE_MATCH           "Matching candidates"
+#define PERF_STAGE_ENCSEQ          "Loading sequences"
+#define PERF_STAGE_ORFS            "Detecting ORFs"
+#define PERF_STAGE_EXPORT          "Exporting families"
+#define PERF_STAGE_FLCANDS         "Determining full length candidates"
+#define PERF_STAGE_WRITE           "Writing data"
+#define PERF_STAGE_LOAD            "Loading candidates"
+#define PERF_STAGE_FILTER          "Filtering"
+#define PERF_STAGE_ACTION          "Applying action"
+#define PERF_LOG_MAX_RECORDS       1000
+#define PERF_LOG_DIALOG_TITLE      "Performance log"
+#define PERF_LOG_NO_PROJECT_FILE   "The project has not been saved yet, so no "\
+                                   "performance log is available."
+#define PERF_LOG_COLUMN_STARTED    "Started"
+#define PERF_LOG_COLUMN_JOB        "Job"
+#define PERF_LOG_COLUMN_STAGE      "Stage"
+#define PERF_LOG_COLUMN_WALL       "Wall time (s)"
+#define PERF_LOG_COLUMN_CPU        "CPU time (s)"
+#define PERF_LOG_COLUMN_ITEMS      "Items"
+#define PERF_LOG_COLUMN_THROUGHPUT "Items/s"
+#define PERF_LOG_COLUMN_MEMORY     "Peak memory"
+#define PERF_LOG_COLUMN_STATUS     "Status"
+#define PERF_LOG_OK                "OK"
+#define PERF_LOG_FAILED            "Failed"
+
+/* job_progress.h */
+#define JOB_PROGRESS_TEXT          "%s (%u/%u): %lu/%lu, %.1f/s, %s left"
+#define JOB_PROGRESS_TEXT_NO_TOTAL "%s (%u/%u): %lu, %.1f/s, %s left"
+#define JOB_PROGRESS_TEXT_INDETERMINATE "%s (%u/%u)"
+#define JOB_PROGRESS_NO_ETA        "?"
+#define WIZARD_STAGE_READ          "Reading candidates"
+#define WIZARD_STAGE_DEDUP         "Merging overlapping candidates"
+#define WIZARD_STAGE_CLUSTER       "Clustering features"
+#define WIZARD_STAGE_CLASSIFY      "Classifying candidates"
+#define WIZARD_STAGE_BUILD         "Building candidate list"
+#define WIZARD_STAGE_FLCANDS       "Determining full length candidates"
+#define WIZARD_WEIGHT_READ         1.0
+#define WIZARD_WEIGHT_DEDUP        0.5
+#define WIZARD_WEIGHT_CLUSTER      20.0
+#define WIZARD_WEIGHT_CLASSIFY     4.0
+#define WIZARD_WEIGHT_BUILD        1.0
+#define WIZARD_WEIGHT_FLCANDS      1.0
 
 /* Misc */
 #define DEFAULT_STYLE "/usr/share/ltrsift/default.style"
@@ -0,0 +1,353 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sys/resource.h>
+#include "message_strings.h"
+#include "perf_log.h"
+
+typedef struct {
+  gchar *name;
+  gdouble wall_time,
+          cpu_time;
+  unsigned long items,
+                peak_memory;
+} PerfLogStage;
+
+struct PerfLog {
+  gchar *job,
+        *started;
+  GTimer *timer;
+  GMutex *mutex;
+  GtArray *stages;
+  gdouble stage_wall_start,
+          stage_cpu_start,
+          cpu_start;
+  gboolean running,
+           finished,
+           failed;
+};
+
+/* user and system time of the process in seconds */
+static gdouble perf_log_cpu_time(void)
+{
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.0;
+  return (gdouble) usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+         (gdouble) usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+/* peak resident set size of the process in bytes */
+static unsigned long perf_log_peak_memory(void)
+{
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return (unsigned long) usage.ru_maxrss * 1024;
+}
+
+PerfLog* perf_log_new(const gchar *job)
+{
+  PerfLog *pl;
+  GTimeVal now;
+
+  gt_assert(job);
+  pl = g_slice_new(PerfLog);
+  pl->job = g_strdup(job);
+  g_get_current_time(&now);
+  pl->started = g_time_val_to_iso8601(&now);
+  pl->stages = gt_array_new(sizeof (PerfLogStage));
+  pl->mutex = g_mutex_new();
+  pl->stage_wall_start = 0.0;
+  pl->cpu_start = pl->stage_cpu_start = perf_log_cpu_time();
+  pl->running = FALSE;
+  pl->finished = FALSE;
+  pl->failed = FALSE;
+  pl->timer = g_timer_new();
+  return pl;
+}
+
+static void perf_log_end_stage(PerfLog *pl)
+{
+  PerfLogStage *stage;
+
+  if (!pl->running)
+    return;
+  stage = (PerfLogStage*) gt_array_get_last(pl->stages);
+  stage->wall_time = g_timer_elapsed(pl->timer, NULL) - pl->stage_wall_start;
+  stage->cpu_time = perf_log_cpu_time() - pl->stage_cpu_start;
+  stage->peak_memory = perf_log_peak_memory();
+  pl->running = FALSE;
+}
+
+void perf_log_stage(PerfLog *pl, const gchar *stage)
+{
+  PerfLogStage new_stage;
+
+  if (!pl || !stage)
+    return;
+  g_mutex_lock(pl->mutex);
+  if (!pl->finished &&
+      (!pl->running ||
+       g_strcmp0(((PerfLogStage*) gt_array_get_last(pl->stages))->name,
+                 stage) != 0)) {
+    perf_log_end_stage(pl);
+    new_stage.name = g_strdup(stage);
+    new_stage.wall_time = new_stage.cpu_time = 0.0;
+    new_stage.items = new_stage.peak_memory = 0;
+    gt_array_add(pl->stages, new_stage);
+    pl->stage_wall_start = g_timer_elapsed(pl->timer, NULL);
+    pl->stage_cpu_start = perf_log_cpu_time();
+    pl->running = TRUE;
+  }
+  g_mutex_unlock(pl->mutex);
+}
+
+void perf_log_add_items(PerfLog *pl, unsigned long items)
+{
+  if (!pl)
+    return;
+  g_mutex_lock(pl->mutex);
+  if (pl->running)
+    ((PerfLogStage*) gt_array_get_last(pl->stages))->items += items;
+  g_mutex_unlock(pl->mutex);
+}
+
+void perf_log_finish(PerfLog *pl, gboolean failed)
+{
+  if (!pl)
+    return;
+  g_mutex_lock(pl->mutex);
+  if (!pl->finished) {
+    perf_log_end_stage(pl);
+    g_timer_stop(pl->timer);
+    pl->finished = TRUE;
+    pl->failed = failed;
+  }
+  g_mutex_unlock(pl->mutex);
+}
+
+static gint perf_log_exec(GtRDB *rdb, const gchar *query, GtError *err)
+{
+  GtRDBStmt *stmt;
+  gint had_err = 0;
+
+  stmt = gt_rdb_prepare(rdb, query, -1, err);
+  if (!stmt || gt_rdb_stmt_exec(stmt, err) < 0)
+    had_err = -1;
+  if (stmt)
+    gt_rdb_stmt_delete(stmt);
+  return had_err;
+}
+
+static gchar* perf_log_quote(const gchar *str)
+{
+  gchar **parts,
+        *quoted;
+
+  parts = g_strsplit(str, "'", -1);
+  quoted = g_strjoinv("''", parts);
+  g_strfreev(parts);
+  return quoted;
+}
+
+static gint perf_log_insert(PerfLog *pl, GtRDB *rdb, PerfLogStage *stage,
+                            GtError *err)
+{
+  gchar *job,
+        *name,
+        *query,
+        wall_time[G_ASCII_DTOSTR_BUF_SIZE],
+        cpu_time[G_ASCII_DTOSTR_BUF_SIZE];
+  gint had_err;
+
+  job = perf_log_quote(pl->job);
+  name = perf_log_quote(stage->name);
+  /* the times are formatted independently of the locale */
+  g_ascii_formatd(wall_time, G_ASCII_DTOSTR_BUF_SIZE, "%.6f",
+                  stage->wall_time);
+  g_ascii_formatd(cpu_time, G_ASCII_DTOSTR_BUF_SIZE, "%.6f",
+                  stage->cpu_time);
+  query = g_strdup_printf("INSERT INTO perf_log (started, job, stage, "
+                          "wall_time, cpu_time, items, peak_memory, failed) "
+                          "VALUES ('%s', '%s', '%s', %s, %s, %lu, %lu, %d)",
+                          pl->started, job, name, wall_time, cpu_time,
+                          stage->items, stage->peak_memory,
+                          pl->failed ? 1 : 0);
+  had_err = perf_log_exec(rdb, query, err);
+  g_free(query);
+  g_free(name);
+  g_free(job);
+  return had_err;
+}
+
+gint perf_log_save(PerfLog *pl, GtRDB *rdb, GtError *err)
+{
+  PerfLogStage *stage,
+               total;
+  unsigned long i;
+  gint had_err;
+
+  gt_assert(pl && rdb && pl->finished);
+  had_err = perf_log_exec(rdb,
+                          "CREATE TABLE IF NOT EXISTS perf_log "
+                          "(id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                           "started TEXT, "
+                           "job TEXT, "
+                           "stage TEXT, "
+                           "wall_time REAL, "
+                           "cpu_time REAL, "
+                           "items INTEGER, "
+                           "peak_memory INTEGER, "
+                           "failed INTEGER)", err);
+  if (had_err)
+    return had_err;
+
+  /* all stages handle the same candidates, so the job handled as many items
+     as its largest stage */
+  total.name = PERF_STAGE_TOTAL;
+  total.wall_time = g_timer_elapsed(pl->timer, NULL);
+  total.cpu_time = perf_log_cpu_time() - pl->cpu_start;
+  total.items = total.peak_memory = 0;
+  if ((had_err = perf_log_exec(rdb, "BEGIN TRANSACTION", err)))
+    return had_err;
+  for (i = 0; !had_err && i < gt_array_size(pl->stages); i++) {
+    stage = (PerfLogStage*) gt_array_get(pl->stages, i);
+    total.items = MAX(total.items, stage->items);
+    total.peak_memory = MAX(total.peak_memory, stage->peak_memory);
+    had_err = perf_log_insert(pl, rdb, stage, err);
+  }
+  if (!had_err) {
+    if (total.peak_memory == 0)
+      total.peak_memory = perf_log_peak_memory();
+    had_err = perf_log_insert(pl, rdb, &total, err);
+  }
+  if (!had_err)
+    had_err = perf_log_exec(rdb, "COMMIT", err);
+  else {
+    GtError *tmp_err = gt_error_new();
+    (void) perf_log_exec(rdb, "ROLLBACK", tmp_err);
+    gt_error_delete(tmp_err);
+  }
+  return had_err;
+}
+
+void perf_log_delete(PerfLog *pl)
+{
+  unsigned long i;
+
+  if (!pl)
+    return;
+  for (i = 0; i < gt_array_size(pl->stages); i++)
+    g_free(((PerfLogStage*) gt_array_get(pl->stages, i))->name);
+  gt_array_delete(pl->stages);
+  g_timer_destroy(pl->timer);
+  g_mutex_free(pl->mutex);
+  g_free(pl->started);
+  g_free(pl->job);
+  g_slice_free(PerfLog, pl);
+}
+
+GtArray* perf_log_read(GtRDB *rdb, unsigned long max_records, GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtArray *records;
+  GtStr *started,
+        *job,
+        *stage;
+  PerfLogRecord record;
+  gchar *query;
+  double wall_time,
+         cpu_time;
+  int failed;
+  gint rval = 0,
+       had_err = 0;
+
+  gt_assert(rdb);
+  records = gt_array_new(sizeof (PerfLogRecord));
+  query = g_strdup_printf("SELECT started, job, stage, wall_time, cpu_time, "
+                          "items, peak_memory, failed FROM perf_log "
+                          "ORDER BY id DESC LIMIT %lu", max_records);
+  stmt = gt_rdb_prepare(rdb, query, -1, err);
+  g_free(query);
+  /* projects without any job logged yet have no table */
+  if (!stmt) {
+    gt_error_unset(err);
+    return records;
+  }
+  started = gt_str_new();
+  job = gt_str_new();
+  stage = gt_str_new();
+  while (!had_err && (rval = gt_rdb_stmt_exec(stmt, err)) == 0) {
+    gt_str_reset(started);
+    gt_str_reset(job);
+    gt_str_reset(stage);
+    had_err = gt_rdb_stmt_get_string(stmt, 0, started, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_string(stmt, 1, job, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_string(stmt, 2, stage, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_double(stmt, 3, &wall_time, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_double(stmt, 4, &cpu_time, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 5, &record.items, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 6, &record.peak_memory, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_int(stmt, 7, &failed, err);
+    if (!had_err) {
+      record.started = g_strdup(gt_str_get(started));
+      record.job = g_strdup(gt_str_get(job));
+      record.stage = g_strdup(gt_str_get(stage));
+      record.wall_time = wall_time;
+      record.cpu_time = cpu_time;
+      record.failed = (failed != 0);
+      gt_array_add(records, record);
+    }
+  }
+  if (rval < 0)
+    had_err = -1;
+  gt_str_delete(stage);
+  gt_str_delete(job);
+  gt_str_delete(started);
+  gt_rdb_stmt_delete(stmt);
+  if (had_err) {
+    perf_log_records_delete(records);
+    return NULL;
+  }
+  return records;
+}
+
+void perf_log_records_delete(GtArray *records)
+{
+  PerfLogRecord *record;
+  unsigned long i;
+
+  if (!records)
+    return;
+  for (i = 0; i < gt_array_size(records); i++) {
+    record = (PerfLogRecord*) gt_array_get(records, i);
+    g_free(record->started);
+    g_free(record->job);
+    g_free(record->stage);
+  }
+  gt_array_delete(records);
+}
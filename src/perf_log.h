@@ -0,0 +1,68 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERF_LOG_H
+#define PERF_LOG_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <PerfLog> records the wall time, CPU time, number of handled items and
+   peak memory of the stages of one job. A stage lasts until the next one is
+   started or the job is finished. The CPU time and the peak memory are those
+   of the whole process, so they include the work of other threads running at
+   the same time. A log can be used from several threads. */
+typedef struct PerfLog PerfLog;
+
+/* One row of the performance log of a project. */
+typedef struct {
+  gchar *started,
+        *job,
+        *stage;
+  gdouble wall_time,
+          cpu_time;
+  unsigned long items,
+                peak_memory;
+  gboolean failed;
+} PerfLogRecord;
+
+/* Returns a new log for the job <job>, the clock starts right away. */
+PerfLog*  perf_log_new(const gchar *job);
+
+/* Ends the current stage and starts the stage <stage>. Nothing is done if
+   the current stage already has the name <stage>. */
+void      perf_log_stage(PerfLog *pl, const gchar *stage);
+
+/* Adds <items> to the number of items handled in the current stage. */
+void      perf_log_add_items(PerfLog *pl, unsigned long items);
+
+/* Ends the current stage and the job. */
+void      perf_log_finish(PerfLog *pl, gboolean failed);
+
+/* Appends the stages of the finished job <pl> and a total for the job to the
+   performance log table of the project <rdb>. */
+gint      perf_log_save(PerfLog *pl, GtRDB *rdb, GtError *err);
+
+void      perf_log_delete(PerfLog *pl);
+
+/* Returns the newest <max_records> rows of the performance log of <rdb> as
+   an array of <PerfLogRecord>s, newest first. */
+GtArray*  perf_log_read(GtRDB *rdb, unsigned long max_records, GtError *err);
+
+void      perf_log_records_delete(GtArray *records);
+
+#endif
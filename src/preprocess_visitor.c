@@ -16,8 +16,8 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <string.h>
 #include "preprocess_visitor.h"
+#include "symbols.h"
 
 struct LTRGuiPreprocessVisitor {
   const GtNodeVisitor parent_instance;
@@ -41,6 +41,7 @@ static int ltrgui_preprocess_visitor_feature_node(GtNodeVisitor *gv,
 {
   LTRGuiPreprocessVisitor *pv;
   const char *fnt = NULL, *clid = NULL, *attr = NULL;
+  FeatureSymbol sym;
   GtFeatureNode *curnode = NULL;
   GtFeatureNodeIterator *fni;
   unsigned long num;
@@ -54,7 +55,8 @@ static int ltrgui_preprocess_visitor_feature_node(GtNodeVisitor *gv,
   fni = gt_feature_node_iterator_new(fn);
   while (!had_err && (curnode = gt_feature_node_iterator_next(fni))) {
     fnt = gt_feature_node_get_type(curnode);
-    if (strcmp(fnt, FNT_LTRRETRO) == 0) {
+    sym = symbols_feature_type(curnode);
+    if (sym == SYMBOL_LTRRETRO) {
       in_ltrretro = true;
       continue;
     }
@@ -62,7 +64,7 @@ static int ltrgui_preprocess_visitor_feature_node(GtNodeVisitor *gv,
                         (clid = gt_feature_node_get_attribute(curnode,
                                                               ATTR_CLUSTID)))) {
       num = *pv->num;
-      if (strcmp(fnt, FNT_PROTEINM) == 0) {
+      if (sym == SYMBOL_PROTEINM) {
         attr = gt_feature_node_get_attribute(curnode, ATTR_PFAMN);
         if (!attr)
           continue;
@@ -70,7 +72,7 @@ static int ltrgui_preprocess_visitor_feature_node(GtNodeVisitor *gv,
           gt_hashmap_add(pv->features, (void*) gt_cstr_dup(attr), (void*) num);
           *pv->num = *pv->num + 1;
         }
-      } else if (strcmp(fnt, FNT_LTR) == 0) {
+      } else if (sym == SYMBOL_LTR) {
         char *tmp;
         if (first_ltr) {
           tmp = gt_cstr_dup("lLTR");
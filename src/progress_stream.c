@@ -0,0 +1,100 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "progress_stream.h"
+
+struct LTRGuiProgressStream {
+  const GtNodeStream parent_instance;
+  GtNodeStream *in_stream;
+  JobProgress *jp;
+  guint stage;
+  unsigned long candidates;
+  bool reads_input,
+       started,
+       ended;
+};
+
+#define ltrgui_progress_stream_cast(GS)\
+        gt_node_stream_cast(ltrgui_progress_stream_class(), GS);
+
+static int ltrgui_progress_stream_next(GtNodeStream *gs, GtGenomeNode **gn,
+                                       GtError *err)
+{
+  LTRGuiProgressStream *ps;
+  int had_err = 0;
+
+  gt_error_check(err);
+  ps = ltrgui_progress_stream_cast(gs);
+
+  had_err = gt_node_stream_next(ps->in_stream, gn, err);
+
+  if (!had_err && *gn) {
+    if (!ps->started) {
+      job_progress_start_stage(ps->jp, ps->stage);
+      ps->started = true;
+    }
+    if (gt_feature_node_try_cast(*gn)) {
+      ps->candidates++;
+      job_progress_add(ps->jp, ps->stage, 1);
+    }
+  } else if (!had_err && ps->reads_input && !ps->ended) {
+    job_progress_set_items(ps->jp, ps->candidates);
+    job_progress_next_stage(ps->jp);
+    ps->ended = true;
+  }
+
+  if (had_err)  {
+    gt_genome_node_delete(*gn);
+    *gn = NULL;
+  }
+  return had_err;
+}
+
+static void ltrgui_progress_stream_free(GtNodeStream *gs)
+{
+  LTRGuiProgressStream *ps = ltrgui_progress_stream_cast(gs);
+  gt_node_stream_delete(ps->in_stream);
+}
+
+const GtNodeStreamClass* ltrgui_progress_stream_class(void)
+{
+  static const GtNodeStreamClass *gsc = NULL;
+  if (!gsc)
+    gsc = gt_node_stream_class_new(sizeof (LTRGuiProgressStream),
+                                   ltrgui_progress_stream_free,
+                                   ltrgui_progress_stream_next);
+  return gsc;
+}
+
+GtNodeStream* ltrgui_progress_stream_new(GtNodeStream *in_stream,
+                                         JobProgress *jp, guint stage,
+                                         bool reads_input)
+{
+  GtNodeStream *gs;
+  LTRGuiProgressStream *ps;
+  gt_assert(in_stream && jp);
+  gs = gt_node_stream_create(ltrgui_progress_stream_class(), false);
+  ps = ltrgui_progress_stream_cast(gs);
+  ps->in_stream = gt_node_stream_ref(in_stream);
+  ps->jp = jp;
+  ps->stage = stage;
+  ps->candidates = 0;
+  ps->reads_input = reads_input;
+  ps->started = false;
+  ps->ended = false;
+  return gs;
+}
@@ -0,0 +1,38 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROGRESS_STREAM_H
+#define PROGRESS_STREAM_H
+
+#include "genometools.h"
+#include "job_progress.h"
+
+typedef struct LTRGuiProgressStream LTRGuiProgressStream;
+
+const GtNodeStreamClass* ltrgui_progress_stream_class(void);
+
+/* Implements the <GtNodeStream> interface. <LTRGuiProgressStream> passes the
+   nodes of <in_stream> on unchanged and counts the candidates as done in
+   <stage> of <jp>, which is started when the first node passes. If
+   <reads_input> is true the stream has to follow the input stream directly:
+   when the input ends, the number of counted candidates is set as the number
+   of items of <jp> and the next stage is started. */
+GtNodeStream* ltrgui_progress_stream_new(GtNodeStream *in_stream,
+                                         JobProgress *jp, guint stage,
+                                         bool reads_input);
+
+#endif
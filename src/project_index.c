@@ -0,0 +1,968 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include "message_strings.h"
+#include "preprocess_stream.h"
+#include "project_index.h"
+#include "symbols.h"
+
+#define PROJECT_INDEX_TERMINATOR "###"
+
+struct ProjectIndex {
+  GtArray *entries,
+          *header;
+  GtHashmap *families,
+            *loaded;
+  GtStrArray *family_order;
+  unsigned long filesize;
+  gchar *sourcefile;
+  gint fd;
+  guint reference_count;
+};
+
+static ProjectIndex* project_index_new(void)
+{
+  ProjectIndex *pi;
+
+  pi = g_slice_new(ProjectIndex);
+  pi->entries = gt_array_new(sizeof (ProjectIndexEntry));
+  pi->header = gt_array_new(sizeof (ProjectIndexEntry));
+  pi->families = gt_hashmap_new(GT_HASH_STRING, NULL,
+                                (GtFree) gt_array_delete);
+  pi->loaded = gt_hashmap_new(GT_HASH_STRING, NULL, NULL);
+  pi->family_order = gt_str_array_new();
+  pi->filesize = 0;
+  pi->sourcefile = NULL;
+  pi->fd = -1;
+  pi->reference_count = 0;
+  return pi;
+}
+
+ProjectIndex* project_index_ref(ProjectIndex *pi)
+{
+  gt_assert(pi);
+  pi->reference_count++;
+  return pi;
+}
+
+static void project_index_add_entry(ProjectIndex *pi, const gchar *family,
+                                    const gchar *seqid, unsigned long start,
+                                    unsigned long end, unsigned long offset,
+                                    unsigned long length)
+{
+  ProjectIndexEntry entry;
+  GtArray *entrynos;
+  unsigned long entryno;
+
+  /* family names and seqids are shared by many entries */
+  entry.family = symbols_intern(family);
+  entry.seqid = symbols_intern(seqid);
+  entry.start = start;
+  entry.end = end;
+  entry.offset = offset;
+  entry.length = length;
+  gt_array_add(pi->entries, entry);
+  entryno = gt_array_size(pi->entries) - 1;
+
+  entrynos = (GtArray*) gt_hashmap_get(pi->families, (void*) entry.family);
+  if (!entrynos) {
+    entrynos = gt_array_new(sizeof (unsigned long));
+    gt_hashmap_add(pi->families, (void*) entry.family, entrynos);
+    if (*family != '\0')
+      gt_str_array_add_cstr(pi->family_order, family);
+  }
+  gt_array_add(entrynos, entryno);
+}
+
+/* lines which do not belong to a candidate (directives, sequence regions)
+   are needed to parse the candidates of any family */
+static void project_index_add_header(ProjectIndex *pi, unsigned long offset,
+                                     unsigned long length)
+{
+  ProjectIndexEntry entry, *last;
+
+  if (gt_array_size(pi->header) > 0) {
+    last = (ProjectIndexEntry*) gt_array_get_last(pi->header);
+    if (last->offset + last->length == offset) {
+      last->length += length;
+      return;
+    }
+  }
+  entry.family = NULL;
+  entry.seqid = NULL;
+  entry.start = entry.end = 0;
+  entry.offset = offset;
+  entry.length = length;
+  gt_array_add(pi->header, entry);
+}
+
+static const gchar* project_index_get_attributes(const gchar *line)
+{
+  const gchar *attributes = line;
+  guint i;
+
+  for (i = 0; i < 8; i++) {
+    if (!(attributes = strchr(attributes, '\t')))
+      return NULL;
+    attributes++;
+  }
+  return attributes;
+}
+
+static gchar* project_index_get_attribute(const gchar *attributes,
+                                          const gchar *key)
+{
+  gchar **attrs,
+        *value = NULL;
+  gsize keylen = strlen(key);
+  guint i;
+
+  attrs = g_strsplit(attributes, ";", -1);
+  for (i = 0; attrs[i] != NULL; i++) {
+    if (strncmp(attrs[i], key, keylen) == 0 && attrs[i][keylen] == '=') {
+      value = g_uri_unescape_string(attrs[i] + keylen + 1, NULL);
+      if (!value)
+        value = g_strdup(attrs[i] + keylen + 1);
+      break;
+    }
+  }
+  g_strfreev(attrs);
+  return value;
+}
+
+static gboolean project_index_has_parent(const gchar *attributes)
+{
+  return (g_str_has_prefix(attributes, ATTR_PARENT "=") ||
+          strstr(attributes, ";" ATTR_PARENT "=") != NULL);
+}
+
+ProjectIndex* project_index_new_from_file(const gchar *gff3file,
+                                          GtError *err)
+{
+  ProjectIndex *pi;
+  FILE *fp;
+  gchar *line = NULL;
+  const gchar *attributes;
+  size_t bufsize = 0;
+  ssize_t len;
+  unsigned long offset = 0;
+  gboolean in_entry = FALSE;
+  gint had_err = 0;
+
+  if (!(fp = g_fopen(gff3file, "r"))) {
+    gt_error_set(err, "Could not open %s: %s", gff3file, g_strerror(errno));
+    return NULL;
+  }
+  pi = project_index_new();
+
+  /* a candidate starts with a feature without parent and ends with the next
+     terminator, everything outside of candidates belongs to the header */
+  while (!had_err && (len = getline(&line, &bufsize, fp)) != -1) {
+    if (g_str_has_prefix(line, PROJECT_INDEX_TERMINATOR) && in_entry) {
+      ((ProjectIndexEntry*) gt_array_get_last(pi->entries))->length += len;
+      in_entry = FALSE;
+    } else if (line[0] == '#' || line[0] == '\n') {
+      in_entry = FALSE;
+      project_index_add_header(pi, offset, len);
+    } else if (!(attributes = project_index_get_attributes(line))) {
+      gt_error_set(err, "Could not index %s: line at offset %lu is not a "
+                        "valid GFF3 line", gff3file, offset);
+      had_err = -1;
+    } else if (project_index_has_parent(attributes)) {
+      if (in_entry)
+        ((ProjectIndexEntry*) gt_array_get_last(pi->entries))->length += len;
+      else
+        project_index_add_header(pi, offset, len);
+    } else {
+      gchar **columns,
+            *seqid,
+            *family,
+            *attrs;
+
+      columns = g_strsplit(line, "\t", 6);
+      attrs = g_strchomp(g_strdup(attributes));
+      if (!(seqid = g_uri_unescape_string(columns[0], NULL)))
+        seqid = g_strdup(columns[0]);
+      if (!(family = project_index_get_attribute(attrs, ATTR_LTRFAM)))
+        family = g_strdup("");
+      project_index_add_entry(pi, family, seqid,
+                              strtoul(columns[3], NULL, 10),
+                              strtoul(columns[4], NULL, 10),
+                              offset, len);
+      in_entry = TRUE;
+      g_free(family);
+      g_free(seqid);
+      g_free(attrs);
+      g_strfreev(columns);
+    }
+    offset += len;
+  }
+  if (!had_err && ferror(fp)) {
+    gt_error_set(err, "Could not read %s: %s", gff3file, g_strerror(errno));
+    had_err = -1;
+  }
+  free(line);
+  fclose(fp);
+
+  if (had_err) {
+    project_index_delete(pi);
+    return NULL;
+  }
+  pi->filesize = offset;
+  return pi;
+}
+
+struct ProjectIndexWriter {
+  ProjectIndex *pi;
+  GtNodeVisitor *gff3_visitor;
+  GtStr *buffer;
+  GtFile *outfp;
+  unsigned long offset;
+  gboolean in_entry,
+           copied;
+};
+
+ProjectIndexWriter* project_index_writer_new(GtFile *outfp)
+{
+  ProjectIndexWriter *piw;
+
+  gt_assert(outfp);
+  piw = g_slice_new(ProjectIndexWriter);
+  piw->pi = project_index_new();
+  piw->buffer = gt_str_new();
+  piw->gff3_visitor = gt_gff3_visitor_new_to_str(piw->buffer);
+  piw->outfp = outfp;
+  piw->offset = 0;
+  piw->in_entry = FALSE;
+  piw->copied = TRUE;
+  return piw;
+}
+
+gint project_index_writer_add_node(ProjectIndexWriter *piw, GtGenomeNode *gn,
+                                   GtError *err)
+{
+  GtFeatureNode *fn;
+  const gchar *output,
+              *family;
+  unsigned long length,
+                headerlength = 0;
+  gint had_err;
+
+  gt_assert(piw && gn);
+  gt_str_reset(piw->buffer);
+  if ((had_err = gt_genome_node_accept(gn, piw->gff3_visitor, err)))
+    return had_err;
+  output = gt_str_get(piw->buffer);
+  length = gt_str_length(piw->buffer);
+  gt_file_xwrite(piw->outfp, (void*) output, length);
+
+  /* directives in front of a candidate (the version line before the first
+     node) belong to the header, just as the lines of a sequence region */
+  if ((fn = gt_feature_node_try_cast(gn))) {
+    while (headerlength < length &&
+           g_str_has_prefix(output + headerlength, "##") &&
+           !g_str_has_prefix(output + headerlength, PROJECT_INDEX_TERMINATOR))
+      headerlength = strchr(output + headerlength, '\n') - output + 1;
+  } else
+    headerlength = length;
+  if (headerlength > 0)
+    project_index_add_header(piw->pi, piw->offset, headerlength);
+  if (headerlength < length) {
+    if (!(family = gt_feature_node_get_attribute(fn, ATTR_LTRFAM)))
+      family = "";
+    project_index_add_entry(piw->pi, family,
+                            gt_str_get(gt_genome_node_get_seqid(gn)),
+                            gt_genome_node_get_start(gn),
+                            gt_genome_node_get_end(gn),
+                            piw->offset + headerlength,
+                            length - headerlength);
+  }
+  piw->in_entry = (headerlength < length);
+  piw->copied = FALSE;
+  piw->offset += length;
+  return 0;
+}
+
+gint project_index_writer_copy_entry(ProjectIndexWriter *piw,
+                                     ProjectIndex *source,
+                                     unsigned long entryno, GtError *err)
+{
+  ProjectIndexEntry *entry;
+  const gchar *terminator = PROJECT_INDEX_TERMINATOR "\n";
+  gint had_err;
+
+  gt_assert(piw && source);
+  /* a terminator keeps the IDs of the copy apart from the IDs assigned by
+     the visitor, it closes the candidate written before */
+  if (!piw->copied) {
+    gt_file_xfputs(terminator, piw->outfp);
+    if (piw->in_entry)
+      ((ProjectIndexEntry*) gt_array_get_last(piw->pi->entries))->length +=
+                                                            strlen(terminator);
+    else
+      project_index_add_header(piw->pi, piw->offset, strlen(terminator));
+    piw->offset += strlen(terminator);
+  }
+  if ((had_err = project_index_copy_entry(source, entryno, piw->outfp, err)))
+    return had_err;
+  entry = project_index_get_entry(source, entryno);
+  project_index_add_entry(piw->pi, entry->family, entry->seqid, entry->start,
+                          entry->end, piw->offset, entry->length);
+  piw->in_entry = TRUE;
+  piw->copied = TRUE;
+  piw->offset += entry->length;
+  return 0;
+}
+
+ProjectIndex* project_index_writer_finish(ProjectIndexWriter *piw)
+{
+  ProjectIndex *pi;
+
+  gt_assert(piw);
+  pi = piw->pi;
+  pi->filesize = piw->offset;
+  piw->pi = NULL;
+  project_index_writer_delete(piw);
+  return pi;
+}
+
+void project_index_writer_delete(ProjectIndexWriter *piw)
+{
+  if (!piw)
+    return;
+  project_index_delete(piw->pi);
+  gt_node_visitor_delete(piw->gff3_visitor);
+  gt_str_delete(piw->buffer);
+  g_slice_free(ProjectIndexWriter, piw);
+}
+
+static gint project_index_exec(GtRDB *rdb, const gchar *query, GtError *err)
+{
+  GtRDBStmt *stmt;
+  gint had_err = 0;
+
+  stmt = gt_rdb_prepare(rdb, query, -1, err);
+  if (!stmt || gt_rdb_stmt_exec(stmt, err) < 0)
+    had_err = -1;
+  if (stmt)
+    gt_rdb_stmt_delete(stmt);
+  return had_err;
+}
+
+static gchar* project_index_quote(const gchar *str)
+{
+  gchar **parts,
+        *quoted;
+
+  parts = g_strsplit(str, "'", -1);
+  quoted = g_strjoinv("''", parts);
+  g_strfreev(parts);
+  return quoted;
+}
+
+static gint project_index_insert(GtRDBStmt *stmt, gint header,
+                                 ProjectIndexEntry *entry, GtError *err)
+{
+  gint had_err;
+
+  had_err = gt_rdb_stmt_reset(stmt, err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_int(stmt, 0, header, err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_string(stmt, 1,
+                                      entry->family ? entry->family : "", err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_string(stmt, 2,
+                                      entry->seqid ? entry->seqid : "", err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_ulong(stmt, 3, entry->start, err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_ulong(stmt, 4, entry->end, err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_ulong(stmt, 5, entry->offset, err);
+  if (!had_err)
+    had_err = gt_rdb_stmt_bind_ulong(stmt, 6, entry->length, err);
+  if (!had_err && gt_rdb_stmt_exec(stmt, err) < 0)
+    had_err = -1;
+  return had_err;
+}
+
+gint project_index_save(ProjectIndex *pi, GtRDB *rdb, GtError *err)
+{
+  GtRDBStmt *stmt = NULL;
+  gchar query[BUFSIZ];
+  unsigned long i;
+  gint had_err;
+
+  gt_assert(pi && rdb);
+  had_err = project_index_exec(rdb,
+                               "CREATE TABLE IF NOT EXISTS gff3_index "
+                               "(header INTEGER, "
+                                "family TEXT, "
+                                "seqid TEXT, "
+                                "startpos INTEGER, "
+                                "endpos INTEGER, "
+                                "fileoffset INTEGER, "
+                                "length INTEGER)", err);
+  if (!had_err)
+    had_err = project_index_exec(rdb,
+                                 "CREATE INDEX IF NOT EXISTS "
+                                 "gff3_index_family ON gff3_index (family)",
+                                 err);
+  if (!had_err)
+    had_err = project_index_exec(rdb,
+                                 "CREATE INDEX IF NOT EXISTS "
+                                 "gff3_index_range ON gff3_index "
+                                 "(seqid, startpos, endpos)", err);
+  if (!had_err)
+    had_err = project_index_exec(rdb,
+                                 "CREATE TABLE IF NOT EXISTS gff3_index_info "
+                                 "(filesize INTEGER)", err);
+  if (had_err)
+    return had_err;
+
+  /* the index is replaced as a whole or not at all */
+  if ((had_err = project_index_exec(rdb, "BEGIN TRANSACTION", err)))
+    return had_err;
+  had_err = project_index_exec(rdb, "DELETE FROM gff3_index", err);
+  if (!had_err)
+    had_err = project_index_exec(rdb, "DELETE FROM gff3_index_info", err);
+  /* all rows are inserted by the same statement, only the values change */
+  if (!had_err &&
+      !(stmt = gt_rdb_prepare(rdb,
+                              "INSERT INTO gff3_index (header, family, seqid, "
+                              "startpos, endpos, fileoffset, length) VALUES "
+                              "(?, ?, ?, ?, ?, ?, ?)", -1, err)))
+    had_err = -1;
+  for (i = 0; !had_err && i < gt_array_size(pi->header); i++)
+    had_err = project_index_insert(stmt, 1,
+                                   (ProjectIndexEntry*) gt_array_get(pi->header,
+                                                                     i),
+                                   err);
+  for (i = 0; !had_err && i < gt_array_size(pi->entries); i++)
+    had_err = project_index_insert(stmt, 0,
+                                   (ProjectIndexEntry*)
+                                              gt_array_get(pi->entries, i),
+                                   err);
+  if (stmt)
+    gt_rdb_stmt_delete(stmt);
+  if (!had_err) {
+    g_snprintf(query, BUFSIZ,
+               "INSERT INTO gff3_index_info (filesize) VALUES (%lu)",
+               pi->filesize);
+    had_err = project_index_exec(rdb, query, err);
+  }
+  if (!had_err)
+    had_err = project_index_exec(rdb, "COMMIT", err);
+  else {
+    GtError *tmp_err = gt_error_new();
+    (void) project_index_exec(rdb, "ROLLBACK", tmp_err);
+    gt_error_delete(tmp_err);
+  }
+  return had_err;
+}
+
+static int project_index_insert_feature(void *key, void *value, void *data,
+                                        GtError *err)
+{
+  gchar *name,
+        *query;
+  gint had_err;
+
+  name = project_index_quote((const gchar*) key);
+  query = g_strdup_printf("INSERT INTO project_features (name, num) VALUES "
+                          "('%s', %lu)", name, (unsigned long) value);
+  had_err = project_index_exec((GtRDB*) data, query, err);
+  g_free(query);
+  g_free(name);
+  return had_err;
+}
+
+gint project_index_save_features(GtRDB *rdb, GtHashmap *features,
+                                 GtError *err)
+{
+  gint had_err;
+
+  gt_assert(rdb && features);
+  had_err = project_index_exec(rdb,
+                               "CREATE TABLE IF NOT EXISTS project_features "
+                               "(name TEXT, num INTEGER)", err);
+  if (!had_err)
+    had_err = project_index_exec(rdb, "DELETE FROM project_features", err);
+  if (!had_err)
+    had_err = gt_hashmap_foreach(features, project_index_insert_feature,
+                                 (void*) rdb, err);
+  return had_err;
+}
+
+static gint project_index_table_exists(GtRDB *rdb, const gchar *table,
+                                       gboolean *exists, GtError *err)
+{
+  GtRDBStmt *stmt;
+  gchar query[BUFSIZ];
+  gint rval;
+
+  g_snprintf(query, BUFSIZ,
+             "SELECT name FROM sqlite_master WHERE type = 'table' AND "
+             "name = '%s'", table);
+  if (!(stmt = gt_rdb_prepare(rdb, query, -1, err)))
+    return -1;
+  rval = gt_rdb_stmt_exec(stmt, err);
+  gt_rdb_stmt_delete(stmt);
+  if (rval < 0)
+    return -1;
+  *exists = (rval == 0);
+  return 0;
+}
+
+static gint project_index_read_entries(ProjectIndex *pi, GtRDB *rdb,
+                                       GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtStr *family,
+        *seqid;
+  gint header,
+       rval = 0,
+       had_err = 0;
+  unsigned long start = 0,
+                end = 0,
+                offset = 0,
+                length = 0;
+
+  stmt = gt_rdb_prepare(rdb,
+                        "SELECT header, family, seqid, startpos, endpos, "
+                        "fileoffset, length FROM gff3_index "
+                        "ORDER BY fileoffset", -1, err);
+  if (!stmt)
+    return -1;
+  family = gt_str_new();
+  seqid = gt_str_new();
+  while (!had_err && (rval = gt_rdb_stmt_exec(stmt, err)) == 0) {
+    gt_str_reset(family);
+    gt_str_reset(seqid);
+    had_err = gt_rdb_stmt_get_int(stmt, 0, &header, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_string(stmt, 1, family, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_string(stmt, 2, seqid, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 3, &start, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 4, &end, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 5, &offset, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 6, &length, err);
+    if (!had_err) {
+      if (header)
+        project_index_add_header(pi, offset, length);
+      else
+        project_index_add_entry(pi, gt_str_get(family), gt_str_get(seqid),
+                                start, end, offset, length);
+    }
+  }
+  if (rval < 0)
+    had_err = -1;
+  gt_str_delete(seqid);
+  gt_str_delete(family);
+  gt_rdb_stmt_delete(stmt);
+  return had_err;
+}
+
+static gint project_index_read_features(GtRDB *rdb, GtHashmap *features,
+                                        unsigned long *n_features,
+                                        gboolean *found, GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtStr *name;
+  unsigned long num = 0;
+  gint rval = 0,
+       had_err = 0;
+
+  *found = FALSE;
+  stmt = gt_rdb_prepare(rdb, "SELECT name, num FROM project_features", -1,
+                        err);
+  if (!stmt)
+    return -1;
+  name = gt_str_new();
+  while (!had_err && (rval = gt_rdb_stmt_exec(stmt, err)) == 0) {
+    gt_str_reset(name);
+    had_err = gt_rdb_stmt_get_string(stmt, 0, name, err);
+    if (!had_err)
+      had_err = gt_rdb_stmt_get_ulong(stmt, 1, &num, err);
+    if (!had_err && !gt_hashmap_get(features, gt_str_get(name))) {
+      gt_hashmap_add(features, gt_cstr_dup(gt_str_get(name)), (void*) num);
+      if (num + 1 > *n_features)
+        *n_features = num + 1;
+    }
+    *found = TRUE;
+  }
+  if (rval < 0)
+    had_err = -1;
+  gt_str_delete(name);
+  gt_rdb_stmt_delete(stmt);
+  return had_err;
+}
+
+ProjectIndex* project_index_new_from_rdb(GtRDB *rdb, const gchar *gff3file,
+                                         GtHashmap *features,
+                                         unsigned long *n_features,
+                                         GtError *err)
+{
+  ProjectIndex *pi = NULL;
+  GtRDBStmt *stmt;
+  GStatBuf statbuf;
+  gboolean exists = FALSE,
+           found = FALSE;
+  unsigned long filesize = 0;
+  gint rval,
+       had_err = 0;
+
+  gt_assert(rdb && gff3file && features && n_features);
+  had_err = project_index_table_exists(rdb, "gff3_index_info", &exists, err);
+  if (!had_err && exists)
+    had_err = project_index_table_exists(rdb, "project_features", &exists,
+                                         err);
+  if (had_err || !exists)
+    return NULL;
+
+  /* the index is only used for exactly the file it was built from, an
+     older LTRsift version might have saved the project in the meantime */
+  if (g_stat(gff3file, &statbuf) != 0) {
+    gt_error_set(err, "Could not access %s: %s", gff3file, g_strerror(errno));
+    return NULL;
+  }
+  if (!(stmt = gt_rdb_prepare(rdb, "SELECT filesize FROM gff3_index_info",
+                              -1, err)))
+    return NULL;
+  rval = gt_rdb_stmt_exec(stmt, err);
+  if (rval == 0)
+    had_err = gt_rdb_stmt_get_ulong(stmt, 0, &filesize, err);
+  else if (rval < 0)
+    had_err = -1;
+  gt_rdb_stmt_delete(stmt);
+  if (had_err || rval != 0 || filesize != (unsigned long) statbuf.st_size)
+    return NULL;
+
+  pi = project_index_new();
+  had_err = project_index_read_entries(pi, rdb, err);
+  if (!had_err)
+    had_err = project_index_read_features(rdb, features, n_features, &found,
+                                          err);
+  if (had_err || !found) {
+    project_index_delete(pi);
+    return NULL;
+  }
+  pi->filesize = filesize;
+  return pi;
+}
+
+gint project_index_set_source(ProjectIndex *pi, const gchar *sourcefile,
+                              gboolean tmpfile, GtError *err)
+{
+  gint fd;
+
+  gt_assert(pi && sourcefile);
+  if ((fd = g_open(sourcefile, O_RDONLY, 0)) == -1) {
+    gt_error_set(err, "Could not open %s: %s", sourcefile, g_strerror(errno));
+    return -1;
+  }
+  /* a temporary file is only accessed through the open descriptor, so it
+     can be removed right away */
+  if (tmpfile)
+    g_unlink(sourcefile);
+  if (pi->fd != -1)
+    close(pi->fd);
+  g_free(pi->sourcefile);
+  pi->fd = fd;
+  pi->sourcefile = g_strdup(sourcefile);
+  return 0;
+}
+
+GtStrArray* project_index_get_families(ProjectIndex *pi)
+{
+  gt_assert(pi);
+  return pi->family_order;
+}
+
+unsigned long project_index_family_size(ProjectIndex *pi, const gchar *family)
+{
+  GtArray *entrynos;
+
+  gt_assert(pi);
+  entrynos = (GtArray*) gt_hashmap_get(pi->families,
+                                       (void*) (family ? family : ""));
+  return entrynos ? gt_array_size(entrynos) : 0;
+}
+
+unsigned long project_index_size(ProjectIndex *pi)
+{
+  gt_assert(pi);
+  return gt_array_size(pi->entries);
+}
+
+gboolean project_index_family_is_loaded(ProjectIndex *pi, const gchar *family)
+{
+  gt_assert(pi);
+  if (!family)
+    family = "";
+  /* families which are not part of the file only exist in memory */
+  if (!gt_hashmap_get(pi->families, (void*) family))
+    return TRUE;
+  return (gt_hashmap_get(pi->loaded, (void*) family) != NULL);
+}
+
+static void project_index_set_loaded(ProjectIndex *pi, const gchar *family)
+{
+  const gchar *interned = symbols_intern(family);
+
+  if (!gt_hashmap_get(pi->loaded, (void*) interned))
+    gt_hashmap_add(pi->loaded, (void*) interned, (void*) interned);
+}
+
+void project_index_unload_family(ProjectIndex *pi, const gchar *family)
+{
+  gt_assert(pi && family);
+  gt_hashmap_remove(pi->loaded, (void*) family);
+}
+
+static int project_index_copy_loaded_family(void *key,
+                                            GT_UNUSED void *value,
+                                            void *data,
+                                            GT_UNUSED GtError *err)
+{
+  ProjectIndex **indices = (ProjectIndex**) data;
+
+  if (project_index_family_is_loaded(indices[1], (const gchar*) key))
+    project_index_set_loaded(indices[0], (const gchar*) key);
+  return 0;
+}
+
+void project_index_copy_loaded(ProjectIndex *to, ProjectIndex *from)
+{
+  ProjectIndex *indices[2];
+
+  gt_assert(to && from);
+  indices[0] = to;
+  indices[1] = from;
+  (void) gt_hashmap_foreach(to->families, project_index_copy_loaded_family,
+                            (void*) indices, NULL);
+}
+
+static gint project_index_copy_range(ProjectIndex *pi, unsigned long offset,
+                                     unsigned long length, GtFile *outfp,
+                                     GtError *err)
+{
+  gchar buffer[BUFSIZ];
+  ssize_t bytes;
+
+  /* pread() does not move a shared file position, the same source is read
+     by the save thread and the main thread at once */
+  while (length > 0) {
+    bytes = pread(pi->fd, buffer, MIN(length, (unsigned long) BUFSIZ),
+                  (off_t) offset);
+    if (bytes <= 0) {
+      gt_error_set(err, "Could not read from %s: %s", pi->sourcefile,
+                   bytes < 0 ? g_strerror(errno) : "unexpected end of file");
+      return -1;
+    }
+    gt_file_xwrite(outfp, buffer, (size_t) bytes);
+    offset += bytes;
+    length -= bytes;
+  }
+  return 0;
+}
+
+static gint project_index_write_family(ProjectIndex *pi, GtArray *entrynos,
+                                       const gchar *filename, GtError *err)
+{
+  ProjectIndexEntry *header,
+                    *entry;
+  GtFile *outfp;
+  unsigned long i = 0,
+                j = 0,
+                n_entries;
+  gint had_err = 0;
+
+  if (!(outfp = gt_file_new(filename, "w", err)))
+    return -1;
+  n_entries = entrynos ? gt_array_size(entrynos) : 0;
+  /* header lines and candidates are written in file order */
+  while (!had_err && (i < gt_array_size(pi->header) || j < n_entries)) {
+    header = i < gt_array_size(pi->header)
+             ? (ProjectIndexEntry*) gt_array_get(pi->header, i) : NULL;
+    entry = j < n_entries
+            ? project_index_get_entry(pi,
+                                *(unsigned long*) gt_array_get(entrynos, j))
+            : NULL;
+    if (header && (!entry || header->offset < entry->offset)) {
+      had_err = project_index_copy_range(pi, header->offset, header->length,
+                                         outfp, err);
+      i++;
+    } else {
+      had_err = project_index_copy_range(pi, entry->offset, entry->length,
+                                         outfp, err);
+      j++;
+    }
+  }
+  gt_file_delete(outfp);
+  return had_err;
+}
+
+gint project_index_read_family(ProjectIndex *pi, const gchar *family,
+                               GtArray *nodes, GtArray **regions,
+                               GtError *err)
+{
+  GtNodeStream *in_stream = NULL,
+               *preprocess_stream = NULL,
+               *array_stream = NULL;
+  GtHashmap *features = NULL;
+  GtGenomeNode *gn = NULL;
+  GError *gerr = NULL;
+  gchar *tmpfile = NULL;
+  unsigned long n_features = 0;
+  gint fd,
+       had_err = 0;
+
+  gt_assert(pi && nodes && pi->fd != -1);
+  if (!family)
+    family = "";
+
+  fd = g_file_open_tmp("ltrsift_XXXXXX", &tmpfile, &gerr);
+  if (fd == -1) {
+    gt_error_set(err, "Could not create temporary file: %s", gerr->message);
+    g_error_free(gerr);
+    return -1;
+  }
+  close(fd);
+  had_err = project_index_write_family(pi,
+                                       (GtArray*) gt_hashmap_get(pi->families,
+                                                               (void*) family),
+                                       tmpfile, err);
+
+  if (!had_err) {
+    in_stream = gt_gff3_in_stream_new_unsorted(1, (const char**) &tmpfile);
+    if (regions) {
+      /* the preprocess stream is only used to collect the regions here */
+      features = gt_hashmap_new(GT_HASH_STRING, gt_free_func, NULL);
+      preprocess_stream = ltrgui_preprocess_stream_new(in_stream, features,
+                                                       &n_features, false,
+                                                       err);
+    }
+    array_stream = gt_array_out_stream_new(preprocess_stream
+                                           ? preprocess_stream : in_stream,
+                                           nodes, err);
+    while (!(had_err = gt_node_stream_next(array_stream, &gn, err)) && gn);
+  }
+  if (!had_err && regions)
+    *regions = ltrgui_preprocess_stream_get_region_nodes(
+                                   (LTRGuiPreprocessStream*) preprocess_stream);
+  if (!had_err)
+    project_index_set_loaded(pi, family);
+
+  gt_node_stream_delete(array_stream);
+  gt_node_stream_delete(preprocess_stream);
+  gt_node_stream_delete(in_stream);
+  if (features)
+    gt_hashmap_delete(features);
+  g_unlink(tmpfile);
+  g_free(tmpfile);
+  return had_err;
+}
+
+GtArray* project_index_get_unloaded(ProjectIndex *pi)
+{
+  ProjectIndexEntry *entry;
+  GtArray *unloaded;
+  unsigned long i;
+
+  gt_assert(pi);
+  unloaded = gt_array_new(sizeof (unsigned long));
+  for (i = 0; i < gt_array_size(pi->entries); i++) {
+    entry = (ProjectIndexEntry*) gt_array_get(pi->entries, i);
+    if (!gt_hashmap_get(pi->loaded, (void*) entry->family))
+      gt_array_add(unloaded, i);
+  }
+  return unloaded;
+}
+
+ProjectIndexEntry* project_index_get_entry(ProjectIndex *pi,
+                                           unsigned long entryno)
+{
+  gt_assert(pi && entryno < gt_array_size(pi->entries));
+  return (ProjectIndexEntry*) gt_array_get(pi->entries, entryno);
+}
+
+gint project_index_copy_entry(ProjectIndex *pi, unsigned long entryno,
+                              GtFile *outfp, GtError *err)
+{
+  ProjectIndexEntry *entry;
+
+  gt_assert(pi && outfp && pi->fd != -1);
+  entry = project_index_get_entry(pi, entryno);
+  return project_index_copy_range(pi, entry->offset, entry->length, outfp,
+                                  err);
+}
+
+gint project_index_entry_cmp(ProjectIndex *pi, unsigned long entryno,
+                             GtGenomeNode *gn)
+{
+  ProjectIndexEntry *entry;
+  GtRange range;
+  gint rval;
+
+  gt_assert(pi && gn);
+  entry = project_index_get_entry(pi, entryno);
+  /* same order as gt_genome_node_cmp(): regions first, then by seqid and
+     range */
+  if (gt_region_node_try_cast(gn))
+    return 1;
+  if ((rval = strcmp(entry->seqid, gt_str_get(gt_genome_node_get_seqid(gn)))))
+    return rval;
+  range = gt_genome_node_get_range(gn);
+  if (entry->start != range.start)
+    return entry->start < range.start ? -1 : 1;
+  if (entry->end != range.end)
+    return entry->end < range.end ? -1 : 1;
+  return 0;
+}
+
+void project_index_delete(ProjectIndex *pi)
+{
+  if (!pi)
+    return;
+  if (pi->reference_count) {
+    pi->reference_count--;
+    return;
+  }
+  if (pi->fd != -1)
+    close(pi->fd);
+  g_free(pi->sourcefile);
+  gt_str_array_delete(pi->family_order);
+  gt_hashmap_delete(pi->loaded);
+  gt_hashmap_delete(pi->families);
+  gt_array_delete(pi->header);
+  gt_array_delete(pi->entries);
+  g_slice_free(ProjectIndex, pi);
+}
@@ -0,0 +1,143 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROJECT_INDEX_H
+#define PROJECT_INDEX_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <ProjectIndex> maps the candidates of a project GFF3 file to the byte
+   ranges they occupy in the (uncompressed) file, by family and by sequence
+   region. It allows to read the candidates of single families from the file
+   and to copy candidates which were never read to a new file. */
+typedef struct ProjectIndex ProjectIndex;
+
+typedef struct {
+  const gchar *family,
+              *seqid;
+  unsigned long start,
+                end,
+                offset,
+                length;
+} ProjectIndexEntry;
+
+/* Scans the uncompressed GFF3 file <gff3file> and returns its index. */
+ProjectIndex*      project_index_new_from_file(const gchar *gff3file,
+                                               GtError *err);
+
+/* Returns the index stored in <rdb> if it matches the uncompressed GFF3 file
+   <gff3file>, or NULL without setting <err> if there is no such index. The
+   feature columns stored with the index are added to <features>. */
+ProjectIndex*      project_index_new_from_rdb(GtRDB *rdb,
+                                              const gchar *gff3file,
+                                              GtHashmap *features,
+                                              unsigned long *n_features,
+                                              GtError *err);
+
+ProjectIndex*      project_index_ref(ProjectIndex *pi);
+
+/* <ProjectIndexWriter> writes a project GFF3 file and builds the index of
+   the written file on the way, so it does not have to be scanned again. */
+typedef struct ProjectIndexWriter ProjectIndexWriter;
+
+/* Returns a writer for the uncompressed GFF3 file <outfp>. */
+ProjectIndexWriter* project_index_writer_new(GtFile *outfp);
+
+/* Writes <gn> in GFF3 format and indexes it. */
+gint               project_index_writer_add_node(ProjectIndexWriter *piw,
+                                                 GtGenomeNode *gn,
+                                                 GtError *err);
+
+/* Copies entry <entryno> of <source> and indexes the copy. */
+gint               project_index_writer_copy_entry(ProjectIndexWriter *piw,
+                                                   ProjectIndex *source,
+                                                   unsigned long entryno,
+                                                   GtError *err);
+
+/* Returns the index of everything written by <piw> and deletes <piw>. */
+ProjectIndex*      project_index_writer_finish(ProjectIndexWriter *piw);
+
+void               project_index_writer_delete(ProjectIndexWriter *piw);
+
+/* Replaces the index stored in <rdb> by <pi>. */
+gint               project_index_save(ProjectIndex *pi, GtRDB *rdb,
+                                      GtError *err);
+
+/* Stores the feature columns <features> which are used together with the
+   index stored in <rdb>. */
+gint               project_index_save_features(GtRDB *rdb,
+                                               GtHashmap *features,
+                                               GtError *err);
+
+/* Candidates are read from <sourcefile>, which has to have the content the
+   index was built from. If <tmpfile> is TRUE, <sourcefile> is removed right
+   away and only read through the descriptor kept by <pi>. */
+gint               project_index_set_source(ProjectIndex *pi,
+                                            const gchar *sourcefile,
+                                            gboolean tmpfile, GtError *err);
+
+/* Returns the names of all families in order of their first occurrence. */
+GtStrArray*        project_index_get_families(ProjectIndex *pi);
+
+unsigned long      project_index_family_size(ProjectIndex *pi,
+                                             const gchar *family);
+
+unsigned long      project_index_size(ProjectIndex *pi);
+
+gboolean           project_index_family_is_loaded(ProjectIndex *pi,
+                                                  const gchar *family);
+
+/* Marks <family> as not loaded, its candidates have to be read again. */
+void               project_index_unload_family(ProjectIndex *pi,
+                                               const gchar *family);
+
+/* Marks the families loaded in <from> as loaded in <to>. */
+void               project_index_copy_loaded(ProjectIndex *to,
+                                             ProjectIndex *from);
+
+/* Reads the candidates of <family> (the unclassified candidates if <family>
+   is NULL) and appends them to <nodes> in file order. The family is marked as
+   loaded. If <regions> is not NULL, it is set to the sequence regions of the
+   file. */
+gint               project_index_read_family(ProjectIndex *pi,
+                                             const gchar *family,
+                                             GtArray *nodes,
+                                             GtArray **regions,
+                                             GtError *err);
+
+/* Returns the numbers of the entries belonging to families which have not
+   been loaded yet, in file order. */
+GtArray*           project_index_get_unloaded(ProjectIndex *pi);
+
+ProjectIndexEntry* project_index_get_entry(ProjectIndex *pi,
+                                           unsigned long entryno);
+
+/* Copies the bytes of entry <entryno> to <outfp>. */
+gint               project_index_copy_entry(ProjectIndex *pi,
+                                            unsigned long entryno,
+                                            GtFile *outfp, GtError *err);
+
+/* Compares entry <entryno> to the genome node <gn> in the order established
+   by gt_genome_node_cmp(). */
+gint               project_index_entry_cmp(ProjectIndex *pi,
+                                           unsigned long entryno,
+                                           GtGenomeNode *gn);
+
+void               project_index_delete(ProjectIndex *pi);
+
+#endif
@@ -16,17 +16,20 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "bgzf.h"
+#include "dedup_stream.h"
 #include "error.h"
 #include "menubar.h"
 #include "message_strings.h"
+#include "progress_stream.h"
 #include "project_wizard.h"
 #include "support.h"
 
 static gboolean project_wizard_finished_job(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
-  GtkWidget *ltrfams = threaddata->ltrgui->ltrfams;
-  (GTK_LTR_FAMILIES(ltrfams))->regions = threaddata->nodes;
+
+  perf_log_stage(threaddata->perf, PERF_STAGE_VIEWS);
   g_source_remove(GPOINTER_TO_INT(
                                g_object_get_data(G_OBJECT(threaddata->window),
                                                  "source_id")));
@@ -35,16 +38,13 @@ static gboolean project_wizard_finished_job(gpointer data)
   if (!threaddata->had_err) {
     gtk_widget_destroy(threaddata->ltrgui->projset);
     threaddata->ltrgui->projset = gtk_project_settings_new(NULL);
-    if (gtk_ltr_assistant_get_classification(
-                            GTK_LTR_ASSISTANT(threaddata->ltrgui->assistant))) {
-      gtk_ltr_families_determine_fl_cands(GTK_LTR_FAMILIES(ltrfams),
-                                          threaddata->ltrtolerance,
-                                          threaddata->lentolerance);
-    }
     extract_project_settings(threaddata->ltrgui);
-    first_save_and_reload(threaddata->ltrgui, threaddata->nodes,
-                          threaddata->regions, threaddata->fullname);
-    create_recently_used_resource(threaddata->fullname);
+    create_new_project(threaddata->ltrgui, threaddata->nodes,
+                       threaddata->regions, threaddata->features,
+                       threaddata->n_features, threaddata->fullname);
+    gtk_ltr_families_log_perf(GTK_LTR_FAMILIES(threaddata->ltrgui->ltrfams),
+                              threaddata->perf, FALSE);
+    threaddata->perf = NULL;
   } else {
     gdk_threads_enter();
     error_handle(threaddata->ltrgui->main_window, threaddata->err);
@@ -55,6 +55,63 @@ static gboolean project_wizard_finished_job(gpointer data)
   return FALSE;
 }
 
+static int add_family_to_flcand_batch(GT_UNUSED void *key, void *value,
+                                      void *data, GT_UNUSED GtError *err)
+{
+  flcand_batch_add((FLCandBatch*) data, (GtArray*) value);
+  return 0;
+}
+
+static void free_family_nodes(void *elem)
+{
+  gt_array_delete((GtArray*) elem);
+}
+
+/* groups the classified candidates by family and marks the full length
+   candidates of each family, before the nodes are shared with the views */
+static int project_wizard_determine_fl_cands(ThreadData *threaddata)
+{
+  GtHashmap *families;
+  FLCandBatch *batch;
+  GtGenomeNode *gn;
+  GtFeatureNode *curnode;
+  GtFeatureNodeIterator *fni;
+  GtArray *fam_nodes;
+  const char *fam;
+  unsigned long i;
+  int had_err;
+
+  families = gt_hashmap_new(GT_HASH_STRING, NULL, free_family_nodes);
+  for (i = 0; i < gt_array_size(threaddata->nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(threaddata->nodes, i);
+    fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
+    curnode = gt_feature_node_iterator_next(fni);
+    fam = gt_feature_node_get_attribute(curnode, ATTR_LTRFAM);
+    if (fam) {
+      fam_nodes = (GtArray*) gt_hashmap_get(families, (void*) fam);
+      if (!fam_nodes) {
+        fam_nodes = gt_array_new(sizeof (GtGenomeNode*));
+        gt_hashmap_add(families, (void*) fam, (void*) fam_nodes);
+      }
+      gt_array_add(fam_nodes, gn);
+    }
+    gt_feature_node_iterator_delete(fni);
+  }
+  /* the families are independent of each other, so they are handled in
+     parallel */
+  batch = flcand_batch_new(threaddata->ltrtolerance, threaddata->lentolerance);
+  had_err = gt_hashmap_foreach(families, add_family_to_flcand_batch,
+                               (void*) batch, threaddata->err);
+  gt_hashmap_delete(families);
+  if (!had_err) {
+    job_progress_next_stage(threaddata->jobprogress);
+    flcand_batch_run(batch, bgzf_default_threads(), &threaddata->progress);
+    (void) flcand_batch_apply(batch, NULL, NULL);
+  }
+  flcand_batch_delete(batch);
+  return had_err;
+}
+
 static gpointer project_wizard_start_job(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
@@ -68,13 +125,21 @@ static gpointer project_wizard_start_job(gpointer data)
   GtStr *tmpdirprefix = NULL;
   GtNodeStream *last_stream = NULL,
                *gff3_in_stream = NULL,
+               *read_progress_stream = NULL,
+               *dedup_stream = NULL,
                *ltr_cluster_stream = NULL,
+               *classify_progress_stream = NULL,
                *ltr_classify_stream = NULL,
+               *build_progress_stream = NULL,
+               *preprocess_stream = NULL,
                *array_out_stream = NULL;
+  JobProgress *jp = threaddata->jobprogress;
   GtEncseqLoader *el = NULL;
   GtEncseq *encseq = NULL;
-  GtArray *nodes;
-  GtHashmap *sel_features = NULL;
+  GtArray *nodes,
+          *regions;
+  GtHashmap *sel_features = NULL,
+            *features = NULL;
   gint psmall = 0,
        plarge = 0,
        i = 0,
@@ -83,7 +148,15 @@ static gpointer project_wizard_start_job(gpointer data)
        *old_gff3 = NULL;
   const char **gff3_files,
              *indexname;
-  gboolean first = TRUE;
+  gboolean first = TRUE,
+           clustering,
+           classification,
+           dedup;
+  guint read_stage,
+        dedup_stage = 0,
+        classify_stage = 0,
+        build_stage = 0;
+  unsigned long classified = 0;
 
   list_view =
           gtk_ltr_assistant_get_list_view_gff3files(GTK_LTR_ASSISTANT(ltrassi));
@@ -113,10 +186,53 @@ static gpointer project_wizard_start_job(gpointer data)
   g_list_foreach(rows, (GFunc) gtk_tree_path_free, NULL);
   g_list_free(rows);
 
+  /* the candidates are counted while they are read, so the later stages
+     know how many candidates they have to handle */
+  clustering = gtk_ltr_assistant_get_clustering(GTK_LTR_ASSISTANT(ltrassi));
+  classification =
+              gtk_ltr_assistant_get_classification(GTK_LTR_ASSISTANT(ltrassi));
+  dedup = gtk_ltr_assistant_get_dedup(GTK_LTR_ASSISTANT(ltrassi));
+  read_stage = job_progress_add_stage(jp, WIZARD_STAGE_READ,
+                                      WIZARD_WEIGHT_READ, JOB_PROGRESS_ITEMS);
+  if (dedup)
+    dedup_stage = job_progress_add_stage(jp, WIZARD_STAGE_DEDUP,
+                                         WIZARD_WEIGHT_DEDUP,
+                                         JOB_PROGRESS_ITEMS);
+  /* the clustering stream does not tell how far it got */
+  if (clustering)
+    (void) job_progress_add_stage(jp, WIZARD_STAGE_CLUSTER,
+                                  WIZARD_WEIGHT_CLUSTER, JOB_PROGRESS_NONE);
+  if (classification) {
+    classify_stage = job_progress_add_stage(jp, WIZARD_STAGE_CLASSIFY,
+                                            WIZARD_WEIGHT_CLASSIFY,
+                                            JOB_PROGRESS_ITEMS);
+    /* every candidate is counted twice by the classification */
+    job_progress_watch_counter(jp, classify_stage, &classified, 2);
+  }
+  if (clustering || classification)
+    build_stage = job_progress_add_stage(jp, WIZARD_STAGE_BUILD,
+                                         WIZARD_WEIGHT_BUILD,
+                                         JOB_PROGRESS_ITEMS);
+  if (classification)
+    job_progress_watch_counter(jp,
+                               job_progress_add_stage(jp, WIZARD_STAGE_FLCANDS,
+                                                      WIZARD_WEIGHT_FLCANDS,
+                                                      JOB_PROGRESS_ITEMS),
+                               &threaddata->progress, 1);
+
   last_stream = gff3_in_stream = gt_gff3_in_stream_new_unsorted(num_of_files,
                                                                 gff3_files);
+  last_stream = read_progress_stream = ltrgui_progress_stream_new(last_stream,
+                                                                  jp,
+                                                                  read_stage,
+                                                                  true);
+  if (dedup)
+    last_stream = dedup_stream = ltrgui_dedup_stream_new(last_stream,
+                gtk_ltr_assistant_get_dedup_overlap(GTK_LTR_ASSISTANT(ltrassi)),
+                gtk_ltr_assistant_get_dedup_flag(GTK_LTR_ASSISTANT(ltrassi)),
+                jp, dedup_stage);
 
-  if (gtk_ltr_assistant_get_clustering(GTK_LTR_ASSISTANT(ltrassi))) {
+  if (clustering) {
     gchar *match_params;
 
     indexname = gtk_ltr_assistant_get_indexname(GTK_LTR_ASSISTANT(ltrassi));
@@ -149,8 +265,7 @@ static gpointer project_wizard_start_job(gpointer data)
                 threaddata->err);
     }
   }
-  if (!threaddata->had_err &&
-      gtk_ltr_assistant_get_classification(GTK_LTR_ASSISTANT(ltrassi))) {
+  if (!threaddata->had_err && classification) {
     GtkTreeView *list_view;
     GtkTreeModel *model;
     GtkTreeSelection *sel;
@@ -184,14 +299,32 @@ static gpointer project_wizard_start_job(gpointer data)
     threaddata->lentolerance = (gfloat)
                        gtk_ltr_assistant_get_lentol(GTK_LTR_ASSISTANT(ltrassi));
 
+    /* the clustering is done once its first candidate arrives */
+    if (ltr_cluster_stream)
+      last_stream = classify_progress_stream =
+                            ltrgui_progress_stream_new(last_stream, jp,
+                                                       classify_stage, false);
     last_stream = ltr_classify_stream = gt_ltr_classify_stream_new(last_stream,
                                                      sel_features,
                                                      fam_prefix,
                                                      &threaddata->current_state,
-                                                     NULL,
+                                                     &classified,
                                                      threaddata->err);
   }
   if (!threaddata->had_err) {
+    /* collect the feature columns on the way, the candidates do not have to
+       be read back from the project file to build the views */
+    features = gt_hashmap_new(GT_HASH_STRING, free_gt_hash_elem, NULL);
+    threaddata->n_features = LTRFAMS_LV_N_COLUMS+1;
+    if (ltr_cluster_stream || ltr_classify_stream)
+      last_stream = build_progress_stream =
+                               ltrgui_progress_stream_new(last_stream, jp,
+                                                          build_stage, false);
+    last_stream = preprocess_stream = ltrgui_preprocess_stream_new(last_stream,
+                                                       features,
+                                                       &threaddata->n_features,
+                                                       FALSE,
+                                                       threaddata->err);
     nodes = gt_array_new(sizeof(GtGenomeNode*));
     last_stream = array_out_stream = gt_array_out_stream_new(last_stream, nodes,
                                                              threaddata->err);
@@ -202,12 +335,23 @@ static gpointer project_wizard_start_job(gpointer data)
     threaddata->had_err = gt_node_stream_pull(last_stream, threaddata->err);
 
   if (!threaddata->had_err) {
-    threaddata->regions =
-                      gtk_ltr_assistant_get_regions(GTK_LTR_ASSISTANT(ltrassi));
+    regions = gtk_ltr_assistant_get_regions(GTK_LTR_ASSISTANT(ltrassi));
+    threaddata->regions = (regions ? gt_array_ref(regions)
+                                   : gt_array_new(sizeof (GtRegionNode*)));
     threaddata->nodes = nodes;
-  }
+    threaddata->features = features;
+    perf_log_add_items(threaddata->perf, gt_array_size(nodes));
+    if (ltr_classify_stream)
+      threaddata->had_err = project_wizard_determine_fl_cands(threaddata);
+  } else
+    gt_hashmap_delete(features);
+  gt_node_stream_delete(preprocess_stream);
+  gt_node_stream_delete(build_progress_stream);
   gt_node_stream_delete(ltr_classify_stream);
+  gt_node_stream_delete(classify_progress_stream);
   gt_node_stream_delete(ltr_cluster_stream);
+  gt_node_stream_delete(dedup_stream);
+  gt_node_stream_delete(read_progress_stream);
   gt_node_stream_delete(gff3_in_stream);
   gt_node_stream_delete(array_out_stream);
   gt_encseq_loader_delete(el);
@@ -220,6 +364,8 @@ static gpointer project_wizard_start_job(gpointer data)
   g_free(tmp_gff3);
   gt_str_delete(tmpdirprefix);
 
+  /* the counters watched by <jp> are gone after this function returns */
+  job_progress_finish(jp);
   g_idle_add(project_wizard_finished_job, data);
   return NULL;
 }
@@ -284,9 +430,10 @@ void project_wizard_apply(GtkAssistant *assistant, GUIData *ltrgui)
   threaddata->projectfile = projectfile;
   threaddata->projectdir = projectdir;
   threaddata->projectw = TRUE;
-  threaddata->n_features = LTRFAMS_LV_N_COLUMS;
   threaddata->current_state = gt_cstr_dup("Starting...");
   threaddata->err = gt_error_new();
+  threaddata->perf = perf_log_new(PERF_JOB_WIZARD);
+  threaddata->jobprogress = job_progress_new();
   progress_dialog_init(threaddata, ltrgui->main_window);
 
   if (!g_thread_create(project_wizard_start_job, (gpointer) threaddata, FALSE,
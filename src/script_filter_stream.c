@@ -16,20 +16,44 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <stdlib.h>
+#include "filter_cache.h"
+#include "filter_pool.h"
+#include "filter_stats.h"
 #include "script_filter_stream.h"
 
+/* the candidates are filtered in blocks of this many candidates, before each
+   block the order of the filters is revised */
+#define SCRIPT_FILTER_BLOCK_SIZE       1000
+/* a filter which never decides the result is still ranked by its cost */
+#define SCRIPT_FILTER_MIN_DECIDES      1e-6
+
 enum {
   SCRIPT_FILTER_AND = 0,
   SCRIPT_FILTER_OR
 };
 
+typedef struct {
+  double rank;
+  unsigned long filter;
+} ScriptFilterRank;
+
 struct LTRGuiScriptFilterStream {
   const GtNodeStream parent_instance;
   GtNodeStream *in_stream;
   GtArray *nodes,
           *filtered_nodes,
-          *script_filters;
+          *scripts,
+          *order,
+          *undecided,
+          *pending,
+          *pending_nodes;
   GtBittab *negate;
+  FilterStats *stats;
+  bool *results,
+       *selected,
+       *batch_results;
+  GTimer *timer;
   int logic;
   bool first_next;
   unsigned long next_index;
@@ -38,55 +62,187 @@ struct LTRGuiScriptFilterStream {
 #define ltrgui_script_filter_stream_cast(GS)\
         gt_node_stream_cast(ltrgui_script_filter_stream_class(), GS);
 
-static int filter_nodes_lua(GtArray *filters, GtFeatureNode *fn,
-                            GtBittab *negate, int logic, bool *select_node,
-                            GtError *err)
+/* the result of a filter (after inverting it) which decides the combined
+   result, so that the remaining filters need not be run */
+static bool script_filter_decisive_result(int logic)
+{
+  return logic == SCRIPT_FILTER_AND;
+}
+
+static int script_filter_rank_cmp(const void *a, const void *b)
+{
+  const ScriptFilterRank *ra = (const ScriptFilterRank*) a,
+                         *rb = (const ScriptFilterRank*) b;
+
+  if (ra->rank != rb->rank)
+    return ra->rank < rb->rank ? -1 : 1;
+  if (ra->filter != rb->filter)
+    return ra->filter < rb->filter ? -1 : 1;
+  return 0;
+}
+
+/* The statistics collected since the last call are added to those of the
+   session and the filters are ordered by their expected cost per decided
+   candidate, i.e. the time per candidate divided by the fraction of
+   candidates for which they decide the result. Cheap filters deciding often
+   come first, filters which have not been run yet before all others. As the
+   filters are combined by the same logic, their order does not change the
+   result. */
+static void script_filter_stream_reorder(LTRGuiScriptFilterStream *sfs)
 {
+  ScriptFilterRank *ranks;
+  FilterStats stats;
+  const gchar *key;
+  unsigned long i, n, decides;
+  bool decisive;
+
+  n = gt_array_size(sfs->scripts);
+  ranks = g_new(ScriptFilterRank, n);
+  decisive = script_filter_decisive_result(sfs->logic);
+  for (i = 0; i < n; i++) {
+    key = (*(FilterScript**) gt_array_get(sfs->scripts, i))->key;
+    filter_stats_add(key, &sfs->stats[i]);
+    sfs->stats[i].runs = sfs->stats[i].passes = 0;
+    sfs->stats[i].seconds = 0.0;
+    filter_stats_get(key, &stats);
+    ranks[i].filter = i;
+    ranks[i].rank = 0.0;
+    if (stats.runs > 0) {
+      decides = stats.passes;
+      if (gt_bittab_bit_is_set(sfs->negate, i) == decisive)
+        decides = stats.runs - stats.passes;
+      ranks[i].rank = (stats.seconds / stats.runs) /
+                      MAX((double) decides / stats.runs,
+                          SCRIPT_FILTER_MIN_DECIDES);
+    }
+  }
+  qsort(ranks, n, sizeof (ScriptFilterRank), script_filter_rank_cmp);
+  gt_array_reset(sfs->order);
+  for (i = 0; i < n; i++)
+    gt_array_add(sfs->order, ranks[i].filter);
+  g_free(ranks);
+}
+
+/* runs filter <i> on the pending candidates (given by their position in the
+   stream) and keeps the results, at once if it has a batch function */
+static int script_filter_stream_run(LTRGuiScriptFilterStream *sfs,
+                                    unsigned long i, unsigned long first,
+                                    GtError *err)
+{
+  FilterScript *fs;
+  GtFeatureNode *fn;
+  unsigned long j, n, pos;
   int had_err = 0;
-  unsigned long i;
-  gt_assert(filters && fn && select_node);
-  gt_error_check(err);
 
-  for (i = 0; !had_err && i < gt_array_size(filters); i++) {
-    bool result;
-    GtScriptFilter *sf = *(GtScriptFilter**) gt_array_get(filters, i);
-    had_err = gt_script_filter_run(sf, fn, &result, err);
+  if ((n = gt_array_size(sfs->pending)) == 0)
+    return 0;
+  fs = *(FilterScript**) gt_array_get(sfs->scripts, i);
+  g_timer_start(sfs->timer);
+  if (fs->batch_filter && batch_filter_has_batch(fs->batch_filter)) {
+    gt_array_reset(sfs->pending_nodes);
+    for (j = 0; j < n; j++) {
+      pos = *(unsigned long*) gt_array_get(sfs->pending, j);
+      fn = *(GtFeatureNode**) gt_array_get(sfs->nodes, pos);
+      gt_array_add(sfs->pending_nodes, fn);
+    }
+    had_err = batch_filter_run(fs->batch_filter,
+                               gt_array_get_space(sfs->pending_nodes), n,
+                               sfs->batch_results, err);
+    for (j = 0; !had_err && j < n; j++) {
+      pos = *(unsigned long*) gt_array_get(sfs->pending, j);
+      sfs->results[pos - first] = sfs->batch_results[j];
+    }
+  } else {
+    for (j = 0; !had_err && j < n; j++) {
+      pos = *(unsigned long*) gt_array_get(sfs->pending, j);
+      fn = *(GtFeatureNode**) gt_array_get(sfs->nodes, pos);
+      if (fs->batch_filter)
+        had_err = batch_filter_run_node(fs->batch_filter, fn,
+                                        &sfs->results[pos - first], err);
+      else
+        had_err = gt_script_filter_run(fs->script_filter, fn,
+                                       &sfs->results[pos - first], err);
+    }
+  }
+  sfs->stats[i].seconds += g_timer_elapsed(sfs->timer, NULL);
+  for (j = 0; !had_err && j < n; j++) {
+    pos = *(unsigned long*) gt_array_get(sfs->pending, j);
+    sfs->stats[i].runs++;
+    if (sfs->results[pos - first])
+      sfs->stats[i].passes++;
+    filter_cache_store(*(GtGenomeNode**) gt_array_get(sfs->nodes, pos),
+                       fs->key, sfs->results[pos - first]);
+  }
+  return had_err;
+}
 
-    if (!had_err) {
-      if (gt_bittab_bit_is_set(negate, i))
+/* The candidates from <first> to <last> - 1 are filtered one filter after
+   the other. Each filter is only run on the candidates which the filters
+   before have not decided and which have changed since they were filtered
+   last. */
+static int filter_nodes_block(LTRGuiScriptFilterStream *sfs,
+                              unsigned long first, unsigned long last,
+                              GtError *err)
+{
+  GtGenomeNode *gn;
+  const gchar *key;
+  unsigned long i, j, k, pos, kept;
+  bool decisive, result;
+  int had_err = 0;
+
+  decisive = script_filter_decisive_result(sfs->logic);
+  gt_array_reset(sfs->undecided);
+  for (pos = first; pos < last; pos++) {
+    sfs->selected[pos - first] = !decisive;
+    gt_array_add(sfs->undecided, pos);
+  }
+  for (j = 0; !had_err && j < gt_array_size(sfs->order) &&
+              gt_array_size(sfs->undecided) > 0; j++) {
+    i = *(unsigned long*) gt_array_get(sfs->order, j);
+    key = (*(FilterScript**) gt_array_get(sfs->scripts, i))->key;
+    gt_array_reset(sfs->pending);
+    for (k = 0; k < gt_array_size(sfs->undecided); k++) {
+      pos = *(unsigned long*) gt_array_get(sfs->undecided, k);
+      gn = *(GtGenomeNode**) gt_array_get(sfs->nodes, pos);
+      if (!filter_cache_lookup(gn, key, &sfs->results[pos - first]))
+        gt_array_add(sfs->pending, pos);
+    }
+    had_err = script_filter_stream_run(sfs, i, first, err);
+
+    /* the candidates decided by this filter need no other filter */
+    for (k = kept = 0; !had_err && k < gt_array_size(sfs->undecided); k++) {
+      pos = *(unsigned long*) gt_array_get(sfs->undecided, k);
+      result = sfs->results[pos - first];
+      if (gt_bittab_bit_is_set(sfs->negate, i))
         result = !result;
-      if (i == 0)
-        *select_node = result;
-      else if (logic == SCRIPT_FILTER_AND) {
-        *select_node = *select_node || result;
-        if (*select_node) {
-          break;
-        }
-      } else if (logic == SCRIPT_FILTER_OR) {
-        *select_node = *select_node && result;
-        if (!*select_node) {
-          break;
-        }
-      }
+      if (result == decisive)
+        sfs->selected[pos - first] = decisive;
+      else
+        *(unsigned long*) gt_array_get(sfs->undecided, kept++) = pos;
     }
+    gt_array_set_size(sfs->undecided, kept);
+  }
+  for (pos = first; !had_err && pos < last; pos++) {
+    if (sfs->selected[pos - first])
+      gt_array_add(sfs->filtered_nodes,
+                   *(GtGenomeNode**) gt_array_get(sfs->nodes, pos));
   }
   return had_err;
 }
 
 static int filter_nodes(LTRGuiScriptFilterStream *sfs, GtError *err)
 {
-  GtGenomeNode *gn;
+  unsigned long first, last;
   int had_err = 0;
-  unsigned long i;
-  bool select_node = false;
-
-  for (i = 0; i < gt_array_size(sfs->nodes); i++) {
-    gn = *(GtGenomeNode**) gt_array_get(sfs->nodes, i);
-    had_err = filter_nodes_lua(sfs->script_filters, (GtFeatureNode*) gn,
-                               sfs->negate, sfs->logic, &select_node, err);
-    if (!had_err && select_node)
-      gt_array_add(sfs->filtered_nodes, gn);
+
+  for (first = 0; !had_err && first < gt_array_size(sfs->nodes);
+       first = last) {
+    last = MIN(first + SCRIPT_FILTER_BLOCK_SIZE, gt_array_size(sfs->nodes));
+    script_filter_stream_reorder(sfs);
+    had_err = filter_nodes_block(sfs, first, last, err);
   }
+  /* the statistics of the last candidates are kept for the next time */
+  script_filter_stream_reorder(sfs);
   return had_err;
 }
 
@@ -140,6 +296,19 @@ static void ltrgui_script_filter_stream_free(GtNodeStream *gs)
     gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(sfs->nodes, i));
   gt_array_delete(sfs->nodes);
   gt_array_delete(sfs->filtered_nodes);
+  /* the scripts are kept loaded for the next time */
+  for (i = 0; i < gt_array_size(sfs->scripts); i++)
+    filter_pool_release(*(FilterScript**) gt_array_get(sfs->scripts, i));
+  gt_array_delete(sfs->scripts);
+  gt_array_delete(sfs->order);
+  gt_array_delete(sfs->undecided);
+  gt_array_delete(sfs->pending);
+  gt_array_delete(sfs->pending_nodes);
+  g_free(sfs->stats);
+  g_free(sfs->results);
+  g_free(sfs->selected);
+  g_free(sfs->batch_results);
+  g_timer_destroy(sfs->timer);
   gt_node_stream_delete(sfs->in_stream);
 }
 
@@ -153,17 +322,19 @@ const GtNodeStreamClass* ltrgui_script_filter_stream_class(void)
   return gsc;
 }
 
-GtNodeStream* ltrgui_script_filter_stream_new(GtNodeStream *in_stream,
-                                              GtStrArray *filter_files,
-                                              GtBittab *negate,
-                                              int logic,
-                                              GtError *err)
+/* <in_stream> is NULL if the nodes are given directly */
+static GtNodeStream* script_filter_stream_create(GtNodeStream *in_stream,
+                                                 GtStrArray *filter_files,
+                                                 GtBittab *negate,
+                                                 int logic,
+                                                 GtError *err)
 {
   GtNodeStream *gs;
   LTRGuiScriptFilterStream *sfs;
+  unsigned long i;
   gs = gt_node_stream_create(ltrgui_script_filter_stream_class(), false);
   sfs = ltrgui_script_filter_stream_cast(gs);
-  sfs->in_stream = gt_node_stream_ref(in_stream);
+  sfs->in_stream = in_stream ? gt_node_stream_ref(in_stream) : NULL;
   sfs->nodes = gt_array_new(sizeof(GtGenomeNode*));
   sfs->filtered_nodes = gt_array_new(sizeof(GtGenomeNode*));
   sfs->logic = logic;
@@ -171,22 +342,63 @@ GtNodeStream* ltrgui_script_filter_stream_new(GtNodeStream *in_stream,
   sfs->next_index = 0;
   sfs->negate = negate;
 
-  int i, j;
-  sfs->script_filters = gt_array_new(sizeof (GtScriptFilter*));
+  sfs->scripts = gt_array_new(sizeof (FilterScript*));
+  sfs->order = gt_array_new(sizeof (unsigned long));
+  sfs->undecided = gt_array_new(sizeof (unsigned long));
+  sfs->pending = gt_array_new(sizeof (unsigned long));
+  sfs->pending_nodes = gt_array_new(sizeof (GtFeatureNode*));
+  sfs->stats = g_new0(FilterStats, gt_str_array_size(filter_files));
+  sfs->results = g_new(bool, SCRIPT_FILTER_BLOCK_SIZE);
+  sfs->selected = g_new(bool, SCRIPT_FILTER_BLOCK_SIZE);
+  sfs->batch_results = g_new(bool, SCRIPT_FILTER_BLOCK_SIZE);
+  sfs->timer = g_timer_new();
+
   for (i = 0; i < gt_str_array_size(filter_files); i++) {
-    GtScriptFilter *sf;
-    sf = gt_script_filter_new(gt_str_array_get(filter_files, i), err);
-    if (!sf) {
-      for (j = 0; j < gt_array_size(sfs->script_filters); j++) {
-        GtScriptFilter *todelete =
-          *(GtScriptFilter**) gt_array_get(sfs->script_filters, j);
-        gt_script_filter_delete(todelete);
-      }
+    FilterScript *fs;
+    if (!(fs = filter_pool_acquire(gt_str_array_get(filter_files, i), err))) {
+      gt_node_stream_delete(gs);
       return NULL;
-      break;
-    } else {
-      gt_array_add(sfs->script_filters, sf);
     }
+    gt_array_add(sfs->scripts, fs);
   }
   return gs;
 }
+
+GtNodeStream* ltrgui_script_filter_stream_new(GtNodeStream *in_stream,
+                                              GtStrArray *filter_files,
+                                              GtBittab *negate,
+                                              int logic,
+                                              GtError *err)
+{
+  gt_assert(in_stream);
+  return script_filter_stream_create(in_stream, filter_files, negate, logic,
+                                     err);
+}
+
+GtNodeStream* ltrgui_script_filter_select_new(GtStrArray *filter_files,
+                                              GtBittab *negate,
+                                              int logic,
+                                              GtError *err)
+{
+  return script_filter_stream_create(NULL, filter_files, negate, logic, err);
+}
+
+int ltrgui_script_filter_select(GtNodeStream *gs, GtArray *nodes,
+                                GtArray *selected, GtError *err)
+{
+  LTRGuiScriptFilterStream *sfs;
+  int had_err;
+
+  gt_error_check(err);
+  gt_assert(gs && nodes && selected);
+  sfs = ltrgui_script_filter_stream_cast(gs);
+  gt_assert(!sfs->in_stream);
+  gt_array_add_array(sfs->nodes, nodes);
+  had_err = filter_nodes(sfs, err);
+  if (!had_err)
+    gt_array_add_array(selected, sfs->filtered_nodes);
+  /* the nodes belong to the caller */
+  gt_array_reset(sfs->nodes);
+  gt_array_reset(sfs->filtered_nodes);
+  return had_err;
+}
@@ -31,4 +31,18 @@ GtNodeStream* ltrgui_script_filter_stream_new(GtNodeStream *in_stream,
                                               int logic,
                                               GtError *err);
 
+/* Returns a stream without input for filtering arrays of nodes with
+   <ltrgui_script_filter_select()>. The filters are loaded once here and kept
+   until the stream is deleted, <negate> must live as long as the stream. */
+GtNodeStream* ltrgui_script_filter_select_new(GtStrArray *filter_files,
+                                              GtBittab *negate,
+                                              int logic,
+                                              GtError *err);
+
+/* Filters <nodes> with the select stream <gs> like the stream does and adds
+   the selected ones to <selected>, in the order of <nodes> and without taking
+   references. The nodes stay with the caller. */
+int ltrgui_script_filter_select(GtNodeStream *gs, GtArray *nodes,
+                                GtArray *selected, GtError *err);
+
 #endif
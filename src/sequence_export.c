@@ -0,0 +1,304 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "message_strings.h"
+#include "sequence_export.h"
+#include "symbols.h"
+
+#define SEQUENCE_EXPORT_WIDTH             50
+#define SEQUENCE_EXPORT_RECORDS_PER_CHUNK 32
+#define SEQUENCE_EXPORT_CHUNKS_PER_THREAD 2
+
+typedef struct {
+  gsize header;
+  unsigned long startpos,
+                endpos;
+  gboolean reverse;
+} SequenceExportRecord;
+
+struct SequenceExport {
+  GtArray *records;
+  GString *headers;
+};
+
+typedef struct {
+  GThreadPool *pool;
+  GMutex *mutex;
+  GCond *cond;
+  SequenceExport *se;
+  GtEncseq *encseq;
+  unsigned long next;
+} SequenceExportJobs;
+
+/* a chunk is a run of consecutive records, formatted as FASTA into <out> by
+   one thread. <out> and <seq> are reused for all runs handled by the chunk */
+typedef struct {
+  SequenceExportJobs *jobs;
+  GString *out;
+  gchar *seq;
+  gsize seqsize;
+  unsigned long first,
+                last;
+  gboolean done;
+  gint had_err;
+  GtError *err;
+} SequenceExportChunk;
+
+SequenceExport* sequence_export_new(void)
+{
+  SequenceExport *se = g_slice_new(SequenceExport);
+
+  se->records = gt_array_new(sizeof (SequenceExportRecord));
+  se->headers = g_string_new(NULL);
+  return se;
+}
+
+void sequence_export_add(SequenceExport *se, const gchar *header,
+                         unsigned long startpos, unsigned long endpos,
+                         gboolean reverse)
+{
+  SequenceExportRecord record;
+
+  gt_assert(se && header && startpos <= endpos);
+  /* all headers share one buffer instead of being allocated one by one */
+  record.header = se->headers->len;
+  record.startpos = startpos;
+  record.endpos = endpos;
+  record.reverse = reverse;
+  g_string_append_len(se->headers, header, (gssize) strlen(header) + 1);
+  gt_array_add(se->records, record);
+}
+
+gint sequence_export_add_nodes(SequenceExport *se, GtArray *nodes,
+                               GtEncseq *encseq, gboolean flcands,
+                               GtError *err)
+{
+  GtStr *seqid;
+  GtGenomeNode *gn;
+  GtFeatureNode *curnode;
+  GtFeatureNodeIterator *fni;
+  GtRange range;
+  char header[BUFSIZ];
+  const char *attr,
+             *id;
+  unsigned long i,
+                seqnum,
+                startpos;
+  gint had_err = 0;
+
+  gt_assert(se && nodes && encseq);
+  for (i = 0; !had_err && i < gt_array_size(nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+    /* the family and the full-length mark are kept at the top level
+       feature */
+    if (flcands &&
+        !gt_feature_node_get_attribute((GtFeatureNode*) gn, ATTR_FULLLEN))
+      continue;
+    fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
+    while ((curnode = gt_feature_node_iterator_next(fni)) &&
+           symbols_feature_type(curnode) != SYMBOL_LTRRETRO);
+    gt_feature_node_iterator_delete(fni);
+    if (!curnode)
+      continue;
+    seqid = gt_genome_node_get_seqid((GtGenomeNode*) curnode);
+    range = gt_genome_node_get_range((GtGenomeNode*) curnode);
+    id = gt_feature_node_get_attribute(curnode, "ID");
+    attr = gt_feature_node_get_attribute((GtFeatureNode*) gn, ATTR_LTRFAM);
+    if (attr)
+      g_snprintf(header, BUFSIZ, "%s_%s_%lu_%lu%c%s", attr, gt_str_get(seqid),
+                 range.start, range.end, id ? '_' : ' ', id ? id : "");
+    else
+      g_snprintf(header, BUFSIZ, "%s_%lu_%lu%c%s", gt_str_get(seqid),
+                 range.start, range.end, id ? '_' : ' ', id ? id : "");
+    if (sscanf(gt_str_get(seqid), "seq%lu", &seqnum) != 1 ||
+        seqnum >= gt_encseq_num_of_sequences(encseq)) {
+      gt_error_set(err, "No sequence found for %s", gt_str_get(seqid));
+      had_err = -1;
+      continue;
+    }
+    startpos = gt_encseq_seqstartpos(encseq, seqnum);
+    sequence_export_add(se, header, startpos + range.start - 1,
+                        startpos + range.end - 1,
+                        gt_feature_node_get_strand(curnode) ==
+                                                           GT_STRAND_REVERSE);
+  }
+  return had_err;
+}
+
+unsigned long sequence_export_size(SequenceExport *se)
+{
+  gt_assert(se);
+  return gt_array_size(se->records);
+}
+
+static gint sequence_export_format(SequenceExportChunk *chunk)
+{
+  SequenceExport *se = chunk->jobs->se;
+  SequenceExportRecord *record;
+  unsigned long i, j,
+                len;
+  gint had_err = 0;
+
+  g_string_truncate(chunk->out, 0);
+  for (i = chunk->first; !had_err && i < chunk->last; i++) {
+    record = (SequenceExportRecord*) gt_array_get(se->records, i);
+    len = record->endpos - record->startpos + 1;
+    if (len > chunk->seqsize) {
+      chunk->seqsize = len;
+      chunk->seq = g_realloc(chunk->seq, chunk->seqsize);
+    }
+    gt_encseq_extract_decoded(chunk->jobs->encseq, chunk->seq,
+                              record->startpos, record->endpos);
+    if (record->reverse)
+      had_err = gt_reverse_complement(chunk->seq, len, chunk->err);
+    if (!had_err) {
+      g_string_append_c(chunk->out, '>');
+      g_string_append(chunk->out, se->headers->str + record->header);
+      g_string_append_c(chunk->out, '\n');
+      for (j = 0; j < len; j += SEQUENCE_EXPORT_WIDTH) {
+        g_string_append_len(chunk->out, chunk->seq + j,
+                            (gssize) MIN(SEQUENCE_EXPORT_WIDTH, len - j));
+        g_string_append_c(chunk->out, '\n');
+      }
+    }
+  }
+  return had_err;
+}
+
+static void sequence_export_worker(gpointer data,
+                                   GT_UNUSED gpointer user_data)
+{
+  SequenceExportChunk *chunk = (SequenceExportChunk*) data;
+  gint had_err;
+
+  had_err = sequence_export_format(chunk);
+
+  g_mutex_lock(chunk->jobs->mutex);
+  chunk->had_err = had_err;
+  chunk->done = TRUE;
+  g_cond_broadcast(chunk->jobs->cond);
+  g_mutex_unlock(chunk->jobs->mutex);
+}
+
+/* assigns the next run of records to <chunk> and starts formatting it, the
+   chunk stays empty if all records have been assigned */
+static void sequence_export_push(SequenceExportJobs *jobs,
+                                 SequenceExportChunk *chunk)
+{
+  chunk->first = jobs->next;
+  chunk->last = MIN(jobs->next + SEQUENCE_EXPORT_RECORDS_PER_CHUNK,
+                    gt_array_size(jobs->se->records));
+  jobs->next = chunk->last;
+  chunk->done = FALSE;
+  chunk->had_err = 0;
+  if (chunk->first == chunk->last)
+    return;
+  if (jobs->pool)
+    g_thread_pool_push(jobs->pool, chunk, NULL);
+  else {
+    chunk->had_err = sequence_export_format(chunk);
+    chunk->done = TRUE;
+  }
+}
+
+gint sequence_export_write(SequenceExport *se, GtEncseq *encseq,
+                           GtFile *outfp, guint num_threads, GtError *err)
+{
+  SequenceExportJobs jobs;
+  SequenceExportChunk *chunks, *chunk;
+  GError *gerr = NULL;
+  guint i, n_chunks;
+  gint had_err = 0;
+
+  gt_assert(se && encseq);
+  if (num_threads == 0)
+    num_threads = 1;
+  jobs.se = se;
+  jobs.encseq = encseq;
+  jobs.next = 0;
+  jobs.pool = NULL;
+  jobs.mutex = g_mutex_new();
+  jobs.cond = g_cond_new();
+  if (num_threads > 1) {
+    jobs.pool = g_thread_pool_new(sequence_export_worker, NULL,
+                                  (gint) num_threads, TRUE, &gerr);
+    if (!jobs.pool) {
+      gt_error_set(err, "Could not create export threads: %s",
+                   gerr->message);
+      g_error_free(gerr);
+      g_mutex_free(jobs.mutex);
+      g_cond_free(jobs.cond);
+      return -1;
+    }
+  }
+
+  n_chunks = num_threads * SEQUENCE_EXPORT_CHUNKS_PER_THREAD;
+  chunks = g_malloc0(n_chunks * sizeof (SequenceExportChunk));
+  for (i = 0; i < n_chunks; i++) {
+    chunks[i].jobs = &jobs;
+    chunks[i].out = g_string_new(NULL);
+    chunks[i].err = gt_error_new();
+  }
+  for (i = 0; i < n_chunks; i++)
+    sequence_export_push(&jobs, &chunks[i]);
+
+  /* the chunks are written in the order the records were assigned to them,
+     as soon as a chunk is written it is refilled with the next run */
+  i = 0;
+  while (!had_err && chunks[i].first < chunks[i].last) {
+    chunk = &chunks[i];
+    g_mutex_lock(jobs.mutex);
+    while (!chunk->done)
+      g_cond_wait(jobs.cond, jobs.mutex);
+    g_mutex_unlock(jobs.mutex);
+    if (chunk->had_err) {
+      gt_error_set(err, "Could not export sequences: %s",
+                   gt_error_get(chunk->err));
+      had_err = -1;
+    }
+    if (!had_err) {
+      gt_file_xwrite(outfp, chunk->out->str, chunk->out->len);
+      sequence_export_push(&jobs, chunk);
+      i = (i + 1) % n_chunks;
+    }
+  }
+
+  /* waits for the chunks still being formatted after an error */
+  if (jobs.pool)
+    g_thread_pool_free(jobs.pool, FALSE, TRUE);
+  for (i = 0; i < n_chunks; i++) {
+    g_string_free(chunks[i].out, TRUE);
+    g_free(chunks[i].seq);
+    gt_error_delete(chunks[i].err);
+  }
+  g_free(chunks);
+  g_mutex_free(jobs.mutex);
+  g_cond_free(jobs.cond);
+
+  return had_err;
+}
+
+void sequence_export_delete(SequenceExport *se)
+{
+  if (!se)
+    return;
+  gt_array_delete(se->records);
+  g_string_free(se->headers, TRUE);
+  g_slice_free(SequenceExport, se);
+}
@@ -0,0 +1,55 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEQUENCE_EXPORT_H
+#define SEQUENCE_EXPORT_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* <SequenceExport> collects the sequence ranges of candidates and writes
+   them as FASTA. The sequences are extracted from the encoded sequence and
+   formatted by several threads, each reusing its own buffers, while the
+   calling thread writes the results in the order the ranges were added. */
+typedef struct SequenceExport SequenceExport;
+
+SequenceExport* sequence_export_new(void);
+
+/* Adds the range from <startpos> to <endpos> (absolute positions in the
+   encoded sequence) with the FASTA header <header>. If <reverse> is TRUE,
+   the reverse complement is written. */
+void            sequence_export_add(SequenceExport *se, const gchar *header,
+                                    unsigned long startpos,
+                                    unsigned long endpos, gboolean reverse);
+
+/* Adds the LTR retrotransposon range of each candidate in <nodes>, only of
+   the full-length candidates if <flcands> is TRUE. */
+gint            sequence_export_add_nodes(SequenceExport *se, GtArray *nodes,
+                                          GtEncseq *encseq, gboolean flcands,
+                                          GtError *err);
+
+unsigned long   sequence_export_size(SequenceExport *se);
+
+/* Writes all ranges added to <se> to <outfp>, extracting them from <encseq>
+   with <num_threads> threads. */
+gint            sequence_export_write(SequenceExport *se, GtEncseq *encseq,
+                                      GtFile *outfp, guint num_threads,
+                                      GtError *err);
+
+void            sequence_export_delete(SequenceExport *se);
+
+#endif
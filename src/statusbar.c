@@ -21,12 +21,18 @@
 
 void statusbar_init(GUIData *ltrgui)
 {
-  GtkWidget *hbox;
+  GtkWidget *hbox,
+            *label;
   gchar msg[BUFSIZ];
   gint id;
 
   ltrgui->statusbar = gtk_statusbar_new();
   ltrgui->progressbar = gtk_progress_bar_new();
+  /* the memory usage is shown at the right end of the status bar */
+  label = gtk_label_new("");
+  gtk_box_pack_end(GTK_BOX(ltrgui->statusbar), label, FALSE, FALSE, 2);
+  g_object_set_data(G_OBJECT(ltrgui->statusbar), STATUSBAR_MEMORY_LABEL,
+                    label);
 
   hbox = gtk_hbox_new(TRUE, 1);
   gtk_box_pack_start(GTK_BOX(hbox), ltrgui->statusbar, FALSE, TRUE, 1);
@@ -52,6 +58,33 @@ void statusbar_set_status(GtkWidget *sb, gchar *status_msg)
   gtk_statusbar_push(GTK_STATUSBAR(sb), id, status_msg);
 }
 
+void statusbar_set_memory_usage(GtkWidget *sb, MemoryUsage *mu)
+{
+  GtkWidget *label;
+  gchar text[BUFSIZ],
+        *size,
+        *details;
+
+  label = (GtkWidget*) g_object_get_data(G_OBJECT(sb), STATUSBAR_MEMORY_LABEL);
+  if (!label)
+    return;
+  if (!mu) {
+    gtk_label_set_text(GTK_LABEL(label), "");
+    gtk_widget_set_tooltip_text(label, NULL);
+    return;
+  }
+  size = g_format_size_for_display((goffset) memory_usage_total(mu));
+  g_snprintf(text, BUFSIZ,
+             memory_usage_exceeded(mu) ? STATUSBAR_MEMORY_EXCEEDED
+                                       : STATUSBAR_MEMORY_USAGE,
+             size);
+  gtk_label_set_text(GTK_LABEL(label), text);
+  details = memory_usage_details(mu);
+  gtk_widget_set_tooltip_text(label, details);
+  g_free(details);
+  g_free(size);
+}
+
 gboolean statusbar_menuhints(GtkMenuItem *menuitem, GdkEvent *event,
                              GUIData *ltrgui)
 {
@@ -20,9 +20,12 @@
 #define STATUSBAR_H
 
 #include "ltrsift.h"
+#include "memory_usage.h"
 
 void     statusbar_set_status(GtkWidget *sb, gchar *status_msg);
 
+void     statusbar_set_memory_usage(GtkWidget *sb, MemoryUsage *mu);
+
 gboolean statusbar_menuhints(GtkMenuItem *menuitem, GdkEvent *event,
                                GUIData *ltrgui);
 
@@ -16,18 +16,20 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include "bgzf.h"
 #include "error.h"
+#include "filter_cache.h"
+#include "flcand.h"
 #include "message_strings.h"
+#include "sequence_export.h"
 #include "support.h"
 
 void delete_gt_genome_node(GtGenomeNode *gn)
 {
-  CandidateData *cdata;
-
-  cdata = gt_genome_node_get_user_data(gn, "cdata");
+  /* the CandidateData belongs to the arena of the project */
   gt_genome_node_release_user_data(gn, "cdata");
-  g_slice_free(CandidateData, cdata);
   gt_genome_node_delete(gn);
 }
 
@@ -152,10 +154,54 @@ GtkWidget* unsaved_changes_dialog(GUIData *ltrgui, const gchar *text)
   return dialog;
 }
 
+static void update_job_progress(ThreadData *threaddata)
+{
+  JobProgressInfo info;
+  gchar *text,
+        *eta;
+
+  job_progress_get(threaddata->jobprogress, &info);
+  if (!info.stage) {
+    gtk_progress_bar_pulse(GTK_PROGRESS_BAR(threaddata->progressbar));
+    return;
+  }
+  perf_log_stage(threaddata->perf, info.stage);
+  if (info.indeterminate) {
+    text = g_strdup_printf(JOB_PROGRESS_TEXT_INDETERMINATE, info.stage,
+                           info.stage_no + 1, info.num_stages);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar), text);
+    gtk_progress_bar_pulse(GTK_PROGRESS_BAR(threaddata->progressbar));
+    g_free(text);
+    return;
+  }
+  eta = (info.eta < 0.0 ? g_strdup(JOB_PROGRESS_NO_ETA)
+                         : job_progress_format_eta(info.eta));
+  if (info.total > 0)
+    text = g_strdup_printf(JOB_PROGRESS_TEXT, info.stage, info.stage_no + 1,
+                           info.num_stages, info.done, info.total,
+                           info.throughput, eta);
+  else
+    text = g_strdup_printf(JOB_PROGRESS_TEXT_NO_TOTAL, info.stage,
+                           info.stage_no + 1, info.num_stages, info.done,
+                           info.throughput, eta);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar), text);
+  gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(threaddata->progressbar),
+                                info.fraction);
+  g_free(text);
+  g_free(eta);
+}
+
 static gboolean update_progress_dialog(gpointer data)
 {
   ThreadData *threaddata = (ThreadData*) data;
 
+  /* the states shown to the user are the stages of the job */
+  if (threaddata->classification && threaddata->current_state)
+    perf_log_stage(threaddata->perf, threaddata->current_state);
+  if (threaddata->jobprogress) {
+    update_job_progress(threaddata);
+    return TRUE;
+  }
   if (threaddata->classification) {
     gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
                               threaddata->current_state);
@@ -165,7 +211,21 @@ static gboolean update_progress_dialog(gpointer data)
   } else if (threaddata->save || threaddata->save_as || threaddata->orf) {
     gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(threaddata->progressbar),
                                   (gdouble) threaddata->progress /
-                                  gt_array_size(threaddata->nodes));
+                                  (gt_array_size(threaddata->nodes) +
+                                   (threaddata->unloaded
+                                    ? gt_array_size(threaddata->unloaded)
+                                    : 0)));
+  } else if (threaddata->famexport) {
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(threaddata->progressbar),
+                                  (gdouble) threaddata->progress /
+                                  MAX(family_export_total(
+                                                     threaddata->famexport),
+                                      1));
+  } else if (threaddata->flcands) {
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(threaddata->progressbar),
+                                  (gdouble) threaddata->progress /
+                                  MAX(flcand_batch_size(threaddata->flcands),
+                                      1));
   } else if (threaddata->projectw) {
     gtk_progress_bar_set_text(GTK_PROGRESS_BAR(threaddata->progressbar),
                               threaddata->current_state);
@@ -181,6 +241,16 @@ void progress_dialog_init(ThreadData *threaddata, GtkWidget *toplevel)
             *vbox;
   guint sid;
 
+  if (threaddata->background) {
+    /* background jobs only report in the status bar, so the user can go on
+       working while they are running */
+    sid = g_timeout_add(50, update_progress_dialog, (gpointer) threaddata);
+    g_object_set_data(G_OBJECT(threaddata->progressbar),
+                      "source_id", GINT_TO_POINTER(sid));
+    gtk_widget_show(threaddata->progressbar);
+    return;
+  }
+
   /* create the modal window which warns the user to wait */
   threaddata->window = gtk_window_new(GTK_WINDOW_POPUP);
   gtk_window_set_transient_for(GTK_WINDOW(threaddata->window),
@@ -210,19 +280,27 @@ void progress_dialog_init(ThreadData *threaddata, GtkWidget *toplevel)
 void threaddata_delete(ThreadData *threaddata)
 {
   if (threaddata->classification) {
-    g_list_foreach(threaddata->references,
-                   (GFunc) gtk_tree_row_reference_free,
-                   NULL);
-    g_list_free(threaddata->references);
     gt_array_delete(threaddata->old_nodes);
     g_free(threaddata->fam_prefix);
     gt_hashmap_delete(threaddata->sel_features);
-  } else if (threaddata->save_as || threaddata->save)
+  } else if (threaddata->save_as || threaddata->save) {
     g_free(threaddata->tmp_filename);
-  else if (threaddata->projectw) {
+    snapshot_node_array_delete(threaddata->nodes);
+    snapshot_node_array_delete(threaddata->regions);
+    if (threaddata->save) {
+      g_free(threaddata->filename);
+      g_free(threaddata->gff3file);
+    }
+  } else if (threaddata->projectw) {
     g_free(threaddata->projectfile);
     g_free(threaddata->projectdir);
   }
+  project_index_delete(threaddata->index);
+  project_index_delete(threaddata->new_index);
+  if (threaddata->unloaded)
+    gt_array_delete(threaddata->unloaded);
+  perf_log_delete(threaddata->perf);
+  job_progress_delete(threaddata->jobprogress);
   gt_free(threaddata->current_state);
   gt_error_delete(threaddata->err);
   g_slice_free(ThreadData, threaddata);
@@ -240,7 +318,6 @@ ThreadData* threaddata_new()
   threaddata->dialog = NULL;
   threaddata->blastn_refseq = NULL;
   threaddata->list_view = NULL;
-  threaddata->references = NULL;
   threaddata->nodes = NULL;
   threaddata->old_nodes = NULL;
   threaddata->new_nodes = NULL;
@@ -269,9 +346,18 @@ ThreadData* threaddata_new()
   threaddata->n_features = 0;
   threaddata->set_id = GT_UNDEF_ULONG;
   threaddata->use_paramset = FALSE;
+  threaddata->background = FALSE;
+  threaddata->generation = 0;
   threaddata->rdb = NULL;
   threaddata->adb = NULL;
   threaddata->fi = NULL;
+  threaddata->index = NULL;
+  threaddata->new_index = NULL;
+  threaddata->famexport = NULL;
+  threaddata->flcands = NULL;
+  threaddata->perf = NULL;
+  threaddata->jobprogress = NULL;
+  threaddata->unloaded = NULL;
 
   return threaddata;
 }
@@ -426,6 +512,393 @@ GtArray* create_region_nodes_from_node_array(GtArray *nodes)
   return region_nodes;
 }
 
+GtArray* snapshot_node_array(GtArray *nodes)
+{
+  GtArray *snapshot;
+  GtGenomeNode *gn;
+  unsigned long i;
+
+  /* the snapshot only copies the node pointers, the extra reference keeps a
+     node alive if it is deleted from the project while the snapshot is used */
+  snapshot = gt_array_new(sizeof (GtGenomeNode*));
+  if (!nodes)
+    return snapshot;
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    gn = gt_genome_node_ref(*(GtGenomeNode**) gt_array_get(nodes, i));
+    gt_array_add(snapshot, gn);
+  }
+  return snapshot;
+}
+
+static GtStr* copy_seqid(GtStr *seqid, GtHashmap *seqids)
+{
+  GtStr *copy;
+
+  if (!(copy = gt_hashmap_get(seqids, seqid))) {
+    copy = gt_str_clone(seqid);
+    gt_hashmap_add(seqids, seqid, copy);
+  }
+  return copy;
+}
+
+static GtFeatureNode* copy_feature_node(GtFeatureNode *fn, GtHashmap *copies,
+                                        GtHashmap *seqids)
+{
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *copy,
+                *child,
+                *child_copy;
+  GtGenomeNode *gn = (GtGenomeNode*) fn;
+  GtStrArray *attributes;
+  GtStr *seqid,
+        *source;
+  const gchar *name;
+  unsigned long i;
+
+  seqid = copy_seqid(gt_genome_node_get_seqid(gn), seqids);
+  if (gt_feature_node_is_pseudo(fn)) {
+    copy = (GtFeatureNode*)
+           gt_feature_node_new_pseudo(seqid,
+                                      gt_genome_node_get_start(gn),
+                                      gt_genome_node_get_end(gn),
+                                      gt_feature_node_get_strand(fn));
+  } else {
+    copy = (GtFeatureNode*)
+           gt_feature_node_new(seqid,
+                               gt_feature_node_get_type(fn),
+                               gt_genome_node_get_start(gn),
+                               gt_genome_node_get_end(gn),
+                               gt_feature_node_get_strand(fn));
+    if (gt_feature_node_has_source(fn)) {
+      source = gt_str_new_cstr(gt_feature_node_get_source(fn));
+      gt_feature_node_set_source(copy, source);
+      gt_str_delete(source);
+    }
+    if (gt_feature_node_score_is_defined(fn))
+      gt_feature_node_set_score(copy, gt_feature_node_get_score(fn));
+    gt_feature_node_set_phase(copy, gt_feature_node_get_phase(fn));
+    attributes = gt_feature_node_get_attribute_list(fn);
+    for (i = 0; i < gt_str_array_size(attributes); i++) {
+      name = gt_str_array_get(attributes, i);
+      gt_feature_node_add_attribute(copy, name,
+                                    gt_feature_node_get_attribute(fn, name));
+    }
+    gt_str_array_delete(attributes);
+  }
+  gt_hashmap_add(copies, fn, copy);
+
+  /* a child with several parents is copied once and shared by the copies
+     of its parents, as in the original tree */
+  fni = gt_feature_node_iterator_new_direct(fn);
+  while ((child = gt_feature_node_iterator_next(fni))) {
+    if ((child_copy = gt_hashmap_get(copies, child)))
+      gt_genome_node_ref((GtGenomeNode*) child_copy);
+    else
+      child_copy = copy_feature_node(child, copies, seqids);
+    gt_feature_node_add_child(copy, child_copy);
+  }
+  gt_feature_node_iterator_delete(fni);
+
+  return copy;
+}
+
+#define NODE_COPY_USER_DATA "node_copy"
+
+/* the copy of a candidate made for the last save and the version of the
+   candidate it was made of */
+typedef struct {
+  GtGenomeNode *copy;
+  unsigned long version;
+} NodeCopy;
+
+static void node_copy_free(void *data)
+{
+  NodeCopy *nc = (NodeCopy*) data;
+
+  gt_genome_node_delete(nc->copy);
+  g_slice_free(NodeCopy, nc);
+}
+
+void attach_node_copy(GtGenomeNode *gn)
+{
+  NodeCopy *nc;
+
+  gt_assert(gn);
+  if (gt_genome_node_get_user_data(gn, NODE_COPY_USER_DATA))
+    return;
+  nc = g_slice_new(NodeCopy);
+  nc->copy = NULL;
+  nc->version = 0;
+  gt_genome_node_add_user_data(gn, NODE_COPY_USER_DATA, nc, node_copy_free);
+}
+
+void drop_node_copy(GtGenomeNode *gn, MemoryUsage *mu)
+{
+  NodeCopy *nc;
+
+  gt_assert(gn);
+  nc = (NodeCopy*) gt_genome_node_get_user_data(gn, NODE_COPY_USER_DATA);
+  if (!nc || !nc->copy)
+    return;
+  if (mu)
+    memory_usage_sub(mu, MEMORY_NODE_COPIES,
+                     memory_usage_estimate_node(nc->copy));
+  gt_genome_node_delete(nc->copy);
+  nc->copy = NULL;
+}
+
+/* returns a new reference to the copy of the candidate <fn>, which is only
+   copied again if it has changed since its copy kept by attach_node_copy()
+   was made */
+static GtGenomeNode* copy_candidate(GtFeatureNode *fn, GtHashmap *copies,
+                                    GtHashmap *seqids, MemoryUsage *mu)
+{
+  GtGenomeNode *gn = (GtGenomeNode*) fn,
+               *copy;
+  NodeCopy *nc;
+  unsigned long version;
+
+  version = filter_cache_get_version(gn);
+  nc = (NodeCopy*) gt_genome_node_get_user_data(gn, NODE_COPY_USER_DATA);
+  if (nc && nc->copy && version > 0 && nc->version == version)
+    return gt_genome_node_ref(nc->copy);
+  copy = (GtGenomeNode*) copy_feature_node(fn, copies, seqids);
+  gt_hashmap_reset(copies);
+  /* without a version it cannot be told whether the candidate has changed */
+  if (!nc || version == 0)
+    return copy;
+  drop_node_copy(gn, mu);
+  nc->copy = copy;
+  nc->version = version;
+  if (mu)
+    memory_usage_add(mu, MEMORY_NODE_COPIES, memory_usage_estimate_node(copy));
+  return gt_genome_node_ref(copy);
+}
+
+GtArray* copy_node_array(GtArray *nodes, MemoryUsage *mu)
+{
+  GtArray *copy;
+  GtGenomeNode *gn;
+  GtFeatureNode *fn;
+  GtRegionNode *rn;
+  GtHashmap *copies,
+            *seqids;
+  GtStr *seqid;
+  unsigned long i;
+
+  /* the copy does not share any reference counted object with <nodes>, so it
+     can be written by another thread while the candidates are edited. The
+     copies are never changed, those of unchanged candidates are shared with
+     the last save, so only the candidates edited since are copied here */
+  copy = gt_array_new(sizeof (GtGenomeNode*));
+  if (!nodes)
+    return copy;
+  copies = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  seqids = gt_hashmap_new(GT_HASH_DIRECT, NULL, (GtFree) gt_str_delete);
+  for (i = 0; i < gt_array_size(nodes); i++) {
+    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
+    if ((fn = gt_feature_node_try_cast(gn)))
+      gn = copy_candidate(fn, copies, seqids, mu);
+    else if ((rn = gt_region_node_try_cast(gn))) {
+      seqid = copy_seqid(gt_genome_node_get_seqid(gn), seqids);
+      gn = gt_region_node_new(seqid, gt_genome_node_get_start(gn),
+                              gt_genome_node_get_end(gn));
+    } else
+      continue;
+    gt_array_add(copy, gn);
+  }
+  gt_hashmap_delete(copies);
+  gt_hashmap_delete(seqids);
+  return copy;
+}
+
+gboolean node_array_is_sorted(GtArray *nodes)
+{
+  unsigned long i;
+
+  for (i = 1; i < gt_array_size(nodes); i++) {
+    if (gt_genome_node_cmp(*(GtGenomeNode**) gt_array_get(nodes, i - 1),
+                           *(GtGenomeNode**) gt_array_get(nodes, i)) > 0)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+void node_array_ensure_sorted(GtArray *nodes)
+{
+  if (nodes && !node_array_is_sorted(nodes))
+    gt_genome_nodes_sort_stable(nodes);
+}
+
+GtArray* merge_sorted_node_arrays(GtArray *nodes1, GtArray *nodes2)
+{
+  GtArray *merged;
+  GtGenomeNode *gn1, *gn2;
+  unsigned long i = 0, j = 0, size1, size2;
+
+  size1 = nodes1 ? gt_array_size(nodes1) : 0;
+  size2 = nodes2 ? gt_array_size(nodes2) : 0;
+  merged = gt_array_new(sizeof (GtGenomeNode*));
+  while (i < size1 && j < size2) {
+    gn1 = *(GtGenomeNode**) gt_array_get(nodes1, i);
+    gn2 = *(GtGenomeNode**) gt_array_get(nodes2, j);
+    if (gt_genome_node_cmp(gn1, gn2) <= 0) {
+      gt_array_add(merged, gn1);
+      i++;
+    } else {
+      gt_array_add(merged, gn2);
+      j++;
+    }
+  }
+  for (; i < size1; i++)
+    gt_array_add_elem(merged, gt_array_get(nodes1, i), sizeof (GtGenomeNode*));
+  for (; j < size2; j++)
+    gt_array_add_elem(merged, gt_array_get(nodes2, j), sizeof (GtGenomeNode*));
+  return merged;
+}
+
+void snapshot_node_array_delete(GtArray *snapshot)
+{
+  unsigned long i;
+
+  if (!snapshot)
+    return;
+  for (i = 0; i < gt_array_size(snapshot); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(snapshot, i));
+  gt_array_delete(snapshot);
+}
+
+guint compression_threads(void)
+{
+  const gchar *threads;
+
+  threads = g_getenv(LTRSIFT_COMPRESS_ENV);
+  if (!threads)
+    return 0;
+  return (guint) g_ascii_strtoull(threads, NULL, 10);
+}
+
+gchar* project_gff3_file(const gchar *projectfile, gboolean write)
+{
+  gchar *base,
+        *plain,
+        *compressed;
+
+  base = g_strndup(projectfile, strlen(projectfile) - strlen(SQLITE_PATTERN));
+  plain = g_strconcat(base, GFF3_PATTERN, NULL);
+  compressed = g_strconcat(base, GFF3_PATTERN, GZ_PATTERN, NULL);
+  g_free(base);
+  if ((write && compression_threads() > 0) ||
+      (!write && g_file_test(compressed, G_FILE_TEST_EXISTS))) {
+    g_free(plain);
+    return compressed;
+  }
+  g_free(compressed);
+  return plain;
+}
+
+static gchar* create_tmp_file(GtError *err)
+{
+  GError *gerr = NULL;
+  gchar *filename = NULL;
+  gint fd;
+
+  fd = g_file_open_tmp("ltrsift_XXXXXX", &filename, &gerr);
+  if (fd == -1) {
+    gt_error_set(err, "Could not create temporary file: %s", gerr->message);
+    g_error_free(gerr);
+    return NULL;
+  }
+  close(fd);
+  return filename;
+}
+
+GtFile* gff3_output_new(const gchar *filename, gchar **plainfile,
+                        GtError *err)
+{
+  /* compressed output is written to a local temporary file first, which is
+     then compressed block-wise in parallel by gff3_output_finish() */
+  *plainfile = NULL;
+  if (g_str_has_suffix(filename, GZ_PATTERN)) {
+    if (!(*plainfile = create_tmp_file(err)))
+      return NULL;
+    return gt_file_new(*plainfile, "w", err);
+  }
+  return gt_file_new(filename, "w+", err);
+}
+
+gint gff3_output_finish(GtFile *outfp, const gchar *filename,
+                        gchar *plainfile, gboolean keep_plainfile,
+                        gint had_err, GtError *err)
+{
+  gchar *tmpfile;
+  guint threads;
+
+  gt_file_delete(outfp);
+  if (!plainfile)
+    return had_err;
+  if (!had_err) {
+    if ((threads = compression_threads()) == 0)
+      threads = bgzf_default_threads();
+    /* <filename> is only replaced once it has been compressed completely */
+    tmpfile = g_strconcat(filename, TMP_PATTERN, NULL);
+    had_err = bgzf_compress_file(plainfile, tmpfile, threads, err);
+    if (!had_err && g_rename(tmpfile, filename) != 0) {
+      gt_error_set(err, "Could not rename %s: %s", tmpfile, g_strerror(errno));
+      had_err = -1;
+    }
+    if (had_err)
+      g_unlink(tmpfile);
+    g_free(tmpfile);
+  }
+  /* with <keep_plainfile> the caller takes over the uncompressed copy */
+  if (had_err || !keep_plainfile) {
+    g_unlink(plainfile);
+    g_free(plainfile);
+  }
+  return had_err;
+}
+
+gchar* gff3_input_new(const gchar *filename, GtError *err)
+{
+  gchar *plainfile;
+
+  if (!g_str_has_suffix(filename, GZ_PATTERN))
+    return g_strdup(filename);
+  if (!(plainfile = create_tmp_file(err)))
+    return NULL;
+  if (bgzf_decompress_file(filename, plainfile, bgzf_default_threads(),
+                           err)) {
+    g_unlink(plainfile);
+    g_free(plainfile);
+    return NULL;
+  }
+  return plainfile;
+}
+
+void gff3_input_delete(const gchar *filename, gchar *plainfile)
+{
+  if (plainfile && g_strcmp0(filename, plainfile) != 0)
+    g_unlink(plainfile);
+  g_free(plainfile);
+}
+
+gchar* export_filename(const gchar *filen, const gchar *pattern)
+{
+  gchar *compressed;
+  gboolean keep;
+
+  /* the name chosen by the user is kept, an export is only compressed if
+     the name asks for it */
+  compressed = g_strconcat(pattern, GZ_PATTERN, NULL);
+  keep = (g_str_has_suffix(filen, compressed) ||
+          g_str_has_suffix(filen, pattern));
+  g_free(compressed);
+  if (keep)
+    return g_strdup(filen);
+  return g_strconcat(filen, pattern, NULL);
+}
+
 void export_annotation(GtArray *nodes, GT_UNUSED GtArray *regions, gchar *filen,
                        gboolean flcands, GtkWidget *toplevel)
 {
@@ -439,16 +912,14 @@ void export_annotation(GtArray *nodes, GT_UNUSED GtArray *regions, gchar *filen,
   GtFile *outfp;
   GtError *err;
   gchar *filename,
+        *plainfile = NULL,
         tmp_filename[BUFSIZ];
   const char *attr;
   int had_err = 0;
   unsigned long i;
   gboolean bakfile = FALSE;
 
-  if (!g_str_has_suffix(filen, GFF3_PATTERN))
-    filename = g_strconcat(filen, GFF3_PATTERN, NULL);
-  else
-    filename = filen;
+  filename = export_filename(filen, GFF3_PATTERN);
 
   if (g_file_test(filename, G_FILE_TEST_EXISTS)) {
     gchar buffer[BUFSIZ];
@@ -464,6 +935,7 @@ void export_annotation(GtArray *nodes, GT_UNUSED GtArray *regions, gchar *filen,
     gtk_window_set_position(GTK_WINDOW(dialog), GTK_WIN_POS_CENTER_ALWAYS);
     if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_YES) {
       gtk_widget_destroy(dialog);
+      g_free(filename);
       return;
     } else {
       g_snprintf(tmp_filename, BUFSIZ, "%s.bak", filename);
@@ -474,7 +946,15 @@ void export_annotation(GtArray *nodes, GT_UNUSED GtArray *regions, gchar *filen,
   }
 
   err = gt_error_new();
-  outfp = gt_file_new(filename, "w", err);
+  outfp = gff3_output_new(filename, &plainfile, err);
+  if (!outfp) {
+    if (bakfile)
+      g_rename(tmp_filename, filename);
+    error_handle(toplevel, err);
+    gt_error_delete(err);
+    g_free(filename);
+    return;
+  }
 
   if (flcands) {
     GtArray *tmp = gt_array_new(sizeof (GtGenomeNode*));
@@ -506,7 +986,8 @@ void export_annotation(GtArray *nodes, GT_UNUSED GtArray *regions, gchar *filen,
   gff3_out_stream = gt_gff3_out_stream_new(array_in_stream, outfp);
 
   had_err = gt_node_stream_pull(gff3_out_stream, err);
-  gt_file_delete(outfp);
+  had_err = gff3_output_finish(outfp, filename, plainfile, FALSE, had_err,
+                               err);
 
   if (had_err) {
     if (bakfile)
@@ -517,35 +998,25 @@ void export_annotation(GtArray *nodes, GT_UNUSED GtArray *regions, gchar *filen,
   gt_node_stream_delete(gff3_out_stream);
   gt_array_delete(export_nodes);
   gt_error_delete(err);
+  g_free(filename);
 }
 
 void export_sequences(GtArray *nodes, gchar *filen, const gchar *indexname,
                       gboolean flcands, GtkWidget *toplevel)
 {
   GtkWidget *dialog;
-  GtStr *seqid;
-  GtGenomeNode *gn;
-  GtFeatureNode *curnode;
-  GtFeatureNodeIterator *fni;
-  GtRange range;
-  GtFile *outfp;
+  GtFile *outfp = NULL;
   GtEncseqLoader *el = NULL;
   GtEncseq *encseq = NULL;
+  SequenceExport *se = NULL;
   GtError *err;
   gchar *filename,
+        *plainfile = NULL,
         tmp_filename[BUFSIZ];
-  char *buffer, header[BUFSIZ];
-  const char *attr;
   gint had_err = 0;
-  unsigned long i,
-                seqnum,
-                startpos;
   gboolean bakfile = FALSE;
 
-  if (!g_str_has_suffix(filen, FAS_PATTERN)) {
-    filename = g_strconcat(filen, FAS_PATTERN, NULL);
-  } else
-    filename = filen;
+  filename = export_filename(filen, FAS_PATTERN);
 
   if (g_file_test(filename, G_FILE_TEST_EXISTS)) {
     gchar buffer[BUFSIZ];
@@ -561,6 +1032,7 @@ void export_sequences(GtArray *nodes, gchar *filen, const gchar *indexname,
     gtk_window_set_position(GTK_WINDOW(dialog), GTK_WIN_POS_CENTER_ALWAYS);
     if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_NO) {
       gtk_widget_destroy(dialog);
+      g_free(filename);
       return;
     } else {
       g_snprintf(tmp_filename, BUFSIZ, "%s.bak", filename);
@@ -571,256 +1043,54 @@ void export_sequences(GtArray *nodes, gchar *filen, const gchar *indexname,
   }
 
   err = gt_error_new();
-  outfp = gt_file_new(filename, "w", err);
-  if (!outfp)
+  el = gt_encseq_loader_new();
+  encseq = gt_encseq_loader_load(el, indexname, err);
+  if (!encseq)
     had_err = -1;
 
   if (!had_err) {
-    el = gt_encseq_loader_new();
-    encseq = gt_encseq_loader_load(el, indexname, err);
-    if (!encseq)
-      had_err = -1;
+    se = sequence_export_new();
+    had_err = sequence_export_add_nodes(se, nodes, encseq, flcands, err);
   }
-
   if (!had_err) {
-    for (i = 0; !had_err && i < gt_array_size(nodes); i++) {
-      const char *id;
-      bool found = false;
-      gn = *(GtGenomeNode**) gt_array_get(nodes, i);
-      fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
-      curnode = gt_feature_node_iterator_next(fni);
-      while (!found) {
-        curnode = gt_feature_node_iterator_next(fni);
-        if (strcmp(gt_feature_node_get_type(curnode), FNT_LTRRETRO) == 0)
-          found = true;
-      }
-      if (!found) {
-        gt_feature_node_iterator_delete(fni);
-        continue;
-      }
-      gt_assert(strcmp(gt_feature_node_get_type(curnode), FNT_LTRRETRO) == 0);
-      seqid = gt_genome_node_get_seqid((GtGenomeNode*) curnode);
-      range = gt_genome_node_get_range((GtGenomeNode*) curnode);
-      if (flcands) {
-        attr = gt_feature_node_get_attribute(curnode, ATTR_FULLLEN);
-        if (!attr) {
-          gt_feature_node_iterator_delete(fni);
-          continue;
-        }
-      }
-      id = gt_feature_node_get_attribute(curnode, "ID");
-      attr = gt_feature_node_get_attribute(curnode, ATTR_LTRFAM);
-      if (attr)
-        g_snprintf(header, BUFSIZ, "%s_%s_%lu_%lu%c%s", attr, gt_str_get(seqid),
-                   range.start, range.end, id ? '_' : ' ', id ? id : "");
-      else
-        g_snprintf(header, BUFSIZ, "%s_%lu_%lu%c%s", gt_str_get(seqid),
-                   range.start, range.end, id ? '_' : ' ', id ? id : "");
-      sscanf(gt_str_get(seqid), "seq%lu", &seqnum);
-      buffer = gt_calloc((size_t) gt_range_length(&range) + 1, sizeof (char));
-      startpos = gt_encseq_seqstartpos(encseq, seqnum);
-      gt_encseq_extract_decoded(encseq, buffer, startpos + range.start - 1,
-                                startpos + range.end - 1);
-      if (gt_feature_node_get_strand(curnode) == GT_STRAND_REVERSE) {
-        had_err = gt_reverse_complement(buffer, gt_range_length(&range), err);
-      }
-      if (!had_err) {
-        gt_fasta_show_entry(header, buffer, gt_range_length(&range), 50, outfp);
-      }
-      gt_free(buffer);
-      gt_feature_node_iterator_delete(fni);
-    }
-    gt_file_delete(outfp);
+    outfp = gff3_output_new(filename, &plainfile, err);
+    if (!outfp)
+      had_err = -1;
   }
+  /* the sequences are extracted and formatted by one thread per processor,
+     compressed output is compressed in parallel afterwards */
+  if (!had_err)
+    had_err = sequence_export_write(se, encseq, outfp, bgzf_default_threads(),
+                                    err);
+  if (outfp || plainfile)
+    had_err = gff3_output_finish(outfp, filename, plainfile, FALSE, had_err,
+                                 err);
 
   if (had_err) {
     if (bakfile)
       g_rename(tmp_filename, filename);
     error_handle(toplevel, err);
   }
+  sequence_export_delete(se);
   gt_encseq_delete(encseq);
   gt_encseq_loader_delete(el);
   gt_error_delete(err);
-}
-
-static int compare_gfloat(const void *a, const void *b)
-{
-  gfloat num1 = *(gfloat*) a,
-        num2 = *(gfloat*) b;
-
-  if (num1 < num2)
-    return -1;
-  else if (num1 > num2)
-    return 1;
-  else
-    return 0;
-}
-
-static gfloat calculate_median(GtArray *gfloat_array)
-{
-  GtArray *gfloat_array_clone;
-  gfloat median;
-  unsigned long n = gt_array_size(gfloat_array);
-
-  gfloat_array_clone = gt_array_clone(gfloat_array);
-  gt_array_sort_stable(gfloat_array_clone, (GtCompare) compare_gfloat);
-
-  if (n % 2 == 0)
-    median = (((*(gfloat*) gt_array_get(gfloat_array_clone, n / 2)) +
-               (*(gfloat*) gt_array_get(gfloat_array_clone, (n / 2) - 1)))
-              / 2.0);
-  else
-    median = (*(gfloat*) gt_array_get(gfloat_array_clone, n / 2));
-
-  gt_array_delete(gfloat_array_clone);
-
-  return median;
-}
-
-static void fl_cands_ltr_and_elem_length_median(GtArray *nodes,
-                                                GtArray *fl_cands_ltr_length,
-                                                GtArray *fl_cands_elem_length,
-                                                gfloat *fl_cands_ltrlen_median,
-                                                gfloat *fl_cands_elemlen_median)
-{
-  GtGenomeNode *gn;
-  GtFeatureNode *curnode;
-  GtFeatureNodeIterator *fni;
-  gfloat length;
-  const char *fnt;
-  unsigned long i;
-
-  for (i = 0; i < gt_array_size(nodes); i++) {
-    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
-    fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
-    while ((curnode = gt_feature_node_iterator_next(fni))) {
-      fnt = gt_feature_node_get_type(curnode);
-      if (g_strcmp0(fnt, FNT_LTRRETRO) == 0) {
-        length = (gfloat) gt_genome_node_get_length((GtGenomeNode*) curnode);
-        gt_array_add(fl_cands_ltr_length, length);
-      } else if (g_strcmp0(fnt, FNT_LTR) == 0) {
-        length = (gfloat) gt_genome_node_get_length((GtGenomeNode*) curnode);
-        gt_array_add(fl_cands_elem_length, length);
-        break;
-      }
-    }
-    gt_feature_node_iterator_delete(fni);
-  }
-  *fl_cands_ltrlen_median = calculate_median(fl_cands_ltr_length);
-  *fl_cands_elemlen_median = calculate_median(fl_cands_elem_length);
-}
-
-void mark_genomenode_as_flcand(GtGenomeNode *gn)
-{
-  GtFeatureNode *curnode;
-  GtFeatureNodeIterator *fni;
-
-  fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
-  curnode = gt_feature_node_iterator_next(fni);
-  gt_feature_node_set_attribute(curnode, ATTR_FULLLEN, "yes");
-  gt_feature_node_iterator_delete(fni);
+  g_free(filename);
 }
 
 unsigned long determine_full_length_candidates(GtArray *nodes,
                                                gfloat ltrtolerance,
                                                gfloat lentolerance)
 {
-  GtGenomeNode *gn;
-  GtFeatureNode *curnode;
-  GtFeatureNodeIterator *fni;
-  GtArray *num_domains_fam,
-          *fl_cands,
-          *fl_cands_ltr_length,
-          *fl_cands_elem_length;
-  const char *fnt;
-  gfloat fl_cands_ltrlen_median,
-         fl_cands_elemlen_median,
-         fl_cand_elem_length,
-         fl_cand_ltr_length;
+  gboolean *flags;
   unsigned long i,
-                num_domains_cand,
-                max_num_domains = 0,
-                most_freq_num_domains = 0,
-                cur_num_domains,
-                old_num_domains = 0,
-                flcands = 0;
-
-  num_domains_fam = gt_array_new(sizeof (unsigned long));
-
-  for (i = 0; i < gt_array_size(nodes); i++) {
-    gn = *(GtGenomeNode**) gt_array_get(nodes, i);
-    fni = gt_feature_node_iterator_new((GtFeatureNode*) gn);
-    while ((curnode = gt_feature_node_iterator_next(fni))) {
-      fnt = gt_feature_node_get_type(curnode);
-      if (g_strcmp0(fnt, FNT_REPEATR) == 0) {
-        const char *attr = gt_feature_node_get_attribute(curnode,
-                                                         ATTR_FULLLEN);
-        if (attr)
-          gt_feature_node_remove_attribute(curnode, ATTR_FULLLEN);
-      } else if (g_strcmp0(fnt, FNT_LTRRETRO) == 0) {
-        num_domains_cand = gt_feature_node_number_of_children(curnode);
-        if (num_domains_cand > max_num_domains)
-          max_num_domains = num_domains_cand;
-        break;
-      }
-    }
-    gt_feature_node_iterator_delete(fni);
-    gt_array_add(num_domains_fam, num_domains_cand);
-  }
-
-  unsigned long num_domains_freq[max_num_domains];
-
-  for (i = 0; i < max_num_domains; i++) {
-    num_domains_freq[i] = 0;
-  }
-
-  for (i = 0; i < gt_array_size(num_domains_fam); i++) {
-    num_domains_cand = *(unsigned long*) gt_array_get(num_domains_fam, i);
-    num_domains_freq[num_domains_cand - 1]++;
-  }
-
-  for (i = 0; i < max_num_domains; i++) {
-    cur_num_domains = num_domains_freq[i];
-    if (cur_num_domains >= old_num_domains) {
-      most_freq_num_domains = i + 1;
-      old_num_domains = num_domains_freq[i];
-    }
-  }
-
-  fl_cands = gt_array_new(sizeof (GtGenomeNode*));
-  for (i = 0; i < gt_array_size(num_domains_fam); i++) {
-    num_domains_cand = *(unsigned long*) gt_array_get(num_domains_fam, i);
-    if (num_domains_cand == most_freq_num_domains) {
-      gn = *(GtGenomeNode**) gt_array_get(nodes, i);
-      gt_array_add(fl_cands, gn);
-    }
-  }
-  gt_array_delete(num_domains_fam);
-
-  fl_cands_ltr_length = gt_array_new(sizeof (gfloat));
-  fl_cands_elem_length = gt_array_new(sizeof (gfloat));
-  fl_cands_ltr_and_elem_length_median(fl_cands,
-                                      fl_cands_ltr_length,
-                                      fl_cands_elem_length,
-                                      &fl_cands_ltrlen_median,
-                                      &fl_cands_elemlen_median);
-
-  for (i = 0; i < gt_array_size(fl_cands); i++) {
-    fl_cand_ltr_length = *(gfloat*) gt_array_get(fl_cands_ltr_length, i);
-    fl_cand_elem_length = *(gfloat*) gt_array_get(fl_cands_elem_length, i);
-    if ((fabsf(fl_cand_ltr_length - fl_cands_ltrlen_median) <= ltrtolerance)
-        && (fabsf(fl_cand_elem_length - fl_cands_elemlen_median) <=
-            lentolerance)) {
-      gn = *(GtGenomeNode**) gt_array_get(fl_cands, i);
-      mark_genomenode_as_flcand(gn);
-      flcands++;
-    }
-  }
-
-  gt_array_delete(fl_cands_elem_length);
-  gt_array_delete(fl_cands_ltr_length);
-  gt_array_delete(fl_cands);
+                flcands;
 
+  flags = g_malloc(MAX(gt_array_size(nodes), 1) * sizeof (gboolean));
+  flcands = flcand_select(nodes, ltrtolerance, lentolerance, flags);
+  for (i = 0; i < gt_array_size(nodes); i++)
+    (void) flcand_set(*(GtGenomeNode**) gt_array_get(nodes, i), flags[i]);
+  g_free(flags);
   return flcands;
 }
 
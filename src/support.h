@@ -19,7 +19,12 @@
 #ifndef SUPPORT_H
 #define SUPPORT_H
 
+#include "family_export.h"
+#include "flcand.h"
+#include "job_progress.h"
 #include "ltrsift.h"
+#include "memory_usage.h"
+#include "perf_log.h"
 
 typedef struct _ThreadData    ThreadData;
 typedef struct _CandidateData CandidateData;
@@ -32,17 +37,23 @@ struct _ThreadData {
             *dialog,
             *blastn_refseq;
   GtkTreeView *list_view;
-  GList *references;
   GtArray *nodes,
           *old_nodes,
           *new_nodes,
-          *regions;
+          *regions,
+          *unloaded;
   GtError *err;
   GtHashmap *sel_features,
             *features;
   GtRDB *rdb;
   GtAnnoDBSchema *adb;
   GtFeatureIndex *fi;
+  ProjectIndex *index,
+               *new_index;
+  FamilyExport *famexport;
+  FLCandBatch *flcands;
+  PerfLog *perf;
+  JobProgress *jobprogress;
   gboolean classification,
            projectw,
            save,
@@ -51,7 +62,8 @@ struct _ThreadData {
            orf,
            match,
            bakfile,
-           use_paramset;
+           use_paramset,
+           background;
   gchar *current_state,
         *filename,
         *tmp_filename,
@@ -65,7 +77,8 @@ struct _ThreadData {
   int had_err;
   unsigned long progress,
                 n_features,
-                set_id;
+                set_id,
+                generation;
 };
 
 struct _CandidateData
@@ -97,6 +110,39 @@ void          extract_project_settings(GUIData *ltrgui);
 
 GtArray*      create_region_nodes_from_node_array(GtArray *nodes);
 
+GtArray*      snapshot_node_array(GtArray *nodes);
+
+GtArray*      copy_node_array(GtArray *nodes, MemoryUsage *mu);
+
+void          attach_node_copy(GtGenomeNode *gn);
+
+void          drop_node_copy(GtGenomeNode *gn, MemoryUsage *mu);
+
+void          snapshot_node_array_delete(GtArray *snapshot);
+
+gboolean      node_array_is_sorted(GtArray *nodes);
+
+void          node_array_ensure_sorted(GtArray *nodes);
+
+GtArray*      merge_sorted_node_arrays(GtArray *nodes1, GtArray *nodes2);
+
+guint         compression_threads(void);
+
+gchar*        project_gff3_file(const gchar *projectfile, gboolean write);
+
+GtFile*       gff3_output_new(const gchar *filename, gchar **plainfile,
+                              GtError *err);
+
+gint          gff3_output_finish(GtFile *outfp, const gchar *filename,
+                                 gchar *plainfile, gboolean keep_plainfile,
+                                 gint had_err, GtError *err);
+
+gchar*        gff3_input_new(const gchar *filename, GtError *err);
+
+void          gff3_input_delete(const gchar *filename, gchar *plainfile);
+
+gchar*        export_filename(const gchar *filen, const gchar *pattern);
+
 void          export_annotation(GtArray *nodes, GtArray *regions, gchar *filen, gboolean flcands,
                                 GtkWidget *toplevel);
 
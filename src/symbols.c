@@ -0,0 +1,57 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "message_strings.h"
+#include "symbols.h"
+
+static const gchar *feature_types[SYMBOL_NUM];
+
+static void symbols_init(void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter(&initialized)) {
+    feature_types[SYMBOL_OTHER] = NULL;
+    feature_types[SYMBOL_REPEATR] = gt_symbol(FNT_REPEATR);
+    feature_types[SYMBOL_LTRRETRO] = gt_symbol(FNT_LTRRETRO);
+    feature_types[SYMBOL_LTR] = gt_symbol(FNT_LTR);
+    feature_types[SYMBOL_TSD] = gt_symbol(FNT_TSD);
+    feature_types[SYMBOL_PROTEINM] = gt_symbol(FNT_PROTEINM);
+    feature_types[SYMBOL_PBS] = gt_symbol(FNT_PBS);
+    feature_types[SYMBOL_PPT] = gt_symbol(FNT_PPT);
+    g_once_init_leave(&initialized, 1);
+  }
+}
+
+FeatureSymbol symbols_feature_type(GtFeatureNode *fn)
+{
+  const gchar *fnt;
+  guint i;
+
+  symbols_init();
+  fnt = gt_feature_node_get_type(fn);
+  for (i = SYMBOL_OTHER + 1; i < SYMBOL_NUM; i++) {
+    if (fnt == feature_types[i])
+      return (FeatureSymbol) i;
+  }
+  return SYMBOL_OTHER;
+}
+
+const gchar* symbols_intern(const gchar *str)
+{
+  return g_intern_string(str);
+}
@@ -0,0 +1,52 @@
+/*
+  Copyright (c) 2013 Center for Bioinformatics, University of Hamburg
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <glib.h>
+#include "genometools.h"
+
+/* The feature types LTRsift handles specially. */
+typedef enum {
+  SYMBOL_OTHER = 0,
+  SYMBOL_REPEATR,
+  SYMBOL_LTRRETRO,
+  SYMBOL_LTR,
+  SYMBOL_TSD,
+  SYMBOL_PROTEINM,
+  SYMBOL_PBS,
+  SYMBOL_PPT,
+  SYMBOL_NUM
+} FeatureSymbol;
+
+/* Returns the symbol of the type of <fn>, <SYMBOL_OTHER> for all types not
+   listed above. The types of feature nodes are interned by genometools, so
+   the type is identified by comparing pointers instead of strings. */
+FeatureSymbol symbols_feature_type(GtFeatureNode *fn);
+
+/* Returns the canonical copy of <str> (or NULL if <str> is NULL). Equal
+   strings are interned only once for the whole program, so interned strings
+   (e.g. family names and seqids) can be compared with ==. They are never
+   freed. Can be called from any thread.
+   Only the tables of LTRsift itself (project index, location index,
+   overview, filter preview) refer to interned names. The ``ltrfam''
+   attribute of every candidate and the string cells of the list stores
+   keep their own copies, which genometools and GTK make. */
+const gchar*  symbols_intern(const gchar *str);
+
+#endif